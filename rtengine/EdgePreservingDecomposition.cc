@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 #include "rt_math.h"
 #include "EdgePreservingDecomposition.h"
@@ -10,6 +11,11 @@
 #define DIAGONALS 5
 #define DIAGONALSP1 6
 
+//CreateBlur stops iterating at this rms residual. The system is solved for the logarithm of luminance, so it's a relative error of 0.01 %.
+#define EPD_RMS_RESIDUAL 0.0001f
+//The multigrid needs up to about 15 iterates for that, at large Scale.
+#define EPD_MIN_ITERATES 20
+
 /* Solves A x = b by the conjugate gradient method, where instead of feeding it the matrix A you feed it a function which
 calculates A x where x is some vector. Stops when rms residual < RMSResidual or when maximum iterates is reached.
 Stops at n iterates if MaximumIterates = 0 since that many iterates gives exact solution. Applicable to symmetric positive
@@ -617,7 +623,383 @@ void MultiDiagonalSymmetricMatrix::CholeskyBackSolve(float* RESTRICT x, float* R
     }
 }
 
-EdgePreservingDecomposition::EdgePreservingDecomposition(int width, int height) : a0(nullptr) , a_1(nullptr), a_w(nullptr), a_w_1(nullptr), a_w1(nullptr)
+namespace
+{
+
+//Damping of the Jacobi smoother and number of smoothing sweeps before and after the coarse grid correction.
+constexpr float MG_OMEGA = 0.8f;
+constexpr int MG_SWEEPS = 1;
+
+//Levels are added while the coarsest one is at least this wide and high and has more than MG_MIN_COARSEST pixels.
+constexpr int MG_MIN_SIZE = 16;
+constexpr int MG_MIN_COARSEST = 4096;
+
+//Entry of the grid matrix with diagonals a (starting at rows 0, 1, w - 1, w, w + 1) between pixel i and its neighbour at (dx, dy).
+inline float StencilEntry(float * const *a, int w, int i, int dx, int dy)
+{
+    if(dy == 0) {
+        return dx == 0 ? a[0][i] : (dx < 0 ? a[1][i - 1] : a[1][i]);
+    } else if(dy < 0) {
+        return dx == 0 ? a[3][i - w] : (dx < 0 ? a[4][i - w - 1] : a[2][i - w + 1]);
+    } else {
+        return dx == 0 ? a[3][i] : (dx < 0 ? a[2][i] : a[4][i]);
+    }
+}
+
+//Weight of the lower coarse neighbour, given the couplings to the lower and the upper one.
+inline float InterpolationWeight(float lo, float hi)
+{
+    lo = std::max(lo, 0.f);
+    hi = std::max(hi, 0.f);
+    return lo + hi > 0.f ? lo / (lo + hi) : 0.5f;
+}
+
+//Row px, py of the product, for the pixels at the borders where not all neighbours exist.
+inline float StencilProduct(float * const *a, const float *x, int w, int h, int px, int py)
+{
+    const int i = py * w + px;
+    float prod = 0.f;
+
+    for(int dy = -1; dy <= 1; dy++) {
+        if(py + dy >= 0 && py + dy < h) {
+            for(int dx = -1; dx <= 1; dx++) {
+                if(px + dx >= 0 && px + dx < w) {
+                    prod += StencilEntry(a, w, i, dx, dy) * x[i + dy * w + dx];
+                }
+            }
+        }
+    }
+
+    return prod;
+}
+
+//r = b - A x, or r = A x without b.
+template<bool WithRhs>
+void StencilApply(float * const *a, int w, int h, float * RESTRICT r, const float * RESTRICT b, const float * RESTRICT x)
+{
+    const float * RESTRICT a0 = a[0];
+    const float * RESTRICT a_1 = a[1];
+    const float * RESTRICT a_w1 = a[2];
+    const float * RESTRICT a_w = a[3];
+    const float * RESTRICT a_w_1 = a[4];
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic,16) if(w * h > 16384)
+#endif
+
+    for(int y = 0; y < h; y++) {
+        const int row = y * w;
+
+        if(y == 0 || y == h - 1) {
+            for(int px = 0; px < w; px++) {
+                const float prod = StencilProduct(a, x, w, h, px, y);
+                r[row + px] = WithRhs ? b[row + px] - prod : prod;
+            }
+
+            continue;
+        }
+
+        for(int px : {0, w - 1}) {
+            const float prod = StencilProduct(a, x, w, h, px, y);
+            r[row + px] = WithRhs ? b[row + px] - prod : prod;
+        }
+
+        for(int i = row + 1; i < row + w - 1; i++) {
+            const float prod = a0[i] * x[i]
+                               + a_1[i - 1] * x[i - 1] + a_1[i] * x[i + 1]
+                               + a_w[i - w] * x[i - w] + a_w[i] * x[i + w]
+                               + a_w_1[i - w - 1] * x[i - w - 1] + a_w_1[i] * x[i + w + 1]
+                               + a_w1[i - w + 1] * x[i - w + 1] + a_w1[i] * x[i + w - 1];
+            r[i] = WithRhs ? b[i] - prod : prod;
+        }
+    }
+}
+
+}
+
+MultigridPreconditioner::MultigridPreconditioner(int width, int height)
+{
+    Level fine;
+    fine.w = width;
+    fine.h = height;
+    fine.A = nullptr;
+    fine.r.resize(width * height);
+    levels.push_back(std::move(fine));
+
+    while(levels.back().w >= MG_MIN_SIZE && levels.back().h >= MG_MIN_SIZE && levels.back().w * levels.back().h > MG_MIN_COARSEST) {
+        //Coarse pixels are at the even fine pixels, plus one beyond the last fine column or row if those are odd.
+        Level coarse;
+        coarse.w = levels.back().w / 2 + 1;
+        coarse.h = levels.back().h / 2 + 1;
+        const int n = coarse.w * coarse.h;
+        coarse.A = new MultiDiagonalSymmetricMatrix(n, DIAGONALS);
+
+        if(!(
+                    coarse.A->CreateDiagonal(0, 0) &&
+                    coarse.A->CreateDiagonal(1, 1) &&
+                    coarse.A->CreateDiagonal(2, coarse.w - 1) &&
+                    coarse.A->CreateDiagonal(3, coarse.w) &&
+                    coarse.A->CreateDiagonal(4, coarse.w + 1))) {
+            delete coarse.A;
+            break;  //Out of memory, the current coarsest level will do.
+        }
+
+        coarse.x.resize(n);
+        coarse.b.resize(n);
+        coarse.r.resize(n);
+        levels.back().wx.resize(levels.back().w * levels.back().h);
+        levels.back().wy.resize(levels.back().w * levels.back().h);
+        levels.push_back(std::move(coarse));
+    }
+}
+
+MultigridPreconditioner::~MultigridPreconditioner()
+{
+    MultiDiagonalSymmetricMatrix *coarsest = levels.back().A;
+
+    if(coarsest != nullptr && coarsest->IncompleteCholeskyFactorization != nullptr) {
+        coarsest->KillIncompleteCholeskyFactorization();
+        coarsest->IncompleteCholeskyFactorization = nullptr;
+    }
+
+    for(size_t l = 1; l < levels.size(); l++) {
+        delete levels[l].A;
+    }
+}
+
+bool MultigridPreconditioner::Setup(MultiDiagonalSymmetricMatrix *A)
+{
+    levels[0].A = A;
+
+    for(size_t l = 1; l < levels.size(); l++) {
+        Level &fine = levels[l - 1];
+        const int wf = fine.w, hf = fine.h;
+        const int wc = levels[l].w, hc = levels[l].h;
+        float * const *af = fine.A->Diagonals;
+        float * const *ac = levels[l].A->Diagonals;
+
+        //Interpolation weights. An odd fine pixel is interpolated from its two coarse neighbours along the axis, weighted by its
+        //couplings to them (the columns or rows of its stencil summed up). So the interpolation doesn't blur across the edges
+        //the decomposition preserves, which a bilinear one would, and convergence doesn't suffer from strong edge stopping.
+#ifdef _OPENMP
+        #pragma omp parallel for if(wf * hf > 16384)
+#endif
+
+        for(int y = 0; y < hf; y++) {
+            for(int x = 0; x < wf; x++) {
+                const int i = y * wf + x;
+                //The coarse pixel beyond an odd last column or row has just this one to interpolate, keep it coupled.
+                fine.wx[i] = (x & 1) ? 0.5f : 1.f;
+                fine.wy[i] = (y & 1) ? 0.5f : 1.f;
+
+                if((x & 1) && x < wf - 1) {
+                    float lo = 0.f, hi = 0.f;
+
+                    for(int d = std::max(-1, -y); d <= std::min(1, hf - 1 - y); d++) {
+                        lo -= StencilEntry(af, wf, i, -1, d);
+                        hi -= StencilEntry(af, wf, i, 1, d);
+                    }
+
+                    fine.wx[i] = InterpolationWeight(lo, hi);
+                }
+
+                if((y & 1) && y < hf - 1) {
+                    float lo = 0.f, hi = 0.f;
+
+                    for(int d = std::max(-1, -x); d <= std::min(1, wf - 1 - x); d++) {
+                        lo -= StencilEntry(af, wf, i, d, -1);
+                        hi -= StencilEntry(af, wf, i, d, 1);
+                    }
+
+                    fine.wy[i] = InterpolationWeight(lo, hi);
+                }
+            }
+        }
+
+        //Galerkin coarse matrix Ac = Pt A P. It has the 3x3 stencil too. Each coarse row only writes its own entries.
+        const float * RESTRICT wx = fine.wx.data();
+        const float * RESTRICT wy = fine.wy.data();
+
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(dynamic,16) if(wc * hc > 4096)
+#endif
+
+        for(int Y = 0; Y < hc; Y++) {
+            for(int X = 0; X < wc; X++) {
+                float c[3][3] = {};
+
+                //Fine pixels interpolated from coarse pixel (X, Y), with their weights.
+                for(int fy = std::max(2 * Y - 1, 0); fy <= std::min(2 * Y + 1, hf - 1); fy++) {
+                    for(int fx = std::max(2 * X - 1, 0); fx <= std::min(2 * X + 1, wf - 1); fx++) {
+                        const int i = fy * wf + fx;
+                        const float wi = (fx < 2 * X ? 1.f - wx[i] : wx[i]) * (fy < 2 * Y ? 1.f - wy[i] : wy[i]);
+
+                        //Their neighbours, and the coarse pixels those are interpolated from.
+                        for(int jy = std::max(fy - 1, 0); jy <= std::min(fy + 1, hf - 1); jy++) {
+                            for(int jx = std::max(fx - 1, 0); jx <= std::min(fx + 1, wf - 1); jx++) {
+                                const int j = jy * wf + jx;
+                                const float aij = wi * StencilEntry(af, wf, i, jx - fx, jy - fy);
+                                const int py = jy / 2 - Y + 1, px = jx / 2 - X + 1;
+                                const float wjx = wx[j], wjy = wy[j];
+
+                                c[py][px] += wjx * wjy * aij;
+
+                                if(jx & 1) {
+                                    c[py][px + 1] += (1.f - wjx) * wjy * aij;
+                                }
+
+                                if(jy & 1) {
+                                    c[py + 1][px] += wjx * (1.f - wjy) * aij;
+
+                                    if(jx & 1) {
+                                        c[py + 1][px + 1] += (1.f - wjx) * (1.f - wjy) * aij;
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+
+                //Store the lower triangle.
+                const int I = Y * wc + X;
+                ac[0][I] = c[1][1];
+
+                if(X > 0) {
+                    ac[1][I - 1] = c[1][0];
+                }
+
+                if(Y > 0) {
+                    ac[3][I - wc] = c[0][1];
+
+                    if(X > 0) {
+                        ac[4][I - wc - 1] = c[0][0];
+                    }
+
+                    if(X < wc - 1) {
+                        ac[2][I - wc + 1] = c[0][2];
+                    }
+                }
+            }
+        }
+    }
+
+    //Coarsest level is solved by incomplete Cholesky. Fill-in of 1, just like the single level solver had.
+    MultiDiagonalSymmetricMatrix *coarsest = levels.back().A;
+
+    if(coarsest->IncompleteCholeskyFactorization != nullptr) {
+        coarsest->KillIncompleteCholeskyFactorization();
+        coarsest->IncompleteCholeskyFactorization = nullptr;
+    }
+
+    return coarsest->CreateIncompleteCholeskyFactorization(1);
+}
+
+void MultigridPreconditioner::VectorProduct(float *Product, float *x)
+{
+    StencilApply<false>(levels[0].A->Diagonals, levels[0].w, levels[0].h, Product, nullptr, x);
+}
+
+void MultigridPreconditioner::VCycle(float *x, float *b)
+{
+    CycleLevel(0, x, b);
+}
+
+void MultigridPreconditioner::Smooth(Level &level, float *x, const float *b)
+{
+    const int n = level.w * level.h;
+    const float * RESTRICT a0 = level.A->Diagonals[0];
+    float * RESTRICT r = level.r.data();
+
+    StencilApply<true>(level.A->Diagonals, level.w, level.h, r, b, x);
+#ifdef _OPENMP
+    #pragma omp parallel for if(n > 16384)
+#endif
+
+    for(int i = 0; i < n; i++) {
+        x[i] += MG_OMEGA * r[i] / a0[i];
+    }
+}
+
+void MultigridPreconditioner::CycleLevel(size_t l, float *x, float *b)
+{
+    Level &level = levels[l];
+
+    if(l == levels.size() - 1) {
+        level.A->CholeskyBackSolve(x, b);
+        return;
+    }
+
+    Level &coarse = levels[l + 1];
+    const int w = level.w, h = level.h;
+    const int wc = coarse.w, hc = coarse.h;
+    const float * RESTRICT a0 = level.A->Diagonals[0];
+    const float * RESTRICT wx = level.wx.data();
+    const float * RESTRICT wy = level.wy.data();
+
+    //Pre-smoothing, the first sweep starts from x = 0. Same number of sweeps after the correction keeps the cycle symmetric, as CG requires.
+#ifdef _OPENMP
+    #pragma omp parallel for if(w * h > 16384)
+#endif
+
+    for(int i = 0; i < w * h; i++) {
+        x[i] = MG_OMEGA * b[i] / a0[i];
+    }
+
+    for(int s = 1; s < MG_SWEEPS; s++) {
+        Smooth(level, x, b);
+    }
+
+    //Restrict the residual with the transpose of the interpolation.
+    float * RESTRICT r = level.r.data();
+    StencilApply<true>(level.A->Diagonals, w, h, r, b, x);
+    float * RESTRICT bc = coarse.b.data();
+
+#ifdef _OPENMP
+    #pragma omp parallel for if(wc * hc > 4096)
+#endif
+
+    for(int Y = 0; Y < hc; Y++) {
+        for(int X = 0; X < wc; X++) {
+            float sum = 0.f;
+
+            for(int fy = std::max(2 * Y - 1, 0); fy <= std::min(2 * Y + 1, h - 1); fy++) {
+                for(int fx = std::max(2 * X - 1, 0); fx <= std::min(2 * X + 1, w - 1); fx++) {
+                    const int i = fy * w + fx;
+                    sum += (fx < 2 * X ? 1.f - wx[i] : wx[i]) * (fy < 2 * Y ? 1.f - wy[i] : wy[i]) * r[i];
+                }
+            }
+
+            bc[Y * wc + X] = sum;
+        }
+    }
+
+    CycleLevel(l + 1, coarse.x.data(), bc);
+
+    //Interpolate and add the correction.
+    const float * RESTRICT xc = coarse.x.data();
+
+#ifdef _OPENMP
+    #pragma omp parallel for if(w * h > 16384)
+#endif
+
+    for(int y = 0; y < h; y++) {
+        const float *c0 = &xc[(y / 2) * wc];
+        const float *c1 = (y & 1) ? c0 + wc : c0;
+
+        for(int px = 0; px < w; px++) {
+            const int i = y * w + px;
+            const int X0 = px / 2;
+            const int X1 = (px & 1) ? X0 + 1 : X0;
+            x[i] += wy[i] * (wx[i] * c0[X0] + (1.f - wx[i]) * c0[X1]) + (1.f - wy[i]) * (wx[i] * c1[X0] + (1.f - wx[i]) * c1[X1]);
+        }
+    }
+
+    for(int s = 0; s < MG_SWEEPS; s++) {
+        Smooth(level, x, b);
+    }
+}
+
+EdgePreservingDecomposition::EdgePreservingDecomposition(int width, int height, bool legacySolver) : MG(nullptr), legacySolver(legacySolver), a0(nullptr) , a_1(nullptr), a_w(nullptr), a_w_1(nullptr), a_w1(nullptr)
 {
     w = width;
     h = height;
@@ -641,11 +1023,16 @@ EdgePreservingDecomposition::EdgePreservingDecomposition(int width, int height)
         a_w1  = A->Diagonals[2];
         a_w   = A->Diagonals[3];
         a_w_1 = A->Diagonals[4];
+
+        if(!legacySolver) {
+            MG = new MultigridPreconditioner(w, h);
+        }
     }
 }
 
 EdgePreservingDecomposition::~EdgePreservingDecomposition()
 {
+    delete MG;
     delete A;
 }
 
@@ -794,25 +1181,52 @@ float *EdgePreservingDecomposition::CreateBlur(float *Source, float Scale, float
         }
     }
 
-    if(UseBlurForEdgeStop) {
-        delete[] a;
+    if(legacySolver) {
+        if(UseBlurForEdgeStop) {
+            delete[] a;
+        }
+
+        //Solve & return.
+        bool success = A->CreateIncompleteCholeskyFactorization(1); //Fill-in of 1 seems to work really good. More doesn't really help and less hurts (slightly).
+
+        if(!success) {
+            fprintf(stderr, "Error: Tonemapping has failed.\n");
+            memset(Blur, 0, sizeof(float)*n);  // On failure, set the blur to zero.  This is subsequently exponentiated in CompressDynamicRange.
+            return Blur;
+        }
+
+        if(!UseBlurForEdgeStop) {
+            memcpy(Blur, Source, n * sizeof(float));
+        }
+
+        SparseConjugateGradient(A->PassThroughVectorProduct, Source, n, false, Blur, 0.0f, (void *)A, Iterates, A->PassThroughCholeskyBackSolve);
+        A->KillIncompleteCholeskyFactorization();
+        return Blur;
     }
 
     //Solve & return.
-    bool success = A->CreateIncompleteCholeskyFactorization(1); //Fill-in of 1 seems to work really good. More doesn't really help and less hurts (slightly).
+    bool success = MG->Setup(A);
 
     if(!success) {
         fprintf(stderr, "Error: Tonemapping has failed.\n");
         memset(Blur, 0, sizeof(float)*n);  // On failure, set the blur to zero.  This is subsequently exponentiated in CompressDynamicRange.
+
+        if(UseBlurForEdgeStop) {
+            delete[] a;
+        }
+
         return Blur;
     }
 
-    if(!UseBlurForEdgeStop) {
+    if(UseBlurForEdgeStop) {
+        delete[] a;
+    } else {
         memcpy(Blur, Source, n * sizeof(float));
     }
 
-    SparseConjugateGradient(A->PassThroughVectorProduct, Source, n, false, Blur, 0.0f, (void *)A, Iterates, A->PassThroughCholeskyBackSolve);
-    A->KillIncompleteCholeskyFactorization();
+    //Multigrid preconditioned CG converges in few iterates, independent of image size. Iterates is just the upper limit now,
+    //raised to EPD_MIN_ITERATES so that callers asking for few iterates (thumbnails) reach the same residual as the output.
+    SparseConjugateGradient(MG->PassThroughVectorProduct, Source, n, false, Blur, EPD_RMS_RESIDUAL, (void *)MG, std::max(Iterates, EPD_MIN_ITERATES), MG->PassThroughVCycle);
     return Blur;
 }
 
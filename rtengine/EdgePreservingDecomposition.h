@@ -67,6 +67,7 @@ ben_s or nonbasketless. Enjoy!
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 
 #include "opthelper.h"
 #include "noncopyable.h"
@@ -134,11 +135,58 @@ public:
 
 };
 
+/* Geometric multigrid for the width x height grid matrices of EdgePreservingDecomposition, those with diagonals
+starting at rows 0, 1, width - 1, width and width + 1 (a 3x3 stencil per pixel). One V-cycle is used as preconditioner
+for SparseConjugateGradient: damped Jacobi smoothing, matrix dependent interpolation between levels and Galerkin coarse
+matrices, which keep the 3x3 stencil. Everything but the coarsest level, which is solved by incomplete Cholesky, runs in parallel. */
+class MultigridPreconditioner :
+    public rtengine::NonCopyable
+{
+public:
+    MultigridPreconditioner(int width, int height);
+    ~MultigridPreconditioner();
+
+    //Builds the coarse levels from A, which is referenced, not copied. Call again whenever the entries of A change.
+    bool Setup(MultiDiagonalSymmetricMatrix *A);
+
+    //Approximates x = A^-1 b by one V-cycle.
+    void VCycle(float *x, float *b);
+
+    //Product = A x, faster than A->VectorProduct.
+    void VectorProduct(float *Product, float *x);
+
+    //For SparseConjugateGradient, with this class as pass through variable.
+    static void PassThroughVectorProduct(float *Product, float *x, void *Pass)
+    {
+        (static_cast<MultigridPreconditioner *>(Pass))->VectorProduct(Product, x);
+    };
+
+    static void PassThroughVCycle(float *Product, float *x, void *Pass)
+    {
+        (static_cast<MultigridPreconditioner *>(Pass))->VCycle(Product, x);
+    };
+
+private:
+    struct Level {
+        int w, h;
+        MultiDiagonalSymmetricMatrix *A;    //Owned, except on the finest level.
+        std::vector<float> x, b, r;         //x and b are unused on the finest level, the arguments of VCycle are used instead.
+        std::vector<float> wx, wy;          //Interpolation weights of the left and upper coarse neighbours, empty on the coarsest level.
+    };
+
+    std::vector<Level> levels;
+
+    void CycleLevel(size_t l, float *x, float *b);
+    void Smooth(Level &level, float *x, const float *b);
+};
+
 class EdgePreservingDecomposition :
     public rtengine::NonCopyable
 {
 public:
-    EdgePreservingDecomposition(int width, int height);
+    //With legacySolver, CreateBlur runs exactly Iterates conjugate gradient iterates preconditioned by incomplete Cholesky,
+    //as before the multigrid. Profiles older than that use it, so that they render as before.
+    EdgePreservingDecomposition(int width, int height, bool legacySolver = false);
     ~EdgePreservingDecomposition();
 
     //Create an edge preserving blur of Source. Will create and return, or fill into Blur if not NULL. In place not ok.
@@ -156,6 +204,8 @@ public:
 
 private:
     MultiDiagonalSymmetricMatrix *A;    //The equations are simple enough to not mandate a matrix class, but fast solution NEEDS a complicated preconditioner.
+    MultigridPreconditioner *MG;        //nullptr with legacySolver.
+    bool legacySolver;
     int w, h, n;
 
     //Convenient access to the data in A.
@@ -38,11 +38,13 @@
 #include "labimage.h"
 #include "LUT.h"
 #include "median.h"
+#include "medianfilter.h"
 #include "mytime.h"
 #include "opthelper.h"
 #include "procparams.h"
 #include "rt_math.h"
 #include "sleef.h"
+#include "utils.h"
 #include "../rtgui/threadutils.h"
 #include "../rtgui/options.h"
 
@@ -91,9 +93,15 @@ void do_median_denoise(float **src, float **dst, float upperBound, int width, in
     typedef ImProcFunctions::Median Median;
 
     int border = 1;
+    bool square = true; // square windows go to medianFilter()
 
     switch (medianType) {
-        case Median::TYPE_3X3_SOFT:
+        case Median::TYPE_3X3_SOFT: {
+            border = 1;
+            square = false;
+            break;
+        }
+
         case Median::TYPE_3X3_STRONG: {
             border = 1;
             break;
@@ -101,6 +109,7 @@ void do_median_denoise(float **src, float **dst, float upperBound, int width, in
 
         case Median::TYPE_5X5_SOFT: {
             border = 2;
+            square = false;
             break;
         }
 
@@ -148,6 +157,17 @@ void do_median_denoise(float **src, float **dst, float upperBound, int width, in
         medianIn = medBuffer[BufferIndex];
         medianOut = medBuffer[BufferIndex ^ 1];
 
+        if (square) {
+            if (useUpperBound) {
+                medianFilter(medianIn, medianOut, upperBound, width, height, border, numThreads);
+            } else {
+                medianFilter(medianIn, medianOut, width, height, border, numThreads);
+            }
+
+            BufferIndex ^= 1; // swap buffers
+            continue;
+        }
+
         if (iteration == 1) { // upper border
             for (int i = 0; i < border; ++i) {
                 for (int j = 0; j < width; ++j) {
@@ -167,220 +187,83 @@ void do_median_denoise(float **src, float **dst, float upperBound, int width, in
                 medianOut[i][j] = medianIn[i][j];
             }
 
-            switch (medianType) {
-                case Median::TYPE_3X3_SOFT: {
-                    for (; j < width - border; ++j) {
-                        if (!useUpperBound || medianIn[i][j] <= upperBound) {
-                            medianOut[i][j] = median(
-                                                  medianIn[i - 1][j],
-                                                  medianIn[i][j - 1],
-                                                  medianIn[i][j],
-                                                  medianIn[i][j + 1],
-                                                  medianIn[i + 1][j]
-                                              );
-                        } else {
-                            medianOut[i][j] = medianIn[i][j];
-                        }
-                    }
-
-                    break;
-                }
-
-                case Median::TYPE_3X3_STRONG: {
-                    for (; j < width - border; ++j) {
-                        if (!useUpperBound || medianIn[i][j] <= upperBound) {
-                            medianOut[i][j] = median(
-                                                  medianIn[i - 1][j - 1],
-                                                  medianIn[i - 1][j],
-                                                  medianIn[i - 1][j + 1],
-                                                  medianIn[i][j - 1],
-                                                  medianIn[i][j],
-                                                  medianIn[i][j + 1],
-                                                  medianIn[i + 1][j - 1],
-                                                  medianIn[i + 1][j],
-                                                  medianIn[i + 1][j + 1]
-                                              );
-                        } else {
-                            medianOut[i][j] = medianIn[i][j];
-                        }
-                    }
-
-                    break;
-                }
-
-                case Median::TYPE_5X5_SOFT: {
-                    for (; j < width - border; ++j) {
-                        if (!useUpperBound || medianIn[i][j] <= upperBound) {
-                            medianOut[i][j] = median(
-                                                  medianIn[i - 2][j],
-                                                  medianIn[i - 1][j - 1],
-                                                  medianIn[i - 1][j],
-                                                  medianIn[i - 1][j + 1],
-                                                  medianIn[i][j - 2],
-                                                  medianIn[i][j - 1],
-                                                  medianIn[i][j],
-                                                  medianIn[i][j + 1],
-                                                  medianIn[i][j + 2],
-                                                  medianIn[i + 1][j - 1],
-                                                  medianIn[i + 1][j],
-                                                  medianIn[i + 1][j + 1],
-                                                  medianIn[i + 2][j]
-                                              );
-                        } else {
-                            medianOut[i][j] = medianIn[i][j];
-                        }
-                    }
-
-                    break;
-                }
-
-                case Median::TYPE_5X5_STRONG: {
 #ifdef __SSE2__
-
-                    for (; !useUpperBound && j < width - border - 3; j += 4) {
-                        STVFU(
-                            medianOut[i][j],
-                            median(
-                                LVFU(medianIn[i - 2][j - 2]),
-                                LVFU(medianIn[i - 2][j - 1]),
-                                LVFU(medianIn[i - 2][j]),
-                                LVFU(medianIn[i - 2][j + 1]),
-                                LVFU(medianIn[i - 2][j + 2]),
-                                LVFU(medianIn[i - 1][j - 2]),
-                                LVFU(medianIn[i - 1][j - 1]),
-                                LVFU(medianIn[i - 1][j]),
-                                LVFU(medianIn[i - 1][j + 1]),
-                                LVFU(medianIn[i - 1][j + 2]),
-                                LVFU(medianIn[i][j - 2]),
-                                LVFU(medianIn[i][j - 1]),
-                                LVFU(medianIn[i][j]),
-                                LVFU(medianIn[i][j + 1]),
-                                LVFU(medianIn[i][j + 2]),
-                                LVFU(medianIn[i + 1][j - 2]),
-                                LVFU(medianIn[i + 1][j - 1]),
-                                LVFU(medianIn[i + 1][j]),
-                                LVFU(medianIn[i + 1][j + 1]),
-                                LVFU(medianIn[i + 1][j + 2]),
-                                LVFU(medianIn[i + 2][j - 2]),
-                                LVFU(medianIn[i + 2][j - 1]),
-                                LVFU(medianIn[i + 2][j]),
-                                LVFU(medianIn[i + 2][j + 1]),
-                                LVFU(medianIn[i + 2][j + 2])
-                            )
-                        );
-                    }
-
+            const vfloat upperBoundv = F2V(upperBound);
 #endif
 
-                    for (; j < width - border; ++j) {
-                        if (!useUpperBound || medianIn[i][j] <= upperBound) {
-                            medianOut[i][j] = median(
-                                                  medianIn[i - 2][j - 2],
-                                                  medianIn[i - 2][j - 1],
-                                                  medianIn[i - 2][j],
-                                                  medianIn[i - 2][j + 1],
-                                                  medianIn[i - 2][j + 2],
-                                                  medianIn[i - 1][j - 2],
-                                                  medianIn[i - 1][j - 1],
-                                                  medianIn[i - 1][j],
-                                                  medianIn[i - 1][j + 1],
-                                                  medianIn[i - 1][j + 2],
-                                                  medianIn[i][j - 2],
-                                                  medianIn[i][j - 1],
-                                                  medianIn[i][j],
-                                                  medianIn[i][j + 1],
-                                                  medianIn[i][j + 2],
-                                                  medianIn[i + 1][j - 2],
-                                                  medianIn[i + 1][j - 1],
-                                                  medianIn[i + 1][j],
-                                                  medianIn[i + 1][j + 1],
-                                                  medianIn[i + 1][j + 2],
-                                                  medianIn[i + 2][j - 2],
-                                                  medianIn[i + 2][j - 1],
-                                                  medianIn[i + 2][j],
-                                                  medianIn[i + 2][j + 1],
-                                                  medianIn[i + 2][j + 2]
-                                              );
-                        } else {
-                            medianOut[i][j] = medianIn[i][j];
-                        }
-                    }
-
-                    break;
-                }
-
-                case Median::TYPE_7X7: {
+            if (medianType == Median::TYPE_3X3_SOFT) {
 #ifdef __SSE2__
-                    std::array<vfloat, 49> vpp ALIGNED16;
 
-                    for (; !useUpperBound && j < width - border - 3; j += 4) {
-                        for (int kk = 0, ii = -border; ii <= border; ++ii) {
-                            for (int jj = -border; jj <= border; ++jj, ++kk) {
-                                vpp[kk] = LVFU(medianIn[i + ii][j + jj]);
-                            }
-                        }
-
-                        STVFU(medianOut[i][j], median(vpp));
-                    }
+                for (; j < width - border - 3; j += 4) {
+                    const vfloat medv = median(
+                                            LVFU(medianIn[i - 1][j]),
+                                            LVFU(medianIn[i][j - 1]),
+                                            LVFU(medianIn[i][j]),
+                                            LVFU(medianIn[i][j + 1]),
+                                            LVFU(medianIn[i + 1][j])
+                                        );
+                    STVFU(medianOut[i][j], useUpperBound ? vself(vmaskf_le(LVFU(medianIn[i][j]), upperBoundv), medv, LVFU(medianIn[i][j])) : medv);
+                }
 
 #endif
 
-                    std::array<float, 49> pp;
-
-                    for (; j < width - border; ++j) {
-                        if (!useUpperBound || medianIn[i][j] <= upperBound) {
-                            for (int kk = 0, ii = -border; ii <= border; ++ii) {
-                                for (int jj = -border; jj <= border; ++jj, ++kk) {
-                                    pp[kk] = medianIn[i + ii][j + jj];
-                                }
-                            }
-
-                            medianOut[i][j] = median(pp);
-                        } else {
-                            medianOut[i][j] = medianIn[i][j];
-                        }
+                for (; j < width - border; ++j) {
+                    if (!useUpperBound || medianIn[i][j] <= upperBound) {
+                        medianOut[i][j] = median(
+                                              medianIn[i - 1][j],
+                                              medianIn[i][j - 1],
+                                              medianIn[i][j],
+                                              medianIn[i][j + 1],
+                                              medianIn[i + 1][j]
+                                          );
+                    } else {
+                        medianOut[i][j] = medianIn[i][j];
                     }
-
-                    break;
                 }
-
-                case Median::TYPE_9X9: {
+            } else { // TYPE_5X5_SOFT
 #ifdef __SSE2__
-                    std::array<vfloat, 81> vpp ALIGNED16;
-
-                    for (; !useUpperBound && j < width - border - 3; j += 4) {
-                        for (int kk = 0, ii = -border; ii <= border; ++ii) {
-                            for (int jj = -border; jj <= border; ++jj, ++kk) {
-                                vpp[kk] = LVFU(medianIn[i + ii][j + jj]);
-                            }
-                        }
 
-                        STVFU(medianOut[i][j], median(vpp));
-                    }
+                for (; j < width - border - 3; j += 4) {
+                    const vfloat medv = median(
+                                            LVFU(medianIn[i - 2][j]),
+                                            LVFU(medianIn[i - 1][j - 1]),
+                                            LVFU(medianIn[i - 1][j]),
+                                            LVFU(medianIn[i - 1][j + 1]),
+                                            LVFU(medianIn[i][j - 2]),
+                                            LVFU(medianIn[i][j - 1]),
+                                            LVFU(medianIn[i][j]),
+                                            LVFU(medianIn[i][j + 1]),
+                                            LVFU(medianIn[i][j + 2]),
+                                            LVFU(medianIn[i + 1][j - 1]),
+                                            LVFU(medianIn[i + 1][j]),
+                                            LVFU(medianIn[i + 1][j + 1]),
+                                            LVFU(medianIn[i + 2][j])
+                                        );
+                    STVFU(medianOut[i][j], useUpperBound ? vself(vmaskf_le(LVFU(medianIn[i][j]), upperBoundv), medv, LVFU(medianIn[i][j])) : medv);
+                }
 
 #endif
 
-                    std::array<float, 81> pp;
-
-                    for (; j < width - border; ++j) {
-                        if (!useUpperBound || medianIn[i][j] <= upperBound) {
-                            for (int kk = 0, ii = -border; ii <= border; ++ii) {
-                                for (int jj = -border; jj <= border; ++jj, ++kk) {
-                                    pp[kk] = medianIn[i + ii][j + jj];
-                                }
-                            }
-
-                            medianOut[i][j] = median(pp);
-                        } else {
-                            medianOut[i][j] = medianIn[i][j];
-                        }
-                    }
-
-                    for (; j < width; ++j) {
+                for (; j < width - border; ++j) {
+                    if (!useUpperBound || medianIn[i][j] <= upperBound) {
+                        medianOut[i][j] = median(
+                                              medianIn[i - 2][j],
+                                              medianIn[i - 1][j - 1],
+                                              medianIn[i - 1][j],
+                                              medianIn[i - 1][j + 1],
+                                              medianIn[i][j - 2],
+                                              medianIn[i][j - 1],
+                                              medianIn[i][j],
+                                              medianIn[i][j + 1],
+                                              medianIn[i][j + 2],
+                                              medianIn[i + 1][j - 1],
+                                              medianIn[i + 1][j],
+                                              medianIn[i + 1][j + 1],
+                                              medianIn[i + 2][j]
+                                          );
+                    } else {
                         medianOut[i][j] = medianIn[i][j];
                     }
-
-                    break;
                 }
             }
 
@@ -421,6 +304,19 @@ void do_median_denoise(float **src, float **dst, float upperBound, int width, in
     }
 }
 
+// Estimated peak memory in bytes needed to denoise one tile of width x height with numThreads nested threads.
+// Per pixel: the Lab copy (3 planes), the noise variance planes (2 quarter planes), the luminance copy for the DCT (1 plane),
+// the wavelet decompositions of L and one chroma channel (4 quarter planes per level, up to 8 levels each)
+// and the temporary buffers of the wavelet shrinkage (about 4 planes).
+// Per thread: the two DCT block buffers of one row of blocks.
+std::size_t denoiseTileMemory(int width, int height, int numThreads)
+{
+    constexpr double floatsPerPixel = 3.0 + 0.5 + 1.0 + 2.0 * 8.0 + 4.0;
+    const std::size_t numblox_W = std::ceil(static_cast<float>(width) / offset) + 2 * blkrad;
+
+    return floatsPerPixel * sizeof(float) * width * height + static_cast<std::size_t>(numThreads) * 2 * numblox_W * TS * TS * sizeof(float);
+}
+
 } // namespace
 
 
@@ -708,6 +604,64 @@ BENCHFUN
             printf("Tiled denoise processing caused by Automatic Multizone mode\n");
         }
 
+#ifdef _OPENMP
+        const int maxThreads = omp_get_max_threads();
+#else
+        const int maxThreads = 1;
+#endif
+        // Choose between whole image and tiles and the tile size from the estimated memory use, instead of running out of memory
+        // in the middle of a whole image pass and retrying with tiles. The retry is kept in case the estimation was too optimistic.
+        // As the choice changes the result, it only depends on the configured budget, never on the memory free at the moment,
+        // and it counts the buffers of a single thread, so that it doesn't depend on the number of cores either.
+        const std::size_t memoryBudget = static_cast<std::size_t>(settings->denoiseMemoryBudget) << 20;
+        int firstKall = (options.rgbDenoiseThreadLimit == 0 && !ponder) ? 0 : 2;
+        // output buffer of the tiled pass
+        const std::size_t tiledOutputMemory = 3 * sizeof(float) * static_cast<std::size_t>(imwidth) * imheight;
+
+        if (memoryBudget > 0) {
+            if (firstKall == 0 && denoiseTileMemory(imwidth, imheight, 1) > memoryBudget) {
+                firstKall = 2;
+            }
+
+            if (firstKall == 2) {
+                while (true) {
+                    int numtiles_W, numtiles_H, tilewidth, tileheight, tileWskip, tileHskip;
+                    Tile_calc(tilesize, overlap, 2, imwidth, imheight, numtiles_W, numtiles_H, tilewidth, tileheight, tileWskip, tileHskip);
+                    const std::size_t available = memoryBudget > tiledOutputMemory ? memoryBudget - tiledOutputMemory : 0;
+
+                    // the tiles of Automatic Multizone mode have to match the tiles of the chroma estimation
+                    if (available >= denoiseTileMemory(tilewidth, tileheight, 1) || tilesize <= 4 * overlap || ponder) {
+                        break;
+                    }
+
+                    // not even one tile fits, use smaller tiles
+                    tilesize = std::max(4 * overlap, tilesize * 3 / 4);
+                }
+            }
+        }
+
+        // The number of tiles processed at once doesn't change the result, it is also limited by the memory available now.
+        int maxConcurrentTiles = maxThreads;
+
+        if (firstKall == 2) {
+            std::size_t availableMemory = getAvailableMemory();
+
+            if (memoryBudget > 0 && (availableMemory == 0 || availableMemory > memoryBudget)) {
+                availableMemory = memoryBudget;
+            }
+
+            if (availableMemory > 0) {
+                int numtiles_W, numtiles_H, tilewidth, tileheight, tileWskip, tileHskip;
+                Tile_calc(tilesize, overlap, 2, imwidth, imheight, numtiles_W, numtiles_H, tilewidth, tileheight, tileWskip, tileHskip);
+                const std::size_t available = availableMemory > tiledOutputMemory ? availableMemory - tiledOutputMemory : 0;
+                maxConcurrentTiles = LIM<std::size_t>(available / denoiseTileMemory(tilewidth, tileheight, 1), 1, maxThreads);
+            }
+        }
+
+        if (settings->verbose) {
+            printf("RGB_denoise memory budget %zu MiB: %s, tile size %d, up to %d tile(s) at once\n", memoryBudget >> 20, firstKall == 0 ? "whole image" : "tiled", tilesize, maxConcurrentTiles);
+        }
+
         bool memoryAllocationFailed = false;
 
         do {
@@ -719,7 +673,7 @@ BENCHFUN
 
             int numtiles_W, numtiles_H, tilewidth, tileheight, tileWskip, tileHskip;
 
-            Tile_calc(tilesize, overlap, (options.rgbDenoiseThreadLimit == 0 && !ponder) ? (numTries == 1 ? 0 : 2) : 2, imwidth, imheight, numtiles_W, numtiles_H, tilewidth, tileheight, tileWskip, tileHskip);
+            Tile_calc(tilesize, overlap, numTries == 1 ? firstKall : 2, imwidth, imheight, numtiles_W, numtiles_H, tilewidth, tileheight, tileWskip, tileHskip);
             memoryAllocationFailed = false;
             const int numtiles = numtiles_W * numtiles_H;
 
@@ -783,6 +737,10 @@ BENCHFUN
             // Calculate number of tiles. If less than omp_get_max_threads(), then limit num_threads to number of tiles
             int numthreads = MIN(numtiles, omp_get_max_threads());
 
+            if (numTries == 1) {
+                numthreads = MIN(numthreads, maxConcurrentTiles);
+            }
+
             if (options.rgbDenoiseThreadLimit > 0) {
                 numthreads = MIN(numthreads, options.rgbDenoiseThreadLimit);
             }
@@ -871,6 +829,10 @@ BENCHFUN
 
                 for (int tiletop = 0; tiletop < imheight; tiletop += tileHskip) {
                     for (int tileleft = 0; tileleft < imwidth ; tileleft += tileWskip) {
+                        if (isCancelled()) {
+                            continue;
+                        }
+
                         //printf("titop=%d tileft=%d\n",tiletop/tileHskip, tileleft/tileWskip);
                         pos = (tiletop / tileHskip) * numtiles_W + tileleft / tileWskip ;
                         int tileright = MIN(imwidth, tileleft + tilewidth);
@@ -1347,6 +1309,9 @@ BENCHFUN
 #endif
 
                                     for (int vblk = 0; vblk < numblox_H; ++vblk) {
+                                        if (isCancelled()) {
+                                            continue;
+                                        }
 
                                         int top = (vblk - blkrad) * offset;
                                         float * datarow = pBuf + blkrad * offset;
@@ -1761,7 +1726,7 @@ BENCHFUN
                 fftwf_destroy_plan(plan_forward_blox[1]);
                 fftwf_destroy_plan(plan_backward_blox[1]);
             }
-        } while (memoryAllocationFailed && numTries < 2 && (options.rgbDenoiseThreadLimit == 0) && !ponder);
+        } while (memoryAllocationFailed && numTries < 2 && firstKall == 0);
 
         if (memoryAllocationFailed) {
             printf("tiled denoise failed due to isufficient memory. Output is not denoised!\n");
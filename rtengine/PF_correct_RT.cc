@@ -662,7 +662,24 @@ void ImProcFunctions::Badpixelscam(CieImage * ncie, double radius, int thresh, i
                     const int ip = i < 2 ? i + 2 : i - 2;
                     const int in = i > height - 3 ? i - 2 : i + 2;
 
-                    for (int j = 0; j < width; j++) {
+                    int j = 0;
+
+                    for (; j < std::min(2, width); j++) {
+                        const int jp = j < 2 ? j + 2 : j -2;
+                        const int jn = j > width - 3 ? j - 2 : j + 2;
+
+                        tmaa[i][j] = median(sraa[ip][jp], sraa[ip][j], sraa[ip][jn], sraa[i][jp], sraa[i][j], sraa[i][jn], sraa[in][jp], sraa[in][j], sraa[in][jn]);
+                    }
+
+#ifdef __SSE2__
+
+                    for (; j < width - 5; j += 4) {
+                        STVFU(tmaa[i][j], median(LVFU(sraa[ip][j - 2]), LVFU(sraa[ip][j]), LVFU(sraa[ip][j + 2]), LVFU(sraa[i][j - 2]), LVFU(sraa[i][j]), LVFU(sraa[i][j + 2]), LVFU(sraa[in][j - 2]), LVFU(sraa[in][j]), LVFU(sraa[in][j + 2])));
+                    }
+
+#endif
+
+                    for (; j < width; j++) {
                         const int jp = j < 2 ? j + 2 : j -2;
                         const int jn = j > width - 3 ? j - 2 : j + 2;
 
@@ -677,7 +694,24 @@ void ImProcFunctions::Badpixelscam(CieImage * ncie, double radius, int thresh, i
                     const int ip = i < 2 ? i + 2 : i - 2;
                     const int in = i > height - 3 ? i - 2 : i + 2;
 
-                    for (int j = 0; j < width; j++) {
+                    int j = 0;
+
+                    for (; j < std::min(2, width); j++) {
+                        const int jp = j < 2 ? j + 2 : j -2;
+                        const int jn = j > width - 3 ? j - 2 : j + 2;
+
+                        tmbb[i][j] = median(srbb[ip][jp], srbb[ip][j], srbb[ip][jn], srbb[i][jp], srbb[i][j], srbb[i][jn], srbb[in][jp], srbb[in][j], srbb[in][jn]);
+                    }
+
+#ifdef __SSE2__
+
+                    for (; j < width - 5; j += 4) {
+                        STVFU(tmbb[i][j], median(LVFU(srbb[ip][j - 2]), LVFU(srbb[ip][j]), LVFU(srbb[ip][j + 2]), LVFU(srbb[i][j - 2]), LVFU(srbb[i][j]), LVFU(srbb[i][j + 2]), LVFU(srbb[in][j - 2]), LVFU(srbb[in][j]), LVFU(srbb[in][j + 2])));
+                    }
+
+#endif
+
+                    for (; j < width; j++) {
                         const int jp = j < 2 ? j + 2 : j -2;
                         const int jn = j > width - 3 ? j - 2 : j + 2;
 
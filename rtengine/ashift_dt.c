@@ -1404,10 +1404,21 @@ static int line_detect(float *in, const int width, const int height, const int x
   // call the line segment detector LSD;
   // LSD stores the number of found lines in lines_count.
   // it returns structural details as vector 'double lines[7 * lines_count]'
-  lsd_lines = LineSegmentDetection(&lines_count, greyscale, width, height,
-                                   LSD_SCALE, LSD_SIGMA_SCALE, LSD_QUANT,
-                                   LSD_ANG_TH, LSD_LOG_EPS, LSD_DENSITY_TH,
-                                   LSD_N_BINS, NULL, NULL, NULL);
+  // RT: by default on a reduced image with refinement on the full one, which is several times faster
+  if(settings->perspectivePyramid)
+  {
+    lsd_lines = LineSegmentDetectionPyramid(&lines_count, greyscale, width, height,
+                                            LSD_SCALE, LSD_SIGMA_SCALE, LSD_QUANT,
+                                            LSD_ANG_TH, LSD_LOG_EPS, LSD_DENSITY_TH,
+                                            LSD_N_BINS);
+  }
+  else
+  {
+    lsd_lines = LineSegmentDetection(&lines_count, greyscale, width, height,
+                                     LSD_SCALE, LSD_SIGMA_SCALE, LSD_QUANT,
+                                     LSD_ANG_TH, LSD_LOG_EPS, LSD_DENSITY_TH,
+                                     LSD_N_BINS, NULL, NULL, NULL);
+  }
 
   if(lines_count > 0)
   {
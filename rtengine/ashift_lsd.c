@@ -696,6 +696,12 @@ static image_double gaussian_sampler( image_double in, double scale,
   double_x_size = (int) (2 * in->xsize);
   double_y_size = (int) (2 * in->ysize);
 
+  /* RT: the kernels of all positions are computed first, then the rows are
+     filtered in parallel. The result is the same as with computing the kernel
+     for each position while filtering. */
+  double * kernels = (double *) malloc( (size_t) (N > M ? N : M) * n * sizeof(double) );
+  if( kernels == NULL ) error("not enough memory.");
+
   /* First subsampling: x axis */
   for(x=0;x<aux->xsize;x++)
     {
@@ -711,24 +717,30 @@ static image_double gaussian_sampler( image_double in, double scale,
       gaussian_kernel( kernel, sigma, (double) h + xx - (double) xc );
       /* the kernel must be computed for each x because the fine
          offset xx-xc is different in each case */
+      for(i=0;i<n;i++) kernels[x*n+i] = kernel->values[i];
+    }
 
-      for(y=0;y<aux->ysize;y++)
-        {
-          sum = 0.0;
-          for(i=0;i<kernel->dim;i++)
-            {
-              j = xc - h + i;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) private(x,xc,i,j,sum)
+#endif
+  for(y=0;y<aux->ysize;y++)
+    for(x=0;x<aux->xsize;x++)
+      {
+        xc = (int) floor( (double) x / scale + 0.5 );
+        sum = 0.0;
+        for(i=0;i<n;i++)
+          {
+            j = xc - h + i;
 
-              /* symmetry boundary condition */
-              while( j < 0 ) j += double_x_size;
-              while( j >= double_x_size ) j -= double_x_size;
-              if( j >= (int) in->xsize ) j = double_x_size-1-j;
+            /* symmetry boundary condition */
+            while( j < 0 ) j += double_x_size;
+            while( j >= double_x_size ) j -= double_x_size;
+            if( j >= (int) in->xsize ) j = double_x_size-1-j;
 
-              sum += in->data[ j + y * in->xsize ] * kernel->values[i];
-            }
-          aux->data[ x + y * aux->xsize ] = sum;
-        }
-    }
+            sum += in->data[ j + y * in->xsize ] * kernels[x*n+i];
+          }
+        aux->data[ x + y * aux->xsize ] = sum;
+      }
 
   /* Second subsampling: y axis */
   for(y=0;y<out->ysize;y++)
@@ -745,11 +757,19 @@ static image_double gaussian_sampler( image_double in, double scale,
       gaussian_kernel( kernel, sigma, (double) h + yy - (double) yc );
       /* the kernel must be computed for each y because the fine
          offset yy-yc is different in each case */
+      for(i=0;i<n;i++) kernels[y*n+i] = kernel->values[i];
+    }
 
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) private(x,yc,i,j,sum)
+#endif
+  for(y=0;y<out->ysize;y++)
+    {
+      yc = (int) floor( (double) y / scale + 0.5 );
       for(x=0;x<out->xsize;x++)
         {
           sum = 0.0;
-          for(i=0;i<kernel->dim;i++)
+          for(i=0;i<n;i++)
             {
               j = yc - h + i;
 
@@ -758,12 +778,14 @@ static image_double gaussian_sampler( image_double in, double scale,
               while( j >= double_y_size ) j -= double_y_size;
               if( j >= (int) in->ysize ) j = double_y_size-1-j;
 
-              sum += aux->data[ x + j * aux->xsize ] * kernel->values[i];
+              sum += aux->data[ x + j * aux->xsize ] * kernels[y*n+i];
             }
           out->data[ x + y * out->xsize ] = sum;
         }
     }
 
+  free( (void *) kernels );
+
   /* free memory */
   free_ntuple_list(kernel);
   free_image_double(aux);
@@ -845,8 +867,12 @@ static image_double ll_angle( image_double in, double threshold,
   for(y=0;y<n;y++) g->data[p*y+p-1]   = NOTDEF;
 
   /* compute gradient on the remaining pixels */
-  for(x=0;x<p-1;x++)
-    for(y=0;y<n-1;y++)
+  /* RT: in parallel, row by row */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) private(x,adr,com1,com2,gx,gy,norm2,norm) reduction(max:max_grad)
+#endif
+  for(y=0;y<n-1;y++)
+    for(x=0;x<p-1;x++)
       {
         adr = y*p+x;
 
@@ -1081,6 +1107,9 @@ __attribute__((constructor)) static void invConstructor()
 {
   if(inv) return;
   inv = (double *)malloc(sizeof(double) * TABSIZE);
+  // RT: fill the table at once, nfa() is called from several threads by LineSegmentDetectionPyramid()
+  inv[0] = 0.0;
+  for(int i = 1; i < TABSIZE; i++) inv[i] = 1.0 / (double) i;
 }
 
 __attribute__((destructor)) static void invDestructor()
@@ -1189,9 +1218,7 @@ static double nfa(int n, int k, double p, double logNT)
          because divisions are expensive.
          p/(1-p) is computed only once and stored in 'p_term'.
        */
-      bin_term = (double) (n-i+1) * ( i<TABSIZE ?
-                   ( inv[i]!=0.0 ? inv[i] : ( inv[i] = 1.0 / (double) i ) ) :
-                   1.0 / (double) i );
+      bin_term = (double) (n-i+1) * ( i<TABSIZE ? inv[i] : 1.0 / (double) i );
 
       mult_term = bin_term * p_term;
       term *= mult_term;
@@ -2085,15 +2112,19 @@ static int refine( struct point * reg, int * reg_size, image_double modgrad,
 /*----------------------------------------------------------------------------*/
 
 /*----------------------------------------------------------------------------*/
-/** LSD full interface.
+/** RT: LSD full interface, with the number of tests of a larger image.
+
+    The number of tests is the one of an NT_X x NT_Y image, which is
+    larger than X x Y when img is a part of a larger image. This way the
+    detection threshold of the part is the one of the whole image.
  */
 static
-double * LineSegmentDetection( int * n_out,
-                               double * img, int X, int Y,
-                               double scale, double sigma_scale, double quant,
-                               double ang_th, double log_eps, double density_th,
-                               int n_bins,
-                               int ** reg_img, int * reg_x, int * reg_y )
+double * LineSegmentDetectionNT( int * n_out,
+                                 double * img, int X, int Y, int NT_X, int NT_Y,
+                                 double scale, double sigma_scale, double quant,
+                                 double ang_th, double log_eps, double density_th,
+                                 int n_bins,
+                                 int ** reg_img, int * reg_x, int * reg_y )
 {
   image_double image;
   ntuple_list out = new_ntuple_list(7);
@@ -2106,13 +2137,14 @@ double * LineSegmentDetection( int * n_out,
   struct rect rec;
   struct point * reg;
   int reg_size,min_reg_size,i;
-  unsigned int xsize,ysize;
+  unsigned int xsize,ysize,nt_xsize,nt_ysize;
   double rho,reg_angle,prec,p,log_nfa,logNT;
   int ls_count = 0;                   /* line segments are numbered 1,2,3,... */
 
 
   /* check parameters */
   if( img == NULL || X <= 0 || Y <= 0 ) error("invalid image input.");
+  if( NT_X < X || NT_Y < Y ) error("invalid size for the number of tests.");
   if( scale <= 0.0 ) error("'scale' value must be positive.");
   if( sigma_scale <= 0.0 ) error("'sigma_scale' value must be positive.");
   if( quant < 0.0 ) error("'quant' value must be positive.");
@@ -2157,7 +2189,9 @@ double * LineSegmentDetection( int * n_out,
      whose logarithm value is
        log10(11) + 5/2 * (log10(X) + log10(Y)).
   */
-  logNT = 5.0 * ( log10( (double) xsize ) + log10( (double) ysize ) ) / 2.0
+  nt_xsize = scale != 1.0 ? (unsigned int) ceil( NT_X * scale ) : (unsigned int) NT_X;
+  nt_ysize = scale != 1.0 ? (unsigned int) ceil( NT_Y * scale ) : (unsigned int) NT_Y;
+  logNT = 5.0 * ( log10( (double) nt_xsize ) + log10( (double) nt_ysize ) ) / 2.0
           + log10(11.0);
   min_reg_size = (int) (-logNT/log10(p)); /* minimal number of points in region
                                              that can give a meaningful event */
@@ -2271,6 +2305,255 @@ double * LineSegmentDetection( int * n_out,
 
   return return_value;
 }
+
+/*----------------------------------------------------------------------------*/
+/** LSD full interface.
+ */
+static
+double * LineSegmentDetection( int * n_out,
+                               double * img, int X, int Y,
+                               double scale, double sigma_scale, double quant,
+                               double ang_th, double log_eps, double density_th,
+                               int n_bins,
+                               int ** reg_img, int * reg_x, int * reg_y )
+{
+  return LineSegmentDetectionNT( n_out, img, X, Y, X, Y, scale, sigma_scale,
+                                 quant, ang_th, log_eps, density_th, n_bins,
+                                 reg_img, reg_x, reg_y );
+}
+
+/*----------------------------------------------------------------------------*/
+/** RT: Refine a segment detected on a reduced image on the full image 'img'.
+
+    The segment is moved onto the ridge of 'img' (the detection runs on edge
+    enhanced images) next to it: along the segment, the maximum of 'img' is
+    searched up to 'radius' pixels across it, and the line through these
+    points (weighted by their value) replaces the segment. The end points are
+    projected onto that line. The segment is kept as it is if there are not
+    enough points or the fit turns too far away from it.
+ */
+static void refine_segment( double * seg, const double * img, int X, int Y,
+                            int radius )
+{
+  const double x1 = seg[0], y1 = seg[1], x2 = seg[2], y2 = seg[3];
+  const double len = dist(x1,y1,x2,y2);
+  double dx,dy,sw,sx,sy,sxx,syy,sxy,mx,my,cxx,cyy,cxy,theta,ux,uy,t;
+  int steps,i,o,count;
+
+  if( len < 2.0 ) return;
+
+  /* unit vectors along and across the segment */
+  dx = (x2 - x1) / len;
+  dy = (y2 - y1) / len;
+
+  sw = sx = sy = sxx = syy = sxy = 0.0;
+  count = 0;
+  steps = (int) len;
+  for(i=0;i<=steps;i++)
+    {
+      const double px = x1 + dx * i;
+      const double py = y1 + dy * i;
+      double values[2 * radius + 1];
+      int best = -1;
+
+      for(o=-radius;o<=radius;o++)
+        {
+          const int qx = (int) floor( px - dy * o + 0.5 );
+          const int qy = (int) floor( py + dx * o + 0.5 );
+          values[o + radius] = ( qx >= 0 && qy >= 0 && qx < X && qy < Y ) ?
+                               img[ qx + qy * X ] : -1.0;
+          if( values[o + radius] > 0.0 &&
+              ( best < 0 || values[o + radius] > values[best] ) )
+            best = o + radius;
+        }
+
+      /* maxima at the border of the search range are not on the ridge */
+      if( best <= 0 || best >= 2 * radius ) continue;
+
+      {
+        /* sub-pixel position of the maximum */
+        const double vm = values[best - 1], v = values[best], vp = values[best + 1];
+        const double denom = vm - 2.0 * v + vp;
+        const double off = best - radius + ( denom < 0.0 ? 0.5 * (vm - vp) / denom : 0.0 );
+        const double qx = px - dy * off;
+        const double qy = py + dx * off;
+
+        sw += v;
+        sx += v * qx;
+        sy += v * qy;
+        sxx += v * qx * qx;
+        syy += v * qy * qy;
+        sxy += v * qx * qy;
+        ++count;
+      }
+    }
+
+  if( count < 3 || sw <= 0.0 ) return;
+
+  /* principal axis of the weighted points */
+  mx = sx / sw;
+  my = sy / sw;
+  cxx = sxx / sw - mx * mx;
+  cyy = syy / sw - my * my;
+  cxy = sxy / sw - mx * my;
+  theta = 0.5 * atan2( 2.0 * cxy, cxx - cyy );
+  ux = cos(theta);
+  uy = sin(theta);
+
+  /* the fit must stay within the search range along the whole segment */
+  if( fabs( ux * dy - uy * dx ) * len > 2.0 * radius ) return;
+
+  t = (x1 - mx) * ux + (y1 - my) * uy;
+  seg[0] = mx + t * ux;
+  seg[1] = my + t * uy;
+  t = (x2 - mx) * ux + (y2 - my) * uy;
+  seg[2] = mx + t * ux;
+  seg[3] = my + t * uy;
+}
+
+/*----------------------------------------------------------------------------*/
+/** RT: LSD on a two level pyramid.
+
+    The segments are detected on the image reduced by 2 (2x2 means), which
+    is split into horizontal bands processed in parallel. Then the segments
+    are refined on the full image, only in their vicinity. The parameters and
+    the result are the ones of LineSegmentDetection() without region output.
+ */
+#define PYRAMID_MIN_SIZE 128      /* smaller reduced images: plain LSD */
+#define PYRAMID_BAND_HEIGHT 128   /* rows of the reduced image per band */
+#define PYRAMID_BAND_OVERLAP 8    /* rows added at both sides of a band */
+#define PYRAMID_REFINE_RADIUS 3   /* full image pixels searched across segments */
+
+static
+double * LineSegmentDetectionPyramid( int * n_out,
+                                      double * img, int X, int Y,
+                                      double scale, double sigma_scale,
+                                      double quant, double ang_th,
+                                      double log_eps, double density_th,
+                                      int n_bins )
+{
+  const int X2 = X / 2;
+  const int Y2 = Y / 2;
+  double * reduced;
+  double ** band_lines;
+  int * band_count;
+  ntuple_list out;
+  double * return_value;
+  int bands,b,x,y,i;
+
+  if( X2 < PYRAMID_MIN_SIZE || Y2 < PYRAMID_MIN_SIZE )
+    return LineSegmentDetection( n_out, img, X, Y, scale, sigma_scale, quant,
+                                 ang_th, log_eps, density_th, n_bins,
+                                 NULL, NULL, NULL );
+
+  /* reduced image */
+  reduced = (double *) malloc( (size_t) X2 * Y2 * sizeof(double) );
+  if( reduced == NULL ) error("not enough memory.");
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) private(x)
+#endif
+  for(y=0;y<Y2;y++)
+    for(x=0;x<X2;x++)
+      {
+        const double * in = img + (size_t) 2 * y * X + 2 * x;
+        reduced[ x + y * X2 ] = 0.25 * ( in[0] + in[1] + in[X] + in[X+1] );
+      }
+
+  /* detection band by band. The segments are clipped to the rows of their
+     band without the overlap, so that segments crossing band borders are
+     neither lost nor counted twice. */
+  bands = (Y2 + PYRAMID_BAND_HEIGHT - 1) / PYRAMID_BAND_HEIGHT;
+  band_lines = (double **) calloc( (size_t) bands, sizeof(double *) );
+  band_count = (int *) calloc( (size_t) bands, sizeof(int) );
+  if( band_lines == NULL || band_count == NULL ) error("not enough memory.");
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) private(i)
+#endif
+  for(b=0;b<bands;b++)
+    {
+      const int c0 = b * PYRAMID_BAND_HEIGHT;
+      const int c1 = c0 + PYRAMID_BAND_HEIGHT < Y2 ? c0 + PYRAMID_BAND_HEIGHT : Y2;
+      const int y0 = c0 - PYRAMID_BAND_OVERLAP > 0 ? c0 - PYRAMID_BAND_OVERLAP : 0;
+      const int y1 = c1 + PYRAMID_BAND_OVERLAP < Y2 ? c1 + PYRAMID_BAND_OVERLAP : Y2;
+      double * lines;
+      int count,kept = 0;
+
+      /* the number of tests is the one of the whole reduced image, a band
+         must not detect segments which LSD on the reduced image rejects */
+      lines = LineSegmentDetectionNT( &count, reduced + (size_t) y0 * X2, X2, y1 - y0,
+                                      X2, Y2, scale, sigma_scale, quant, ang_th,
+                                      log_eps, density_th, n_bins, NULL, NULL, NULL );
+      for(i=0;i<count;i++)
+        {
+          double * l = lines + 7 * i;
+          const double ymin = (double) (c0 - y0);
+          const double ymax = (double) (c1 - y0);
+
+          if( fabs( l[3] - l[1] ) < 1e-6 )
+            {
+              if( l[1] < ymin || l[1] >= ymax ) continue;
+            }
+          else
+            {
+              /* clip the parameter range to ymin <= y <= ymax */
+              double ta = (ymin - l[1]) / (l[3] - l[1]);
+              double tb = (ymax - l[1]) / (l[3] - l[1]);
+              double t0 = ta < tb ? ta : tb;
+              double t1 = ta < tb ? tb : ta;
+              double cx1,cy1,cx2,cy2;
+              t0 = t0 > 0.0 ? t0 : 0.0;
+              t1 = t1 < 1.0 ? t1 : 1.0;
+              if( t1 <= t0 ) continue;
+              cx1 = l[0] + t0 * (l[2] - l[0]);
+              cy1 = l[1] + t0 * (l[3] - l[1]);
+              cx2 = l[0] + t1 * (l[2] - l[0]);
+              cy2 = l[1] + t1 * (l[3] - l[1]);
+              if( dist(cx1,cy1,cx2,cy2) < 1.0 ) continue;
+              l[0] = cx1; l[1] = cy1; l[2] = cx2; l[3] = cy2;
+            }
+
+          /* to full image coordinates */
+          l[0] = 2.0 * l[0] + 0.5;
+          l[1] = 2.0 * (l[1] + y0) + 0.5;
+          l[2] = 2.0 * l[2] + 0.5;
+          l[3] = 2.0 * (l[3] + y0) + 0.5;
+          l[4] *= 2.0;
+
+          refine_segment( l, img, X, Y, PYRAMID_REFINE_RADIUS );
+
+          if( kept != i )
+            for(x=0;x<7;x++) lines[7 * kept + x] = l[x];
+          ++kept;
+        }
+      band_lines[b] = lines;
+      band_count[b] = kept;
+    }
+  free( (void *) reduced );
+
+  /* collect the segments of all bands */
+  out = new_ntuple_list(7);
+  for(b=0;b<bands;b++)
+    {
+      for(i=0;i<band_count[b];i++)
+        {
+          const double * l = band_lines[b] + 7 * i;
+          add_7tuple( out, l[0], l[1], l[2], l[3], l[4], l[5], l[6] );
+        }
+      free( (void *) band_lines[b] );
+    }
+  free( (void *) band_lines );
+  free( (void *) band_count );
+
+  if( out->size > (unsigned int) INT_MAX )
+    error("too many detections to fit in an INT.");
+  *n_out = (int) (out->size);
+
+  return_value = out->values;
+  free( (void *) out );
+
+  return return_value;
+}
+
 #if 0
 /*----------------------------------------------------------------------------*/
 /** LSD Simple Interface with Scale and Region output.
@@ -2329,6 +2612,10 @@ double * lsd(int * n_out, double * img, int X, int Y)
 #undef USED
 #undef RELATIVE_ERROR_FACTOR
 #undef TABSIZE
+#undef PYRAMID_MIN_SIZE
+#undef PYRAMID_BAND_HEIGHT
+#undef PYRAMID_BAND_OVERLAP
+#undef PYRAMID_REFINE_RADIUS
 
 // modelines: These editor modelines have been set for all relevant files by tools/update_modelines.sh
 // vim: shiftwidth=2 expandtab tabstop=2 cindent
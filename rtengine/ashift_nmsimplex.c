@@ -103,6 +103,18 @@ static int simplex(double (*objfunc)(double[], void *params), double start[], in
 
   double fsum, favg, s, cent;
 
+  /* RT: with several threads, all points a step may need are evaluated at
+     once in parallel (speculatively). The sequence of steps and the result
+     are the same as with evaluating them one by one. objfunc has to be
+     thread safe. */
+#ifdef _OPENMP
+  const int speculative = omp_get_max_threads() > 1;
+#else
+  const int speculative = FALSE;
+#endif
+  double *vci;   /* inside contraction - coordinates */
+  double fspec[4]; /* speculative values at vr, ve, vc, vci */
+
   /* dynamically allocate arrays */
 
   /* allocate the rows of the arrays */
@@ -112,6 +124,7 @@ static int simplex(double (*objfunc)(double[], void *params), double start[], in
   ve = (double *)malloc(n * sizeof(double));
   vc = (double *)malloc(n * sizeof(double));
   vm = (double *)malloc(n * sizeof(double));
+  vci = (double *)malloc(n * sizeof(double));
 
   /* allocate the columns of the arrays */
   for(i = 0; i <= n; i++)
@@ -150,6 +163,9 @@ static int simplex(double (*objfunc)(double[], void *params), double start[], in
     constrain(v[j], n);
   }
   /* find the initial function values */
+#ifdef _OPENMP
+#pragma omp parallel for if(speculative)
+#endif
   for(j = 0; j <= n; j++)
   {
     f[j] = objfunc(v[j], params);
@@ -225,7 +241,33 @@ static int simplex(double (*objfunc)(double[], void *params), double start[], in
     {
       constrain(vr, n);
     }
-    fr = objfunc(vr, params);
+
+    if(speculative)
+    {
+      /* expansion, outside and inside contraction, see below */
+      for(j = 0; j <= n - 1; j++)
+      {
+        ve[j] = vm[j] + NMS_GAMMA * (vr[j] - vm[j]);
+        vc[j] = vm[j] + NMS_BETA * (vr[j] - vm[j]);
+        vci[j] = vm[j] - NMS_BETA * (vm[j] - v[vg][j]);
+      }
+      if(constrain != NULL)
+      {
+        constrain(ve, n);
+        constrain(vc, n);
+        constrain(vci, n);
+      }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+      for(m = 0; m < 4; m++)
+      {
+        double *const points[4] = { vr, ve, vc, vci };
+        fspec[m] = objfunc(points[m], params);
+      }
+    }
+
+    fr = speculative ? fspec[0] : objfunc(vr, params);
     k++;
 
     if(fr < f[vh] && fr >= f[vs])
@@ -249,7 +291,7 @@ static int simplex(double (*objfunc)(double[], void *params), double start[], in
       {
         constrain(ve, n);
       }
-      fe = objfunc(ve, params);
+      fe = speculative ? fspec[1] : objfunc(ve, params);
       k++;
 
       /* by making fe < fr as opposed to fe < f[vs],
@@ -289,7 +331,7 @@ static int simplex(double (*objfunc)(double[], void *params), double start[], in
         {
           constrain(vc, n);
         }
-        fc = objfunc(vc, params);
+        fc = speculative ? fspec[2] : objfunc(vc, params);
         k++;
       }
       else
@@ -304,7 +346,7 @@ static int simplex(double (*objfunc)(double[], void *params), double start[], in
         {
           constrain(vc, n);
         }
-        fc = objfunc(vc, params);
+        fc = speculative ? fspec[3] : objfunc(vc, params);
         k++;
       }
 
@@ -337,15 +379,17 @@ static int simplex(double (*objfunc)(double[], void *params), double start[], in
         if(constrain != NULL)
         {
           constrain(v[vg], n);
+          constrain(v[vh], n);
         }
-        f[vg] = objfunc(v[vg], params);
-        k++;
-        if(constrain != NULL)
+#ifdef _OPENMP
+#pragma omp parallel for if(speculative && vg != vh)
+#endif
+        for(m = 0; m < 2; m++)
         {
-          constrain(v[vh], n);
+          const int vertex = m == 0 ? vg : vh;
+          f[vertex] = objfunc(v[vertex], params);
         }
-        f[vh] = objfunc(v[vh], params);
-        k++;
+        k += 2;
       }
     }
 #if 0
@@ -408,6 +452,7 @@ static int simplex(double (*objfunc)(double[], void *params), double start[], in
   free(ve);
   free(vc);
   free(vm);
+  free(vci);
   for(i = 0; i <= n; i++)
   {
     free(v[i]);
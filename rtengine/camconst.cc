@@ -17,6 +17,7 @@
 
 #include "settings.h"
 #include "rt_math.h"
+#include "startuptimer.h"
 
 // cJSON is a very minimal JSON parser lib in C, not for threaded stuff etc, so if we're going to use JSON more than just
 // here we should probably replace cJSON with something beefier.
@@ -748,7 +749,8 @@ parse_error:
     return false;
 }
 
-CameraConstantsStore::CameraConstantsStore()
+CameraConstantsStore::CameraConstantsStore() :
+    pending(false)
 {
 }
 
@@ -762,6 +764,22 @@ CameraConstantsStore::~CameraConstantsStore()
 
 void CameraConstantsStore::init(const Glib::ustring& baseDir, const Glib::ustring& userSettingsDir)
 {
+    MyMutex::MyLock lock(mutex);
+    this->baseDir = baseDir;
+    this->userSettingsDir = userSettingsDir;
+    pending = true;
+}
+
+void CameraConstantsStore::load()
+{
+    StartupTimer timer("camera constants", true);
+
+    for (auto &p : mCameraConstants) {
+        delete p.second;
+    }
+
+    mCameraConstants.clear();
+
     parse_camera_constants_file(Glib::build_filename(baseDir, "camconst.json"));
 
     const Glib::ustring userFile(Glib::build_filename(userSettingsDir, "camconst.json"));
@@ -774,6 +792,16 @@ void CameraConstantsStore::init(const Glib::ustring& baseDir, const Glib::ustrin
 CameraConstantsStore* CameraConstantsStore::getInstance()
 {
     static CameraConstantsStore instance_;
+
+    if (instance_.pending) {
+        MyMutex::MyLock lock(instance_.mutex);
+
+        if (instance_.pending) {
+            instance_.load();
+            instance_.pending = false;
+        }
+    }
+
     return &instance_;
 }
 
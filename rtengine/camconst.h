@@ -3,10 +3,13 @@
  */
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <string>
 #include <vector>
 
+#include "../rtgui/threadutils.h"
+
 namespace Glib
 {
 
@@ -66,12 +69,18 @@ class CameraConstantsStore final
 {
 private:
     std::map<std::string, CameraConst *> mCameraConstants;
+    std::string baseDir;
+    std::string userSettingsDir;
+    std::atomic<bool> pending;
+    MyMutex mutex;
 
     CameraConstantsStore();
     bool parse_camera_constants_file(const Glib::ustring& filename);
+    void load();
 
 public:
     ~CameraConstantsStore();
+    // only records the directories, camconst.json is parsed on the first call of getInstance() after init()
     void init(const Glib::ustring& baseDir, const Glib::ustring& userSettingsDir);
     static CameraConstantsStore *getInstance(void);
     const CameraConst *get(const char make[], const char model[]) const;
@@ -26,6 +26,7 @@
 #include "procparams.h"
 #include "color.h"
 #include "rt_algo.h"
+#include "alignedbuffer.h"
 //#define BENCHMARK
 #include "StopWatch.h"
 #include "opthelper.h"
@@ -33,50 +34,6 @@
 
 namespace {
 
-void compute13x13kernel(float sigma, float kernel[13][13]) {
-
-    const double temp = -2.f * rtengine::SQR(sigma);
-    float sum = 0.f;
-    for (int i = -6; i <= 6; ++i) {
-        for (int j = -6; j <= 6; ++j) {
-            if((rtengine::SQR(i) + rtengine::SQR(j)) <= rtengine::SQR(3.0 * 2.0)) {
-                kernel[i + 6][j + 6] = std::exp((rtengine::SQR(i) + rtengine::SQR(j)) / temp);
-                sum += kernel[i + 6][j + 6];
-            } else {
-                kernel[i + 6][j + 6] = 0.f;
-            }
-        }
-    }
-
-    for (int i = 0; i < 13; ++i) {
-        for (int j = 0; j < 13; ++j) {
-            kernel[i][j] /= sum;
-        }
-    }
-}
-
-void compute9x9kernel(float sigma, float kernel[9][9]) {
-
-    const double temp = -2.f * rtengine::SQR(sigma);
-    float sum = 0.f;
-    for (int i = -4; i <= 4; ++i) {
-        for (int j = -4; j <= 4; ++j) {
-            if((rtengine::SQR(i) + rtengine::SQR(j)) <= rtengine::SQR(3.0 * 1.5)) {
-                kernel[i + 4][j + 4] = std::exp((rtengine::SQR(i) + rtengine::SQR(j)) / temp);
-                sum += kernel[i + 4][j + 4];
-            } else {
-                kernel[i + 4][j + 4] = 0.f;
-            }
-        }
-    }
-
-    for (int i = 0; i < 9; ++i) {
-        for (int j = 0; j < 9; ++j) {
-            kernel[i][j] /= sum;
-        }
-    }
-}
-
 void compute7x7kernel(float sigma, float kernel[7][7]) {
 
     const double temp = -2.f * rtengine::SQR(sigma);
@@ -223,105 +180,6 @@ void gauss7x7div(float** RESTRICT src, float** RESTRICT dst, float** RESTRICT di
     }
 }
 
-void gauss9x9div(float** RESTRICT src, float** RESTRICT dst, float** RESTRICT divBuffer, const int tileSize, const float kernel[9][9])
-{
-
-    const float c42 = kernel[0][2];
-    const float c41 = kernel[0][3];
-    const float c40 = kernel[0][4];
-    const float c33 = kernel[1][1];
-    const float c32 = kernel[1][2];
-    const float c31 = kernel[1][3];
-    const float c30 = kernel[1][4];
-    const float c22 = kernel[2][2];
-    const float c21 = kernel[2][3];
-    const float c20 = kernel[2][4];
-    const float c11 = kernel[3][3];
-    const float c10 = kernel[3][4];
-    const float c00 = kernel[4][4];
-
-    for (int i = 4; i < tileSize - 4; ++i) {
-        // I tried hand written SSE code but gcc vectorizes better
-#if defined(__clang__)
-        #pragma clang loop vectorize(assume_safety)
-#elif defined(__GNUC__)
-        #pragma GCC ivdep
-#endif
-        for (int j = 4; j < tileSize - 4; ++j) {
-            const float val = c42 * ((src[i - 4][j - 2] + src[i - 4][j + 2]) + (src[i - 2][j - 4] + src[i - 2][j + 4]) + (src[i + 2][j - 4] + src[i + 2][j + 4]) + (src[i + 4][j - 2] + src[i + 4][j + 2])) +
-                              c41 * ((src[i - 4][j - 1] + src[i - 4][j + 1]) + (src[i - 1][j - 4] + src[i - 1][j + 4]) + (src[i + 1][j - 4] + src[i + 1][j + 4]) + (src[i + 4][j - 1] + src[i + 4][j + 1])) +
-                              c40 * (src[i - 4][j] + src[i][j - 4] + src[i][j + 4] + src[i + 4][j]) +
-                              c33 * (src[i - 3][j - 3] + src[i - 3][j + 3] + src[i + 3][j - 3] + src[i + 3][j + 3]) +
-                              c32 * ((src[i - 3][j - 2] + src[i - 3][j + 2]) + (src[i - 2][j - 3] + src[i - 2][j + 3]) + (src[i + 2][j - 3] + src[i + 2][j + 3]) + (src[i + 3][j - 2] + src[i + 3][j + 2])) +
-                              c31 * ((src[i - 3][j - 1] + src[i - 3][j + 1]) + (src[i - 1][j - 3] + src[i - 1][j + 3]) + (src[i + 1][j - 3] + src[i + 1][j + 3]) + (src[i + 3][j - 1] + src[i + 3][j + 1])) +
-                              c30 * (src[i - 3][j] + src[i][j - 3] + src[i][j + 3] + src[i + 3][j]) +
-                              c22 * (src[i - 2][j - 2] + src[i - 2][j + 2] + src[i + 2][j - 2] + src[i + 2][j + 2]) +
-                              c21 * ((src[i - 2][j - 1] + src[i - 2][j + 1]) + (src[i - 1][j - 2] + src[i - 1][j + 2]) + (src[i + 1][j - 2] + src[i + 1][j + 2]) + (src[i + 2][j - 1] + src[i + 2][j + 1])) +
-                              c20 * (src[i - 2][j] + src[i][j - 2] + src[i][j + 2] + src[i + 2][j]) +
-                              c11 * (src[i - 1][j - 1] + src[i - 1][j + 1] + src[i + 1][j - 1] + src[i + 1][j + 1]) +
-                              c10 * (src[i - 1][j] + src[i][j - 1] + src[i][j + 1] + src[i + 1][j]) +
-                              c00 * src[i][j];
-
-            dst[i][j] = divBuffer[i][j] / std::max(val, 0.00001f);
-        }
-    }
-}
-
-void gauss13x13div(float** RESTRICT src, float** RESTRICT dst, float** RESTRICT divBuffer, const int tileSize, const float kernel[13][13])
-{
-    const float c60 = kernel[0][6];
-    const float c53 = kernel[1][3];
-    const float c52 = kernel[1][4];
-    const float c51 = kernel[1][5];
-    const float c50 = kernel[1][6];
-    const float c44 = kernel[2][2];
-    const float c42 = kernel[2][4];
-    const float c41 = kernel[2][5];
-    const float c40 = kernel[2][6];
-    const float c33 = kernel[3][3];
-    const float c32 = kernel[3][4];
-    const float c31 = kernel[3][5];
-    const float c30 = kernel[3][6];
-    const float c22 = kernel[4][4];
-    const float c21 = kernel[4][5];
-    const float c20 = kernel[4][6];
-    const float c11 = kernel[5][5];
-    const float c10 = kernel[5][6];
-    const float c00 = kernel[6][6];
-
-    for (int i = 6; i < tileSize - 6; ++i) {
-        // I tried hand written SSE code but gcc vectorizes better
-#if defined(__clang__)
-        #pragma clang loop vectorize(assume_safety)
-#elif defined(__GNUC__)
-        #pragma GCC ivdep
-#endif
-        for (int j = 6; j < tileSize - 6; ++j) {
-            const float val = c60 * (src[i - 6][j] + src[i][j - 6] + src[i][j + 6] + src[i + 6][j]) +
-                              c53 * ((src[i - 5][j - 3] + src[i - 5][j + 3]) + (src[i - 3][j - 5] + src[i - 3][j + 5]) + (src[i + 3][j - 5] + src[i + 3][j + 5]) + (src[i + 5][j - 3] + src[i + 5][j + 3])) +
-                              c52 * ((src[i - 5][j - 2] + src[i - 5][j + 2]) + (src[i - 2][j - 5] + src[i - 2][j + 5]) + (src[i + 2][j - 5] + src[i + 2][j + 5]) + (src[i + 5][j - 2] + src[i + 5][j + 2])) +
-                              c51 * ((src[i - 5][j - 1] + src[i - 5][j + 1]) + (src[i - 1][j - 5] + src[i - 1][j + 5]) + (src[i + 1][j - 5] + src[i + 1][j + 5]) + (src[i + 5][j - 1] + src[i + 5][j + 1])) +
-                              c50 * ((src[i - 5][j] + src[i][j - 5] + src[i][j + 5] + src[i + 5][j]) + ((src[i - 4][j - 3] + src[i - 4][j + 3]) + (src[i - 3][j - 4] + src[i - 3][j + 4]) + (src[i + 3][j - 4] + src[i + 3][j + 4]) + (src[i + 4][j - 3] + src[i + 4][j + 3]))) +
-                              c44 * (src[i - 4][j - 4] + src[i - 4][j + 4] + src[i + 4][j - 4] + src[i + 4][j + 4]) +
-                              c42 * ((src[i - 4][j - 2] + src[i - 4][j + 2]) + (src[i - 2][j - 4] + src[i - 2][j + 4]) + (src[i + 2][j - 4] + src[i + 2][j + 4]) + (src[i + 4][j - 2] + src[i + 4][j + 2])) +
-                              c41 * ((src[i - 4][j - 1] + src[i - 4][j + 1]) + (src[i - 1][j - 4] + src[i - 1][j + 4]) + (src[i + 1][j - 4] + src[i + 1][j + 4]) + (src[i + 4][j - 1] + src[i + 4][j + 1])) +
-                              c40 * (src[i - 4][j] + src[i][j - 4] + src[i][j + 4] + src[i + 4][j]) +
-                              c33 * (src[i - 3][j - 3] + src[i - 3][j + 3] + src[i + 3][j - 3] + src[i + 3][j + 3]) +
-                              c32 * ((src[i - 3][j - 2] + src[i - 3][j + 2]) + (src[i - 2][j - 3] + src[i - 2][j + 3]) + (src[i + 2][j - 3] + src[i + 2][j + 3]) + (src[i + 3][j - 2] + src[i + 3][j + 2])) +
-                              c31 * ((src[i - 3][j - 1] + src[i - 3][j + 1]) + (src[i - 1][j - 3] + src[i - 1][j + 3]) + (src[i + 1][j - 3] + src[i + 1][j + 3]) + (src[i + 3][j - 1] + src[i + 3][j + 1])) +
-                              c30 * (src[i - 3][j] + src[i][j - 3] + src[i][j + 3] + src[i + 3][j]) +
-                              c22 * (src[i - 2][j - 2] + src[i - 2][j + 2] + src[i + 2][j - 2] + src[i + 2][j + 2]) +
-                              c21 * ((src[i - 2][j - 1] + src[i - 2][j + 1]) + (src[i - 1][j - 2] + src[i - 1][j + 2]) + (src[i + 1][j - 2] + src[i + 1][j + 2]) + (src[i + 2][j - 1] + src[i + 2][j + 1])) +
-                              c20 * (src[i - 2][j] + src[i][j - 2] + src[i][j + 2] + src[i + 2][j]) +
-                              c11 * (src[i - 1][j - 1] + src[i - 1][j + 1] + src[i + 1][j - 1] + src[i + 1][j + 1]) +
-                              c10 * (src[i - 1][j] + src[i][j - 1] + src[i][j + 1] + src[i + 1][j]) +
-                              c00 * src[i][j];
-
-            dst[i][j] = divBuffer[i][j] / std::max(val, 0.00001f);
-        }
-    }
-}
-
 void gauss3x3mult(float** RESTRICT src, float** RESTRICT dst, const int tileSize, const float kernel[3][3])
 {
     const float c11 = kernel[0][0];
@@ -406,104 +264,179 @@ void gauss7x7mult(float** RESTRICT src, float** RESTRICT dst, const int tileSize
     }
 }
 
-void gauss9x9mult(float** RESTRICT src, float** RESTRICT dst, const int tileSize, const float kernel[9][9])
+// Gaussian kernel of size (2 * radius + 1) x (2 * radius + 1), truncated to the disc of radius discRadius.
+// The weight of (i, j) is g(i) * g(j), so the large kernels don't need the 2D convolution: a horizontal pass
+// sums each row for all half widths 0 .. radius (each width extends the previous one), a vertical pass adds up
+// the rows of the disc, each with its own half width. For 13x13 that's about a third of the operations.
+// The horizontal sums are kept only for the last 2 * radius + 1 rows, so they stay in L1 cache.
+template<int radius>
+class DiscGaussian
 {
+public:
+    DiscGaussian(float sigma, double discRadius)
+    {
+        const double temp = -2.0 * rtengine::SQR(sigma);
+        double weights[radius + 1];
 
-    const float c42 = kernel[0][2];
-    const float c41 = kernel[0][3];
-    const float c40 = kernel[0][4];
-    const float c33 = kernel[1][1];
-    const float c32 = kernel[1][2];
-    const float c31 = kernel[1][3];
-    const float c30 = kernel[1][4];
-    const float c22 = kernel[2][2];
-    const float c21 = kernel[2][3];
-    const float c20 = kernel[2][4];
-    const float c11 = kernel[3][3];
-    const float c10 = kernel[3][4];
-    const float c00 = kernel[4][4];
-
-    for (int i = 4; i < tileSize - 4; ++i) {
-        // I tried hand written SSE code but gcc vectorizes better
-#if defined(__clang__)
-        #pragma clang loop vectorize(assume_safety)
-#elif defined(__GNUC__)
-        #pragma GCC ivdep
+        for (int k = 0; k <= radius; ++k) {
+            weights[k] = std::exp(rtengine::SQR(k) / temp);
+        }
+
+        double sum = 0.0;
+
+        for (int i = 0; i <= radius; ++i) {
+            int width = radius;
+
+            while (rtengine::SQR(i) + rtengine::SQR(width) > rtengine::SQR(discRadius)) {
+                --width;
+            }
+
+            halfWidth[i] = width;
+            double rowSum = weights[0];
+
+            for (int j = 1; j <= width; ++j) {
+                rowSum += 2.0 * weights[j];
+            }
+
+            sum += (i == 0 ? 1.0 : 2.0) * weights[i] * rowSum;
+        }
+
+        const double norm = 1.0 / std::sqrt(sum);
+
+        for (int k = 0; k <= radius; ++k) {
+            coeffs[k] = weights[k] * norm;
+#ifdef __SSE2__
+            coeffsv[k] = F2V(coeffs[k]);
 #endif
-        for (int j = 4; j < tileSize - 4; ++j) {
-            const float val = c42 * ((src[i - 4][j - 2] + src[i - 4][j + 2]) + (src[i - 2][j - 4] + src[i - 2][j + 4]) + (src[i + 2][j - 4] + src[i + 2][j + 4]) + (src[i + 4][j - 2] + src[i + 4][j + 2])) +
-                              c41 * ((src[i - 4][j - 1] + src[i - 4][j + 1]) + (src[i - 1][j - 4] + src[i - 1][j + 4]) + (src[i + 1][j - 4] + src[i + 1][j + 4]) + (src[i + 4][j - 1] + src[i + 4][j + 1])) +
-                              c40 * (src[i - 4][j] + src[i][j - 4] + src[i][j + 4] + src[i + 4][j]) +
-                              c33 * (src[i - 3][j - 3] + src[i - 3][j + 3] + src[i + 3][j - 3] + src[i + 3][j + 3]) +
-                              c32 * ((src[i - 3][j - 2] + src[i - 3][j + 2]) + (src[i - 2][j - 3] + src[i - 2][j + 3]) + (src[i + 2][j - 3] + src[i + 2][j + 3]) + (src[i + 3][j - 2] + src[i + 3][j + 2])) +
-                              c31 * ((src[i - 3][j - 1] + src[i - 3][j + 1]) + (src[i - 1][j - 3] + src[i - 1][j + 3]) + (src[i + 1][j - 3] + src[i + 1][j + 3]) + (src[i + 3][j - 1] + src[i + 3][j + 1])) +
-                              c30 * (src[i - 3][j] + src[i][j - 3] + src[i][j + 3] + src[i + 3][j]) +
-                              c22 * (src[i - 2][j - 2] + src[i - 2][j + 2] + src[i + 2][j - 2] + src[i + 2][j + 2]) +
-                              c21 * ((src[i - 2][j - 1] + src[i - 2][j + 1]) + (src[i - 1][j - 2] + src[i - 1][j + 2]) + (src[i + 1][j - 2] + src[i + 1][j + 2]) + (src[i + 2][j - 1] + src[i + 2][j + 1])) +
-                              c20 * (src[i - 2][j] + src[i][j - 2] + src[i][j + 2] + src[i + 2][j]) +
-                              c11 * (src[i - 1][j - 1] + src[i - 1][j + 1] + src[i + 1][j - 1] + src[i + 1][j + 1]) +
-                              c10 * (src[i - 1][j] + src[i][j - 1] + src[i][j + 1] + src[i + 1][j]) +
-                              c00 * src[i][j];
-            dst[i][j] *= val;
         }
     }
-}
 
-void gauss13x13mult(float** RESTRICT src, float** RESTRICT dst, const int tileSize, const float kernel[13][13])
-{
+    // number of floats needed as buffer for tiles of tileSize x tileSize
+    static std::size_t bufferSize(int tileSize)
+    {
+        return static_cast<std::size_t>(radius + 1) * window * tileSize;
+    }
 
-    const float c60 = kernel[0][6];
-    const float c53 = kernel[1][3];
-    const float c52 = kernel[1][4];
-    const float c51 = kernel[1][5];
-    const float c50 = kernel[1][6];
-    const float c44 = kernel[2][2];
-    const float c42 = kernel[2][4];
-    const float c41 = kernel[2][5];
-    const float c40 = kernel[2][6];
-    const float c33 = kernel[3][3];
-    const float c32 = kernel[3][4];
-    const float c31 = kernel[3][5];
-    const float c30 = kernel[3][6];
-    const float c22 = kernel[4][4];
-    const float c21 = kernel[4][5];
-    const float c20 = kernel[4][6];
-    const float c11 = kernel[5][5];
-    const float c10 = kernel[5][6];
-    const float c00 = kernel[6][6];
-
-    for (int i = 6; i < tileSize - 6; ++i) {
-        // I tried hand written SSE code but gcc vectorizes better
-#if defined(__clang__)
-        #pragma clang loop vectorize(assume_safety)
-#elif defined(__GNUC__)
-        #pragma GCC ivdep
+    // dst = divBuffer / gaussian blur of src
+    void div(float** RESTRICT src, float** RESTRICT dst, float** RESTRICT divBuffer, int tileSize, float* buffer) const
+    {
+        blur(src, tileSize, buffer, [&](int i, const float* const* rows) {
+            int j = radius;
+#ifdef __SSE2__
+            const vfloat minValv = F2V(0.00001f);
+
+            for (; j < tileSize - radius - 3; j += 4) {
+                STVFU(dst[i][j], LVFU(divBuffer[i][j]) / vmaxf(blurColumnv(rows, j), minValv));
+            }
 #endif
-        for (int j = 6; j < tileSize - 6; ++j) {
-            const float val = c60 * (src[i - 6][j] + src[i][j - 6] + src[i][j + 6] + src[i + 6][j]) +
-                              c53 * ((src[i - 5][j - 3] + src[i - 5][j + 3]) + (src[i - 3][j - 5] + src[i - 3][j + 5]) + (src[i + 3][j - 5] + src[i + 3][j + 5]) + (src[i + 5][j - 3] + src[i + 5][j + 3])) +
-                              c52 * ((src[i - 5][j - 2] + src[i - 5][j + 2]) + (src[i - 2][j - 5] + src[i - 2][j + 5]) + (src[i + 2][j - 5] + src[i + 2][j + 5]) + (src[i + 5][j - 2] + src[i + 5][j + 2])) +
-                              c51 * ((src[i - 5][j - 1] + src[i - 5][j + 1]) + (src[i - 1][j - 5] + src[i - 1][j + 5]) + (src[i + 1][j - 5] + src[i + 1][j + 5]) + (src[i + 5][j - 1] + src[i + 5][j + 1])) +
-                              c50 * ((src[i - 5][j] + src[i][j - 5] + src[i][j + 5] + src[i + 5][j]) + ((src[i - 4][j - 3] + src[i - 4][j + 3]) + (src[i - 3][j - 4] + src[i - 3][j + 4]) + (src[i + 3][j - 4] + src[i + 3][j + 4]) + (src[i + 4][j - 3] + src[i + 4][j + 3]))) +
-                              c44 * (src[i - 4][j - 4] + src[i - 4][j + 4] + src[i + 4][j - 4] + src[i + 4][j + 4]) +
-                              c42 * ((src[i - 4][j - 2] + src[i - 4][j + 2]) + (src[i - 2][j - 4] + src[i - 2][j + 4]) + (src[i + 2][j - 4] + src[i + 2][j + 4]) + (src[i + 4][j - 2] + src[i + 4][j + 2])) +
-                              c41 * ((src[i - 4][j - 1] + src[i - 4][j + 1]) + (src[i - 1][j - 4] + src[i - 1][j + 4]) + (src[i + 1][j - 4] + src[i + 1][j + 4]) + (src[i + 4][j - 1] + src[i + 4][j + 1])) +
-                              c40 * (src[i - 4][j] + src[i][j - 4] + src[i][j + 4] + src[i + 4][j]) +
-                              c33 * (src[i - 3][j - 3] + src[i - 3][j + 3] + src[i + 3][j - 3] + src[i + 3][j + 3]) +
-                              c32 * ((src[i - 3][j - 2] + src[i - 3][j + 2]) + (src[i - 2][j - 3] + src[i - 2][j + 3]) + (src[i + 2][j - 3] + src[i + 2][j + 3]) + (src[i + 3][j - 2] + src[i + 3][j + 2])) +
-                              c31 * ((src[i - 3][j - 1] + src[i - 3][j + 1]) + (src[i - 1][j - 3] + src[i - 1][j + 3]) + (src[i + 1][j - 3] + src[i + 1][j + 3]) + (src[i + 3][j - 1] + src[i + 3][j + 1])) +
-                              c30 * (src[i - 3][j] + src[i][j - 3] + src[i][j + 3] + src[i + 3][j]) +
-                              c22 * (src[i - 2][j - 2] + src[i - 2][j + 2] + src[i + 2][j - 2] + src[i + 2][j + 2]) +
-                              c21 * ((src[i - 2][j - 1] + src[i - 2][j + 1]) + (src[i - 1][j - 2] + src[i - 1][j + 2]) + (src[i + 1][j - 2] + src[i + 1][j + 2]) + (src[i + 2][j - 1] + src[i + 2][j + 1])) +
-                              c20 * (src[i - 2][j] + src[i][j - 2] + src[i][j + 2] + src[i + 2][j]) +
-                              c11 * (src[i - 1][j - 1] + src[i - 1][j + 1] + src[i + 1][j - 1] + src[i + 1][j + 1]) +
-                              c10 * (src[i - 1][j] + src[i][j - 1] + src[i][j + 1] + src[i + 1][j]) +
-                              c00 * src[i][j];
 
-            dst[i][j] *= val;
+            for (; j < tileSize - radius; ++j) {
+                dst[i][j] = divBuffer[i][j] / std::max(blurColumn(rows, j), 0.00001f);
+            }
+        });
+    }
+
+    // dst *= gaussian blur of src
+    void mult(float** RESTRICT src, float** RESTRICT dst, int tileSize, float* buffer) const
+    {
+        blur(src, tileSize, buffer, [&](int i, const float* const* rows) {
+            int j = radius;
+#ifdef __SSE2__
+
+            for (; j < tileSize - radius - 3; j += 4) {
+                STVFU(dst[i][j], LVFU(dst[i][j]) * blurColumnv(rows, j));
+            }
+#endif
+
+            for (; j < tileSize - radius; ++j) {
+                dst[i][j] *= blurColumn(rows, j);
+            }
+        });
+    }
+
+private:
+    static constexpr int window = 2 * radius + 1;
+
+    // calls process(i, rows) for the rows i of the tile which have a full window, rows[radius + k] points to the horizontal sums
+    // of row i + k with the half width of the disc at k. The sums of half width w of row r are at buffer + (w * window + r % window) * tileSize
+    template<class Process>
+    void blur(float** RESTRICT src, int tileSize, float* RESTRICT buffer, const Process& process) const
+    {
+        for (int r = 0; r < tileSize; ++r) {
+            const float* const row = src[r];
+            float* sums[radius + 1];
+
+            for (int w = 0; w <= radius; ++w) {
+                sums[w] = buffer + (w * window + r % window) * tileSize;
+            }
+
+            int j = radius;
+#ifdef __SSE2__
+
+            for (; j < tileSize - radius - 3; j += 4) {
+                vfloat val = coeffsv[0] * LVFU(row[j]);
+                STVFU(sums[0][j], val);
+
+                for (int w = 1; w <= radius; ++w) {
+                    val += coeffsv[w] * (LVFU(row[j - w]) + LVFU(row[j + w]));
+                    STVFU(sums[w][j], val);
+                }
+            }
+#endif
+
+            for (; j < tileSize - radius; ++j) {
+                float val = coeffs[0] * row[j];
+                sums[0][j] = val;
+
+                for (int w = 1; w <= radius; ++w) {
+                    val += coeffs[w] * (row[j - w] + row[j + w]);
+                    sums[w][j] = val;
+                }
+            }
+
+            if (r >= 2 * radius) {
+                const int i = r - radius;
+                const float* rows[window];
+
+                for (int k = -radius; k <= radius; ++k) {
+                    rows[radius + k] = buffer + (halfWidth[std::abs(k)] * window + (i + k) % window) * tileSize;
+                }
+
+                process(i, rows);
+            }
         }
     }
-}
+
+    float blurColumn(const float* const* rows, int j) const
+    {
+        float val = coeffs[0] * rows[radius][j];
+
+        for (int k = 1; k <= radius; ++k) {
+            val += coeffs[k] * (rows[radius - k][j] + rows[radius + k][j]);
+        }
+
+        return val;
+    }
+
+#ifdef __SSE2__
+    vfloat blurColumnv(const float* const* rows, int j) const
+    {
+        vfloat val = coeffsv[0] * LVFU(rows[radius][j]);
+
+        for (int k = 1; k <= radius; ++k) {
+            val += coeffsv[k] * (LVFU(rows[radius - k][j]) + LVFU(rows[radius + k][j]));
+        }
+
+        return val;
+    }
+#endif
+
+    float coeffs[radius + 1];
+#ifdef __SSE2__
+    vfloat coeffsv[radius + 1];
+#endif
+    int halfWidth[radius + 1];
+};
 
 void buildClipMaskBayer(const float * const *rawData, int W, int H, float** clipMask, const float whites[2][2])
 {
@@ -757,6 +690,62 @@ bool checkForStop(float** tmpIThr, float** iterCheck, int fullTileSize, int bord
     return false;
 }
 
+// copies the core of the tile
+void saveCore(float** tmpIThr, float** previous, int fullTileSize, int border)
+{
+    for (int ii = border; ii < fullTileSize - border; ++ii) {
+        for (int jj = border; jj < fullTileSize - border; ++jj) {
+            previous[ii - border][jj - border] = tmpIThr[ii][jj];
+        }
+    }
+}
+
+// The iterations have converged when the last one changed the core of the tile by less than maxMeanChange on average.
+// Single pixels are not checked, the estimate keeps adapting to the noise.
+bool isConverged(float** tmpIThr, float** previous, int fullTileSize, int border)
+{
+    constexpr float maxMeanChange = 0.0005f;
+    float change = 0.f;
+    float sum = 0.f;
+#ifdef __SSE2__
+    vfloat changev = ZEROV;
+    vfloat sumv = ZEROV;
+#endif
+    for (int ii = border; ii < fullTileSize - border; ++ii) {
+        int jj = border;
+#ifdef __SSE2__
+        for (; jj < fullTileSize - border - 3; jj += 4) {
+            const vfloat valv = LVFU(tmpIThr[ii][jj]);
+            changev += vabsf(valv - LVFU(previous[ii - border][jj - border]));
+            sumv += valv;
+        }
+#endif
+        for (; jj < fullTileSize - border; ++jj) {
+            change += std::fabs(tmpIThr[ii][jj] - previous[ii - border][jj - border]);
+            sum += tmpIThr[ii][jj];
+        }
+    }
+#ifdef __SSE2__
+    change += vhadd(changev);
+    sum += vhadd(sumv);
+#endif
+    return change <= maxMeanChange * sum;
+}
+
+// iterations on one tile, div() sets tmpThr to the luminance divided by the blurred tmpIThr, mult() multiplies tmpIThr by the blurred tmpThr
+template<class Div, class Mult>
+void deconvolveTile(float** tmpIThr, float** iterCheck, float** previous, int fullTileSize, int border, int iterations, bool checkIterStop, const Div& div, const Mult& mult)
+{
+    for (int k = 0; k < iterations; ++k) {
+        saveCore(tmpIThr, previous, fullTileSize, border);
+        div();
+        mult();
+        if (k < iterations - 1 && ((checkIterStop && checkForStop(tmpIThr, iterCheck, fullTileSize, border)) || isConverged(tmpIThr, previous, fullTileSize, border))) {
+            break;
+        }
+    }
+}
+
 void CaptureDeconvSharpening (float** luminance, const float* const * oldLuminance, const float * const * blend, int W, int H, float sigma, float sigmaCornerOffset, int iterations, bool checkIterStop, rtengine::ProgressListener* plistener, double startVal, double endVal)
 {
 BENCHFUN
@@ -764,8 +753,8 @@ BENCHFUN
     const bool is7x7 = (sigma <= 1.15f && sigmaCornerOffset == 0.f);
     const bool is5x5 = (sigma <= 0.84f && sigmaCornerOffset == 0.f);
     const bool is3x3 = (sigma < 0.6f && sigmaCornerOffset == 0.f);
-    float kernel13[13][13];
-    float kernel9[9][9];
+    const DiscGaussian<6> kernel13(sigma, 3.0 * 2.0);
+    const DiscGaussian<4> kernel9(sigma, 3.0 * 1.5);
     float kernel7[7][7];
     float kernel5[5][5];
     float kernel3[3][3];
@@ -775,10 +764,6 @@ BENCHFUN
         compute5x5kernel(sigma, kernel5);
     } else if (is7x7) {
         compute7x7kernel(sigma, kernel7);
-    } else if (is9x9) {
-        compute9x9kernel(sigma, kernel9);
-    } else {
-        compute13x13kernel(sigma, kernel13);
     }
 
     constexpr int tileSize = 32;
@@ -803,6 +788,8 @@ BENCHFUN
         tmpThr.fill(1.f);
         array2D<float> lumThr(fullTileSize, fullTileSize);
         array2D<float> iterCheck(tileSize, tileSize);
+        array2D<float> previous(tileSize, tileSize);
+        AlignedBuffer<float> discBuffer(is7x7 ? 0 : DiscGaussian<6>::bufferSize(fullTileSize));
 #ifdef _OPENMP
         #pragma omp for schedule(dynamic,16) collapse(2)
 #endif
@@ -865,103 +852,55 @@ BENCHFUN
                         }
                     }
                 }
+                // apply gaussian blur and divide luminance by result of gaussian blur, then multiply by the gaussian blur of the quotient
                 if (is3x3) {
-                    for (int k = 0; k < iterations; ++k) {
-                        // apply 3x3 gaussian blur and divide luminance by result of gaussian blur
-                        gauss3x3div(tmpIThr, tmpThr, lumThr, fullTileSize, kernel3);
-                        gauss3x3mult(tmpThr, tmpIThr, fullTileSize, kernel3);
-                        if (checkIterStop && k < iterations - 1 && checkForStop(tmpIThr, iterCheck, fullTileSize, border)) {
-                            break;
-                        }
-                    }
+                    deconvolveTile(tmpIThr, iterCheck, previous, fullTileSize, border, iterations, checkIterStop,
+                        [&]() { gauss3x3div(tmpIThr, tmpThr, lumThr, fullTileSize, kernel3); },
+                        [&]() { gauss3x3mult(tmpThr, tmpIThr, fullTileSize, kernel3); });
                 } else if (is5x5) {
-                    for (int k = 0; k < iterations; ++k) {
-                        // apply 5x5 gaussian blur and divide luminance by result of gaussian blur
-                        gauss5x5div(tmpIThr, tmpThr, lumThr, fullTileSize, kernel5);
-                        gauss5x5mult(tmpThr, tmpIThr, fullTileSize, kernel5);
-                        if (checkIterStop && k < iterations - 1 && checkForStop(tmpIThr, iterCheck, fullTileSize, border)) {
-                            break;
-                        }
-                    }
+                    deconvolveTile(tmpIThr, iterCheck, previous, fullTileSize, border, iterations, checkIterStop,
+                        [&]() { gauss5x5div(tmpIThr, tmpThr, lumThr, fullTileSize, kernel5); },
+                        [&]() { gauss5x5mult(tmpThr, tmpIThr, fullTileSize, kernel5); });
                 } else if (is7x7) {
-                    for (int k = 0; k < iterations; ++k) {
-                        // apply 5x5 gaussian blur and divide luminance by result of gaussian blur
-                        gauss7x7div(tmpIThr, tmpThr, lumThr, fullTileSize, kernel7);
-                        gauss7x7mult(tmpThr, tmpIThr, fullTileSize, kernel7);
-                        if (checkIterStop && k < iterations - 1 && checkForStop(tmpIThr, iterCheck, fullTileSize, border)) {
-                            break;
-                        }
-                    }
+                    deconvolveTile(tmpIThr, iterCheck, previous, fullTileSize, border, iterations, checkIterStop,
+                        [&]() { gauss7x7div(tmpIThr, tmpThr, lumThr, fullTileSize, kernel7); },
+                        [&]() { gauss7x7mult(tmpThr, tmpIThr, fullTileSize, kernel7); });
                 } else if (is9x9) {
-                    for (int k = 0; k < iterations; ++k) {
-                        // apply 5x5 gaussian blur and divide luminance by result of gaussian blur
-                        gauss9x9div(tmpIThr, tmpThr, lumThr, fullTileSize, kernel9);
-                        gauss9x9mult(tmpThr, tmpIThr, fullTileSize, kernel9);
-                        if (checkIterStop && k < iterations - 1 && checkForStop(tmpIThr, iterCheck, fullTileSize, border)) {
-                            break;
+                    deconvolveTile(tmpIThr, iterCheck, previous, fullTileSize, border, iterations, checkIterStop,
+                        [&]() { kernel9.div(tmpIThr, tmpThr, lumThr, fullTileSize, discBuffer.data); },
+                        [&]() { kernel9.mult(tmpThr, tmpIThr, fullTileSize, discBuffer.data); });
+                } else if (sigmaCornerOffset != 0.f) {
+                    const float distance = sqrt(rtengine::SQR(i + tileSize / 2 - H / 2) + rtengine::SQR(j + tileSize / 2 - W / 2));
+                    const float sigmaTile = static_cast<float>(sigma) + distanceFactor * distance;
+                    if (sigmaTile >= 0.4f) {
+                        if (sigmaTile > 1.5f) { // have to use 13x13 kernel
+                            const DiscGaussian<6> lkernel13(sigmaTile, 3.0 * 2.0);
+                            deconvolveTile(tmpIThr, iterCheck, previous, fullTileSize, border, iterations, checkIterStop,
+                                [&]() { lkernel13.div(tmpIThr, tmpThr, lumThr, fullTileSize, discBuffer.data); },
+                                [&]() { lkernel13.mult(tmpThr, tmpIThr, fullTileSize, discBuffer.data); });
+                        } else if (sigmaTile > 1.15f) { // have to use 9x9 kernel
+                            const DiscGaussian<4> lkernel9(sigmaTile, 3.0 * 1.5);
+                            deconvolveTile(tmpIThr, iterCheck, previous, fullTileSize, border, iterations, checkIterStop,
+                                [&]() { lkernel9.div(tmpIThr, tmpThr, lumThr, fullTileSize, discBuffer.data); },
+                                [&]() { lkernel9.mult(tmpThr, tmpIThr, fullTileSize, discBuffer.data); });
+                        } else if (sigmaTile > 0.84f) { // have to use 7x7 kernel
+                            float lkernel7[7][7];
+                            compute7x7kernel(sigmaTile, lkernel7);
+                            deconvolveTile(tmpIThr, iterCheck, previous, fullTileSize, border, iterations, checkIterStop,
+                                [&]() { gauss7x7div(tmpIThr, tmpThr, lumThr, fullTileSize, lkernel7); },
+                                [&]() { gauss7x7mult(tmpThr, tmpIThr, fullTileSize, lkernel7); });
+                        } else { // can use 5x5 kernel
+                            float lkernel5[5][5];
+                            compute5x5kernel(sigmaTile, lkernel5);
+                            deconvolveTile(tmpIThr, iterCheck, previous, fullTileSize, border, iterations, checkIterStop,
+                                [&]() { gauss5x5div(tmpIThr, tmpThr, lumThr, fullTileSize, lkernel5); },
+                                [&]() { gauss5x5mult(tmpThr, tmpIThr, fullTileSize, lkernel5); });
                         }
                     }
                 } else {
-                    if (sigmaCornerOffset != 0.f) {
-                        const float distance = sqrt(rtengine::SQR(i + tileSize / 2 - H / 2) + rtengine::SQR(j + tileSize / 2 - W / 2));
-                        const float sigmaTile = static_cast<float>(sigma) + distanceFactor * distance;
-                        if (sigmaTile >= 0.4f) {
-                            if (sigmaTile > 1.5f) { // have to use 13x13 kernel
-                                float lkernel13[13][13];
-                                compute13x13kernel(static_cast<float>(sigma) + distanceFactor * distance, lkernel13);
-                                for (int k = 0; k < iterations; ++k) {
-                                    // apply 13x13 gaussian blur and divide luminance by result of gaussian blur
-                                    gauss13x13div(tmpIThr, tmpThr, lumThr, fullTileSize, lkernel13);
-                                    gauss13x13mult(tmpThr, tmpIThr, fullTileSize, lkernel13);
-                                    if (checkIterStop && k < iterations - 1 && checkForStop(tmpIThr, iterCheck, fullTileSize, border)) {
-                                        break;
-                                    }
-                                }
-                            } else if (sigmaTile > 1.15f) { // have to use 9x9 kernel
-                                float lkernel9[9][9];
-                                compute9x9kernel(static_cast<float>(sigma) + distanceFactor * distance, lkernel9);
-                                for (int k = 0; k < iterations; ++k) {
-                                    // apply 9x9 gaussian blur and divide luminance by result of gaussian blur
-                                    gauss9x9div(tmpIThr, tmpThr, lumThr, fullTileSize, lkernel9);
-                                    gauss9x9mult(tmpThr, tmpIThr, fullTileSize, lkernel9);
-                                    if (checkIterStop && k < iterations - 1 && checkForStop(tmpIThr, iterCheck, fullTileSize, border)) {
-                                        break;
-                                    }
-                                }
-                            } else if (sigmaTile > 0.84f) { // have to use 7x7 kernel
-                                float lkernel7[7][7];
-                                compute7x7kernel(static_cast<float>(sigma) + distanceFactor * distance, lkernel7);
-                                for (int k = 0; k < iterations; ++k) {
-                                    // apply 7x7 gaussian blur and divide luminance by result of gaussian blur
-                                    gauss7x7div(tmpIThr, tmpThr, lumThr, fullTileSize, lkernel7);
-                                    gauss7x7mult(tmpThr, tmpIThr, fullTileSize, lkernel7);
-                                    if (checkIterStop && k < iterations - 1 && checkForStop(tmpIThr, iterCheck, fullTileSize, border)) {
-                                        break;
-                                    }
-                                }
-                            } else { // can use 5x5 kernel
-                                float lkernel5[5][5];
-                                compute5x5kernel(static_cast<float>(sigma) + distanceFactor * distance, lkernel5);
-                                for (int k = 0; k < iterations; ++k) {
-                                    // apply 7x7 gaussian blur and divide luminance by result of gaussian blur
-                                    gauss5x5div(tmpIThr, tmpThr, lumThr, fullTileSize, lkernel5);
-                                    gauss5x5mult(tmpThr, tmpIThr, fullTileSize, lkernel5);
-                                    if (checkIterStop && k < iterations - 1 && checkForStop(tmpIThr, iterCheck, fullTileSize, border)) {
-                                        break;
-                                    }
-                                }
-                            }
-                        }
-                    } else {
-                        for (int k = 0; k < iterations; ++k) {
-                            // apply 13x13 gaussian blur and divide luminance by result of gaussian blur
-                            gauss13x13div(tmpIThr, tmpThr, lumThr, fullTileSize, kernel13);
-                            gauss13x13mult(tmpThr, tmpIThr, fullTileSize, kernel13);
-                            if (checkIterStop && k < iterations - 1 && checkForStop(tmpIThr, iterCheck, fullTileSize, border)) {
-                                break;
-                            }
-                        }
-                    }
+                    deconvolveTile(tmpIThr, iterCheck, previous, fullTileSize, border, iterations, checkIterStop,
+                        [&]() { kernel13.div(tmpIThr, tmpThr, lumThr, fullTileSize, discBuffer.data); },
+                        [&]() { kernel13.mult(tmpThr, tmpIThr, fullTileSize, discBuffer.data); });
                 }
                 if (endOfRow || endOfCol) {
                     // special handling for small tiles at end of row or column
@@ -19,6 +19,7 @@
 #include "ciecam02.h"
 #include "rt_math.h"
 #include "curves.h"
+#include "color.h"
 #include <math.h>
 #include "sleef.h"
 
@@ -48,6 +49,23 @@ void Ciecam02::curvecolorfloat (float satind, float satval, float &sres, float p
     }
 }
 
+#ifdef __SSE2__
+void Ciecam02::curvecolorfloat (float satind, vfloat satval, vfloat &sres, vfloat parsat)
+{
+    if (satind > 0.f) {
+        const vfloat onev = F2V (1.f);
+        const vfloat satindv = F2V (satind / 100.f);
+        sres = (onev - satindv) * satval + satindv * (onev - SQRV (SQRV (onev - vminf (satval, onev))));
+        sres = vself (vmaskf_ge (satval, onev), satval, sres); // The calculation above goes wrong direction when satval > 1
+        sres = vself (vmaskf_gt (sres, parsat), vmaxf (parsat, satval), sres);
+    } else if (satind < 0.f) {
+        sres = satval * F2V (1.f + satind / 100.f);
+    } else { // satind == 0 means we don't want to change the value at all
+        sres = satval;
+    }
+}
+#endif
+
 void Ciecam02::curveJfloat (float br, float contr, const LUTu & histogram, LUTf & outCurve)
 {
 
@@ -812,4 +830,222 @@ vfloat Ciecam02::inverse_nonlinear_adaptationfloat ( vfloat c, vfloat fl )
     return (F2V (100.0f) / fl) * pow_F ( (F2V (27.13f) * c) / (F2V (400.0f) - c), F2V (2.38095238f) );
 }
 #endif
+
+void Ciecam02::jchqmsAdjustfloat ( float &J, float &C, float &h, float &Q, float &M, float &s, const CamAdjustParams &params)
+{
+    constexpr float epsil = 0.0001f;
+    const LUTf &curveJ = *params.curveJ;
+    const LUTf &curveQ = *params.curveQ;
+    const float coe = params.coe;
+    const float rstprotection = params.rstprotection;
+
+    float Jpro = J;
+    float Cpro = C;
+    float hpro = h;
+    float Qpro = Q;
+    float Mpro = M;
+    float spro = s;
+
+    // we cannot have all algorithms with all chroma curves
+    if (params.alg == 0) {
+        Jpro = curveJ[Jpro * 327.68f]; //lightness CIECAM02 + contrast
+        Qpro = params.QproFactor * sqrtf (Jpro);
+        float Cp = (spro * spro * Qpro) / (1000000.f);
+        Cpro = Cp * 100.f;
+        float sres;
+        curvecolorfloat (params.chr, Cp, sres, 1.8f);
+        Color::skinredfloat (Jpro, hpro, sres, Cp, 55.f, 30.f, 1, rstprotection, 100.f, Cpro);
+    } else if (params.alg == 1) {
+        // Lightness saturation
+        Jpro = curveJ[Jpro * 327.68f]; //lightness CIECAM02 + contrast
+        float sres;
+        float Sp = spro / 100.0f;
+        float parsat = 1.5f; //parsat=1.5 =>saturation  ; 1.8 => chroma ; 2.5 => colorfullness (personal evaluation)
+        curvecolorfloat (params.schr, Sp, sres, parsat);
+        float dred = 100.f; // in C mode
+        float protect_red = 80.0f; // in C mode
+        dred = 100.0f * sqrtf ((dred * coe) / Qpro);
+        protect_red = 100.0f * sqrtf ((protect_red * coe) / Qpro);
+        Color::skinredfloat (Jpro, hpro, sres, Sp, dred, protect_red, 0, rstprotection, 100.f, spro);
+        Qpro = params.QproFactor * sqrtf (Jpro);
+        Cpro = (spro * spro * Qpro) / (10000.0f);
+    } else if (params.alg == 2) {
+        Qpro = curveQ[ (float) (Qpro * params.coefQ)] / params.coefQ; //brightness and contrast
+        float Mp, sres;
+        Mp = Mpro / 100.0f;
+        curvecolorfloat (params.mchr, Mp, sres, 2.5f);
+        float dred = 100.f; //in C mode
+        float protect_red = 80.0f; // in C mode
+        dred *= coe; //in M mode
+        protect_red *= coe; //M mode
+        Color::skinredfloat (Jpro, hpro, sres, Mp, dred, protect_red, 0, rstprotection, 100.f, Mpro);
+        Jpro = SQR ((10.f * Qpro) / params.wh);
+        Cpro = Mpro / coe;
+        Qpro = (Qpro == 0.f ? epsil : Qpro); // avoid division by zero
+        spro = 100.0f * sqrtf (Mpro / Qpro);
+    } else { /*if(alg == 3) */
+        Qpro = curveQ[ (float) (Qpro * params.coefQ)] / params.coefQ; //brightness and contrast
+        float Mp, sres;
+        Mp = Mpro / 100.0f;
+        curvecolorfloat (params.mchr, Mp, sres, 2.5f);
+        float dred = 100.f; //in C mode
+        float protect_red = 80.0f; // in C mode
+        dred *= coe; //in M mode
+        protect_red *= coe; //M mode
+        Color::skinredfloat (Jpro, hpro, sres, Mp, dred, protect_red, 0, rstprotection, 100.f, Mpro);
+        Jpro = SQR ((10.f * Qpro) / params.wh);
+        Cpro = Mpro / coe;
+        Qpro = (Qpro == 0.f ? epsil : Qpro); // avoid division by zero
+        spro = 100.0f * sqrtf (Mpro / Qpro);
+
+        if (Jpro > 99.9f) {
+            Jpro = 99.9f;
+        }
+
+        Jpro = curveJ[ (float) (Jpro * 327.68f)]; //lightness CIECAM02 + contrast
+        float Sp = spro / 100.0f;
+        curvecolorfloat (params.schr, Sp, sres, 1.5f);
+        dred = 100.f; // in C mode
+        protect_red = 80.0f; // in C mode
+        dred = 100.0f * sqrtf ((dred * coe) / Q);
+        protect_red = 100.0f * sqrtf ((protect_red * coe) / Q);
+        Color::skinredfloat (Jpro, hpro, sres, Sp, dred, protect_red, 0, rstprotection, 100.f, spro);
+        Qpro = params.QproFactor * sqrtf (Jpro);
+        float Cp = (spro * spro * Qpro) / (1000000.f);
+        Cpro = Cp * 100.f;
+        curvecolorfloat (params.chr, Cp, sres, 1.8f);
+        Color::skinredfloat (Jpro, hpro, sres, Cp, 55.f, 30.f, 1, rstprotection, 100.f, Cpro);
+        hpro = hpro + params.hue;
+
+        if (hpro < 0.0f) {
+            hpro += 360.0f;    //hue
+        }
+    }
+
+    J = Jpro;
+    C = Cpro;
+    h = hpro;
+    Q = Qpro;
+    M = Mpro;
+    s = spro;
+}
+
+#ifdef __SSE2__
+namespace
+{
+
+// Vectorized curve[index] with the results of LUTf::operator[](float) for all clip flags. The vector operator[] of LUTf
+// always clips, but some CAM curves extrapolate above or below.
+vfloat camCurveValue(const LUTf &curve, vfloat index)
+{
+    const vfloat value = (curve.getClip() & LUT_CLIP_BELOW) ? curve.cb(index) : curve(index);
+
+    if (curve.getClip() & LUT_CLIP_ABOVE) {
+        const int upperBound = curve.getUpperBound();
+        return vself(vmaskf_gt(index, F2V(upperBound - 1)), F2V(curve[upperBound]), value);
+    }
+
+    return value;
+}
+
+}
+
+void Ciecam02::jchqmsAdjustfloat ( vfloat &J, vfloat &C, vfloat &h, vfloat &Q, vfloat &M, vfloat &s, const CamAdjustParams &params)
+{
+    // same as the scalar version, see there for comments
+    const LUTf &curveJ = *params.curveJ;
+    const LUTf &curveQ = *params.curveQ;
+    const float rstprotection = params.rstprotection;
+    const vfloat coev = F2V (params.coe);
+    const vfloat c327d68v = F2V (327.68f);
+    const vfloat QproFactorv = F2V (params.QproFactor);
+
+    vfloat Jpro = J;
+    vfloat Cpro = C;
+    vfloat hpro = h;
+    vfloat Qpro = Q;
+    vfloat Mpro = M;
+    vfloat spro = s;
+    vfloat sres;
+
+    if (params.alg == 0) {
+        Jpro = camCurveValue(curveJ, Jpro * c327d68v);
+        Qpro = QproFactorv * vsqrtf (Jpro);
+        const vfloat Cp = (spro * spro * Qpro) / F2V (1000000.f);
+        Cpro = Cp * F2V (100.f);
+        curvecolorfloat (params.chr, Cp, sres, F2V (1.8f));
+        Color::skinredfloat (Jpro, hpro, sres, Cp, F2V (55.f), F2V (30.f), 1, rstprotection, 100.f, Cpro);
+    } else if (params.alg == 1) {
+        Jpro = camCurveValue(curveJ, Jpro * c327d68v);
+        const vfloat Sp = spro / F2V (100.f);
+        curvecolorfloat (params.schr, Sp, sres, F2V (1.5f));
+        const vfloat dred = F2V (100.f) * vsqrtf (F2V (100.f * params.coe) / Qpro);
+        const vfloat protect_red = F2V (100.f) * vsqrtf (F2V (80.f * params.coe) / Qpro);
+        Color::skinredfloat (Jpro, hpro, sres, Sp, dred, protect_red, 0, rstprotection, 100.f, spro);
+        Qpro = QproFactorv * vsqrtf (Jpro);
+        Cpro = (spro * spro * Qpro) / F2V (10000.f);
+    } else {
+        const vfloat coefQv = F2V (params.coefQ);
+        Qpro = camCurveValue(curveQ, Qpro * coefQv) / coefQv;
+        const vfloat Mp = Mpro / F2V (100.f);
+        curvecolorfloat (params.mchr, Mp, sres, F2V (2.5f));
+        Color::skinredfloat (Jpro, hpro, sres, Mp, F2V (100.f * params.coe), F2V (80.f * params.coe), 0, rstprotection, 100.f, Mpro);
+        Jpro = SQRV ((F2V (10.f) * Qpro) / F2V (params.wh));
+        Cpro = Mpro / coev;
+        Qpro = vself (vmaskf_eq (Qpro, ZEROV), F2V (0.0001f), Qpro); // avoid division by zero
+        spro = F2V (100.f) * vsqrtf (Mpro / Qpro);
+
+        if (params.alg == 3) {
+            Jpro = camCurveValue(curveJ, vminf (Jpro, F2V (99.9f)) * c327d68v);
+            const vfloat Sp = spro / F2V (100.f);
+            curvecolorfloat (params.schr, Sp, sres, F2V (1.5f));
+            const vfloat dred = F2V (100.f) * vsqrtf (F2V (100.f * params.coe) / Q);
+            const vfloat protect_red = F2V (100.f) * vsqrtf (F2V (80.f * params.coe) / Q);
+            Color::skinredfloat (Jpro, hpro, sres, Sp, dred, protect_red, 0, rstprotection, 100.f, spro);
+            Qpro = QproFactorv * vsqrtf (Jpro);
+            const vfloat Cp = (spro * spro * Qpro) / F2V (1000000.f);
+            Cpro = Cp * F2V (100.f);
+            curvecolorfloat (params.chr, Cp, sres, F2V (1.8f));
+            Color::skinredfloat (Jpro, hpro, sres, Cp, F2V (55.f), F2V (30.f), 1, rstprotection, 100.f, Cpro);
+            hpro += F2V (params.hue);
+            hpro = vself (vmaskf_lt (hpro, ZEROV), hpro + F2V (360.f), hpro);
+        }
+    }
+
+    J = Jpro;
+    C = Cpro;
+    h = hpro;
+    Q = Qpro;
+    M = Mpro;
+    s = spro;
+}
+#endif
+
+void Ciecam02::jchqmsAdjustfloat ( float *J, float *C, float *h, float *Q, float *M, float *s, int width, const CamAdjustParams &params)
+{
+    int k = 0;
+#ifdef __SSE2__
+
+    for (; k < width - 3; k += 4) {
+        vfloat Jv = LVFU (J[k]);
+        vfloat Cv = LVFU (C[k]);
+        vfloat hv = LVFU (h[k]);
+        vfloat Qv = LVFU (Q[k]);
+        vfloat Mv = LVFU (M[k]);
+        vfloat sv = LVFU (s[k]);
+        jchqmsAdjustfloat (Jv, Cv, hv, Qv, Mv, sv, params);
+        STVFU (J[k], Jv);
+        STVFU (C[k], Cv);
+        STVFU (h[k], hv);
+        STVFU (Q[k], Qv);
+        STVFU (M[k], Mv);
+        STVFU (s[k], sv);
+    }
+
+#endif
+
+    for (; k < width; ++k) {
+        jchqmsAdjustfloat (J[k], C[k], h[k], Q[k], M[k], s[k], params);
+    }
+}
 }
@@ -32,6 +32,25 @@ using LUTf = LUT<float>;
 namespace rtengine
 {
 
+/**
+ * Settings of the lightness/brightness, chroma/saturation/colourfulness and hue adjustments
+ * which are applied between the forward and the inverse CIECAM transform, see Ciecam02::jchqmsAdjustfloat
+ */
+struct CamAdjustParams {
+    int alg;                // 0: J + C, 1: J + s, 2: Q + M, 3: J + Q + C + s + M + hue
+    float chr;              // chroma
+    float schr;             // saturation
+    float mchr;             // colourfulness
+    float rstprotection;    // skin tones protection
+    float hue;              // hue rotation in degrees, alg 3 only
+    float coe;              // pow(fl, 0.25)
+    float coefQ;            // 32767 / wh
+    float QproFactor;       // (0.4 / c) * (aw + 4)
+    float wh;
+    const LUTf *curveJ;     // lightness and contrast, used by alg 0, 1 and 3
+    const LUTf *curveQ;     // brightness and contrast, used by alg 2 and 3
+};
+
 class Ciecam02
 {//also used with Ciecam16
 private:
@@ -65,6 +84,9 @@ private:
 public:
     Ciecam02 () {}
     static void curvecolorfloat (float satind, float satval, float &sres, float parsat);
+#ifdef __SSE2__
+    static void curvecolorfloat (float satind, vfloat satval, vfloat &sres, vfloat parsat);
+#endif
     static void curveJfloat (float br, float contr, const LUTu & histogram, LUTf & outCurve ) ;
 
     /**
@@ -109,6 +131,16 @@ public:
                                            vfloat c, vfloat nc, vfloat n, vfloat nbb, vfloat ncb, vfloat pfl, vfloat cz, vfloat d, int c16);
 
 
+#endif
+
+    /**
+     * Adjustments of J, C, h, Q, M and s between the forward and the inverse transform (in place).
+     * The row version processes width values of each buffer, 4 at a time when SSE2 is available.
+     */
+    static void jchqmsAdjustfloat ( float &J, float &C, float &h, float &Q, float &M, float &s, const CamAdjustParams &params);
+    static void jchqmsAdjustfloat ( float *J, float *C, float *h, float *Q, float *M, float *s, int width, const CamAdjustParams &params);
+#ifdef __SSE2__
+    static void jchqmsAdjustfloat ( vfloat &J, vfloat &C, vfloat &h, vfloat &Q, vfloat &M, vfloat &s, const CamAdjustParams &params);
 #endif
 
 };
@@ -2026,6 +2026,70 @@ void Color::skinredfloat ( float J, float h, float sres, float Sp, float dred, f
     }
 }
 
+#ifdef __SSE2__
+void Color::skinredfloat ( vfloat J, vfloat h, vfloat sres, vfloat Sp, vfloat dred, vfloat protect_red, int sk, float rstprotection, float ko, vfloat &s)
+{
+    // same as the scalar version, all branches are evaluated and merged using masks
+    const vmask range1 = vandm(vmaskf_gt(h, F2V(8.6f)), vmaskf_le(h, F2V(74.f)));
+    const vmask range2 = vandm(vmaskf_gt(h, ZEROV), vmaskf_le(h, F2V(8.6f)));
+    const vmask range3 = vandm(vmaskf_gt(h, F2V(355.f)), vmaskf_le(h, F2V(360.f)));
+    const vmask range4 = vandm(vmaskf_gt(h, F2V(74.f)), vmaskf_lt(h, F2V(95.f)));
+    const vmask doskin = vorm(vorm(range1, range2), vorm(range3, range4));
+
+    if (!_mm_movemask_ps((vfloat)doskin)) {
+        // no skin tones, which is the most common case
+        s = F2V(ko) * sres;
+        return;
+    }
+
+    vfloat HH = F2V(0.30f / 21.0f) * h + F2V(0.24285f);
+    HH = vself(range3, F2V(0.11f / 5.0f) * h - F2V(7.96f), HH);
+    HH = vself(range2, F2V(0.19f / 8.6f) * h - F2V(0.04f), HH);
+    HH = vself(range1, F2V(1.15f / 65.4f) * h - F2V(0.0012f), HH);
+
+    const vfloat onev = F2V(1.f);
+    const vfloat deltaHH = F2V(0.3f);
+    const vfloat chromapro = sres / Sp;
+
+    if (sk == 1) { //in C mode to adapt dred to J
+        dred = F2V(40.f);
+        dred = vself(vmaskf_lt(J, F2V(70.f)), F2V(145.f) - F2V(1.5f) * J, dred);
+        dred = vself(vmaskf_lt(J, F2V(60.f)), F2V(55.f), dred);
+        dred = vself(vmaskf_lt(J, F2V(22.f)), F2V(2.5f) * J, dred);
+        dred = vself(vmaskf_lt(J, F2V(16.f)), F2V(40.f), dred);
+    }
+
+    // see scalered
+    float scale = 0.999000999f;
+    vfloat scaleext = onev;
+
+    if (rstprotection < 99.9999f) {
+        scale = rstprotection / 100.1f;
+        const vfloat scalev = F2V(scale);
+        const vmask redYellow = vandm(vmaskf_lt(HH, F2V(1.3f) + deltaHH), vmaskf_ge(HH, F2V(1.3f)));
+        const vmask redPurple = vandm(vmaskf_lt(HH, F2V(0.15f)), vmaskf_gt(HH, F2V(0.15f) - deltaHH));
+        scaleext = vself(redYellow, (HH * (onev - scalev) + deltaHH - (F2V(1.3f) + deltaHH) * (onev - scalev)) / deltaHH, scaleext);
+        scaleext = vself(redPurple, (HH * (scalev - onev) + deltaHH - (F2V(0.15f) - deltaHH) * (scalev - onev)) / deltaHH, scaleext);
+    }
+
+    const vmask increase = vmaskf_gt(chromapro, onev);
+    const vfloat interm = chromapro - onev;
+    const vfloat factorskin = vself(increase, onev + interm * F2V(scale), chromapro);
+    const vfloat factorskinext = vself(increase, onev + interm * scaleext, chromapro);
+
+    // see transitred
+    const vmask inner = vandm(vmaskf_ge(HH, F2V(0.15f)), vmaskf_lt(HH, F2V(1.3f)));
+    const vmask extended = vandm(vmaskf_gt(HH, F2V(0.15f) - deltaHH), vmaskf_lt(HH, F2V(1.3f) + deltaHH));
+    const vfloat factorskinsel = vself(inner, factorskin, factorskinext);
+    const vfloat dredprotect = dred + protect_red;
+    vfloat factor = chromapro;
+    factor = vself(vandm(extended, vmaskf_lt(s, dredprotect)), ((chromapro - factorskinsel) * s + chromapro * protect_red - dredprotect * (chromapro - factorskinsel)) / protect_red, factor);
+    factor = vself(vandm(extended, vmaskf_lt(s, dred)), factorskinsel, factor);
+
+    s = vself(doskin, s * factor, F2V(ko) * sres);
+}
+#endif
+
 void Color::scalered ( const float rstprotection, const float param, const float limit, const float HH, const float deltaHH, float &scale, float &scaleext)
 {
     if(rstprotection < 99.9999f) {
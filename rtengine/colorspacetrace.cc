@@ -0,0 +1,98 @@
+/*
+ *  This file is part of RawTherapee.
+ *
+ *  RawTherapee is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RawTherapee is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RawTherapee.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <cstdio>
+
+#include <glibmm/ustring.h>
+
+#include "colorspacetrace.h"
+#include "imagefloat.h"
+#include "improcfun.h"
+#include "labimage.h"
+#include "settings.h"
+
+namespace
+{
+
+const char* spaceName(rtengine::ColorSpaceTrace::Space space)
+{
+    return space == rtengine::ColorSpaceTrace::Space::RGB ? "RGB" : "Lab";
+}
+
+}
+
+namespace rtengine
+{
+
+ColorSpaceTrace::ColorSpaceTrace(const char* pipeline) :
+    pipeline(pipeline),
+    space(Space::RGB)
+{
+}
+
+void ColorSpaceTrace::rgb2lab(ImProcFunctions& ipf, const Imagefloat& src, LabImage& dst, const Glib::ustring& workingSpace, const char* stage)
+{
+    ipf.rgb2lab(src, dst, workingSpace);
+    converted(Space::RGB, Space::LAB, stage, src.getWidth(), src.getHeight());
+}
+
+void ColorSpaceTrace::lab2rgb(ImProcFunctions& ipf, const LabImage& src, Imagefloat& dst, const Glib::ustring& workingSpace, const char* stage)
+{
+    ipf.lab2rgb(src, dst, workingSpace);
+    converted(Space::LAB, Space::RGB, stage, dst.getWidth(), dst.getHeight());
+}
+
+void ColorSpaceTrace::converted(Space from, Space to, const char* stage, int width, int height)
+{
+    entries.push_back({from, to, stage, width, height, false});
+    space = to;
+}
+
+void ColorSpaceTrace::elided(Space from, Space to, const char* stage, int width, int height)
+{
+    entries.push_back({from, to, stage, width, height, true});
+}
+
+unsigned int ColorSpaceTrace::getConversions() const
+{
+    unsigned int count = 0;
+
+    for (const auto& entry : entries) {
+        count += !entry.elided;
+    }
+
+    return count;
+}
+
+unsigned int ColorSpaceTrace::getElisions() const
+{
+    return entries.size() - getConversions();
+}
+
+void ColorSpaceTrace::print() const
+{
+    if (!settings->verbose || entries.empty()) {
+        return;
+    }
+
+    printf("Color space conversions (%s): %u performed, %u elided\n", pipeline, getConversions(), getElisions());
+
+    for (const auto& entry : entries) {
+        printf("    %s -> %s %-12s %dx%d%s\n", spaceName(entry.from), spaceName(entry.to), entry.stage, entry.width, entry.height, entry.elided ? " (elided)" : "");
+    }
+}
+
+}
@@ -0,0 +1,120 @@
+/*
+ *  This file is part of RawTherapee.
+ *
+ *  RawTherapee is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RawTherapee is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RawTherapee.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <vector>
+
+#include "noncopyable.h"
+
+namespace Glib
+{
+class ustring;
+}
+
+namespace rtengine
+{
+
+class ImProcFunctions;
+class Imagefloat;
+class LabImage;
+
+/*
+ * Plans the colour spaces of the stages of one pipeline run (preview, detail window or output).
+ *
+ * Some tools work in Lab on data which is otherwise held in working RGB. When such tools follow each
+ * other, the frame does not need to go back to RGB in between. Currently planned:
+ *
+ *   CBDL "before black-and-white" directly followed by Local Adjustments: CBDL is applied on the Lab
+ *   buffer of Local Adjustments, saving a full frame Lab -> RGB -> Lab round trip.
+ */
+class ColorSpacePlan
+{
+public:
+    ColorSpacePlan(bool cbdlBefore, bool locallab) :
+        cbdlBefore(cbdlBefore),
+        locallab(locallab)
+    {
+    }
+
+    // CBDL runs with its own RGB -> Lab -> RGB round trip
+    bool cbdlStandalone() const
+    {
+        return cbdlBefore && !locallab;
+    }
+
+    // CBDL runs on the Lab input of Local Adjustments
+    bool cbdlInLocallab() const
+    {
+        return cbdlBefore && locallab;
+    }
+
+private:
+    const bool cbdlBefore;
+    const bool locallab;
+};
+
+/*
+ * Keeps track of the colour space the frame of one pipeline run is held in and records
+ * every full frame conversion performed (or avoided) during the run.
+ * The report is printed by print() in verbose mode.
+ */
+class ColorSpaceTrace :
+    public NonCopyable
+{
+public:
+    enum class Space {
+        RGB,
+        LAB
+    };
+
+    explicit ColorSpaceTrace(const char* pipeline);
+
+    // convert using ImProcFunctions and record the conversion
+    void rgb2lab(ImProcFunctions& ipf, const Imagefloat& src, LabImage& dst, const Glib::ustring& workingSpace, const char* stage);
+    void lab2rgb(ImProcFunctions& ipf, const LabImage& src, Imagefloat& dst, const Glib::ustring& workingSpace, const char* stage);
+
+    // record a conversion performed inside a stage, e.g. rgbProc
+    void converted(Space from, Space to, const char* stage, int width, int height);
+    // record a conversion which was avoided by the plan
+    void elided(Space from, Space to, const char* stage, int width, int height);
+
+    Space getSpace() const
+    {
+        return space;
+    }
+
+    unsigned int getConversions() const;
+    unsigned int getElisions() const;
+
+    void print() const;
+
+private:
+    struct Entry {
+        Space from;
+        Space to;
+        const char* stage;
+        int width;
+        int height;
+        bool elided;
+    };
+
+    const char* const pipeline;
+    Space space;
+    std::vector<Entry> entries;
+};
+
+}
@@ -0,0 +1,308 @@
+/*
+ *  This file is part of RawTherapee.
+ *
+ *  RawTherapee is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RawTherapee is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RawTherapee.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ *  Declaration of cache-resident compact Lookup Tables
+ *
+ *  A LUTf of 65536 entries occupies 256 KB. Per-pixel stages which use several of them at once
+ *  (rgbProc for example) evict each other from L1/L2 on nearly every lookup.
+ *  CompactLUTf resamples such a LUTf every 8, 16 or 32 entries (a 65536 entries LUT becomes
+ *  2049..8193 nodes, 8..32 KB) and reconstructs the values in between by cubic (Catmull-Rom)
+ *  interpolation.
+ *
+ *  The reconstruction error against the source LUT is measured at build time at every integer
+ *  and half-integer index. The coarsest stride which stays below the requested maximum absolute
+ *  error is used. If no stride meets the requirement, the compact LUT is left empty
+ *  (operator bool returns false) and the caller has to use the source LUT.
+ *
+ *  Usage:
+ *
+ *      CompactLUTf compact(source, 0.5f);
+ *
+ *      if (compact) {
+ *          float value = compact[2.5f];        // same result as source[2.5f] +/- 0.5, clip flags of source are respected
+ *          vfloat valuev = compact[indexv];    // same semantics as source[indexv]
+ *      }
+ *
+ *  The vectorized accessors mirror those of LUTf: operator[](vfloat) clips at both bounds,
+ *  operator()(vfloat) does not clip and cb(vfloat) clips only at the lower bound.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "LUT.h"
+#include "opthelper.h"
+
+class CompactLUTf
+{
+private:
+    std::vector<float> nodes;
+    const float *data;      // points to nodes[1], so data[-1] is valid
+    int lastSegment;        // index of the last node which starts a segment
+    unsigned int clip;
+    unsigned int stride;
+    float invStride;
+    float upperBoundf;
+    float maxsf;
+    float lowValue;         // source[0]
+    float lowSlope;         // source[1] - source[0], used for extrapolation below 0
+    float highValue;        // source[upperBound]
+    float highBase;         // source[upperBound - 1]
+    float highSlope;        // source[upperBound] - source[upperBound - 1], used for extrapolation above upperBound
+    float error;            // measured maximum absolute error against the source LUT
+#ifdef __SSE2__
+    alignas(16) vfloat invStridev;
+    alignas(16) vfloat upperBoundv;
+    alignas(16) vfloat maxsv;
+    alignas(16) vfloat lastSegmentv;
+    alignas(16) vfloat lowValuev;
+    alignas(16) vfloat lowSlopev;
+    alignas(16) vfloat highBasev;
+    alignas(16) vfloat highSlopev;
+#endif
+
+    void fill(const LUTf &source, unsigned int s)
+    {
+        const unsigned int upperBound = source.getUpperBound();
+        // nodes 0 .. n - 1 cover [0, (n - 1) * s] >= [0, upperBound]
+        const int n = (upperBound + s - 1) / s + 1;
+
+        // one node before the first one and two after the last one to feed the cubic interpolation at the borders
+        nodes.assign(n + 3, 0.f);
+        data = nodes.data() + 1;
+        stride = s;
+        invStride = 1.f / s;
+        lastSegment = n - 2;
+
+        for (int k = -1; k <= n + 1; ++k) {
+            // use the interpolating accessor of the source, this way nodes outside the source range follow its clip flags
+            nodes[k + 1] = source[static_cast<float>(k) * s];
+        }
+
+#ifdef __SSE2__
+        invStridev = F2V(invStride);
+        lastSegmentv = F2V(lastSegment);
+#endif
+    }
+
+    float measureError(const LUTf &source) const
+    {
+        float maxErr = 0.f;
+
+        for (unsigned int i = 0; i < source.getSize(); ++i) {
+            const float x = i;
+            maxErr = std::max(maxErr, std::fabs(interpolate(x) - source[x]));
+
+            if (i < source.getUpperBound()) {
+                maxErr = std::max(maxErr, std::fabs(interpolate(x + 0.5f) - source[x + 0.5f]));
+            }
+        }
+
+        return maxErr;
+    }
+
+    // index must be in [0, upperBound]
+    float interpolate(float index) const
+    {
+        const float pos = index * invStride;
+        const int i = std::min(static_cast<int>(pos), lastSegment);
+        const float f = pos - i;
+        const float p0 = data[i - 1];
+        const float p1 = data[i];
+        const float p2 = data[i + 1];
+        const float p3 = data[i + 2];
+        return p1 + 0.5f * f * (p2 - p0 + f * (2.f * p0 - 5.f * p1 + 4.f * p2 - p3 + f * (3.f * (p1 - p2) + p3 - p0)));
+    }
+
+#ifdef __SSE2__
+    template<bool clipBelow, bool clipAbove>
+    vfloat interpolate(vfloat indexv) const
+    {
+        const vfloat posv = vclampf(indexv, ZEROV, upperBoundv) * invStridev; // this automagically uses ZEROV in case indexv is NaN
+        const vfloat segmentv = vminf(_mm_cvtepi32_ps(_mm_cvttps_epi32(posv)), lastSegmentv);
+        int indexArray[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&indexArray[0]), _mm_cvttps_epi32(segmentv));
+
+        // Load the four nodes around each index and transpose, so that p0..p3 hold the nodes i-1..i+2 of each lane
+        vfloat p0 = LVFU(data[indexArray[0] - 1]);
+        vfloat p1 = LVFU(data[indexArray[1] - 1]);
+        vfloat p2 = LVFU(data[indexArray[2] - 1]);
+        vfloat p3 = LVFU(data[indexArray[3] - 1]);
+        _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+
+        const vfloat fv = posv - segmentv;
+        const vfloat halfv = F2V(0.5f);
+        const vfloat twov = F2V(2.f);
+        const vfloat threev = F2V(3.f);
+        const vfloat fourv = F2V(4.f);
+        const vfloat fivev = F2V(5.f);
+        vfloat resultv = p1 + halfv * fv * (p2 - p0 + fv * (twov * p0 - fivev * p1 + fourv * p2 - p3 + fv * (threev * (p1 - p2) + p3 - p0)));
+
+        if (!clipBelow) {
+            resultv = vself(vmaskf_lt(indexv, ZEROV), lowValuev + lowSlopev * indexv, resultv);
+        }
+
+        if (!clipAbove) {
+            resultv = vself(vmaskf_gt(indexv, upperBoundv), highBasev + highSlopev * (indexv - maxsv), resultv);
+        }
+
+        return resultv;
+    }
+#endif
+
+public:
+    CompactLUTf() :
+        data(nullptr),
+        lastSegment(0),
+        clip(0),
+        stride(0),
+        invStride(0.f),
+        upperBoundf(0.f),
+        maxsf(0.f),
+        lowValue(0.f),
+        lowSlope(0.f),
+        highValue(0.f),
+        highBase(0.f),
+        highSlope(0.f),
+        error(0.f)
+    {
+    }
+
+    CompactLUTf(const LUTf &source, float maxError) : CompactLUTf()
+    {
+        build(source, maxError);
+    }
+
+    CompactLUTf(const CompactLUTf&) = delete;
+    CompactLUTf& operator=(const CompactLUTf&) = delete;
+
+    /** @brief Build the compact representation of source
+     *  @param source LUT to be resampled, its clip flags are taken over
+     *  @param maxError maximum allowed absolute difference to source
+     *  @return true if a compact representation within maxError was found
+     */
+    bool build(const LUTf &source, float maxError)
+    {
+        reset();
+
+        if (!source || source.getSize() < 64) {
+            return false;
+        }
+
+        const unsigned int upperBound = source.getUpperBound();
+        clip = source.getClip();
+        upperBoundf = upperBound;
+        maxsf = upperBound - 1;
+        lowValue = source[0];
+        lowSlope = source[1] - source[0];
+        highValue = source[upperBound];
+        highBase = source[upperBound - 1];
+        highSlope = source[upperBound] - source[upperBound - 1];
+#ifdef __SSE2__
+        upperBoundv = F2V(upperBoundf);
+        maxsv = F2V(maxsf);
+        lowValuev = F2V(lowValue);
+        lowSlopev = F2V(lowSlope);
+        highBasev = F2V(highBase);
+        highSlopev = F2V(highSlope);
+#endif
+
+        for (unsigned int s = 32; s >= 8; s /= 2) {
+            if (s * 8 > source.getSize()) {
+                continue;
+            }
+
+            fill(source, s);
+            error = measureError(source);
+
+            if (error <= maxError) {
+                return true;
+            }
+        }
+
+        reset();
+        return false;
+    }
+
+    void reset()
+    {
+        nodes.clear();
+        nodes.shrink_to_fit();
+        data = nullptr;
+        stride = 0;
+        error = 0.f;
+    }
+
+    explicit operator bool() const
+    {
+        return data != nullptr;
+    }
+
+    /** @brief Get the distance (in source entries) between two nodes, 0 if empty */
+    unsigned int getStride() const
+    {
+        return stride;
+    }
+
+    /** @brief Get the number of nodes, including the border nodes */
+    unsigned int getSize() const
+    {
+        return nodes.size();
+    }
+
+    /** @brief Get the measured maximum absolute difference to the source LUT */
+    float getMaxError() const
+    {
+        return error;
+    }
+
+    // use with float indices, same semantics as LUTf::operator[](float)
+    float operator[](float index) const
+    {
+        if (index < 0.f) {
+            return (clip & LUT_CLIP_BELOW) ? lowValue : lowValue + lowSlope * index;
+        } else if (index > upperBoundf) {
+            return (clip & LUT_CLIP_ABOVE) ? highValue : highBase + highSlope * (index - maxsf);
+        }
+
+        return interpolate(index);
+    }
+
+#ifdef __SSE2__
+    // clips at lower and upper bound, same semantics as LUTf::operator[](vfloat)
+    vfloat operator[](vfloat indexv) const
+    {
+        return interpolate<true, true>(indexv);
+    }
+
+    // does not clip, same semantics as LUTf::operator()(vfloat)
+    vfloat operator()(vfloat indexv) const
+    {
+        return interpolate<false, false>(indexv);
+    }
+
+    // clips only at lower bound, same semantics as LUTf::cb(vfloat)
+    vfloat cb(vfloat indexv) const
+    {
+        return interpolate<true, false>(indexv);
+    }
+#endif
+};
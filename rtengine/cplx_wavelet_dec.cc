@@ -18,6 +18,9 @@
  *  2012 Emil Martinec <ejmartin@uchicago.edu>
  */
 
+#include <algorithm>
+#include <new>
+
 #include "cplx_wavelet_dec.h"
 
 namespace rtengine
@@ -39,5 +42,63 @@ wavelet_decomposition::~wavelet_decomposition()
     }
 }
 
+wavelet_decomposition::wavelet_decomposition() :
+    lvltot(0),
+    subsamp(0),
+    m_w(0),
+    m_h(0),
+    wavfilt_len(0),
+    wavfilt_offset(0),
+    wavfilt_anal(nullptr),
+    wavfilt_synth(nullptr),
+    coeff0(nullptr),
+    memoryAllocationFailed(false),
+    wavelet_decomp{}
+{
+}
+
+std::unique_ptr<wavelet_decomposition> wavelet_decomposition::clone() const
+{
+    std::unique_ptr<wavelet_decomposition> copy(new wavelet_decomposition);
+
+    copy->lvltot = lvltot;
+    copy->subsamp = subsamp;
+    copy->m_w = m_w;
+    copy->m_h = m_h;
+    copy->wavfilt_len = wavfilt_len;
+    copy->wavfilt_offset = wavfilt_offset;
+    copy->wavfilt_anal = new float[2 * wavfilt_len];
+    copy->wavfilt_synth = new float[2 * wavfilt_len];
+    std::copy(wavfilt_anal, wavfilt_anal + 2 * wavfilt_len, copy->wavfilt_anal);
+    std::copy(wavfilt_synth, wavfilt_synth + 2 * wavfilt_len, copy->wavfilt_synth);
+    copy->memoryAllocationFailed = memoryAllocationFailed;
+
+    if (memoryAllocationFailed || !coeff0) {
+        copy->memoryAllocationFailed = true;
+        copy->lvltot = -1; // nothing to delete in the destructor
+        return copy;
+    }
+
+    const std::size_t coeff0Size = static_cast<std::size_t>(m_w / 2 + 1) * (m_h / 2 + 1);
+    copy->coeff0 = new (std::nothrow) internal_type[coeff0Size];
+
+    if (!copy->coeff0) {
+        copy->memoryAllocationFailed = true;
+        copy->lvltot = -1;
+        return copy;
+    }
+
+    std::copy(coeff0, coeff0 + coeff0Size, copy->coeff0);
+
+    for (int i = 0; i <= lvltot; ++i) {
+        copy->wavelet_decomp[i] = wavelet_decomp[i] ? new wavelet_level<internal_type>(*wavelet_decomp[i]) : nullptr;
+
+        if (copy->wavelet_decomp[i] && copy->wavelet_decomp[i]->memoryAllocationFailed) {
+            copy->memoryAllocationFailed = true;
+        }
+    }
+
+    return copy;
 }
 
+}
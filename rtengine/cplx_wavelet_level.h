@@ -20,6 +20,7 @@
 */
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
 #include "rt_math.h"
 #include "opthelper.h"
@@ -110,6 +111,22 @@ public:
 
     }
 
+    // deep copy, used by wavelet_decomposition::clone()
+    wavelet_level(const wavelet_level& other)
+        : lvl(other.lvl), subsamp_out(other.subsamp_out), numThreads(other.numThreads), skip(other.skip), bigBlockOfMemory(true), memoryAllocationFailed(other.memoryAllocationFailed), wavcoeffs(nullptr), m_w(other.m_w), m_h(other.m_h), m_w2(other.m_w2), m_h2(other.m_h2)
+    {
+        const int n = m_w2 * m_h2;
+        wavcoeffs = create(n);
+
+        if (!memoryAllocationFailed) {
+            for (int j = 1; j < 4; j++) {
+                std::copy(other.wavcoeffs[j], other.wavcoeffs[j] + n, wavcoeffs[j]);
+            }
+        }
+    }
+
+    wavelet_level& operator=(const wavelet_level&) = delete;
+
     ~wavelet_level()
     {
         destroy(wavcoeffs);
@@ -19,6 +19,7 @@
  */
 
 #include "cieimage.h"
+#include "colorspacetrace.h"
 #include "curves.h"
 #include "dcp.h"
 #include "dcrop.h"
@@ -143,6 +144,7 @@ void Crop::update(int todo)
     MyMutex::MyLock cropLock(cropMutex);
 
     ProcParams& params = *parent->params;
+    ColorSpaceTrace csTrace("detail");
 //       CropGUIListener* cropgl;
 
     // No need to update todo here, since it has already been changed in ImprocCoordinator::updatePreviewImage,
@@ -800,14 +802,19 @@ void Crop::update(int todo)
         transCrop = nullptr;
     }
 
-    if ((todo & (M_TRANSFORM | M_RGBCURVE))  && params.dirpyrequalizer.cbdlMethod == "bef" && params.dirpyrequalizer.enabled && !params.colorappearance.enabled) {
+    const ColorSpacePlan csPlan(
+        (todo & (M_TRANSFORM | M_RGBCURVE)) && params.dirpyrequalizer.cbdlMethod == "bef" && params.dirpyrequalizer.enabled && !params.colorappearance.enabled,
+        (todo & (M_AUTOEXP | M_RGBCURVE)) && params.locallab.enabled && !params.locallab.spots.empty()
+    );
+
+    if (csPlan.cbdlStandalone()) {
 
         const int W = baseCrop->getWidth();
         const int H = baseCrop->getHeight();
         LabImage labcbdl(W, H);
-        parent->ipf.rgb2lab(*baseCrop, labcbdl, params.icm.workingProfile);
+        csTrace.rgb2lab(parent->ipf, *baseCrop, labcbdl, params.icm.workingProfile, "cbdl");
         parent->ipf.dirpyrequalizer(&labcbdl, skip);
-        parent->ipf.lab2rgb(labcbdl, *baseCrop, params.icm.workingProfile);
+        csTrace.lab2rgb(parent->ipf, labcbdl, *baseCrop, params.icm.workingProfile, "cbdl");
 
     }
 
@@ -815,7 +822,14 @@ void Crop::update(int todo)
     if ((todo & (M_AUTOEXP | M_RGBCURVE)) && params.locallab.enabled && !params.locallab.spots.empty()) {
     
         //I made a little change here. Rather than have luminanceCurve (and others) use in/out lab images, we can do more if we copy right here.
-        parent->ipf.rgb2lab(*baseCrop, *laboCrop, params.icm.workingProfile);
+        csTrace.rgb2lab(parent->ipf, *baseCrop, *laboCrop, params.icm.workingProfile, "locallab");
+
+        if (csPlan.cbdlInLocallab()) {
+            // the crop is in Lab already, no need to convert back and forth for CBDL
+            parent->ipf.dirpyrequalizer(laboCrop, skip);
+            csTrace.elided(ColorSpaceTrace::Space::LAB, ColorSpaceTrace::Space::RGB, "cbdl", laboCrop->W, laboCrop->H);
+            csTrace.elided(ColorSpaceTrace::Space::RGB, ColorSpaceTrace::Space::LAB, "cbdl", laboCrop->W, laboCrop->H);
+        }
  
 
         labnCrop->CopyFrom(laboCrop);
@@ -1124,7 +1138,7 @@ void Crop::update(int todo)
                 Glib::usleep(settings->cropsleep);    //wait to avoid crash when crop 100% and move window
             }
         }
-        parent->ipf.lab2rgb(*labnCrop, *baseCrop, params.icm.workingProfile);
+        csTrace.lab2rgb(parent->ipf, *labnCrop, *baseCrop, params.icm.workingProfile, "locallab");
     }
 
     if (todo & M_RGBCURVE) {
@@ -1152,6 +1166,7 @@ void Crop::update(int todo)
                             params.toneCurve.saturation, parent->rCurve, parent->gCurve, parent->bCurve, parent->colourToningSatLimit, parent->colourToningSatLimitOpacity, parent->ctColorCurve, parent->ctOpacityCurve, parent->opautili, parent->clToningcurve, parent->cl2Toningcurve,
                             parent->customToneCurve1, parent->customToneCurve2, parent->beforeToneCurveBW, parent->afterToneCurveBW, rrm, ggm, bbm,
                             parent->bwAutoR, parent->bwAutoG, parent->bwAutoB, dcpProf, as, histToneCurve);
+        csTrace.converted(ColorSpaceTrace::Space::RGB, ColorSpaceTrace::Space::LAB, "rgbProc", workingCrop->getWidth(), workingCrop->getHeight());
 
         if (workingCrop != baseCrop) {
             delete workingCrop;
@@ -1501,6 +1516,8 @@ void Crop::update(int todo)
     // all pipette buffer processing should be finished now
     PipetteBuffer::setReady();
 
+    csTrace.print();
+
     // Computing the preview image, i.e. converting from lab->Monitor color space (soft-proofing disabled) or lab->Output profile->Monitor color space (soft-proofing enabled)
     parent->ipf.lab2monitorRgb(labnCrop, cropImg);
 
@@ -27,6 +27,7 @@
 #include "../rtgui/options.h"
 #include "rawimage.h"
 #include "imagedata.h"
+#include "startuptimer.h"
 #include "utils.h"
 
 namespace rtengine
@@ -275,6 +276,24 @@ void dfInfo::updateBadPixelList( RawImage *df )
 // ************************* class DFManager *********************************
 
 void DFManager::init(const Glib::ustring& pathname)
+{
+    MyMutex::MyLock lock(initMutex);
+    pendingPath = pathname;
+    initialized = false;
+}
+
+void DFManager::ensureInitialized()
+{
+    MyMutex::MyLock lock(initMutex);
+
+    if (!initialized) {
+        StartupTimer timer("dark frames", true);
+        scan(pendingPath);
+        initialized = true;
+    }
+}
+
+void DFManager::scan(const Glib::ustring& pathname)
 {
     if (pathname.empty()) {
         return;
@@ -420,6 +439,8 @@ dfInfo* DFManager::addFileInfo (const Glib::ustring& filename, bool pool)
 
 void DFManager::getStat( int &totFiles, int &totTemplates)
 {
+    ensureInitialized();
+
     totFiles = 0;
     totTemplates = 0;
 
@@ -482,6 +503,8 @@ dfInfo* DFManager::find( const std::string &mak, const std::string &mod, int iso
 
 RawImage* DFManager::searchDarkFrame( const std::string &mak, const std::string &mod, int iso, double shut, time_t t )
 {
+    ensureInitialized();
+
     dfInfo *df = find( ((Glib::ustring)mak).uppercase(), ((Glib::ustring)mod).uppercase(), iso, shut, t );
 
     if( df ) {
@@ -493,6 +516,8 @@ RawImage* DFManager::searchDarkFrame( const std::string &mak, const std::string
 
 RawImage* DFManager::searchDarkFrame( const Glib::ustring filename )
 {
+    ensureInitialized();
+
     for ( dfList_t::iterator iter = dfList.begin(); iter != dfList.end(); ++iter ) {
         if( iter->second.pathname.compare( filename ) == 0  ) {
             return iter->second.getRawImage();
@@ -509,6 +534,8 @@ RawImage* DFManager::searchDarkFrame( const Glib::ustring filename )
 }
 std::vector<badPix> *DFManager::getHotPixels ( const Glib::ustring filename )
 {
+    ensureInitialized();
+
     for ( dfList_t::iterator iter = dfList.begin(); iter != dfList.end(); ++iter ) {
         if( iter->second.pathname.compare( filename ) == 0  ) {
             return &iter->second.getHotPixels();
@@ -519,6 +546,8 @@ std::vector<badPix> *DFManager::getHotPixels ( const Glib::ustring filename )
 }
 std::vector<badPix> *DFManager::getHotPixels ( const std::string &mak, const std::string &mod, int iso, double shut, time_t t )
 {
+    ensureInitialized();
+
     dfInfo *df = find( ((Glib::ustring)mak).uppercase(), ((Glib::ustring)mod).uppercase(), iso, shut, t );
 
     if( df ) {
@@ -592,6 +621,8 @@ int DFManager::scanBadPixelsFile( Glib::ustring filename )
 
 std::vector<badPix> *DFManager::getBadPixels ( const std::string &mak, const std::string &mod, const std::string &serial)
 {
+    ensureInitialized();
+
     bpList_t::iterator iter;
     bool found = false;
 
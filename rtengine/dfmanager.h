@@ -26,6 +26,7 @@
 #include <glibmm/ustring.h>
 
 #include "pixelsmap.h"
+#include "../rtgui/threadutils.h"
 
 namespace rtengine
 {
@@ -77,9 +78,11 @@ protected:
 class DFManager final
 {
 public:
+    // only records pathname, the directory is scanned on first use
     void init(const Glib::ustring &pathname);
     Glib::ustring getPathname()
     {
+        ensureInitialized();
         return currentPath;
     };
     void getStat( int &totFiles, int &totTemplate);
@@ -94,8 +97,12 @@ protected:
     typedef std::map<std::string, std::vector<badPix> > bpList_t;
     dfList_t dfList;
     bpList_t bpList;
-    bool initialized;
+    bool initialized = false;
+    Glib::ustring pendingPath;
     Glib::ustring currentPath;
+    MyMutex initMutex;
+    void ensureInitialized();
+    void scan(const Glib::ustring &pathname);
     dfInfo *addFileInfo(const Glib::ustring &filename, bool pool = true );
     dfInfo *find( const std::string &mak, const std::string &mod, int isospeed, double shut, time_t t );
     int scanBadPixelsFile( Glib::ustring filename );
@@ -25,6 +25,7 @@
 #include "rawimage.h"
 #include "imagedata.h"
 #include "median.h"
+#include "startuptimer.h"
 #include "utils.h"
 
 namespace rtengine
@@ -239,6 +240,24 @@ void ffInfo::updateRawImage()
 // ************************* class FFManager *********************************
 
 void FFManager::init(const Glib::ustring& pathname)
+{
+    MyMutex::MyLock lock(initMutex);
+    pendingPath = pathname;
+    initialized = false;
+}
+
+void FFManager::ensureInitialized()
+{
+    MyMutex::MyLock lock(initMutex);
+
+    if (!initialized) {
+        StartupTimer timer("flat fields", true);
+        scan(pendingPath);
+        initialized = true;
+    }
+}
+
+void FFManager::scan(const Glib::ustring& pathname)
 {
     if (pathname.empty()) {
         return;
@@ -372,6 +391,8 @@ ffInfo* FFManager::addFileInfo (const Glib::ustring& filename, bool pool)
 
 void FFManager::getStat( int &totFiles, int &totTemplates)
 {
+    ensureInitialized();
+
     totFiles = 0;
     totTemplates = 0;
 
@@ -434,6 +455,8 @@ ffInfo* FFManager::find( const std::string &mak, const std::string &mod, const s
 
 RawImage* FFManager::searchFlatField( const std::string &mak, const std::string &mod, const std::string &len, double focal, double apert, time_t t )
 {
+    ensureInitialized();
+
     ffInfo *ff = find( mak, mod, len, focal, apert, t );
 
     if( ff ) {
@@ -445,6 +468,8 @@ RawImage* FFManager::searchFlatField( const std::string &mak, const std::string
 
 RawImage* FFManager::searchFlatField( const Glib::ustring filename )
 {
+    ensureInitialized();
+
     for ( ffList_t::iterator iter = ffList.begin(); iter != ffList.end(); ++iter ) {
         if( iter->second.pathname.compare( filename ) == 0  ) {
             return iter->second.getRawImage();
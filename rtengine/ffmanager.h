@@ -25,6 +25,8 @@
 
 #include <glibmm/ustring.h>
 
+#include "../rtgui/threadutils.h"
+
 namespace rtengine
 {
 
@@ -74,9 +76,11 @@ protected:
 class FFManager final
 {
 public:
+    // only records pathname, the directory is scanned on first use
     void init(const Glib::ustring &pathname);
     Glib::ustring getPathname()
     {
+        ensureInitialized();
         return currentPath;
     };
     void getStat( int &totFiles, int &totTemplate);
@@ -86,8 +90,12 @@ public:
 protected:
     typedef std::multimap<std::string, ffInfo> ffList_t;
     ffList_t ffList;
-    bool initialized;
+    bool initialized = false;
+    Glib::ustring pendingPath;
     Glib::ustring currentPath;
+    MyMutex initMutex;
+    void ensureInitialized();
+    void scan(const Glib::ustring &pathname);
     ffInfo *addFileInfo(const Glib::ustring &filename, bool pool = true );
     ffInfo *find( const std::string &mak, const std::string &mod, const std::string &len, double focal, double apert, time_t t );
 };
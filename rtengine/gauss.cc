@@ -16,6 +16,7 @@
  *  You should have received a copy of the GNU General Public License
  *  along with RawTherapee.  If not, see <https://www.gnu.org/licenses/>.
  */
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
@@ -25,6 +26,7 @@
 #include "boxblur.h"
 #include "opthelper.h"
 #include "rt_math.h"
+#include "separablefilter.h"
 
 namespace
 {
@@ -527,117 +529,129 @@ template<class T> void gaussVertical3 (T** src, T** dst, int W, int H, const flo
 #endif
 
 #ifdef __SSE2__
-// fast gaussian approximation if the support window is large
-template<class T> void gaussHorizontalSse (T** src, T** dst, const int W, const int H, const float sigma)
-{
+// Young - van Vliet coefficients with the boundary matrix M normalized for the SSE passes
+struct YvVCoefficients {
     double b1, b2, b3, B, M[3][3];
-    calculateYvVFactors<double>(sigma, b1, b2, b3, B, M);
+};
+
+YvVCoefficients calculateSseYvVCoefficients(const float sigma)
+{
+    YvVCoefficients c;
+    calculateYvVFactors<double>(sigma, c.b1, c.b2, c.b3, c.B, c.M);
 
     for (int i = 0; i < 3; i++)
         for (int j = 0; j < 3; j++) {
-            M[i][j] *= (1.0 + b2 + (b1 - b3) * b3);
-            M[i][j] /= (1.0 + b1 - b2 + b3) * (1.0 - b1 - b2 - b3);
+            c.M[i][j] *= (1.0 + c.b2 + (c.b1 - c.b3) * c.b3);
+            c.M[i][j] /= (1.0 + c.b1 - c.b2 + c.b3) * (1.0 - c.b1 - c.b2 - c.b3);
         }
 
-    vfloat Rv;
-    vfloat Tv, Tm2v, Tm3v;
-    vfloat Bv, b1v, b2v, b3v;
-    vfloat temp2W, temp2Wp1;
-    float tmp[W][4] ALIGNED16;
-    Bv = F2V(B);
-    b1v = F2V(b1);
-    b2v = F2V(b2);
-    b3v = F2V(b3);
+    return c;
+}
 
-#ifdef _OPENMP
-    #pragma omp for nowait
-#endif
+// recursive filter on contiguous lines, the same arithmetic for the rows and the columns
+class YvVKernel
+{
+public:
+    explicit YvVKernel(const YvVCoefficients& c) :
+        B(F2V(c.B)),
+        b1(F2V(c.b1)),
+        b2(F2V(c.b2)),
+        b3(F2V(c.b3))
+    {
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++) {
+                M[i][j] = F2V(c.M[i][j]);
+            }
+    }
 
-    for (int i = 0; i < H - 3; i += 4) {
-        Tv = _mm_set_ps(src[i][0], src[i + 1][0], src[i + 2][0], src[i + 3][0]);
-        Tm3v = Tv * (Bv + b1v + b2v + b3v);
-        STVF( tmp[0][0], Tm3v );
+    template<class Lines> void filter(Lines lines, int n, vfloat* tmp) const
+    {
+        constexpr int N = Lines::N;
+        // local copies stay in registers, the stores through vfloat* may alias the members
+        const vfloat Bv = B;
+        const vfloat b1v = b1;
+        const vfloat b2v = b2;
+        const vfloat b3v = b3;
+        vfloat Rv[N];
+        vfloat Tv[N], Tm2v[N], Tm3v[N];
+        vfloat temp2W[N], temp2Wp1[N];
 
-        Tm2v = _mm_set_ps(src[i][1], src[i + 1][1], src[i + 2][1], src[i + 3][1]) * Bv + Tm3v * b1v + Tv * (b2v + b3v);
-        STVF( tmp[1][0], Tm2v );
+        for (int k = 0; k < N; k++) {
+            Tv[k] = lines.load(0, k);
+            Tm3v[k] = Tv[k] * (Bv + b1v + b2v + b3v);
+            tmp[k] = Tm3v[k];
 
-        Rv = _mm_set_ps(src[i][2], src[i + 1][2], src[i + 2][2], src[i + 3][2]) * Bv + Tm2v * b1v + Tm3v * b2v + Tv * b3v;
-        STVF( tmp[2][0], Rv );
+            Tm2v[k] = lines.load(1, k) * Bv + Tm3v[k] * b1v + Tv[k] * (b2v + b3v);
+            tmp[N + k] = Tm2v[k];
 
-        for (int j = 3; j < W; j++) {
-            Tv = Rv;
-            Rv = _mm_set_ps(src[i][j], src[i + 1][j], src[i + 2][j], src[i + 3][j]) * Bv + Tv * b1v + Tm2v * b2v + Tm3v * b3v;
-            STVF( tmp[j][0], Rv );
-            Tm3v = Tm2v;
-            Tm2v = Tv;
+            Rv[k] = lines.load(2, k) * Bv + Tm2v[k] * b1v + Tm3v[k] * b2v + Tv[k] * b3v;
+            tmp[2 * N + k] = Rv[k];
         }
 
-        Tv = _mm_set_ps(src[i][W - 1], src[i + 1][W - 1], src[i + 2][W - 1], src[i + 3][W - 1]);
+        for (int j = 3; j < n; j++) {
+            vfloat x[N];
 
-        temp2Wp1 = Tv + F2V(M[2][0]) * (Rv - Tv) + F2V(M[2][1]) * ( Tm2v - Tv ) +  F2V(M[2][2]) * (Tm3v - Tv);
-        temp2W = Tv + F2V(M[1][0]) * (Rv - Tv) + F2V(M[1][1]) * (Tm2v - Tv) + F2V(M[1][2]) * (Tm3v - Tv);
-
-        Rv = Tv + F2V(M[0][0]) * (Rv - Tv) + F2V(M[0][1]) * (Tm2v - Tv) + F2V(M[0][2]) * (Tm3v - Tv);
-        STVF(tmp[W - 1][0], Rv);
-
-        Tm2v = Bv * Tm2v + b1v * Rv + b2v * temp2W + b3v * temp2Wp1;
-        STVF(tmp[W - 2][0], Tm2v);
-
-        Tm3v = Bv * Tm3v + b1v * Tm2v + b2v * Rv + b3v * temp2W;
-        STVF(tmp[W - 3][0], Tm3v);
-
-        Tv = Rv;
-        Rv = Tm3v;
-        Tm3v = Tv;
+            for (int k = 0; k < N; k++) {
+                x[k] = lines.load(j, k);
+            }
 
-        for (int j = W - 4; j >= 0; j--) {
-            Tv = Rv;
-            Rv = LVF(tmp[j][0]) * Bv + Tv * b1v + Tm2v * b2v + Tm3v * b3v;
-            STVF(tmp[j][0], Rv);
-            Tm3v = Tm2v;
-            Tm2v = Tv;
+            for (int k = 0; k < N; k++) {
+                Tv[k] = Rv[k];
+                Rv[k] = x[k] * Bv + Tv[k] * b1v + Tm2v[k] * b2v + Tm3v[k] * b3v;
+                tmp[j * N + k] = Rv[k];
+                Tm3v[k] = Tm2v[k];
+                Tm2v[k] = Tv[k];
+            }
         }
 
-        for (int j = 0; j < W; j++) {
-            dst[i + 3][j] = tmp[j][0];
-            dst[i + 2][j] = tmp[j][1];
-            dst[i + 1][j] = tmp[j][2];
-            dst[i + 0][j] = tmp[j][3];
-        }
+        for (int k = 0; k < N; k++) {
+            Tv[k] = lines.load(n - 1, k);
 
+            temp2Wp1[k] = Tv[k] + M[2][0] * (Rv[k] - Tv[k]) + M[2][1] * (Tm2v[k] - Tv[k]) + M[2][2] * (Tm3v[k] - Tv[k]);
+            temp2W[k] = Tv[k] + M[1][0] * (Rv[k] - Tv[k]) + M[1][1] * (Tm2v[k] - Tv[k]) + M[1][2] * (Tm3v[k] - Tv[k]);
 
-    }
+            Rv[k] = Tv[k] + M[0][0] * (Rv[k] - Tv[k]) + M[0][1] * (Tm2v[k] - Tv[k]) + M[0][2] * (Tm3v[k] - Tv[k]);
+            lines.store(n - 1, k, Rv[k]);
 
-// Borders are done without SSE
-#ifdef _OPENMP
-    #pragma omp single
-#endif
+            Tm2v[k] = Bv * Tm2v[k] + b1v * Rv[k] + b2v * temp2W[k] + b3v * temp2Wp1[k];
+            lines.store(n - 2, k, Tm2v[k]);
 
-    for (int i = H - (H % 4); i < H; i++) {
-        tmp[0][0] = src[i][0] * (B + b1 + b2 + b3);
-        tmp[1][0] = B * src[i][1] + b1 * tmp[0][0]  + src[i][0] * (b2 + b3);
-        tmp[2][0] = B * src[i][2] + b1 * tmp[1][0]  + b2 * tmp[0][0]  + b3 * src[i][0];
+            Tm3v[k] = Bv * Tm3v[k] + b1v * Tm2v[k] + b2v * Rv[k] + b3v * temp2W[k];
+            lines.store(n - 3, k, Tm3v[k]);
 
-        for (int j = 3; j < W; j++) {
-            tmp[j][0] = B * src[i][j] + b1 * tmp[j - 1][0] + b2 * tmp[j - 2][0] + b3 * tmp[j - 3][0];
+            Tv[k] = Rv[k];
+            Rv[k] = Tm3v[k];
+            Tm3v[k] = Tv[k];
         }
 
-        float temp2Wm1 = src[i][W - 1] + M[0][0] * (tmp[W - 1][0] - src[i][W - 1]) + M[0][1] * (tmp[W - 2][0] - src[i][W - 1]) + M[0][2] * (tmp[W - 3][0] - src[i][W - 1]);
-        float temp2W   = src[i][W - 1] + M[1][0] * (tmp[W - 1][0] - src[i][W - 1]) + M[1][1] * (tmp[W - 2][0] - src[i][W - 1]) + M[1][2] * (tmp[W - 3][0] - src[i][W - 1]);
-        float temp2Wp1 = src[i][W - 1] + M[2][0] * (tmp[W - 1][0] - src[i][W - 1]) + M[2][1] * (tmp[W - 2][0] - src[i][W - 1]) + M[2][2] * (tmp[W - 3][0] - src[i][W - 1]);
-
-        tmp[W - 1][0] = temp2Wm1;
-        tmp[W - 2][0] = B * tmp[W - 2][0] + b1 * tmp[W - 1][0] + b2 * temp2W + b3 * temp2Wp1;
-        tmp[W - 3][0] = B * tmp[W - 3][0] + b1 * tmp[W - 2][0] + b2 * tmp[W - 1][0] + b3 * temp2W;
-
-        for (int j = W - 4; j >= 0; j--) {
-            tmp[j][0] = B * tmp[j][0] + b1 * tmp[j + 1][0] + b2 * tmp[j + 2][0] + b3 * tmp[j + 3][0];
-        }
+        for (int j = n - 4; j >= 0; j--) {
+            for (int k = 0; k < N; k++) {
+                Tv[k] = Rv[k];
+                Rv[k] = tmp[j * N + k] * Bv + Tv[k] * b1v + Tm2v[k] * b2v + Tm3v[k] * b3v;
+                Tm3v[k] = Tm2v[k];
+                Tm2v[k] = Tv[k];
+            }
 
-        for (int j = 0; j < W; j++) {
-            dst[i][j] = tmp[j][0];
+            for (int k = 0; k < N; k++) {
+                lines.store(j, k, Rv[k]);
+            }
         }
     }
+
+private:
+    vfloat B;
+    vfloat b1;
+    vfloat b2;
+    vfloat b3;
+    vfloat M[3][3];
+};
+
+// fast gaussian approximation if the support window is large
+template<class T> void gaussHorizontalSse (T** src, T** dst, const int W, const int H, const float sigma)
+{
+    const YvVKernel kernel(calculateSseYvVCoefficients(sigma));
+    rtengine::LineVectorBuffer buffer(rtengine::separableFilterBufferSize(W, H));
+    rtengine::filterRows(src, dst, W, H, kernel, buffer.data);
 }
 #endif
 
@@ -690,143 +704,9 @@ template<class T> void gaussHorizontal (T** src, T** dst, const int W, const int
 #ifdef __SSE2__
 template<class T> void gaussVerticalSse (T** src, T** dst, const int W, const int H, const float sigma)
 {
-    double b1, b2, b3, B, M[3][3];
-    calculateYvVFactors<double>(sigma, b1, b2, b3, B, M);
-
-    for (int i = 0; i < 3; i++)
-        for (int j = 0; j < 3; j++) {
-            M[i][j] *= (1.0 + b2 + (b1 - b3) * b3);
-            M[i][j] /= (1.0 + b1 - b2 + b3) * (1.0 - b1 - b2 - b3);
-        }
-
-    float tmp[H][8] ALIGNED16;
-    vfloat Rv;
-    vfloat Tv, Tm2v, Tm3v;
-    vfloat Rv1;
-    vfloat Tv1, Tm2v1, Tm3v1;
-    vfloat Bv, b1v, b2v, b3v;
-    vfloat temp2W, temp2Wp1;
-    vfloat temp2W1, temp2Wp11;
-    Bv = F2V(B);
-    b1v = F2V(b1);
-    b2v = F2V(b2);
-    b3v = F2V(b3);
-
-#ifdef _OPENMP
-    #pragma omp for nowait
-#endif
-
-    // process 8 columns per iteration for better usage of cpu cache
-    for (int i = 0; i < W - 7; i += 8) {
-        Tv = LVFU( src[0][i]);
-        Tv1 = LVFU( src[0][i + 4]);
-        Rv = Tv * (Bv + b1v + b2v + b3v);
-        Rv1 = Tv1 * (Bv + b1v + b2v + b3v);
-        Tm3v = Rv;
-        Tm3v1 = Rv1;
-        STVF( tmp[0][0], Rv );
-        STVF( tmp[0][4], Rv1 );
-
-        Rv = LVFU(src[1][i]) * Bv + Rv * b1v + Tv * (b2v + b3v);
-        Rv1 = LVFU(src[1][i + 4]) * Bv + Rv1 * b1v + Tv1 * (b2v + b3v);
-        Tm2v = Rv;
-        Tm2v1 = Rv1;
-        STVF( tmp[1][0], Rv );
-        STVF( tmp[1][4], Rv1 );
-
-        Rv = LVFU(src[2][i]) * Bv + Rv * b1v + Tm3v * b2v + Tv * b3v;
-        Rv1 = LVFU(src[2][i + 4]) * Bv + Rv1 * b1v + Tm3v1 * b2v + Tv1 * b3v;
-        STVF( tmp[2][0], Rv );
-        STVF( tmp[2][4], Rv1 );
-
-        for (int j = 3; j < H; j++) {
-            Tv = Rv;
-            Tv1 = Rv1;
-            Rv = LVFU(src[j][i]) * Bv +  Tv * b1v + Tm2v * b2v + Tm3v * b3v;
-            Rv1 = LVFU(src[j][i + 4]) * Bv +  Tv1 * b1v + Tm2v1 * b2v + Tm3v1 * b3v;
-            STVF( tmp[j][0], Rv );
-            STVF( tmp[j][4], Rv1 );
-            Tm3v = Tm2v;
-            Tm3v1 = Tm2v1;
-            Tm2v = Tv;
-            Tm2v1 = Tv1;
-        }
-
-        Tv = LVFU(src[H - 1][i]);
-        Tv1 = LVFU(src[H - 1][i + 4]);
-
-        temp2Wp1 = Tv + F2V(M[2][0]) * (Rv - Tv) + F2V(M[2][1]) * (Tm2v - Tv) + F2V(M[2][2]) * (Tm3v - Tv);
-        temp2Wp11 = Tv1 + F2V(M[2][0]) * (Rv1 - Tv1) + F2V(M[2][1]) * (Tm2v1 - Tv1) + F2V(M[2][2]) * (Tm3v1 - Tv1);
-        temp2W = Tv + F2V(M[1][0]) * (Rv - Tv) + F2V(M[1][1]) * (Tm2v - Tv) + F2V(M[1][2]) * (Tm3v - Tv);
-        temp2W1 = Tv1 + F2V(M[1][0]) * (Rv1 - Tv1) + F2V(M[1][1]) * (Tm2v1 - Tv1) + F2V(M[1][2]) * (Tm3v1 - Tv1);
-
-        Rv = Tv + F2V(M[0][0]) * (Rv - Tv) + F2V(M[0][1]) * (Tm2v - Tv) + F2V(M[0][2]) * (Tm3v - Tv);
-        Rv1 = Tv1 + F2V(M[0][0]) * (Rv1 - Tv1) + F2V(M[0][1]) * (Tm2v1 - Tv1) + F2V(M[0][2]) * (Tm3v1 - Tv1);
-        STVFU( dst[H - 1][i], Rv );
-        STVFU( dst[H - 1][i + 4], Rv1 );
-
-        Tm2v = Bv * Tm2v + b1v * Rv + b2v * temp2W + b3v * temp2Wp1;
-        Tm2v1 = Bv * Tm2v1 + b1v * Rv1 + b2v * temp2W1 + b3v * temp2Wp11;
-        STVFU( dst[H - 2][i], Tm2v );
-        STVFU( dst[H - 2][i + 4], Tm2v1 );
-
-        Tm3v = Bv * Tm3v + b1v * Tm2v + b2v * Rv + b3v * temp2W;
-        Tm3v1 = Bv * Tm3v1 + b1v * Tm2v1 + b2v * Rv1 + b3v * temp2W1;
-        STVFU( dst[H - 3][i], Tm3v );
-        STVFU( dst[H - 3][i + 4], Tm3v1 );
-
-        Tv = Rv;
-        Tv1 = Rv1;
-        Rv = Tm3v;
-        Rv1 = Tm3v1;
-        Tm3v = Tv;
-        Tm3v1 = Tv1;
-
-        for (int j = H - 4; j >= 0; j--) {
-            Tv = Rv;
-            Tv1 = Rv1;
-            Rv = LVF(tmp[j][0]) * Bv +  Tv * b1v + Tm2v * b2v + Tm3v * b3v;
-            Rv1 = LVF(tmp[j][4]) * Bv +  Tv1 * b1v + Tm2v1 * b2v + Tm3v1 * b3v;
-            STVFU( dst[j][i], Rv );
-            STVFU( dst[j][i + 4], Rv1 );
-            Tm3v = Tm2v;
-            Tm3v1 = Tm2v1;
-            Tm2v = Tv;
-            Tm2v1 = Tv1;
-        }
-    }
-
-// Borders are done without SSE
-#ifdef _OPENMP
-    #pragma omp single
-#endif
-
-    for (int i = W - (W % 8); i < W; i++) {
-        tmp[0][0] = src[0][i] * (B + b1 + b2 + b3);
-        tmp[1][0] = B * src[1][i] + b1 * tmp[0][0] + src[0][i] * (b2 + b3);
-        tmp[2][0] = B * src[2][i] + b1 * tmp[1][0] + b2 * tmp[0][0] + b3 * src[0][i];
-
-        for (int j = 3; j < H; j++) {
-            tmp[j][0] = B * src[j][i] + b1 * tmp[j - 1][0] + b2 * tmp[j - 2][0] + b3 * tmp[j - 3][0];
-        }
-
-        float temp2Hm1 = src[H - 1][i] + M[0][0] * (tmp[H - 1][0] - src[H - 1][i]) + M[0][1] * (tmp[H - 2][0] - src[H - 1][i]) + M[0][2] * (tmp[H - 3][0] - src[H - 1][i]);
-        float temp2H   = src[H - 1][i] + M[1][0] * (tmp[H - 1][0] - src[H - 1][i]) + M[1][1] * (tmp[H - 2][0] - src[H - 1][i]) + M[1][2] * (tmp[H - 3][0] - src[H - 1][i]);
-        float temp2Hp1 = src[H - 1][i] + M[2][0] * (tmp[H - 1][0] - src[H - 1][i]) + M[2][1] * (tmp[H - 2][0] - src[H - 1][i]) + M[2][2] * (tmp[H - 3][0] - src[H - 1][i]);
-
-        tmp[H - 1][0] = temp2Hm1;
-        tmp[H - 2][0] = B * tmp[H - 2][0] + b1 * tmp[H - 1][0] + b2 * temp2H + b3 * temp2Hp1;
-        tmp[H - 3][0] = B * tmp[H - 3][0] + b1 * tmp[H - 2][0] + b2 * tmp[H - 1][0] + b3 * temp2H;
-
-        for (int j = H - 4; j >= 0; j--) {
-            tmp[j][0] = B * tmp[j][0] + b1 * tmp[j + 1][0] + b2 * tmp[j + 2][0] + b3 * tmp[j + 3][0];
-        }
-
-        for (int j = 0; j < H; j++) {
-            dst[j][i] = tmp[j][0];
-        }
-
-    }
+    const YvVKernel kernel(calculateSseYvVCoefficients(sigma));
+    rtengine::LineVectorBuffer buffer(rtengine::separableFilterBufferSize(W, H));
+    rtengine::filterColumns(src, dst, W, H, kernel, buffer.data);
 }
 #endif
 
@@ -1353,13 +1233,13 @@ template<class T> void gaussVerticalmult (T** src, T** dst, const int W, const i
 }
 #endif
 
+constexpr auto GAUSS_3X3_LIMIT = 0.6;
+constexpr auto GAUSS_5X5_LIMIT = 0.84;
+constexpr auto GAUSS_7X7_LIMIT = 1.15;
+constexpr auto GAUSS_DOUBLE = 25.0;
+
 template<class T> void gaussianBlurImpl(T** src, T** dst, const int W, const int H, const double sigma, bool useBoxBlur, eGaussType gausstype = GAUSS_STANDARD, T** buffer2 = nullptr)
 {
-    static constexpr auto GAUSS_3X3_LIMIT = 0.6;
-    static constexpr auto GAUSS_5X5_LIMIT = 0.84;
-    static constexpr auto GAUSS_7X7_LIMIT = 1.15;
-    static constexpr auto GAUSS_DOUBLE = 25.0;
-
     if (useBoxBlur) {
         // special variant for very large sigma, currently only used by retinex algorithm
         // use iterated boxblur to approximate gaussian blur
@@ -1536,6 +1416,40 @@ template<class T> void gaussianBlurImpl(T** src, T** dst, const int W, const int
         }
     }
 }
+
+#ifdef __SSE2__
+// standard recursive filter on several planes, each pass is one parallel loop over all planes
+template<class T> void gaussianBlurSsePlanes(T** const* src, T** const* dst, const int numPlanes, const int W, const int H, const YvVCoefficients* const* coeffs)
+{
+    rtengine::LineVectorBuffer buffer(rtengine::separableFilterBufferSize(W, H));
+
+    // groups of rows of all planes
+    const int rowGroups = (H + rtengine::ROW_GROUP_SIZE - 1) / rtengine::ROW_GROUP_SIZE;
+
+#ifdef _OPENMP
+    #pragma omp for
+#endif
+
+    for (int k = 0; k < numPlanes * rowGroups; ++k) {
+        const int p = k / rowGroups;
+        rtengine::filterRowGroup(src[p], dst[p], W, H, rtengine::ROW_GROUP_SIZE * (k % rowGroups), YvVKernel(*coeffs[p]), buffer.data);
+    }
+
+    // column strips, the planes are interleaved so that the same strip of all planes is processed by the same thread in a row
+    const int stripWidth = rtengine::columnStripWidth(H);
+    const int strips = (W + stripWidth - 1) / stripWidth;
+
+#ifdef _OPENMP
+    #pragma omp for
+#endif
+
+    for (int k = 0; k < strips * numPlanes; ++k) {
+        const int p = k % numPlanes;
+        const int col = (k / numPlanes) * stripWidth;
+        rtengine::filterColumnStrip(dst[p], dst[p], H, col, std::min(stripWidth, W - col), YvVKernel(*coeffs[p]), buffer.data);
+    }
+}
+#endif
 }
 
 void gaussianBlur(float** src, float** dst, const int W, const int H, const double sigma, bool useBoxBlur, eGaussType gausstype, float** buffer2)
@@ -1543,3 +1457,65 @@ void gaussianBlur(float** src, float** dst, const int W, const int H, const doub
     gaussianBlurImpl<float>(src, dst, W, H, sigma, useBoxBlur, gausstype, buffer2);
 }
 
+void gaussianBlur(float** const* src, float** const* dst, const int numPlanes, const int W, const int H, const double* sigma)
+{
+#ifdef __SSE2__
+    // the planes which use the recursive filter are blurred together, the others one after the other
+    float** batchSrc[numPlanes];
+    float** batchDst[numPlanes];
+    double batchSigma[numPlanes];
+    YvVCoefficients coeffs[numPlanes];
+    const YvVCoefficients* batchCoeffs[numPlanes];
+    int batchSize = 0;
+
+    for (int i = 0; i < numPlanes; ++i) {
+        if (sigma[i] >= GAUSS_3X3_LIMIT && sigma[i] < GAUSS_DOUBLE) {
+            batchSrc[batchSize] = src[i];
+            batchDst[batchSize] = dst[i];
+            batchSigma[batchSize] = sigma[i];
+
+            // planes with the same sigma share the coefficients
+            int j = 0;
+
+            while (batchSigma[j] != sigma[i]) {
+                ++j;
+            }
+
+            if (j == batchSize) {
+                coeffs[j] = calculateSseYvVCoefficients(sigma[i]);
+            }
+
+            batchCoeffs[batchSize] = &coeffs[j];
+            ++batchSize;
+        }
+    }
+
+    if (batchSize > 0) {
+        gaussianBlurSsePlanes<float>(batchSrc, batchDst, batchSize, W, H, batchCoeffs);
+    }
+
+    for (int i = 0; i < numPlanes; ++i) {
+        if (sigma[i] < GAUSS_3X3_LIMIT || sigma[i] >= GAUSS_DOUBLE) {
+            gaussianBlurImpl<float>(src[i], dst[i], W, H, sigma[i], false);
+        }
+    }
+
+#else
+
+    for (int i = 0; i < numPlanes; ++i) {
+        gaussianBlurImpl<float>(src[i], dst[i], W, H, sigma[i], false);
+    }
+
+#endif
+}
+
+void gaussianBlur(float** const* src, float** const* dst, const int numPlanes, const int W, const int H, const double sigma)
+{
+    double sigmas[numPlanes];
+
+    for (int i = 0; i < numPlanes; ++i) {
+        sigmas[i] = sigma;
+    }
+
+    gaussianBlur(src, dst, numPlanes, W, H, sigmas);
+}
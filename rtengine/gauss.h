@@ -23,3 +23,8 @@ static constexpr auto GAUSS_SKIP = 0.25;
 
 
 void gaussianBlur(float** src, float** dst, const int W, const int H, const double sigma, bool useBoxBlur = false, eGaussType gausstype = GAUSS_STANDARD, float** buffer2 = nullptr);
+
+// Blurs numPlanes planes of the same size (src[i] to dst[i] with sigma[i]) with one parallel loop per pass for all planes.
+// Like gaussianBlur it has to be called by all threads of a parallel region (or outside of one). src[i] may be dst[i], but different planes must not share memory.
+void gaussianBlur(float** const* src, float** const* dst, const int numPlanes, const int W, const int H, const double* sigma);
+void gaussianBlur(float** const* src, float** const* dst, const int numPlanes, const int W, const int H, const double sigma);
@@ -76,10 +76,157 @@ int calculate_subsampling(int w, int h, int r)
     return LIM(r / 2, 2, 4);
 }
 
+enum Op { MUL, DIVEPSILON, ADD, SUB, ADDMUL, SUBMUL };
+
+void apply(Op op, array2D<float> &res, const array2D<float> &a, const array2D<float> &b, const array2D<float> &c, float epsilon, bool multithread)
+{
+    const int w = res.getWidth();
+    const int h = res.getHeight();
+
+#ifdef _OPENMP
+    #pragma omp parallel for if (multithread)
+#endif
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            float r;
+            float aa = a[y][x];
+            float bb = b[y][x];
+            switch (op) {
+            case MUL:
+                r = aa * bb;
+                break;
+            case DIVEPSILON:
+                r = aa / (bb + epsilon);
+                break;
+            case ADD:
+                r = aa + bb;
+                break;
+            case SUB:
+                r = aa - bb;
+                break;
+            case ADDMUL:
+                r = aa * bb + c[y][x];
+                break;
+            case SUBMUL:
+                r = c[y][x] - (aa * bb);
+                break;
+            default:
+                assert(false);
+                r = 0;
+                break;
+            }
+            res[y][x] = r;
+        }
+    }
+}
+
+void f_subsample(array2D<float> &d, const array2D<float> &s, bool multithread)
+{
+    if (d.getWidth() == s.getWidth() && d.getHeight() == s.getHeight()) {
+#ifdef _OPENMP
+#       pragma omp parallel for if (multithread)
+#endif
+        for (int y = 0; y < s.getHeight(); ++y) {
+            for (int x = 0; x < s.getWidth(); ++x) {
+                d[y][x] = s[y][x];
+            }
+        }
+    } else {
+        rescaleBilinear(s, d, multithread);
+    }
+}
+
+void f_mean(array2D<float> &d, const array2D<float> &s, int rad, bool multithread)
+{
+    rad = LIM(rad, 0, (min(s.getWidth(), s.getHeight()) - 1) / 2 - 1);
+    // boxblur only reads src
+    boxblur(const_cast<float**>(static_cast<const float* const *>(s)), static_cast<float**>(d), rad, s.getWidth(), s.getHeight(), multithread);
+}
+
 } // namespace
 
 
+// use the terminology of the paper (Algorithm 2)
+struct GuidedFilterGuide::Planes {
+    Planes(const array2D<float> &I, int r, int subsampling, bool multithread) :
+        r(r),
+        subsampling(subsampling),
+        I1(subsampling > 1 ? I.getWidth() / subsampling : 0, subsampling > 1 ? I.getHeight() / subsampling : 0),
+        meanI(I.getWidth() / subsampling, I.getHeight() / subsampling),
+        varI(I.getWidth() / subsampling, I.getHeight() / subsampling)
+    {
+        if (subsampling > 1) {
+            f_subsample(I1, I, multithread);
+            DEBUG_DUMP(I1);
+        }
+
+        const array2D<float> &sI = getI1(I);
+        const float r1 = float(r) / subsampling;
+
+        f_mean(meanI, sI, r1, multithread);
+        DEBUG_DUMP(meanI);
+
+        array2D<float> &corrI = varI;
+        apply(MUL, corrI, sI, sI, array2D<float>(), 0.f, multithread);
+        f_mean(corrI, corrI, r1, multithread);
+        DEBUG_DUMP(corrI);
+
+        apply(SUBMUL, varI, meanI, meanI, corrI, 0.f, multithread);
+        DEBUG_DUMP(varI);
+    }
+
+    // without subsampling the guide itself is used instead of a copy
+    const array2D<float> &getI1(const array2D<float> &I) const
+    {
+        return subsampling > 1 ? I1 : I;
+    }
+
+    const int r;
+    const int subsampling;
+    array2D<float> I1;
+    array2D<float> meanI;
+    array2D<float> varI;
+};
+
+
+GuidedFilterGuide::GuidedFilterGuide(const array2D<float> &guide, bool multithread) :
+    guide(guide),
+    multithread(multithread)
+{
+}
+
+GuidedFilterGuide::~GuidedFilterGuide() = default;
+
+const array2D<float> &GuidedFilterGuide::getGuide() const
+{
+    return guide;
+}
+
+void GuidedFilterGuide::invalidate()
+{
+    planes.reset();
+}
+
+const GuidedFilterGuide::Planes &GuidedFilterGuide::getPlanes(int r, int subsampling)
+{
+    if (!planes || planes->r != r || planes->subsampling != subsampling) {
+        // free the old planes first, to keep the peak memory down
+        planes.reset();
+        planes.reset(new Planes(guide, r, subsampling, multithread));
+    }
+
+    return *planes;
+}
+
+
 void guidedFilter(const array2D<float> &guide, const array2D<float> &src, array2D<float> &dst, int r, float epsilon, bool multithread, int subsampling)
+{
+    GuidedFilterGuide sharedGuide(guide, multithread);
+    guidedFilter(sharedGuide, src, dst, r, epsilon, multithread, subsampling);
+}
+
+
+void guidedFilter(GuidedFilterGuide &guide, const array2D<float> &src, array2D<float> &dst, int r, float epsilon, bool multithread, int subsampling)
 {
 
     const int W = src.getWidth();
@@ -89,139 +236,56 @@ void guidedFilter(const array2D<float> &guide, const array2D<float> &src, array2
         subsampling = calculate_subsampling(W, H, r);
     }
 
-    enum Op { MUL, DIVEPSILON, ADD, SUB, ADDMUL, SUBMUL };
-
-    const auto apply =
-        [=](Op op, array2D<float> &res, const array2D<float> &a, const array2D<float> &b, const array2D<float> &c=array2D<float>()) -> void
-        {
-            const int w = res.getWidth();
-            const int h = res.getHeight();
-            
-#ifdef _OPENMP
-            #pragma omp parallel for if (multithread)
-#endif
-            for (int y = 0; y < h; ++y) {
-                for (int x = 0; x < w; ++x) {
-                    float r;
-                    float aa = a[y][x];
-                    float bb = b[y][x];
-                    switch (op) {
-                    case MUL:
-                        r = aa * bb;
-                        break;
-                    case DIVEPSILON:
-                        r = aa / (bb + epsilon);
-                        break;
-                    case ADD:
-                        r = aa + bb;
-                        break;
-                    case SUB:
-                        r = aa - bb;
-                        break;
-                    case ADDMUL:
-                        r = aa * bb + c[y][x];
-                        break;
-                    case SUBMUL:
-                        r = c[y][x] - (aa * bb);
-                        break;
-                    default:
-                        assert(false);
-                        r = 0;
-                        break;
-                    }
-                    res[y][x] = r;
-                }
-            }
-        };
-
     // use the terminology of the paper (Algorithm 2)
-    const array2D<float> &I = guide;
+    const array2D<float> &I = guide.getGuide();
     const array2D<float> &p = src;
     array2D<float> &q = dst;
 
-    const auto f_subsample =
-        [=](array2D<float> &d, const array2D<float> &s) -> void
-        {
-            if (d.getWidth() == s.getWidth() && d.getHeight() == s.getHeight()) {
-#ifdef _OPENMP
-#               pragma omp parallel for if (multithread)
-#endif
-                for (int y = 0; y < s.getHeight(); ++y) {
-                    for (int x = 0; x < s.getWidth(); ++x) {
-                        d[y][x] = s[y][x];
-                    }
-                }
-            } else {
-                rescaleBilinear(s, d, multithread);
-            }
-        };
+    // the planes of the guide are computed before dst is written, so dst may be the guide if it isn't shared
+    const GuidedFilterGuide::Planes &guidePlanes = guide.getPlanes(r, subsampling);
+    const array2D<float> &I1 = guidePlanes.getI1(I);
+    const array2D<float> &meanI = guidePlanes.meanI;
+    const array2D<float> &varI = guidePlanes.varI;
 
-    // const auto f_upsample = f_subsample;
-    
     const size_t w = W / subsampling;
     const size_t h = H / subsampling;
 
-    const auto f_mean =
-        [multithread](array2D<float> &d, array2D<float> &s, int rad) -> void
-        {
-            rad = LIM(rad, 0, (min(s.getWidth(), s.getHeight()) - 1) / 2 - 1);
-           // boxblur(s, d, rad, s.getWidth(), s.getHeight(), multithread);
-            boxblur(static_cast<float**>(s), static_cast<float**>(d), rad, s.getWidth(), s.getHeight(), multithread);
-        };
-
-    array2D<float> I1(w, h);
     array2D<float> p1(w, h);
-
-    f_subsample(I1, I);
-    f_subsample(p1, p);
+    f_subsample(p1, p, multithread);
 
     DEBUG_DUMP(I);
     DEBUG_DUMP(p);
-    DEBUG_DUMP(I1);
     DEBUG_DUMP(p1);
 
     float r1 = float(r) / subsampling;
 
-    array2D<float> meanI(w, h);
-    f_mean(meanI, I1, r1);
-    DEBUG_DUMP(meanI);
-
     array2D<float> meanp(w, h);
-    f_mean(meanp, p1, r1);
+    f_mean(meanp, p1, r1, multithread);
     DEBUG_DUMP(meanp);
 
     array2D<float> &corrIp = p1;
-    apply(MUL, corrIp, I1, p1);
-    f_mean(corrIp, corrIp, r1);
+    apply(MUL, corrIp, I1, p1, array2D<float>(), epsilon, multithread);
+    f_mean(corrIp, corrIp, r1, multithread);
     DEBUG_DUMP(corrIp);
 
-    array2D<float> &corrI = I1;
-    apply(MUL, corrI, I1, I1);
-    f_mean(corrI, corrI, r1);
-    DEBUG_DUMP(corrI);
-
-    array2D<float> &varI = corrI;
-    apply(SUBMUL, varI, meanI, meanI, corrI);
-    DEBUG_DUMP(varI);
-
     array2D<float> &covIp = corrIp;
-    apply(SUBMUL, covIp, meanI, meanp, corrIp);
+    apply(SUBMUL, covIp, meanI, meanp, corrIp, epsilon, multithread);
     DEBUG_DUMP(covIp);
 
-    array2D<float> &a = varI;
-    apply(DIVEPSILON, a, covIp, varI);
+    array2D<float> &a = covIp;
+    apply(DIVEPSILON, a, covIp, varI, array2D<float>(), epsilon, multithread);
     DEBUG_DUMP(a);
 
-    array2D<float> &b = covIp;
-    apply(SUBMUL, b, a, meanI, meanp);
+    array2D<float> &b = meanp;
+    apply(SUBMUL, b, a, meanI, meanp, epsilon, multithread);
     DEBUG_DUMP(b);
 
     array2D<float> &meana = a;
-    f_mean(meana, a, r1);
+    f_mean(meana, a, r1, multithread);
     DEBUG_DUMP(meana);
 
     array2D<float> &meanb = b;
-    f_mean(meanb, b, r1);
+    f_mean(meanb, b, r1, multithread);
     DEBUG_DUMP(meanb);
 
     // speedup by heckflosse67
@@ -245,6 +309,13 @@ void guidedFilter(const array2D<float> &guide, const array2D<float> &src, array2
 
 
 void guidedFilterLog(const array2D<float> &guide, float base, array2D<float> &chan, int r, float eps, bool multithread, int subsampling)
+{
+    GuidedFilterGuide sharedGuide(guide, multithread);
+    guidedFilterLog(sharedGuide, base, chan, r, eps, multithread, subsampling);
+}
+
+
+void guidedFilterLog(GuidedFilterGuide &guide, float base, array2D<float> &chan, int r, float eps, bool multithread, int subsampling)
 {
 #ifdef _OPENMP
 #    pragma omp parallel for if (multithread)
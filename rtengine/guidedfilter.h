@@ -20,16 +20,55 @@
 
 #pragma once
 
+#include <memory>
+
+#include "noncopyable.h"
+
 template<typename T> class array2D;
 
 namespace rtengine
 {
 
+/*
+ * Guide shared by several guided filters. The planes which depend only on the guide (its subsampled copy,
+ * mean and variance) are computed by the first filter with a given radius and subsampling and reused by
+ * the following ones, which then only have to process their source. Only the planes of the last radius and
+ * subsampling are kept, so filters with the same radius should run one after the other. The guide image is
+ * referenced, it must outlive this object and must not change while in use unless invalidate() is called.
+ * Not thread safe.
+ */
+class GuidedFilterGuide final :
+    public NonCopyable
+{
+public:
+    GuidedFilterGuide(const array2D<float> &guide, bool multithread);
+    ~GuidedFilterGuide();
+
+    const array2D<float> &getGuide() const;
+    // drops the planes computed so far, to be called after the guide image has changed
+    void invalidate();
+
+private:
+    struct Planes;
+
+    const Planes &getPlanes(int r, int subsampling);
+
+    friend void guidedFilter(GuidedFilterGuide &guide, const array2D<float> &src, array2D<float> &dst, int r, float epsilon, bool multithread, int subsampling);
+
+    const array2D<float> &guide;
+    const bool multithread;
+    std::unique_ptr<Planes> planes;
+};
+
 
 void guidedFilter(const array2D<float> &guide, const array2D<float> &src, array2D<float> &dst, int r, float epsilon, bool multithread, int subsampling=0);
 
+void guidedFilter(GuidedFilterGuide &guide, const array2D<float> &src, array2D<float> &dst, int r, float epsilon, bool multithread, int subsampling=0);
+
 void guidedFilterLog(float base, array2D<float> &chan, int r, float eps, bool multithread, int subsampling=0);
 
 void guidedFilterLog(const array2D<float> &guide, float base, array2D<float> &chan, int r, float eps, bool multithread, int subsampling=0);
 
+void guidedFilterLog(GuidedFilterGuide &guide, float base, array2D<float> &chan, int r, float eps, bool multithread, int subsampling=0);
+
 } // namespace rtengine
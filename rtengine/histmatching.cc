@@ -19,6 +19,7 @@
  */
 
 #include <iostream>
+#include <sstream>
 
 #include "color.h"
 #include "curves.h"
@@ -37,6 +38,17 @@ namespace rtengine
 
 namespace {
 
+AutoMatchedToneCurveStore* toneCurveStore = nullptr;
+
+// identifies the parameters a matched curve depends on in the store, increase the version when the matching changes
+Glib::ustring getToneCurveStoreKey(const ColorManagementParams &cp)
+{
+    std::ostringstream key;
+    key << "1;" << cp.inputProfile.raw() << ';' << cp.toneCurve << ';' << cp.applyLookTable << ';' << cp.applyBaselineExposureOffset
+        << ';' << cp.applyHueSatMap << ';' << cp.dcpIlluminant;
+    return key.str();
+}
+
 struct CdfInfo {
     std::vector<int> cdf;
     int min_val;
@@ -256,6 +268,17 @@ void RawImageSource::getAutoMatchedToneCurve(const ColorManagementParams &cp, st
         return;
     }
 
+    const Glib::ustring storeKey = getToneCurveStoreKey(cp);
+
+    if (toneCurveStore && toneCurveStore->loadAutoMatchedToneCurve(getFileName(), storeKey, outCurve)) {
+        if (settings->verbose) {
+            std::cout << "tone curve found in the image cache" << std::endl;
+        }
+        histMatchingCache = outCurve;
+        *histMatchingParams = cp;
+        return;
+    }
+
     outCurve = { DCT_Linear };
 
     int fw, fh;
@@ -287,6 +310,9 @@ void RawImageSource::getAutoMatchedToneCurve(const ColorManagementParams &cp, st
             }
             histMatchingCache = outCurve;
             *histMatchingParams = cp;
+            if (toneCurveStore) {
+                toneCurveStore->storeAutoMatchedToneCurve(getFileName(), storeKey, outCurve);
+            }
             return;
         } else if (w * 33 < fw || w * h < 19200) {
              // Some cameras have extremely small thumbs, for example Canon PowerShot A3100 IS has 128x96 thumbs.
@@ -297,6 +323,9 @@ void RawImageSource::getAutoMatchedToneCurve(const ColorManagementParams &cp, st
             }
             histMatchingCache = outCurve;
             *histMatchingParams = cp;
+            if (toneCurveStore) {
+                toneCurveStore->storeAutoMatchedToneCurve(getFileName(), storeKey, outCurve);
+            }
             return;
         }
         skip = LIM(skip * fh / h, 6, 10); // adjust the skip factor -- the larger the thumbnail, the less we should skip to get a good match
@@ -392,6 +421,16 @@ void RawImageSource::getAutoMatchedToneCurve(const ColorManagementParams &cp, st
 
     histMatchingCache = outCurve;
     *histMatchingParams = cp;
+
+    if (toneCurveStore) {
+        toneCurveStore->storeAutoMatchedToneCurve(getFileName(), storeKey, outCurve);
+    }
+}
+
+
+void setAutoMatchedToneCurveStore(AutoMatchedToneCurveStore* store)
+{
+    toneCurveStore = store;
 }
 
 } // namespace rtengine
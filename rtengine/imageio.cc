@@ -21,11 +21,18 @@
 #include <glib/gstdio.h>
 #include <tiff.h>
 #include <tiffio.h>
+#include <algorithm>
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <fcntl.h>
 #include <libiptcdata/iptc-jpeg.h>
 #include <memory>
+#include <vector>
+#include <zlib.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "rt_math.h"
 #include "procparams.h"
 #include "utils.h"
@@ -79,6 +86,57 @@ FILE* g_fopen_withBinaryAndLock(const Glib::ustring& fname)
     return f;
 }
 
+// The following functions prepare the data of a TIFF strip or tile the way libtiff does it for TIFFWriteScanline,
+// so that it can be compressed outside of libtiff and written with TIFFWriteRawStrip/TIFFWriteRawTile
+
+void swabSamples(unsigned char* data, std::size_t size, int bytesPerSample)
+{
+    if (bytesPerSample == 2) {
+        for (std::size_t i = 0; i < size; i += 2) {
+            std::swap(data[i], data[i + 1]);
+        }
+    } else if (bytesPerSample == 4) {
+        for (std::size_t i = 0; i < size; i += 4) {
+            std::swap(data[i], data[i + 3]);
+            std::swap(data[i + 1], data[i + 2]);
+        }
+    }
+}
+
+// PREDICTOR_HORIZONTAL for 3 samples per pixel, the samples are in native byte order and swapped afterwards if needed
+template<typename T>
+void horizontalDiff(unsigned char* row, int width)
+{
+    T* const samples = reinterpret_cast<T*>(row);
+
+    for (int i = 3 * width - 1; i >= 3; --i) {
+        samples[i] -= samples[i - 3];
+    }
+}
+
+// PREDICTOR_FLOATINGPOINT for 3 samples per pixel: splits the row into byte planes (most significant byte first)
+// and differences the bytes, see fpDiff() in libtiff tif_predict.c
+void floatingPointDiff(unsigned char* row, int width, int bytesPerSample, unsigned char* buffer)
+{
+    const int count = 3 * width;
+    const int size = count * bytesPerSample;
+    std::memcpy(buffer, row, size);
+
+    for (int i = 0; i < count; ++i) {
+        for (int byte = 0; byte < bytesPerSample; ++byte) {
+#if __BYTE_ORDER__==__ORDER_LITTLE_ENDIAN__
+            row[(bytesPerSample - byte - 1) * count + i] = buffer[bytesPerSample * i + byte];
+#else
+            row[byte * count + i] = buffer[bytesPerSample * i + byte];
+#endif
+        }
+    }
+
+    for (int i = size - 1; i >= 3; --i) {
+        row[i] -= row[i - 3];
+    }
+}
+
 }
 
 Glib::ustring ImageIO::errorMsg[6] = {"Success", "Cannot read file.", "Invalid header.", "Error while reading header.", "File reading error", "Image format not supported."};
@@ -1142,59 +1200,11 @@ int ImageIO::savePNG  (const Glib::ustring &fname, int bps) const
 
 
 // Quality 0..100, subsampling: 1=low quality, 2=medium, 3=high
-int ImageIO::saveJPEG (const Glib::ustring &fname, int quality, int subSamp) const
+namespace
 {
-    if (getWidth() < 1 || getHeight() < 1) {
-        return IMIO_HEADERERROR;
-    }
-
-    FILE* const file = g_fopen_withBinaryAndLock (fname);
-
-    if (!file) {
-        return IMIO_CANNOTWRITEFILE;
-    }
-
-    jpeg_compress_struct cinfo;
-    /* We use our private extension JPEG error handler.
-       Note that this struct must live as long as the main JPEG parameter
-       struct, to avoid dangling-pointer problems.
-    */
-    my_error_mgr jerr;
-    /* We set up the normal JPEG error routines, then override error_exit. */
-    cinfo.err = jpeg_std_error(&jerr.pub);
-    jerr.pub.error_exit = my_error_exit;
-
-    /* Establish the setjmp return context for my_error_exit to use. */
-#if defined( WIN32 ) && defined( __x86_64__ ) && !defined(__clang__)
-
-    if (__builtin_setjmp(jerr.setjmp_buffer)) {
-#else
-
-    if (setjmp(jerr.setjmp_buffer)) {
-#endif
-        /* If we get here, the JPEG code has signaled an error.
-           We need to clean up the JPEG object, close the file, remove the already saved part of the file and return.
-        */
-        jpeg_destroy_compress(&cinfo);
-        fclose(file);
-        g_remove (fname.c_str());
-        return IMIO_CANNOTWRITEFILE;
-    }
-
-    jpeg_create_compress (&cinfo);
-
-
-
-    if (pl) {
-        pl->setProgressStr ("PROGRESSBAR_SAVEJPEG");
-        pl->setProgress (0.0);
-    }
-
-    jpeg_stdio_dest (&cinfo, file);
-
-    int width = getWidth ();
-    int height = getHeight ();
 
+void setJPEGParameters(jpeg_compress_struct& cinfo, int width, int height, int quality, int subSamp, bool optimizeCoding)
+{
     cinfo.image_width  = width;
     cinfo.image_height = height;
     cinfo.in_color_space = JCS_RGB;
@@ -1203,7 +1213,7 @@ int ImageIO::saveJPEG (const Glib::ustring &fname, int quality, int subSamp) con
     cinfo.write_JFIF_header = FALSE;
 
     // compute optimal Huffman coding tables for the image. Bit slower to generate, but size of result image is a bit less (default was FALSE)
-    cinfo.optimize_coding = TRUE;
+    cinfo.optimize_coding = optimizeCoding;
 
     // Since math coprocessors are common these days, FLOAT should be a bit more accurate AND fast (default is ISLOW)
     // (machine dependency is not really an issue, since we all run on x86 and having exactly the same file is not a requirement)
@@ -1227,16 +1237,56 @@ int ImageIO::saveJPEG (const Glib::ustring &fname, int quality, int subSamp) con
         // Best quality 1x1 1x1 1x1 (4:4:4)
         cinfo.comp_info[0].h_samp_factor = cinfo.comp_info[0].v_samp_factor = 1;
     }
+}
 
-    jpeg_start_compress(&cinfo, TRUE);
+// libjpeg destination manager appending to a vector
+struct VectorDestination {
+    jpeg_destination_mgr pub;
+    std::vector<unsigned char>* data;
+};
+
+void initVectorDestination(j_compress_ptr cinfo)
+{
+    VectorDestination* const dest = reinterpret_cast<VectorDestination*>(cinfo->dest);
+    dest->data->resize(1 << 16);
+    dest->pub.next_output_byte = dest->data->data();
+    dest->pub.free_in_buffer = dest->data->size();
+}
+
+boolean emptyVectorDestination(j_compress_ptr cinfo)
+{
+    // called when the buffer is full
+    VectorDestination* const dest = reinterpret_cast<VectorDestination*>(cinfo->dest);
+    const std::size_t used = dest->data->size();
+    dest->data->resize(2 * used);
+    dest->pub.next_output_byte = dest->data->data() + used;
+    dest->pub.free_in_buffer = dest->data->size() - used;
+    return TRUE;
+}
+
+void termVectorDestination(j_compress_ptr cinfo)
+{
+    VectorDestination* const dest = reinterpret_cast<VectorDestination*>(cinfo->dest);
+    dest->data->resize(dest->data->size() - dest->pub.free_in_buffer);
+}
+
+// offset of the first byte after the marker segment at pos
+std::size_t skipJPEGSegment(const std::vector<unsigned char>& data, std::size_t pos)
+{
+    return pos + 2 + ((data[pos + 2] << 8) | data[pos + 3]);
+}
 
+}
+
+void ImageIO::writeJPEGMarkers (jpeg_compress_struct& cinfo, int width, int height) const
+{
     // buffer for exif and iptc markers
     unsigned char* buffer = new unsigned char[165535]; //FIXME: no buffer size check so it can be overflowed in createJPEGMarker() for large tags, and then software will crash
     unsigned int size;
 
     // assemble and write exif marker
     if (exifRoot) {
-        int size = rtexif::ExifManager::createJPEGMarker (exifRoot, *exifChange, cinfo.image_width, cinfo.image_height, buffer);
+        int size = rtexif::ExifManager::createJPEGMarker (exifRoot, *exifChange, width, height, buffer);
 
         if (size > 0 && size < 65530) {
             jpeg_write_marker(&cinfo, JPEG_APP0 + 1, buffer, size);
@@ -1277,6 +1327,248 @@ int ImageIO::saveJPEG (const Glib::ustring &fname, int quality, int subSamp) con
     if (profileData) {
         write_icc_profile (&cinfo, (JOCTET*)profileData, profileLength);
     }
+}
+
+// Encodes rows [top, top + rows) as a JPEG file of its own, with a restart marker after each MCU row
+// and the standard Huffman tables, so that the entropy coded data of the bands can be concatenated
+bool ImageIO::encodeJPEGBand (int top, int rows, int quality, int subSamp, std::vector<unsigned char>& dst) const
+{
+    jpeg_compress_struct cinfo;
+    my_error_mgr jerr;
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = my_error_exit;
+
+    std::vector<unsigned char> row(getWidth() * 3);
+
+#if defined( WIN32 ) && defined( __x86_64__ ) && !defined(__clang__)
+
+    if (__builtin_setjmp(jerr.setjmp_buffer)) {
+#else
+
+    if (setjmp(jerr.setjmp_buffer)) {
+#endif
+        jpeg_destroy_compress(&cinfo);
+        return false;
+    }
+
+    jpeg_create_compress (&cinfo);
+
+    VectorDestination dest;
+    dest.pub.init_destination = initVectorDestination;
+    dest.pub.empty_output_buffer = emptyVectorDestination;
+    dest.pub.term_destination = termVectorDestination;
+    dest.data = &dst;
+    cinfo.dest = &dest.pub;
+
+    setJPEGParameters(cinfo, getWidth(), rows, quality, subSamp, false);
+    cinfo.restart_in_rows = 1;
+
+    jpeg_start_compress(&cinfo, TRUE);
+
+    // the header of the first band becomes the header of the file
+    if (top == 0) {
+        writeJPEGMarkers(cinfo, getWidth(), getHeight());
+    }
+
+    for (int i = 0; i < rows; ++i) {
+        unsigned char* rowPtr = row.data();
+        getScanline (top + i, rowPtr, 8);
+        jpeg_write_scanlines (&cinfo, &rowPtr, 1);
+    }
+
+    jpeg_finish_compress (&cinfo);
+    jpeg_destroy_compress (&cinfo);
+    return true;
+}
+
+int ImageIO::saveJPEGBands (const Glib::ustring &fname, int quality, int subSamp, int bandHeight) const
+{
+    const int height = getHeight();
+    const int numBands = (height + bandHeight - 1) / bandHeight;
+    std::vector<std::vector<unsigned char>> bands(numBands);
+    bool ok = true;
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic)
+#endif
+
+    for (int band = 0; band < numBands; ++band) {
+        if (!encodeJPEGBand(band * bandHeight, std::min(bandHeight, height - band * bandHeight), quality, subSamp, bands[band])) {
+#ifdef _OPENMP
+            #pragma omp critical
+#endif
+            ok = false;
+        }
+    }
+
+    if (!ok) {
+        return IMIO_CANNOTWRITEFILE;
+    }
+
+    if (pl) {
+        pl->setProgress (0.9);
+    }
+
+    // Each band is a complete file: SOI, markers, SOF, DHT, DRI, SOS, entropy coded data, EOI.
+    // The file gets the header of the first band with the full height in SOF, then the entropy coded
+    // data of all bands, separated by restart markers which are renumbered to follow each other.
+    std::vector<std::size_t> dataStart(numBands);
+
+    for (int band = 0; band < numBands; ++band) {
+        const std::vector<unsigned char>& data = bands[band];
+        std::size_t pos = 2;
+
+        while (pos + 4 <= data.size() && data[pos] == 0xFF && data[pos + 1] != 0xDA) {
+            pos = skipJPEGSegment(data, pos);
+        }
+
+        if (pos + 4 > data.size() || data[pos] != 0xFF || data.size() < 2 || data[data.size() - 2] != 0xFF || data[data.size() - 1] != 0xD9) {
+            return IMIO_CANNOTWRITEFILE;
+        }
+
+        dataStart[band] = skipJPEGSegment(data, pos);
+    }
+
+    std::vector<unsigned char>& header = bands[0];
+
+    for (std::size_t pos = 2; pos < dataStart[0]; pos = skipJPEGSegment(header, pos)) {
+        if (header[pos + 1] == 0xC0) { // SOF0: length, precision, height, width
+            header[pos + 5] = height >> 8;
+            header[pos + 6] = height & 0xFF;
+        }
+    }
+
+    int restarts = 0;
+
+    for (int band = 0; band < numBands; ++band) {
+        std::vector<unsigned char>& data = bands[band];
+        const std::size_t end = data.size() - 2;
+
+        if (band > 0) {
+            // the last byte of the header of a following band becomes the restart marker at the band boundary
+            data[dataStart[band] - 2] = 0xFF;
+            data[dataStart[band] - 1] = 0xD0 + (restarts++ & 7);
+            dataStart[band] -= 2;
+        }
+
+        for (std::size_t pos = dataStart[band] + (band > 0 ? 2 : 0); pos + 1 < end; ++pos) {
+            if (data[pos] == 0xFF) {
+                if (data[pos + 1] >= 0xD0 && data[pos + 1] <= 0xD7) {
+                    data[pos + 1] = 0xD0 + (restarts++ & 7);
+                }
+
+                ++pos; // skip stuffed 0 bytes and marker codes
+            }
+        }
+    }
+
+    FILE* const file = g_fopen_withBinaryAndLock (fname);
+
+    if (!file) {
+        return IMIO_CANNOTWRITEFILE;
+    }
+
+    static const unsigned char eoi[2] = {0xFF, 0xD9};
+    ok = fwrite(header.data(), 1, dataStart[0], file) == dataStart[0];
+
+    for (int band = 0; band < numBands && ok; ++band) {
+        const std::size_t length = bands[band].size() - 2 - dataStart[band];
+        ok = fwrite(bands[band].data() + dataStart[band], 1, length, file) == length;
+    }
+
+    ok = ok && fwrite(eoi, 1, 2, file) == 2;
+    ok = fclose(file) == 0 && ok;
+
+    if (!ok) {
+        g_remove (fname.c_str());
+        return IMIO_CANNOTWRITEFILE;
+    }
+
+    if (pl) {
+        pl->setProgressStr ("PROGRESSBAR_READY");
+        pl->setProgress (1.0);
+    }
+
+    return IMIO_SUCCESS;
+}
+
+int ImageIO::saveJPEG (const Glib::ustring &fname, int quality, int subSamp) const
+{
+    if (getWidth() < 1 || getHeight() < 1) {
+        return IMIO_HEADERERROR;
+    }
+
+#ifdef _OPENMP
+    {
+        // With Output/JpegParallelBands, large images are encoded in bands of whole MCU rows in parallel. They use the
+        // standard Huffman tables instead of optimized ones, the files are larger.
+        const int mcuHeight = subSamp == 1 ? 16 : 8;
+        const int numThreads = omp_get_max_threads();
+        const int bandHeight = std::max(256, ((getHeight() + 2 * numThreads - 1) / (2 * numThreads) + mcuHeight - 1) / mcuHeight * mcuHeight);
+
+        if (settings->jpegParallelBands && numThreads > 1 && getHeight() > bandHeight) {
+            if (pl) {
+                pl->setProgressStr ("PROGRESSBAR_SAVEJPEG");
+                pl->setProgress (0.0);
+            }
+
+            return saveJPEGBands(fname, quality, subSamp, bandHeight);
+        }
+    }
+#endif
+
+    FILE* const file = g_fopen_withBinaryAndLock (fname);
+
+    if (!file) {
+        return IMIO_CANNOTWRITEFILE;
+    }
+
+    jpeg_compress_struct cinfo;
+    /* We use our private extension JPEG error handler.
+       Note that this struct must live as long as the main JPEG parameter
+       struct, to avoid dangling-pointer problems.
+    */
+    my_error_mgr jerr;
+    /* We set up the normal JPEG error routines, then override error_exit. */
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = my_error_exit;
+
+    /* Establish the setjmp return context for my_error_exit to use. */
+#if defined( WIN32 ) && defined( __x86_64__ ) && !defined(__clang__)
+
+    if (__builtin_setjmp(jerr.setjmp_buffer)) {
+#else
+
+    if (setjmp(jerr.setjmp_buffer)) {
+#endif
+        /* If we get here, the JPEG code has signaled an error.
+           We need to clean up the JPEG object, close the file, remove the already saved part of the file and return.
+        */
+        jpeg_destroy_compress(&cinfo);
+        fclose(file);
+        g_remove (fname.c_str());
+        return IMIO_CANNOTWRITEFILE;
+    }
+
+    jpeg_create_compress (&cinfo);
+
+
+
+    if (pl) {
+        pl->setProgressStr ("PROGRESSBAR_SAVEJPEG");
+        pl->setProgress (0.0);
+    }
+
+    jpeg_stdio_dest (&cinfo, file);
+
+    int width = getWidth ();
+    int height = getHeight ();
+
+    setJPEGParameters(cinfo, width, height, quality, subSamp, true);
+
+    jpeg_start_compress(&cinfo, TRUE);
+
+    writeJPEGMarkers(cinfo, width, height);
 
     // write image data
     int rowlen = width * 3;
@@ -1484,7 +1776,18 @@ int ImageIO::saveTIFF (const Glib::ustring &fname, int bps, bool isFloat, bool u
     TIFFSetField (out, TIFFTAG_IMAGELENGTH, height);
     TIFFSetField (out, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT);
     TIFFSetField (out, TIFFTAG_SAMPLESPERPIXEL, 3);
-    TIFFSetField (out, TIFFTAG_ROWSPERSTRIP, height);
+    // tiles have to be a multiple of 16 pixels
+    const int tileSize = settings->tiffTileSize > 0 ? (settings->tiffTileSize + 15) / 16 * 16 : 0;
+    // strips of about 1 MiB are compressed in parallel
+    const int rowsPerStrip = uncompressed ? height : rtengine::LIM((1 << 20) / lineWidth, 1, height);
+
+    if (tileSize > 0) {
+        TIFFSetField (out, TIFFTAG_TILEWIDTH, tileSize);
+        TIFFSetField (out, TIFFTAG_TILELENGTH, tileSize);
+    } else {
+        TIFFSetField (out, TIFFTAG_ROWSPERSTRIP, rowsPerStrip);
+    }
+
     TIFFSetField (out, TIFFTAG_BITSPERSAMPLE, bps);
     TIFFSetField (out, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
     TIFFSetField (out, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_RGB);
@@ -1511,39 +1814,159 @@ int ImageIO::saveTIFF (const Glib::ustring &fname, int bps, bool isFloat, bool u
         TIFFSetField (out, TIFFTAG_ICCPROFILE, profileLength, profileData);
     }
 
-    for (int row = 0; row < height; row++) {
-        getScanline (row, linebuffer, bps, isFloat);
+    const auto readScanline =
+        [this, bps, isFloat, uncompressed, needsReverse, lineWidth](int row, unsigned char* buffer)
+        {
+            getScanline (row, buffer, bps, isFloat);
 
-        if (bps == 16) {
-            if(needsReverse && !uncompressed && isFloat) {
-                for(int i = 0; i < lineWidth; i += 2) {
-                    char temp = linebuffer[i];
-                    linebuffer[i] = linebuffer[i + 1];
-                    linebuffer[i + 1] = temp;
+            if (bps == 16) {
+                if(needsReverse && !uncompressed && isFloat) {
+                    for(int i = 0; i < lineWidth; i += 2) {
+                        char temp = buffer[i];
+                        buffer[i] = buffer[i + 1];
+                        buffer[i + 1] = temp;
+                    }
                 }
+            } else if (bps == 32) {
+                if(needsReverse && !uncompressed) {
+                    for(int i = 0; i < lineWidth; i += 4) {
+                        char temp = buffer[i];
+                        buffer[i] = buffer[i + 3];
+                        buffer[i + 3] = temp;
+                        temp = buffer[i + 1];
+                        buffer[i + 1] = buffer[i + 2];
+                        buffer[i + 2] = temp;
+                    }
+                }
+            }
+        };
+
+    if (uncompressed && tileSize == 0) {
+        for (int row = 0; row < height; row++) {
+            readScanline (row, linebuffer);
+
+            if (TIFFWriteScanline (out, linebuffer, row, 0) < 0) {
+                TIFFClose (out);
+                delete [] linebuffer;
+                return IMIO_CANNOTWRITEFILE;
             }
-        } else if (bps == 32) {
-            if(needsReverse && !uncompressed) {
-                for(int i = 0; i < lineWidth; i += 4) {
-                    char temp = linebuffer[i];
-                    linebuffer[i] = linebuffer[i + 3];
-                    linebuffer[i + 3] = temp;
-                    temp = linebuffer[i + 1];
-                    linebuffer[i + 1] = linebuffer[i + 2];
-                    linebuffer[i + 2] = temp;
+
+            if (pl && !(row % 100)) {
+                pl->setProgress ((double)(row + 1) / height);
+            }
+        }
+    } else {
+        // Strips or rows of tiles are read, predicted and deflated in parallel, in batches to limit the memory use,
+        // and written in file order as raw data, libtiff only stores them and builds the offset tables
+        const int bytesPerSample = bps / 8;
+        const int bandHeight = tileSize > 0 ? tileSize : rowsPerStrip;
+        const int chunkWidth = tileSize > 0 ? tileSize : width;
+        const int chunksPerBand = tileSize > 0 ? (width + tileSize - 1) / tileSize : 1;
+        const int chunkLineWidth = chunkWidth * 3 * bytesPerSample;
+        const std::size_t chunkSize = static_cast<std::size_t>(chunkLineWidth) * bandHeight;
+        const int numBands = (height + bandHeight - 1) / bandHeight;
+        const bool floatPredictor = (bps == 16 || bps == 32) && isFloat;
+#ifdef _OPENMP
+        const int batchSize = 2 * omp_get_max_threads();
+#else
+        const int batchSize = 1;
+#endif
+        std::vector<std::vector<unsigned char>> chunks(static_cast<std::size_t>(batchSize) * chunksPerBand);
+
+        for (int firstBand = 0; firstBand < numBands && writeOk; firstBand += batchSize) {
+            const int lastBand = std::min(firstBand + batchSize, numBands);
+            bool compressOk = true;
+
+#ifdef _OPENMP
+            #pragma omp parallel for schedule(dynamic)
+#endif
+
+            for (int band = firstBand; band < lastBand; ++band) {
+                const int top = band * bandHeight;
+                const int rows = std::min(bandHeight, height - top);
+                std::vector<unsigned char> bandBuffer(static_cast<std::size_t>(lineWidth) * rows);
+                std::vector<unsigned char> chunk(chunkSize);
+                std::vector<unsigned char> rowBuffer(chunkLineWidth);
+
+                for (int row = 0; row < rows; ++row) {
+                    readScanline (top + row, bandBuffer.data() + static_cast<std::size_t>(row) * lineWidth);
+                }
+
+                for (int c = 0; c < chunksPerBand; ++c) {
+                    const int left = c * chunkWidth;
+                    const int lineBytes = std::min(chunkWidth, width - left) * 3 * bytesPerSample;
+                    // partial tiles are padded with 0, the last strip is not
+                    const std::size_t dataSize = tileSize > 0 ? chunkSize : static_cast<std::size_t>(chunkLineWidth) * rows;
+                    std::fill(chunk.begin(), chunk.end(), 0);
+
+                    for (int row = 0; row < rows; ++row) {
+                        unsigned char* const line = chunk.data() + static_cast<std::size_t>(row) * chunkLineWidth;
+                        std::memcpy(line, bandBuffer.data() + static_cast<std::size_t>(row) * lineWidth + left * 3 * bytesPerSample, lineBytes);
+
+                        if (uncompressed) {
+                            if (needsReverse) {
+                                swabSamples(line, chunkLineWidth, bytesPerSample);
+                            }
+                        } else if (floatPredictor) {
+                            floatingPointDiff(line, chunkWidth, bytesPerSample, rowBuffer.data());
+                        } else {
+                            if (bps == 8) {
+                                horizontalDiff<std::uint8_t>(line, chunkWidth);
+                            } else if (bps == 16) {
+                                horizontalDiff<std::uint16_t>(line, chunkWidth);
+                            } else {
+                                horizontalDiff<std::uint32_t>(line, chunkWidth);
+                            }
+
+                            if (needsReverse) {
+                                swabSamples(line, chunkLineWidth, bytesPerSample);
+                            }
+                        }
+                    }
+
+                    std::vector<unsigned char>& compressed = chunks[static_cast<std::size_t>(band - firstBand) * chunksPerBand + c];
+
+                    if (uncompressed) {
+                        compressed.assign(chunk.begin(), chunk.begin() + dataSize);
+                    } else {
+                        uLongf compressedSize = compressBound(dataSize);
+                        compressed.resize(compressedSize);
+
+                        if (compress2(compressed.data(), &compressedSize, chunk.data(), dataSize, Z_DEFAULT_COMPRESSION) != Z_OK) {
+#ifdef _OPENMP
+                            #pragma omp critical
+#endif
+                            compressOk = false;
+                        }
+
+                        compressed.resize(compressedSize);
+                    }
                 }
             }
+
+            writeOk = compressOk;
+
+            for (int band = firstBand; band < lastBand && writeOk; ++band) {
+                for (int c = 0; c < chunksPerBand && writeOk; ++c) {
+                    std::vector<unsigned char>& data = chunks[static_cast<std::size_t>(band - firstBand) * chunksPerBand + c];
+                    const tmsize_t written = tileSize > 0
+                        ? TIFFWriteRawTile (out, static_cast<ttile_t>(band) * chunksPerBand + c, data.data(), data.size())
+                        : TIFFWriteRawStrip (out, band, data.data(), data.size());
+
+                    writeOk = written == static_cast<tmsize_t>(data.size());
+                }
+            }
+
+            if (pl) {
+                pl->setProgress ((double)lastBand / numBands);
+            }
         }
 
-        if (TIFFWriteScanline (out, linebuffer, row, 0) < 0) {
+        if (!writeOk) {
             TIFFClose (out);
             delete [] linebuffer;
             return IMIO_CANNOTWRITEFILE;
         }
-
-        if (pl && !(row % 100)) {
-            pl->setProgress ((double)(row + 1) / height);
-        }
     }
 
     if (TIFFFlush(out) != 1) {
@@ -19,6 +19,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include <glibmm/ustring.h>
 
@@ -40,6 +41,8 @@ enum {
     IMIO_CANNOTWRITEFILE
 };
 
+struct jpeg_compress_struct;
+
 namespace rtexif
 {
 
@@ -82,6 +85,10 @@ protected:
 private:
     void deleteLoadedProfileData( );
 
+    void writeJPEGMarkers (jpeg_compress_struct& cinfo, int width, int height) const;
+    bool encodeJPEGBand (int top, int rows, int quality, int subSamp, std::vector<unsigned char>& dst) const;
+    int saveJPEGBands (const Glib::ustring &fname, int quality, int subSamp, int bandHeight) const;
+
 public:
     static Glib::ustring errorMsg[6];
 
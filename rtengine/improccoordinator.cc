@@ -24,6 +24,7 @@
 #include "array2D.h"
 #include "cieimage.h"
 #include "color.h"
+#include "colorspacetrace.h"
 #include "colortemp.h"
 #include "curves.h"
 #include "dcp.h"
@@ -36,6 +37,7 @@
 #include "procparams.h"
 #include "refreshmap.h"
 #include "guidedfilter.h"
+#include "taskpool.h"
 
 #include "../rtgui/options.h"
 
@@ -231,6 +233,7 @@ ImProcCoordinator::ImProcCoordinator() :
     locall_Mask(0),
     retistrsav(nullptr)
 {
+    ipf.setLocallabMaskCache(&locallabMaskCache);
 }
 
 ImProcCoordinator::~ImProcCoordinator()
@@ -297,6 +300,21 @@ void ImProcCoordinator::updatePreviewImage(int todo, bool panningRelatedChange)
 
     MyMutex::MyLock processingLock(mProcessing);
 
+    // oprevi may be a transformed copy of orig_prev which lives only during this update, also when it is abandoned
+    struct TransformedPreviewRelease {
+        ImProcCoordinator& ipc;
+
+        ~TransformedPreviewRelease()
+        {
+            if (ipc.orig_prev != ipc.oprevi) {
+                delete ipc.oprevi;
+                ipc.oprevi = nullptr;
+            }
+        }
+    } transformedPreviewRelease{*this};
+
+    ColorSpaceTrace csTrace("preview");
+
     bool highDetailNeeded = options.prevdemo == PD_Sidecar ? true : (todo & M_HIGHQUAL);
                 //    printf("metwb=%s \n", params->wb.method.c_str());
 
@@ -312,6 +330,9 @@ void ImProcCoordinator::updatePreviewImage(int todo, bool panningRelatedChange)
 
     if (((todo & ALL) == ALL) || (todo & M_MONITOR) || panningRelatedChange || (highDetailNeeded && options.prevdemo != PD_Sidecar)) {
         bwAutoR = bwAutoG = bwAutoB = -9000.f;
+        // the image may be demosaiced differently, the input of the Local Adjustments spots is not reproducible
+        locallabSpotCache.clear();
+        locallabMaskCache.clear();
 
         if (todo == CROP && ipf.needsPCVignetting()) {
             todo |= TRANSFORM;    // Change about Crop does affect TRANSFORM
@@ -668,6 +689,10 @@ void ImProcCoordinator::updatePreviewImage(int todo, bool panningRelatedChange)
 
         oprevi = orig_prev;
 
+        if (ipf.isCancelled()) {
+            return;
+        }
+
         // Remove transformation if unneeded
         bool needstransform = ipf.needsTransform(fw, fh, imgsrc->getRotateDegree(), imgsrc->getMetaData());
 
@@ -684,13 +709,18 @@ void ImProcCoordinator::updatePreviewImage(int todo, bool panningRelatedChange)
             }
         }
 
-        if ((todo & (M_TRANSFORM | M_RGBCURVE))  && params->dirpyrequalizer.cbdlMethod == "bef" && params->dirpyrequalizer.enabled && !params->colorappearance.enabled) {
+        const ColorSpacePlan csPlan(
+            (todo & (M_TRANSFORM | M_RGBCURVE)) && params->dirpyrequalizer.cbdlMethod == "bef" && params->dirpyrequalizer.enabled && !params->colorappearance.enabled,
+            ((todo & (M_AUTOEXP | M_RGBCURVE)) || (todo & M_CROP)) && params->locallab.enabled && !params->locallab.spots.empty()
+        );
+
+        if (csPlan.cbdlStandalone()) {
             const int W = oprevi->getWidth();
             const int H = oprevi->getHeight();
             LabImage labcbdl(W, H);
-            ipf.rgb2lab(*oprevi, labcbdl, params->icm.workingProfile);
+            csTrace.rgb2lab(ipf, *oprevi, labcbdl, params->icm.workingProfile, "cbdl");
             ipf.dirpyrequalizer(&labcbdl, scale);
-            ipf.lab2rgb(labcbdl, *oprevi, params->icm.workingProfile);
+            csTrace.lab2rgb(ipf, labcbdl, *oprevi, params->icm.workingProfile, "cbdl");
         }
 
         if (todo & M_AUTOEXP) {
@@ -866,7 +896,14 @@ void ImProcCoordinator::updatePreviewImage(int todo, bool panningRelatedChange)
         //    if (todo & M_RGBCURVE) {
         if (((todo & (M_AUTOEXP | M_RGBCURVE)) || (todo & M_CROP)) && params->locallab.enabled && !params->locallab.spots.empty()) {
             
-            ipf.rgb2lab(*oprevi, *oprevl, params->icm.workingProfile);
+            csTrace.rgb2lab(ipf, *oprevi, *oprevl, params->icm.workingProfile, "locallab");
+
+            if (csPlan.cbdlInLocallab()) {
+                // the frame is in Lab already, no need to convert back and forth for CBDL
+                ipf.dirpyrequalizer(oprevl, scale);
+                csTrace.elided(ColorSpaceTrace::Space::LAB, ColorSpaceTrace::Space::RGB, "cbdl", pW, pH);
+                csTrace.elided(ColorSpaceTrace::Space::RGB, ColorSpaceTrace::Space::LAB, "cbdl", pW, pH);
+            }
 
             nprevl->CopyFrom(oprevl);
             //  int maxspot = 1;
@@ -911,7 +948,29 @@ void ImProcCoordinator::updatePreviewImage(int todo, bool panningRelatedChange)
             sobelrefs.resize(params->locallab.spots.size());
             avgs.resize(params->locallab.spots.size());
 
-            for (int sp = 0; sp < (int)params->locallab.spots.size(); sp++) {
+            // the spots before the selected one usually did not change, start with the first spot which did
+            int firstSpot = 0;
+
+            if (todo & (M_PREPROC | M_RAW | M_INIT | M_LINDENOISE | M_TRANSFORM | M_BLURMAP)) {
+                locallabSpotCache.clear();
+            } else {
+                firstSpot = locallabSpotCache.restore(*params, pW, pH, scale, *nprevl, locallref, locallretiminmax);
+
+                if (firstSpot > 0) {
+                    lastorigimp->CopyFrom(nprevl);
+                }
+            }
+
+            for (int sp = firstSpot; sp < (int)params->locallab.spots.size(); sp++) {
+                if (ipf.isCancelled()) {
+                    // the image at the input of this spot is incomplete, don't store it
+                    return;
+                }
+
+                if (sp == params->locallab.selspot && sp > firstSpot) {
+                    locallabSpotCache.store(*params, sp, pW, pH, scale, *nprevl, locallref, locallretiminmax);
+                }
+
                 // Set local curves of current spot to LUT
                 locRETgainCurve.Set(params->locallab.spots.at(sp).localTgaincurve);
                 locRETtransCurve.Set(params->locallab.spots.at(sp).localTtranscurve);
@@ -1110,12 +1169,16 @@ void ImProcCoordinator::updatePreviewImage(int todo, bool panningRelatedChange)
                 }
             }
 
+            if (ipf.isCancelled()) {
+                return;
+            }
+
             // Transmit Locallab reference values and Locallab Retinex min/max to LocallabListener
             if (locallListener) {
                 locallListener->refChanged(locallref, params->locallab.selspot);
                 locallListener->minmaxChanged(locallretiminmax, params->locallab.selspot);
             }
-            ipf.lab2rgb(*nprevl, *oprevi, params->icm.workingProfile);
+            csTrace.lab2rgb(ipf, *nprevl, *oprevi, params->icm.workingProfile, "locallab");
             //*************************************************************
             // end locallab
             //*************************************************************
@@ -1217,6 +1280,7 @@ void ImProcCoordinator::updatePreviewImage(int todo, bool panningRelatedChange)
 
                 ipf.rgbProc(oprevi, oprevl, nullptr, hltonecurve, shtonecurve, tonecurve, params->toneCurve.saturation,
                             rCurve, gCurve, bCurve, colourToningSatLimit, colourToningSatLimitOpacity, ctColorCurve, ctOpacityCurve, opautili, clToningcurve, cl2Toningcurve, customToneCurve1, customToneCurve2, beforeToneCurveBW, afterToneCurveBW, rrm, ggm, bbm, bwAutoR, bwAutoG, bwAutoB, params->toneCurve.expcomp, params->toneCurve.hlcompr, params->toneCurve.hlcomprthresh, dcpProf, as, histToneCurve);
+                csTrace.converted(ColorSpaceTrace::Space::RGB, ColorSpaceTrace::Space::LAB, "rgbProc", pW, pH);
 
                 if (params->blackwhite.enabled && params->blackwhite.autoc && abwListener) {
                     if (settings->verbose) {
@@ -1512,6 +1576,10 @@ void ImProcCoordinator::updatePreviewImage(int todo, bool panningRelatedChange)
                
             }
 
+            if (ipf.isCancelled()) {
+                return;
+            }
+
             ipf.softLight(nprevl, params->softlight);
 
             if (params->colorappearance.enabled) {
@@ -1631,11 +1699,16 @@ void ImProcCoordinator::updatePreviewImage(int todo, bool panningRelatedChange)
     }
 
 // process crop, if needed
+    // the crops share ipf but are not cancellable, they are also updated from their own threads
+    ipf.setCancellationToken(nullptr);
+
     for (size_t i = 0; i < crops.size(); i++)
         if (crops[i]->hasListener() && (panningRelatedChange || (highDetailNeeded && options.prevdemo != PD_Sidecar) || (todo & (M_MONITOR | M_RGBCURVE | M_LUMACURVE)) || crops[i]->get_skip() == 1)) {
             crops[i]->update(todo);     // may call ourselves
         }
 
+    ipf.setCancellationToken(&cancelToken);
+
     if (panningRelatedChange || (todo & M_MONITOR)) {
         if ((todo != CROP && todo != MINUPDATE) || (todo & M_MONITOR)) {
             MyMutex::MyLock prevImgLock(previmg->getMutex());
@@ -1684,12 +1757,7 @@ void ImProcCoordinator::updatePreviewImage(int todo, bool panningRelatedChange)
         }
     }
 
-    if (orig_prev != oprevi) {
-        delete oprevi;
-        oprevi = nullptr;
-    }
-
-
+    csTrace.print();
 }
 
 
@@ -1708,6 +1776,8 @@ void ImProcCoordinator::freeAll()
         oprevl    = nullptr;
         delete nprevl;
         nprevl    = nullptr;
+        locallabSpotCache.clear();
+        locallabMaskCache.clear();
 
         if (ncie) {
             delete ncie;
@@ -2333,6 +2403,11 @@ void ImProcCoordinator::startProcessing(int changeCode)
 {
     paramsUpdateMutex.lock();
     changeSinceLast |= changeCode;
+
+    if (updaterRunning && (changeCode & (M_VOID - 1))) {
+        cancelToken.cancel();
+    }
+
     paramsUpdateMutex.unlock();
 
     startProcessing();
@@ -2340,15 +2415,22 @@ void ImProcCoordinator::startProcessing(int changeCode)
 
 void ImProcCoordinator::process()
 {
+    TaskPool::applyThreadLimit();
+
     if (plistener) {
         plistener->setProgressState(true);
     }
 
+    // only the updates of this thread may be cancelled, not the crop updates started by the detail windows
+    ipf.setCancellationToken(&cancelToken);
+    bool cancelledPanningChange = false;
+
     paramsUpdateMutex.lock();
 
     while (changeSinceLast) {
         const bool panningRelatedChange =
-            params->toneCurve.isPanningRelatedChange(nextParams->toneCurve)
+            cancelledPanningChange
+            || params->toneCurve.isPanningRelatedChange(nextParams->toneCurve)
             || params->labCurve != nextParams->labCurve
             || params->locallab != nextParams->locallab
             || params->localContrast != nextParams->localContrast
@@ -2390,6 +2472,7 @@ void ImProcCoordinator::process()
         *params = *nextParams;
         int change = changeSinceLast;
         changeSinceLast = 0;
+        cancelToken.reset();
         paramsUpdateMutex.unlock();
 
         // M_VOID means no update, and is a bit higher that the rest
@@ -2398,9 +2481,17 @@ void ImProcCoordinator::process()
         }
 
         paramsUpdateMutex.lock();
+
+        // the stages of a cancelled update hold incomplete data, they have to be computed again with the new changes
+        cancelledPanningChange = cancelToken.isCancelled() && panningRelatedChange;
+
+        if (cancelToken.isCancelled()) {
+            changeSinceLast |= change;
+        }
     }
 
     paramsUpdateMutex.unlock();
+    ipf.setCancellationToken(nullptr);
     updaterRunning = false;
 
     if (plistener) {
@@ -2425,6 +2516,11 @@ void ImProcCoordinator::endUpdateParams(int changeFlags)
 {
     changeSinceLast |= changeFlags;
 
+    // the running update is outdated, abandon it as soon as possible
+    if (updaterRunning && (changeFlags & (M_VOID - 1))) {
+        cancelToken.cancel();
+    }
+
     paramsUpdateMutex.unlock();
     startProcessing();
 }
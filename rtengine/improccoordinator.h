@@ -26,6 +26,8 @@
 #include "dcrop.h"
 #include "imagesource.h"
 #include "improcfun.h"
+#include "locallabmaskcache.h"
+#include "locallabspotcache.h"
 #include "LUT.h"
 #include "rtengine.h"
 
@@ -234,6 +236,7 @@ protected:
     MyMutex paramsUpdateMutex;
     int  changeSinceLast;
     bool updaterRunning;
+    CancellationToken cancelToken; // set when new changes arrive while an update is running
     const std::unique_ptr<ProcParams> nextParams;
     bool destroying;
     bool utili;
@@ -339,6 +342,8 @@ protected:
     std::vector<float> lumarefs;
     std::vector<float> sobelrefs;
     std::vector<float> avgs;
+    LocallabSpotCache locallabSpotCache;
+    LocallabMaskCache locallabMaskCache;
     bool lastspotdup;
     bool previewDeltaE;
     int locallColorMask;
@@ -32,6 +32,7 @@
 #include "clutstore.h"
 #include "color.h"
 #include "colortemp.h"
+#include "compactlut.h"
 #include "curves.h"
 #include "dcp.h"
 #include "EdgePreservingDecomposition.h"
@@ -60,7 +61,8 @@ using namespace rtengine;
 
 
 // begin of helper function for rgbProc()
-void shadowToneCurve(const LUTf &shtonecurve, float *rtemp, float *gtemp, float *btemp, int istart, int tH, int jstart, int tW, int tileSize)
+template<class LUTType>
+void shadowToneCurve(const LUTType &shtonecurve, float *rtemp, float *gtemp, float *btemp, int istart, int tH, int jstart, int tW, int tileSize)
 {
 
 #if defined( __SSE2__ ) && defined( __x86_64__ )
@@ -105,7 +107,8 @@ void shadowToneCurve(const LUTf &shtonecurve, float *rtemp, float *gtemp, float
     }
 }
 
-void highlightToneCurve(const LUTf &hltonecurve, float *rtemp, float *gtemp, float *btemp, int istart, int tH, int jstart, int tW, int tileSize, float exp_scale, float comp, float hlrange)
+template<class LUTType>
+void highlightToneCurve(const LUTType &hltonecurve, float *rtemp, float *gtemp, float *btemp, int istart, int tH, int jstart, int tW, int tileSize, float exp_scale, float comp, float hlrange)
 {
 
 #if defined( __SSE2__ ) && defined( __x86_64__ )
@@ -172,6 +175,55 @@ void highlightToneCurve(const LUTf &hltonecurve, float *rtemp, float *gtemp, flo
     }
 }
 
+template<class LUTType>
+void brightnessContrastCurve(const LUTType &tonecurve, float *rtemp, float *gtemp, float *btemp, int istart, int tH, int jstart, int tW, int tileSize)
+{
+    for (int i = istart, ti = 0; i < tH; i++, ti++) {
+        int j = jstart, tj = 0;
+#ifdef __SSE2__
+        float tmpr[4] ALIGNED16;
+        float tmpg[4] ALIGNED16;
+        float tmpb[4] ALIGNED16;
+
+        for (; j < tW - 3; j+=4, tj+=4) {
+            //brightness/contrast
+            STVF(tmpr[0], tonecurve(LVF(rtemp[ti * tileSize + tj])));
+            STVF(tmpg[0], tonecurve(LVF(gtemp[ti * tileSize + tj])));
+            STVF(tmpb[0], tonecurve(LVF(btemp[ti * tileSize + tj])));
+
+            for (int k = 0; k < 4; ++k) {
+                setUnlessOOG(rtemp[ti * tileSize + tj + k], gtemp[ti * tileSize + tj + k], btemp[ti * tileSize + tj + k], tmpr[k], tmpg[k], tmpb[k]);
+            }
+        }
+
+#endif
+
+        for (; j < tW; j++, tj++) {
+            //brightness/contrast
+            setUnlessOOG(rtemp[ti * tileSize + tj], gtemp[ti * tileSize + tj], btemp[ti * tileSize + tj], tonecurve[rtemp[ti * tileSize + tj]], tonecurve[gtemp[ti * tileSize + tj]], tonecurve[btemp[ti * tileSize + tj]]);
+        }
+    }
+}
+
+template<class LUTType>
+void brightnessContrastCurveHistogram(const LUTType &tonecurve, float *rtemp, float *gtemp, float *btemp, int istart, int tH, int jstart, int tW, int tileSize, const float lumimulf[3], LUTu &histToneCurve, int histToneCurveCompression)
+{
+    for (int i = istart, ti = 0; i < tH; i++, ti++) {
+        for (int j = jstart, tj = 0; j < tW; j++, tj++) {
+
+            //brightness/contrast
+            float r = tonecurve[ CLIP(rtemp[ti * tileSize + tj]) ];
+            float g = tonecurve[ CLIP(gtemp[ti * tileSize + tj]) ];
+            float b = tonecurve[ CLIP(btemp[ti * tileSize + tj]) ];
+
+            int y = CLIP<int> (lumimulf[0] * Color::gamma2curve[rtemp[ti * tileSize + tj]] + lumimulf[1] * Color::gamma2curve[gtemp[ti * tileSize + tj]] + lumimulf[2] * Color::gamma2curve[btemp[ti * tileSize + tj]]);
+            histToneCurve[y >> histToneCurveCompression]++;
+
+            setUnlessOOG(rtemp[ti * tileSize + tj], gtemp[ti * tileSize + tj], btemp[ti * tileSize + tj], r, g, b);
+        }
+    }
+}
+
 void proPhotoBlue(float *rtemp, float *gtemp, float *btemp, int istart, int tH, int jstart, int tW, int tileSize)
 {
     // this is a hack to avoid the blue=>black bug (Issue 2141)
@@ -1010,6 +1062,8 @@ void ImProcFunctions::ciecam_02float(CieImage* ncie, float adap, int pW, int pwb
         }
 
 
+        const CamAdjustParams camAdjust = {alg, chr, schr, mchr, rstprotection, hue, coe, coefQ, QproFactor, wh, &CAMBrightCurveJ, &CAMBrightCurveQ};
+
         //matrix for current working space
         TMatrix wiprof = ICCStore::getInstance()->workingSpaceInverseMatrix (params->icm.workingProfile);
         const float wip[3][3] = {
@@ -1091,13 +1145,15 @@ void ImProcFunctions::ciecam_02float(CieImage* ncie, float adap, int pW, int pwb
                     sbuffer[k] = s;
                 }
 
+                // vectorized lightness, chroma and hue adjustments
+                Ciecam02::jchqmsAdjustfloat(Jbuffer, Cbuffer, hbuffer, Qbuffer, Mbuffer, sbuffer, width, camAdjust);
 #endif // __SSE2__
 
                 for (int j = 0; j < width; j++) {
                     float J, C, h, Q, M, s;
 
 #ifdef __SSE2__
-                    // use precomputed values from above
+                    // use precomputed (and adjusted) values from above
                     J = Jbuffer[j];
                     C = Cbuffer[j];
                     h = hbuffer[j];
@@ -1121,6 +1177,7 @@ void ImProcFunctions::ciecam_02float(CieImage* ncie, float adap, int pW, int pwb
                                                        x,  y,  z,
                                                        xw1, yw1,  zw1,
                                                          c,  nc, pow1, nbb, ncb, pfl, cz, d, c16);
+                    Ciecam02::jchqmsAdjustfloat(J, C, h, Q, M, s, camAdjust);
 #endif
                     float Jpro, Cpro, hpro, Qpro, Mpro, spro;
                     Jpro = J;
@@ -1130,92 +1187,6 @@ void ImProcFunctions::ciecam_02float(CieImage* ncie, float adap, int pW, int pwb
                     Mpro = M;
                     spro = s;
 
-                    // we cannot have all algorithms with all chroma curves
-                    if (alg == 0) {
-                        Jpro = CAMBrightCurveJ[Jpro * 327.68f]; //lightness CIECAM02 + contrast
-                        Qpro = QproFactor * sqrtf(Jpro);
-                        float Cp = (spro * spro * Qpro) / (1000000.f);
-                        Cpro = Cp * 100.f;
-                        float sres;
-                        Ciecam02::curvecolorfloat(chr, Cp, sres, 1.8f);
-                        Color::skinredfloat(Jpro, hpro, sres, Cp, 55.f, 30.f, 1, rstprotection, 100.f, Cpro);
-                    } else if (alg == 1)  {
-                        // Lightness saturation
-                        Jpro = CAMBrightCurveJ[Jpro * 327.68f]; //lightness CIECAM02 + contrast
-                        float sres;
-                        float Sp = spro / 100.0f;
-                        float parsat = 1.5f; //parsat=1.5 =>saturation  ; 1.8 => chroma ; 2.5 => colorfullness (personal evaluation)
-                        Ciecam02::curvecolorfloat(schr, Sp, sres, parsat);
-                        float dred = 100.f; // in C mode
-                        float protect_red = 80.0f; // in C mode
-                        dred = 100.0f * sqrtf((dred * coe) / Qpro);
-                        protect_red = 100.0f * sqrtf((protect_red * coe) / Qpro);
-                        Color::skinredfloat(Jpro, hpro, sres, Sp, dred, protect_red, 0, rstprotection, 100.f, spro);
-                        Qpro = QproFactor * sqrtf(Jpro);
-                        Cpro = (spro * spro * Qpro) / (10000.0f);
-                    } else if (alg == 2) {
-                        //printf("Qp0=%f ", Qpro);
-
-                        Qpro = CAMBrightCurveQ[(float)(Qpro * coefQ)] / coefQ;   //brightness and contrast
-                        //printf("Qpaf=%f ", Qpro);
-
-                        float Mp, sres;
-                        Mp = Mpro / 100.0f;
-                        Ciecam02::curvecolorfloat(mchr, Mp, sres, 2.5f);
-                        float dred = 100.f; //in C mode
-                        float protect_red = 80.0f; // in C mode
-                        dred *= coe; //in M mode
-                        protect_red *= coe; //M mode
-                        Color::skinredfloat(Jpro, hpro, sres, Mp, dred, protect_red, 0, rstprotection, 100.f, Mpro);
-                        Jpro = SQR((10.f * Qpro) / wh);
-                        Cpro = Mpro / coe;
-                        Qpro = (Qpro == 0.f ? epsil : Qpro); // avoid division by zero
-                        spro = 100.0f * sqrtf(Mpro / Qpro);
-                    } else { /*if(alg == 3) */
-                        Qpro = CAMBrightCurveQ[(float)(Qpro * coefQ)] / coefQ;   //brightness and contrast
-
-                        float Mp, sres;
-                        Mp = Mpro / 100.0f;
-                        Ciecam02::curvecolorfloat(mchr, Mp, sres, 2.5f);
-                        float dred = 100.f; //in C mode
-                        float protect_red = 80.0f; // in C mode
-                        dred *= coe; //in M mode
-                        protect_red *= coe; //M mode
-                        Color::skinredfloat(Jpro, hpro, sres, Mp, dred, protect_red, 0, rstprotection, 100.f, Mpro);
-                        Jpro = SQR((10.f * Qpro) / wh);
-                        Cpro = Mpro / coe;
-                        Qpro = (Qpro == 0.f ? epsil : Qpro); // avoid division by zero
-                        spro = 100.0f * sqrtf(Mpro / Qpro);
-
-                        if (Jpro > 99.9f) {
-                            Jpro = 99.9f;
-                        }
-
-                        Jpro = CAMBrightCurveJ[(float)(Jpro * 327.68f)];   //lightness CIECAM02 + contrast
-                        float Sp = spro / 100.0f;
-                        Ciecam02::curvecolorfloat(schr, Sp, sres, 1.5f);
-                        dred = 100.f; // in C mode
-                        protect_red = 80.0f; // in C mode
-                        dred = 100.0f * sqrtf((dred * coe) / Q);
-                        protect_red = 100.0f * sqrtf((protect_red * coe) / Q);
-                        Color::skinredfloat(Jpro, hpro, sres, Sp, dred, protect_red, 0, rstprotection, 100.f, spro);
-                        Qpro = QproFactor * sqrtf(Jpro);
-                        float Cp = (spro * spro * Qpro) / (1000000.f);
-                        Cpro = Cp * 100.f;
-                        Ciecam02::curvecolorfloat(chr, Cp, sres, 1.8f);
-                        Color::skinredfloat(Jpro, hpro, sres, Cp, 55.f, 30.f, 1, rstprotection, 100.f, Cpro);
-// disabled this code, Issue 2690
-//              if(Jpro < 1.f && Cpro > 12.f) Cpro=12.f;//reduce artifacts by "pseudo gamut control CIECAM"
-//              else if(Jpro < 2.f && Cpro > 15.f) Cpro=15.f;
-//              else if(Jpro < 4.f && Cpro > 30.f) Cpro=30.f;
-//              else if(Jpro < 7.f && Cpro > 50.f) Cpro=50.f;
-                        hpro = hpro + hue;
-
-                        if (hpro < 0.0f) {
-                            hpro += 360.0f;    //hue
-                        }
-                    }
-
                     if (hasColCurve1) {//curve 1 with Lightness and Brightness
                         if (curveMode == ColorAppearanceParams::TcMode::LIGHT) {
                             float Jj = (float) Jpro * 327.68f;
@@ -2326,6 +2297,23 @@ void ImProcFunctions::rgbProc (Imagefloat* working, LabImage* lab, PipetteBuffer
         histToneCurveCompression = log2(65536 / toneCurveHistSize);
     }
 
+    // The three tone curves are looked up for every pixel. Their 65536 entries LUTs don't fit into L1/L2 together,
+    // so optionally use compact copies of them, as long as those are accurate enough (see compactlut.h)
+    CompactLUTf hltonecurveCompact;
+    CompactLUTf shtonecurveCompact;
+    CompactLUTf tonecurveCompact;
+
+    if (settings->compactLUTs) {
+        // hltonecurve and shtonecurve are factors applied to values in [0;65535], tonecurve maps [0;65535] to [0;65535]
+        hltonecurveCompact.build(hltonecurve, 0.5f / 65535.f);
+
+        if (params->toneCurve.black != 0.0) {
+            shtonecurveCompact.build(shtonecurve, 0.5f / 65535.f);
+        }
+
+        tonecurveCompact.build(tonecurve, 0.5f);
+    }
+
     // For tonecurve histogram
     const float lumimulf[3] = {static_cast<float>(lumimul[0]), static_cast<float>(lumimul[1]), static_cast<float>(lumimul[2])};
 
@@ -2421,9 +2409,18 @@ void ImProcFunctions::rgbProc (Imagefloat* working, LabImage* lab, PipetteBuffer
                     }
                 }
 
-                highlightToneCurve(hltonecurve, rtemp, gtemp, btemp, istart, tH, jstart, tW, TS, exp_scale, comp, hlrange);
+                if (hltonecurveCompact) {
+                    highlightToneCurve(hltonecurveCompact, rtemp, gtemp, btemp, istart, tH, jstart, tW, TS, exp_scale, comp, hlrange);
+                } else {
+                    highlightToneCurve(hltonecurve, rtemp, gtemp, btemp, istart, tH, jstart, tW, TS, exp_scale, comp, hlrange);
+                }
+
                 if (params->toneCurve.black != 0.0) {
-                    shadowToneCurve(shtonecurve, rtemp, gtemp, btemp, istart, tH, jstart, tW, TS);
+                    if (shtonecurveCompact) {
+                        shadowToneCurve(shtonecurveCompact, rtemp, gtemp, btemp, istart, tH, jstart, tW, TS);
+                    } else {
+                        shadowToneCurve(shtonecurve, rtemp, gtemp, btemp, istart, tH, jstart, tW, TS);
+                    }
                 }
 
                 if (dcpProf) {
@@ -2451,45 +2448,16 @@ void ImProcFunctions::rgbProc (Imagefloat* working, LabImage* lab, PipetteBuffer
                 }
 
                 if (histToneCurveThr) {
-                    for (int i = istart, ti = 0; i < tH; i++, ti++) {
-                        for (int j = jstart, tj = 0; j < tW; j++, tj++) {
-
-                            //brightness/contrast
-                            float r = tonecurve[ CLIP(rtemp[ti * TS + tj]) ];
-                            float g = tonecurve[ CLIP(gtemp[ti * TS + tj]) ];
-                            float b = tonecurve[ CLIP(btemp[ti * TS + tj]) ];
-
-                            int y = CLIP<int> (lumimulf[0] * Color::gamma2curve[rtemp[ti * TS + tj]] + lumimulf[1] * Color::gamma2curve[gtemp[ti * TS + tj]] + lumimulf[2] * Color::gamma2curve[btemp[ti * TS + tj]]);
-                            histToneCurveThr[y >> histToneCurveCompression]++;
-
-                            setUnlessOOG(rtemp[ti * TS + tj], gtemp[ti * TS + tj], btemp[ti * TS + tj], r, g, b);
-                        }
+                    if (tonecurveCompact) {
+                        brightnessContrastCurveHistogram(tonecurveCompact, rtemp, gtemp, btemp, istart, tH, jstart, tW, TS, lumimulf, histToneCurveThr, histToneCurveCompression);
+                    } else {
+                        brightnessContrastCurveHistogram(tonecurve, rtemp, gtemp, btemp, istart, tH, jstart, tW, TS, lumimulf, histToneCurveThr, histToneCurveCompression);
                     }
                 } else {
-                    for (int i = istart, ti = 0; i < tH; i++, ti++) {
-                        int j = jstart, tj = 0;
-#ifdef __SSE2__
-                        float tmpr[4] ALIGNED16;
-                        float tmpg[4] ALIGNED16;
-                        float tmpb[4] ALIGNED16;
-
-                        for (; j < tW - 3; j+=4, tj+=4) {
-                            //brightness/contrast
-                            STVF(tmpr[0], tonecurve(LVF(rtemp[ti * TS + tj])));
-                            STVF(tmpg[0], tonecurve(LVF(gtemp[ti * TS + tj])));
-                            STVF(tmpb[0], tonecurve(LVF(btemp[ti * TS + tj])));
-
-                            for (int k = 0; k < 4; ++k) {
-                                setUnlessOOG(rtemp[ti * TS + tj + k], gtemp[ti * TS + tj + k], btemp[ti * TS + tj + k], tmpr[k], tmpg[k], tmpb[k]);
-                            }
-                        }
-
-#endif
-
-                        for (; j < tW; j++, tj++) {
-                            //brightness/contrast
-                            setUnlessOOG(rtemp[ti * TS + tj], gtemp[ti * TS + tj], btemp[ti * TS + tj], tonecurve[rtemp[ti * TS + tj]], tonecurve[gtemp[ti * TS + tj]], tonecurve[btemp[ti * TS + tj]]);
-                        }
+                    if (tonecurveCompact) {
+                        brightnessContrastCurve(tonecurveCompact, rtemp, gtemp, btemp, istart, tH, jstart, tW, TS);
+                    } else {
+                        brightnessContrastCurve(tonecurve, rtemp, gtemp, btemp, istart, tH, jstart, tW, TS);
                     }
                 }
 
@@ -5039,7 +5007,7 @@ void ImProcFunctions::EPDToneMapCIE(CieImage *ncie, float a_w, float c_, int Wid
         Qpro = maxQ;
     }
 
-    EdgePreservingDecomposition epd(Wid, Hei);
+    EdgePreservingDecomposition epd(Wid, Hei, params->epd.legacySolver);
 
 #ifdef _OPENMP
     #pragma omp parallel for
@@ -5133,7 +5101,7 @@ void ImProcFunctions::EPDToneMaplocal(int sp, LabImage *lab, LabImage *tmp1, uns
     std::size_t N = static_cast<size_t>(lab->W) * static_cast<size_t>(lab->H);
     int WW = lab->W ;
 
-    EdgePreservingDecomposition epd(lab->W, lab->H);
+    EdgePreservingDecomposition epd(lab->W, lab->H, params->locallab.spots.at(sp).legacysolvertm);
 
     //Due to the taking of logarithms, L must be nonnegative. Further, scale to 0 to 1 using nominal range of L, 0 to 15 bit.
     float minL = L[0];
@@ -5229,7 +5197,7 @@ void ImProcFunctions::EPDToneMap(LabImage *lab, unsigned int Iterates, int skip)
     float *b = lab->b[0];
     const size_t N = lab->W * lab->H;
 
-    EdgePreservingDecomposition epd(lab->W, lab->H);
+    EdgePreservingDecomposition epd(lab->W, lab->H, params->epd.legacySolver);
 
     //Due to the taking of logarithms, L must be nonnegative. Further, scale to 0 to 1 using nominal range of L, 0 to 15 bit.
     float minL = L[0];
@@ -18,9 +18,11 @@
  */
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <vector>
 
+#include "cancellation.h"
 #include "coord2d.h"
 #include "gamutwarning.h"
 #include "jaggedarray.h"
@@ -57,6 +59,7 @@ class LocCCmaskCurve;
 class LocLLmaskCurve;
 class LocHHmaskCurve;
 class LocwavCurve;
+class LocallabMaskCache;
 class LocretigainCurve;
 class LocretitransCurve;
 class LocLHCurve;
@@ -110,6 +113,8 @@ class ImProcFunctions
     const procparams::ProcParams* params;
     double scale;
     bool multiThread;
+    std::atomic<const CancellationToken*> cancelToken; // set and cleared by the preview updater, read by the kernels of any thread using this instance
+    LocallabMaskCache* locallabMaskCache;
 
     void calcVignettingParams(int oW, int oH, const procparams::VignettingParams& vignetting, double &w2, double &h2, double& maxRadius, double &v, double &b, double &mul);
 
@@ -145,7 +150,7 @@ enum class BlurType {
     double lumimul[3];
 
     explicit ImProcFunctions(const procparams::ProcParams* iparams, bool imultiThread = true)
-        : monitorTransform(nullptr), params(iparams), scale(1), multiThread(imultiThread), lumimul{} {}
+        : monitorTransform(nullptr), params(iparams), scale(1), multiThread(imultiThread), cancelToken(nullptr), locallabMaskCache(nullptr), lumimul{} {}
     ~ImProcFunctions();
     bool needsLuminanceOnly()
     {
@@ -153,6 +158,24 @@ enum class BlurType {
     }
     void setScale(double iscale);
 
+    // the heavy kernels (wavelets, denoise, Fattal, Local Adjustments, dehaze) return early once token is cancelled
+    void setCancellationToken(const CancellationToken* token)
+    {
+        cancelToken.store(token, std::memory_order_release);
+    }
+
+    bool isCancelled() const
+    {
+        const CancellationToken* const token = cancelToken.load(std::memory_order_acquire);
+        return token && token->isCancelled();
+    }
+
+    // the masks of the Local Adjustments tools are looked up in and stored to maskCache
+    void setLocallabMaskCache(LocallabMaskCache* maskCache)
+    {
+        locallabMaskCache = maskCache;
+    }
+
     bool needsTransform(int oW, int oH, int rawRotationDeg, const FramesMetaData *metadata) const;
     bool needsPCVignetting() const;
 
@@ -33,6 +33,8 @@
 #include "profilestore.h"
 #include "../rtgui/threadutils.h"
 #include "rtlensfun.h"
+#include "startuptimer.h"
+#include "taskpool.h"
 #include "procparams.h"
 
 namespace rtengine
@@ -46,63 +48,63 @@ MyMutex *fftwMutex = nullptr;
 int init (const Settings* s, const Glib::ustring& baseDir, const Glib::ustring& userSettingsDir, bool loadAll)
 {
     settings = s;
-    ProcParams::init();
-    PerceptualToneCurve::init();
-    RawImageSource::init();
+    TaskPool::applyThreadLimit();
 
-#ifdef _OPENMP
-#pragma omp parallel sections if (!settings->verbose)
-#endif
-{
-#ifdef _OPENMP
-#pragma omp section
-#endif
-{
+    {
+        StartupTimer timer("procparams");
+        ProcParams::init();
+    }
+    {
+        StartupTimer timer("perceptual tone curve");
+        PerceptualToneCurve::init();
+    }
+    {
+        StartupTimer timer("raw image source");
+        RawImageSource::init();
+    }
+
+    // These only record their paths here and load on first use, which a batch run
+    // without lens correction, dark frames or flat fields never triggers
     if (s->lensfunDbDirectory.empty() || Glib::path_is_absolute(s->lensfunDbDirectory)) {
         LFDatabase::init(s->lensfunDbDirectory);
     } else {
         LFDatabase::init(Glib::build_filename(baseDir, s->lensfunDbDirectory));
     }
-}
-#ifdef _OPENMP
-#pragma omp section
-#endif
-{
-    ProfileStore::getInstance()->init(loadAll);
-}
-#ifdef _OPENMP
-#pragma omp section
-#endif
-{
-    ICCStore::getInstance()->init(s->iccDirectory, Glib::build_filename (baseDir, "iccprofiles"), loadAll);
-}
+    CameraConstantsStore::getInstance()->init(baseDir, userSettingsDir);
+    dfm.init(s->darkFramesPath);
+    ffm.init(s->flatFieldsPath);
+
 #ifdef _OPENMP
-#pragma omp section
+#pragma omp parallel sections if (!settings->verbose)
 #endif
 {
-    DCPStore::getInstance()->init(Glib::build_filename (baseDir, "dcpprofiles"), loadAll);
-}
 #ifdef _OPENMP
 #pragma omp section
 #endif
 {
-    CameraConstantsStore::getInstance()->init(baseDir, userSettingsDir);
+    StartupTimer timer("processing profiles");
+    ProfileStore::getInstance()->init(loadAll);
 }
 #ifdef _OPENMP
 #pragma omp section
 #endif
 {
-    dfm.init(s->darkFramesPath);
+    StartupTimer timer("ICC profiles");
+    ICCStore::getInstance()->init(s->iccDirectory, Glib::build_filename (baseDir, "iccprofiles"), loadAll);
 }
 #ifdef _OPENMP
 #pragma omp section
 #endif
 {
-    ffm.init(s->flatFieldsPath);
+    StartupTimer timer("DCP profiles");
+    DCPStore::getInstance()->init(Glib::build_filename (baseDir, "dcpprofiles"), loadAll);
 }
 }
 
-    Color::init ();
+    {
+        StartupTimer timer("color tables");
+        Color::init ();
+    }
     delete lcmsMutex;
     lcmsMutex = new MyMutex;
     fftwMutex = new MyMutex;
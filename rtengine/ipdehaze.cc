@@ -368,11 +368,19 @@ void ImProcFunctions::dehaze(Imagefloat *img, const DehazeParams &dehazeParams)
         get_dark_channel(R, G, B, dark, patchsize, ambient, true, multiThread, strength);
     }
 
+    if (isCancelled()) {
+        return;
+    }
+
     const int radius = patchsize * 4;
     constexpr float epsilon = 1e-5f;
 
     array2D<float> guideB(W, H, img->b.ptrs, ARRAY2D_BYREFERENCE);
     guidedFilter(guideB, dark, dark, radius, epsilon, multiThread);
+
+    if (isCancelled()) {
+        return;
+    }
         
     if (settings->verbose) {
         std::cout << "dehaze: max distance is " << maxDistance << std::endl;
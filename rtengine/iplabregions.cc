@@ -18,6 +18,10 @@
  *  along with RawTherapee.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include "array2D.h"
 #include "color.h"
 #include "curves.h"
@@ -146,13 +150,30 @@ BENCHFUN
         }
     }
 
+    // the masks of all regions have the same guide. The guide keeps the planes of one radius only, so the masks
+    // are filtered ordered by radius, each radius computes them once.
+    GuidedFilterGuide maskGuide(guide, multiThread);
+    std::vector<std::pair<int, int>> abFilters; // radius, region
+    std::vector<std::pair<int, int>> LFilters;
+
     for (int i = begin_idx; i < end_idx; ++i) {
         double blur = params->colorToning.labregions[i].maskBlur;
         blur = blur < 0.0 ? -1.0 / blur : 1.0 + blur;
         int r1 = max(int(4 / scale * blur + 0.5), 1);
         int r2 = max(int(25 / scale * blur + 0.5), 1);
-        rtengine::guidedFilter(guide, abmask[i], abmask[i], r1, 0.001, multiThread);
-        rtengine::guidedFilter(guide, Lmask[i], Lmask[i], r2, 0.0001, multiThread);
+        abFilters.emplace_back(r1, i);
+        LFilters.emplace_back(r2, i);
+    }
+
+    std::sort(abFilters.begin(), abFilters.end());
+    std::sort(LFilters.begin(), LFilters.end());
+
+    for (const auto &f : abFilters) {
+        rtengine::guidedFilter(maskGuide, abmask[f.second], abmask[f.second], f.first, 0.001, multiThread);
+    }
+
+    for (const auto &f : LFilters) {
+        rtengine::guidedFilter(maskGuide, Lmask[f.second], Lmask[f.second], f.first, 0.0001, multiThread);
     }
 
     if (show_mask_idx >= 0) {
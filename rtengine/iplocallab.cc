@@ -21,6 +21,7 @@
 
  */
 #include <cmath>
+#include <vector>
 #include <fftw3.h>
 
 #include "improcfun.h"
@@ -30,6 +31,7 @@
 #include "iccstore.h"
 #include "imagefloat.h"
 #include "labimage.h"
+#include "locallabmaskcache.h"
 #include "color.h"
 #include "rt_math.h"
 #include "jaggedarray.h"
@@ -1765,6 +1767,55 @@ static void calcTransition(const float lox, const float loy, const float ach, co
     }
 }
 
+// Part of a GW x GH buffer at position cx, cy which is covered by the spot (selection and transition zone),
+// enlarged by the support of a gaussian blur of radius (6 sigma) and clipped to the buffer
+struct SpotRegion {
+    int x; // left column in buffer coordinates
+    int y; // top row in buffer coordinates
+    int W;
+    int H;
+};
+
+static SpotRegion calcSpotRegion(const local_params& lp, int cx, int cy, int GW, int GH, float radius)
+{
+    const int halo = static_cast<int>(std::ceil(6.f * radius)) + 2;
+    const int xstart = LIM(static_cast<int>(lp.xc - lp.lxL) - cx - halo, 0, GW - 1);
+    const int ystart = LIM(static_cast<int>(lp.yc - lp.lyT) - cy - halo, 0, GH - 1);
+    const int xend = LIM(static_cast<int>(lp.xc + lp.lx) - cx + 1 + halo, xstart + 1, GW);
+    const int yend = LIM(static_cast<int>(lp.yc + lp.ly) - cy + 1 + halo, ystart + 1, GH);
+    return {xstart, ystart, xend - xstart, yend - ystart};
+}
+
+// The spot tools compute deltaE against a blurred copy of the image, but only read it inside the spot.
+// Blurring the region of the spot gives the same values there (within rounding) as blurring the whole buffer.
+// Returns the blurred region, which is indexed by [y - region.y][x - region.x]
+static std::unique_ptr<LabImage> blurSpotRegion(const LabImage* src, const SpotRegion& region, float radius, bool multiThread)
+{
+    std::unique_ptr<LabImage> dst(new LabImage(region.W, region.H));
+    // row pointers into src, this way the region is blurred without copying it first
+    std::vector<float*> rows(3 * region.H);
+    float** const srcL = rows.data();
+    float** const srca = srcL + region.H;
+    float** const srcb = srca + region.H;
+
+    for (int y = 0; y < region.H; ++y) {
+        srcL[y] = src->L[region.y + y] + region.x;
+        srca[y] = src->a[region.y + y] + region.x;
+        srcb[y] = src->b[region.y + y] + region.x;
+    }
+
+#ifdef _OPENMP
+    #pragma omp parallel if (multiThread)
+#endif
+    {
+        float** const srcPlanes[3] = {srcL, srca, srcb};
+        float** const dstPlanes[3] = {dst->L, dst->a, dst->b};
+        gaussianBlur(srcPlanes, dstPlanes, 3, region.W, region.H, radius);
+    }
+
+    return dst;
+}
+
 // Copyright 2018 Alberto Griggio <alberto.griggio@gmail.com>
 //J.Desmis 12 2019 - I will try to port a raw process in local adjustments
 // I choose this one because, it is "new"
@@ -2610,11 +2661,12 @@ void ImProcFunctions::ciecamloc_02float(int sp, LabImage* lab, int call)
 #ifdef __SSE2__
     const float reccmcz = 1.f / (c2 * czj);
 #endif
-    const float epsil = 0.0001f;
     const float coefQ = 32767.f / wh;
     const float pow1n = pow_F(1.64f - pow_F(0.29f, nj), 0.73f);
     const float coe = pow_F(fl, 0.25f);
     const float QproFactor = (0.4f / c) * (aw + 4.0f) ;
+    // same as alg 3 of ciecam_02float, with a default skin tones protection of 50 to avoid one more slider and no chroma
+    const CamAdjustParams camAdjust = {3, 0.f, schr, mchr, 50.f, 0.f, coe, coefQ, QproFactor, wh, &CAMBrightCurveJ, &CAMBrightCurveQ};
 
 #ifdef __SSE2__
     int bufferLength = ((width + 3) / 4) * 4; // bufferLength has to be a multiple of 4
@@ -2685,20 +2737,14 @@ void ImProcFunctions::ciecamloc_02float(int sp, LabImage* lab, int call)
                 sbuffer[k] = s;
             }
 
-#endif // __SSE2__
+            if (ciec) {
+                // vectorized brightness, lightness, colourfulness and saturation adjustments
+                Ciecam02::jchqmsAdjustfloat(Jbuffer, Cbuffer, hbuffer, Qbuffer, Mbuffer, sbuffer, width, camAdjust);
+            }
+#else
 
             for (int j = 0; j < width; j++) {
                 float J, C, h, Q, M, s;
-
-#ifdef __SSE2__
-                // use precomputed values from above
-                J = Jbuffer[j];
-                C = Cbuffer[j];
-                h = hbuffer[j];
-                Q = Qbuffer[j];
-                M = Mbuffer[j];
-                s = sbuffer[j];
-#else
                 float x, y, z;
                 float L = lab->L[i][j];
                 float a = lab->a[i][j];
@@ -2715,65 +2761,11 @@ void ImProcFunctions::ciecamloc_02float(int sp, LabImage* lab, int call)
                                                    x,  y,  z,
                                                    xw1, yw1,  zw1,
                                                    c,  nc, pow1, nbb, ncb, pfl, cz, d, c16);
-#endif
-                float Jpro, Cpro, hpro, Qpro, Mpro, spro;
-                Jpro = J;
-                Cpro = C;
-                hpro = h;
-                Qpro = Q;
-                Mpro = M;
-                spro = s;
-                /*
-                */
-                if(ciec) {
-                    Qpro = CAMBrightCurveQ[(float)(Qpro * coefQ)] / coefQ;   //brightness and contrast
-                    float rstprotection = 50.f;//default value to avoid 1 slider
-                    float chr = 0.f;//no use of chroma 
-                    float Mp, sres;
-                    Mp = Mpro / 100.0f;
-                    Ciecam02::curvecolorfloat(mchr, Mp, sres, 2.5f);
-                    float dred = 100.f; //in C mode
-                    float protect_red = 80.0f; // in C mode
-                    dred *= coe; //in M mode
-                    protect_red *= coe; //M mode
-                    Color::skinredfloat(Jpro, hpro, sres, Mp, dred, protect_red, 0, rstprotection, 100.f, Mpro);
-                    Jpro = SQR((10.f * Qpro) / wh);
-                    Qpro = (Qpro == 0.f ? epsil : Qpro); // avoid division by zero
-                    spro = 100.0f * sqrtf(Mpro / Qpro);
-
-                    if (Jpro > 99.9f) {
-                       Jpro = 99.9f;
-                    }
-
-                    Jpro = CAMBrightCurveJ[(float)(Jpro * 327.68f)];   //lightness CIECAM02 + contrast
-                    float Sp = spro / 100.0f;
-                    Ciecam02::curvecolorfloat(schr, Sp, sres, 1.5f);
-                    dred = 100.f; // in C mode
-                    protect_red = 80.0f; // in C mode
-                    dred = 100.0f * sqrtf((dred * coe) / Q);
-                    protect_red = 100.0f * sqrtf((protect_red * coe) / Q);
-                    Color::skinredfloat(Jpro, hpro, sres, Sp, dred, protect_red, 0, rstprotection, 100.f, spro);
-                    Qpro = QproFactor * sqrtf(Jpro);
-                    float Cp = (spro * spro * Qpro) / (1000000.f);
-                    Cpro = Cp * 100.f;
-                    Ciecam02::curvecolorfloat(chr, Cp, sres, 1.8f);
-                    Color::skinredfloat(Jpro, hpro, sres, Cp, 55.f, 30.f, 1, rstprotection, 100.f, Cpro);
-                }
-
-                //retrieve values C,J...s
-                C = Cpro;
-                J = Jpro;
-                Q = Qpro;
-                M = Mpro;
-                h = hpro;
-                s = spro;
 
-#ifdef __SSE2__
-                // write to line buffers
-                Jbuffer[j] = J;
-                Cbuffer[j] = C;
-                hbuffer[j] = h;
-#else
+                if (ciec) {
+                    Ciecam02::jchqmsAdjustfloat(J, C, h, Q, M, s, camAdjust);
+                }
+
                 float xx, yy, zz;
                 //process normal==> viewing
 
@@ -2790,9 +2782,10 @@ void ImProcFunctions::ciecamloc_02float(int sp, LabImage* lab, int call)
                 lab->L[i][j] = Ll;
                 lab->a[i][j] = aa;
                 lab->b[i][j] = bb;
-#endif
             }
 
+#endif
+
 #ifdef __SSE2__
             // process line buffers
             float *xbuffer = Qbuffer;
@@ -3143,27 +3136,12 @@ void ImProcFunctions::DeNoise_Local(int call, const struct local_params& lp, Lab
     const bool blshow = lp.showmaskblmet == 1 || lp.showmaskblmet == 2;
     const bool previewbl = lp.showmaskblmet == 4;
 
-    const std::unique_ptr<LabImage> origblur(new LabImage(GW, GH));
     const float radius = 3.f / sk;
+    const SpotRegion region = calcSpotRegion(lp, cx, cy, GW, GH, radius);
+    std::unique_ptr<LabImage> origblur;
 
-    if (usemaskbl) {
-#ifdef _OPENMP
-        #pragma omp parallel if (multiThread)
-#endif
-        {
-            gaussianBlur(originalmask->L, origblur->L, GW, GH, radius);
-            gaussianBlur(originalmask->a, origblur->a, GW, GH, radius);
-            gaussianBlur(originalmask->b, origblur->b, GW, GH, radius);
-        }
-    } else {
-#ifdef _OPENMP
-        #pragma omp parallel if (multiThread)
-#endif
-        {
-            gaussianBlur(original->L, origblur->L, GW, GH, radius);
-            gaussianBlur(original->a, origblur->a, GW, GH, radius);
-            gaussianBlur(original->b, origblur->b, GW, GH, radius);
-        }
+    if (levred == 7) { // origblur is only needed for deltaE
+        origblur = blurSpotRegion(usemaskbl ? originalmask : original, region, radius, multiThread);
     }
 
     const int begx = lp.xc - lp.lxL;
@@ -3210,9 +3188,12 @@ void ImProcFunctions::DeNoise_Local(int call, const struct local_params& lp, Lab
                 float reducdEb = 1.f;
 
                 if (levred == 7) {
-                    const float dEL = std::sqrt(0.9f * SQR(refa - maskptr->a[y][x]) + 0.9f * SQR(refb - maskptr->b[y][x]) + 1.2f * SQR(lumaref - maskptr->L[y][x])) * r327d68;
-                    const float dEa = std::sqrt(1.2f * SQR(refa - maskptr->a[y][x]) + 1.f * SQR(refb - maskptr->b[y][x]) + 0.8f * SQR(lumaref - maskptr->L[y][x])) * r327d68;
-                    const float dEb = std::sqrt(1.f * SQR(refa - maskptr->a[y][x]) + 1.2f * SQR(refb - maskptr->b[y][x]) + 0.8f * SQR(lumaref - maskptr->L[y][x])) * r327d68;
+                    const float blurL = maskptr->L[y - region.y][x - region.x];
+                    const float blura = maskptr->a[y - region.y][x - region.x];
+                    const float blurb = maskptr->b[y - region.y][x - region.x];
+                    const float dEL = std::sqrt(0.9f * SQR(refa - blura) + 0.9f * SQR(refb - blurb) + 1.2f * SQR(lumaref - blurL)) * r327d68;
+                    const float dEa = std::sqrt(1.2f * SQR(refa - blura) + 1.f * SQR(refb - blurb) + 0.8f * SQR(lumaref - blurL)) * r327d68;
+                    const float dEb = std::sqrt(1.f * SQR(refa - blura) + 1.2f * SQR(refb - blurb) + 0.8f * SQR(lumaref - blurL)) * r327d68;
                     reducdEL = SQR(calcreducdE(dEL, maxdE, mindE, maxdElim, mindElim, lp.iterat, limscope, lp.sensden));
                     reducdEa = SQR(calcreducdE(dEa, maxdE, mindE, maxdElim, mindElim, lp.iterat, limscope, lp.sensden));
                     reducdEb = SQR(calcreducdE(dEb, maxdE, mindE, maxdElim, mindElim, lp.iterat, limscope, lp.sensden));
@@ -3292,27 +3273,12 @@ void ImProcFunctions::DeNoise_Local2(const struct local_params& lp, LabImage* or
     const bool blshow = lp.showmaskblmet == 1 || lp.showmaskblmet == 2;
     const bool previewbl = lp.showmaskblmet == 4;
 
-    const std::unique_ptr<LabImage> origblur(new LabImage(GW, GH));
     const float radius = 3.f / sk;
+    const SpotRegion region = calcSpotRegion(lp, cx, cy, GW, GH, radius);
+    std::unique_ptr<LabImage> origblur;
 
-    if (usemaskbl) {
-#ifdef _OPENMP
-        #pragma omp parallel if (multiThread)
-#endif
-        {
-            gaussianBlur(originalmask->L, origblur->L, GW, GH, radius);
-            gaussianBlur(originalmask->a, origblur->a, GW, GH, radius);
-            gaussianBlur(originalmask->b, origblur->b, GW, GH, radius);
-        }
-    } else {
-#ifdef _OPENMP
-        #pragma omp parallel if (multiThread)
-#endif
-        {
-            gaussianBlur(original->L, origblur->L, GW, GH, radius);
-            gaussianBlur(original->a, origblur->a, GW, GH, radius);
-            gaussianBlur(original->b, origblur->b, GW, GH, radius);
-        }
+    if (levred == 7) { // origblur is only needed for deltaE
+        origblur = blurSpotRegion(usemaskbl ? originalmask : original, region, radius, multiThread);
     }
 
  //   const int begx = lp.xc - lp.lxL;
@@ -3360,9 +3326,12 @@ void ImProcFunctions::DeNoise_Local2(const struct local_params& lp, LabImage* or
                 float reducdEb = 1.f;
 
                 if (levred == 7) {
-                    const float dEL = std::sqrt(0.9f * SQR(refa - maskptr->a[y][x]) + 0.9f * SQR(refb - maskptr->b[y][x]) + 1.2f * SQR(lumaref - maskptr->L[y][x])) * r327d68;
-                    const float dEa = std::sqrt(1.2f * SQR(refa - maskptr->a[y][x]) + 1.f * SQR(refb - maskptr->b[y][x]) + 0.8f * SQR(lumaref - maskptr->L[y][x])) * r327d68;
-                    const float dEb = std::sqrt(1.f * SQR(refa - maskptr->a[y][x]) + 1.2f * SQR(refb - maskptr->b[y][x]) + 0.8f * SQR(lumaref - maskptr->L[y][x])) * r327d68;
+                    const float blurL = maskptr->L[y - region.y][x - region.x];
+                    const float blura = maskptr->a[y - region.y][x - region.x];
+                    const float blurb = maskptr->b[y - region.y][x - region.x];
+                    const float dEL = std::sqrt(0.9f * SQR(refa - blura) + 0.9f * SQR(refb - blurb) + 1.2f * SQR(lumaref - blurL)) * r327d68;
+                    const float dEa = std::sqrt(1.2f * SQR(refa - blura) + 1.f * SQR(refb - blurb) + 0.8f * SQR(lumaref - blurL)) * r327d68;
+                    const float dEb = std::sqrt(1.f * SQR(refa - blura) + 1.2f * SQR(refb - blurb) + 0.8f * SQR(lumaref - blurL)) * r327d68;
                     reducdEL = SQR(calcreducdE(dEL, maxdE, mindE, maxdElim, mindElim, lp.iterat, limscope, lp.sensden));
                     reducdEa = SQR(calcreducdE(dEa, maxdE, mindE, maxdElim, mindElim, lp.iterat, limscope, lp.sensden));
                     reducdEb = SQR(calcreducdE(dEb, maxdE, mindE, maxdElim, mindElim, lp.iterat, limscope, lp.sensden));
@@ -3434,9 +3403,9 @@ void ImProcFunctions::InverseReti_Local(const struct local_params & lp, const fl
     #pragma omp parallel if (multiThread)
 #endif
     {
-        gaussianBlur(original->L, origblur->L, GW, GH, radius);
-        gaussianBlur(original->a, origblur->a, GW, GH, radius);
-        gaussianBlur(original->b, origblur->b, GW, GH, radius);
+        float** const srcPlanes[3] = {original->L, original->a, original->b};
+        float** const dstPlanes[3] = {origblur->L, origblur->a, origblur->b};
+        gaussianBlur(srcPlanes, dstPlanes, 3, GW, GH, radius);
 
     }
 #ifdef _OPENMP
@@ -3562,9 +3531,9 @@ void ImProcFunctions::InverseBlurNoise_Local(LabImage * originalmask, const stru
         #pragma omp parallel if (multiThread)
 #endif
         {
-            gaussianBlur(originalmask->L, origblurmask->L, GW, GH, radius);
-            gaussianBlur(originalmask->a, origblurmask->a, GW, GH, radius);
-            gaussianBlur(originalmask->b, origblurmask->b, GW, GH, radius);
+            float** const srcPlanes[3] = {originalmask->L, originalmask->a, originalmask->b};
+            float** const dstPlanes[3] = {origblurmask->L, origblurmask->a, origblurmask->b};
+            gaussianBlur(srcPlanes, dstPlanes, 3, GW, GH, radius);
         }
     }
 
@@ -3573,9 +3542,9 @@ void ImProcFunctions::InverseBlurNoise_Local(LabImage * originalmask, const stru
     #pragma omp parallel if (multiThread)
 #endif
     {
-        gaussianBlur(original->L, origblur->L, GW, GH, radius);
-        gaussianBlur(original->a, origblur->a, GW, GH, radius);
-        gaussianBlur(original->b, origblur->b, GW, GH, radius);
+        float** const srcPlanes[3] = {original->L, original->a, original->b};
+        float** const dstPlanes[3] = {origblur->L, origblur->a, origblur->b};
+        gaussianBlur(srcPlanes, dstPlanes, 3, GW, GH, radius);
 
     }
 #ifdef _OPENMP
@@ -4523,7 +4492,40 @@ void ImProcFunctions::maskcalccol(bool invmask, bool pde, int bfw, int bfh, int
         kneg = -1.f;
     }
 
-    if (deltaE || modmask || enaMask || showmaske) {
+    const bool maskEnabled = deltaE || modmask || enaMask || showmaske;
+    // the mask depends on the input of the tool and on the mask settings, not on the settings of the tool itself
+    LocallabMaskCache::Key maskKey;
+    const bool useMaskCache = maskEnabled && locallabMaskCache && settings->locallabMaskCacheSize > 0;
+    bool maskCached = false;
+
+    if (useMaskCache) {
+        maskKey.add(invmask, pde, bfw, bfh, xstart, ystart, sk, strumask, astool, deltaE, fab, chrom, rad, lap, gamma, slope, shado, highl, amountcd, anchorcd);
+        maskKey.add(level_bl, level_hl, level_br, level_hr, shortcu, delt, hueref, chromaref, lumaref, maxdE, mindE, maxdElim, mindElim, iterat, limscope, scope, fftt, blu_ma, cont_ma, indic);
+        maskKey.add(lp.balance, lp.balanceh, lp.daubLen, lp.xc, lp.yc, lp.feath, lp.strmaexp, lp.angmaexp, lp.str_mas, lp.ang_mas);
+        maskKey.add(params->icm.workingProfile.raw());
+        maskKey.addCurve(locccmasCurve, lcmasutili);
+        maskKey.addCurve(locllmasCurve, llmasutili);
+        maskKey.addCurve(lochhmasCurve, lhmasutili);
+        maskKey.addCurve(lochhhmasCurve, lhhmasutili);
+        maskKey.addCurve(lmasklocalcurve, localmaskutili);
+        maskKey.addCurve(loclmasCurvecolwav, lmasutilicolwav);
+        maskKey.addData(bufcolorig->L, 0, 0, bfw, bfh, multiThread);
+        maskKey.addData(bufcolorig->a, 0, 0, bfw, bfh, multiThread);
+        maskKey.addData(bufcolorig->b, 0, 0, bfw, bfh, multiThread);
+        maskKey.addData(original->L, xstart, ystart, bfw, bfh, multiThread);
+        maskKey.addData(original->a, xstart, ystart, bfw, bfh, multiThread);
+        maskKey.addData(original->b, xstart, ystart, bfw, bfh, multiThread);
+
+        if (delt) {
+            maskKey.addData(reserved->L, xstart, ystart, bfw, bfh, multiThread);
+            maskKey.addData(reserved->a, xstart, ystart, bfw, bfh, multiThread);
+            maskKey.addData(reserved->b, xstart, ystart, bfw, bfh, multiThread);
+        }
+
+        maskCached = locallabMaskCache->restore(maskKey, *bufmaskblurcol);
+    }
+
+    if (maskEnabled && !maskCached) {
 #ifdef _OPENMP
         #pragma omp parallel for schedule(dynamic,16) if (multiThread)
 #endif
@@ -5053,14 +5055,21 @@ void ImProcFunctions::maskcalccol(bool invmask, bool pde, int bfw, int bfh, int
 
     const float radiusb = 1.f / sk;
 
-    if (deltaE || modmask || enaMask || showmaske) {
+    if (maskEnabled) {
+        if (!maskCached) {
 #ifdef _OPENMP
-        #pragma omp parallel if (multiThread)
+            #pragma omp parallel if (multiThread)
 #endif
-        {
-            gaussianBlur(bufmaskblurcol->L, bufmaskblurcol->L, bfw, bfh, radiusb);
-            gaussianBlur(bufmaskblurcol->a, bufmaskblurcol->a, bfw, bfh, 1.f + (0.5f * rad) / sk);
-            gaussianBlur(bufmaskblurcol->b, bufmaskblurcol->b, bfw, bfh, 1.f + (0.5f * rad) / sk);
+            {
+                float** const planes[3] = {bufmaskblurcol->L, bufmaskblurcol->a, bufmaskblurcol->b};
+                const double sigmas[3] = {radiusb, 1.f + (0.5f * rad) / sk, 1.f + (0.5f * rad) / sk};
+                gaussianBlur(planes, planes, 3, bfw, bfh, sigmas);
+            }
+
+            // a cancelled Fattal compression leaves the mask incomplete
+            if (useMaskCache && !isCancelled()) {
+                locallabMaskCache->store(maskKey, *bufmaskblurcol);
+            }
         }
 
         if (zero || modif || modmask || deltaE || enaMask) {
@@ -5105,9 +5114,9 @@ void ImProcFunctions::InverseSharp_Local(float **loctemp, const float hueref, co
     #pragma omp parallel
 #endif
     {
-        gaussianBlur(original->L, origblur->L, GW, GH, radius);
-        gaussianBlur(original->a, origblur->a, GW, GH, radius);
-        gaussianBlur(original->b, origblur->b, GW, GH, radius);
+        float** const srcPlanes[3] = {original->L, original->a, original->b};
+        float** const dstPlanes[3] = {origblur->L, origblur->a, origblur->b};
+        gaussianBlur(srcPlanes, dstPlanes, 3, GW, GH, radius);
     }
 
 #ifdef _OPENMP
@@ -5235,20 +5244,12 @@ void ImProcFunctions::Sharp_Local(int call, float **loctemp, int senstype, const
     const int GW = transformed->W;
     const int GH = transformed->H;
 
-    const std::unique_ptr<LabImage> origblur(new LabImage(GW, GH));
     const float refa = chromaref * cos(hueref) * 327.68f;
     const float refb = chromaref * sin(hueref) * 327.68f;
     const float refL = lumaref * 327.68f;
     const float radius = 3.f / sk;
-
-#ifdef _OPENMP
-    #pragma omp parallel if (multiThread)
-#endif
-    {
-        gaussianBlur(original->L, origblur->L, GW, GH, radius);
-        gaussianBlur(original->a, origblur->a, GW, GH, radius);
-        gaussianBlur(original->b, origblur->b, GW, GH, radius);
-    }
+    const SpotRegion region = calcSpotRegion(lp, cx, cy, GW, GH, radius);
+    const std::unique_ptr<LabImage> origblur = blurSpotRegion(original, region, radius, multiThread);
 
 #ifdef _OPENMP
     #pragma omp parallel if (multiThread)
@@ -5288,10 +5289,13 @@ void ImProcFunctions::Sharp_Local(int call, float **loctemp, int senstype, const
                 }
 
                 //deltaE
-                const float abdelta2 = SQR(refa - origblur->a[y][x]) + SQR(refb - origblur->b[y][x]);
-                const float chrodelta2 = SQR(std::sqrt(SQR(origblur->a[y][x]) + SQR(origblur->b[y][x])) - (chromaref * 327.68f));
+                const float blurL = origblur->L[y - region.y][x - region.x];
+                const float blura = origblur->a[y - region.y][x - region.x];
+                const float blurb = origblur->b[y - region.y][x - region.x];
+                const float abdelta2 = SQR(refa - blura) + SQR(refb - blurb);
+                const float chrodelta2 = SQR(std::sqrt(SQR(blura) + SQR(blurb)) - (chromaref * 327.68f));
                 const float huedelta2 = abdelta2 - chrodelta2;
-                const float dE = std::sqrt(kab * (kch * chrodelta2 + kH * huedelta2) + kL * SQR(refL - origblur->L[y][x]));
+                const float dE = std::sqrt(kab * (kch * chrodelta2 + kH * huedelta2) + kL * SQR(refL - blurL));
 
                 float reducdE = calcreducdE(dE, maxdE, mindE, maxdElim, mindElim, lp.iterat, limscope, varsens);
                 const float reducview = reducdE;
@@ -5361,21 +5365,15 @@ void ImProcFunctions::Exclude_Local(float **deltaso, float hueref, float chromar
 
         sobelref = log1p(sobelref);
 
-        const std::unique_ptr<LabImage> origblur(new LabImage(GW, GH));
-
         const float radius = 3.f / sk;
+        const SpotRegion region = calcSpotRegion(lp, cx, cy, GW, GH, radius);
+        const std::unique_ptr<LabImage> origblur = blurSpotRegion(reserv, region, radius, multiThread);
 
 #ifdef _OPENMP
         #pragma omp parallel if (multiThread)
 #endif
         {
-            gaussianBlur(reserv->L, origblur->L, GW, GH, radius);
-            gaussianBlur(reserv->a, origblur->a, GW, GH, radius);
-            gaussianBlur(reserv->b, origblur->b, GW, GH, radius);
-
-
 #ifdef _OPENMP
-            #pragma omp barrier
             #pragma omp for schedule(dynamic,16)
 #endif
             for (int y = 0; y < transformed->H; y++)
@@ -5441,11 +5439,14 @@ void ImProcFunctions::Exclude_Local(float **deltaso, float hueref, float chromar
                         }
                     }
 
-                    float abdelta2 = SQR(refa - origblur->a[y][x]) + SQR(refb - origblur->b[y][x]);
-                    float chrodelta2 = SQR(std::sqrt(SQR(origblur->a[y][x]) + SQR(origblur->b[y][x])) - (chromaref * 327.68f));
+                    const float blurL = origblur->L[y - region.y][x - region.x];
+                    const float blura = origblur->a[y - region.y][x - region.x];
+                    const float blurb = origblur->b[y - region.y][x - region.x];
+                    float abdelta2 = SQR(refa - blura) + SQR(refb - blurb);
+                    float chrodelta2 = SQR(std::sqrt(SQR(blura) + SQR(blurb)) - (chromaref * 327.68f));
                     float huedelta2 = abdelta2 - chrodelta2;
-                    const float dE = std::sqrt(kab * (kch * chrodelta2 + kH * huedelta2) + kL * SQR(refL - origblur->L[y][x]));
-                    const float rL = origblur->L[y][x];
+                    const float dE = std::sqrt(kab * (kch * chrodelta2 + kH * huedelta2) + kL * SQR(refL - blurL));
+                    const float rL = blurL;
                     const float reducdE = calcreducdE(dE, maxdE, mindE, maxdElim, mindElim, lp.iterat, limscope, varsens);
 
                     if (rL > 32.768f) { //to avoid crash with very low gamut in rare cases ex : L=0.01 a=0.5 b=-0.9
@@ -5516,8 +5517,8 @@ void ImProcFunctions::transit_shapedetect_retinex(int call, int senstype, LabIma
 */
         const bool showmas = lp.showmaskretimet == 3 ;
 
-        const std::unique_ptr<LabImage> origblur(new LabImage(GW, GH));
         const float radius = 3.f / sk;
+        const SpotRegion region = calcSpotRegion(lp, cx, cy, GW, GH, radius);
         const bool usemaskreti = lp.enaretiMask && senstype == 4 && !lp.enaretiMasktmap;
         float strcli = 0.03f * lp.str;
 
@@ -5525,14 +5526,7 @@ void ImProcFunctions::transit_shapedetect_retinex(int call, int senstype, LabIma
             strcli = 0.015f * lp.str;
         }
 
-#ifdef _OPENMP
-        #pragma omp parallel
-#endif
-        {
-            gaussianBlur(original->L, origblur->L, GW, GH, radius);
-            gaussianBlur(original->a, origblur->a, GW, GH, radius);
-            gaussianBlur(original->b, origblur->b, GW, GH, radius);
-        }
+        const std::unique_ptr<LabImage> origblur = blurSpotRegion(original, region, radius, multiThread);
 
 
 #ifdef _OPENMP
@@ -5568,17 +5562,20 @@ void ImProcFunctions::transit_shapedetect_retinex(int call, int senstype, LabIma
                         continue;
                     }
 
-                    float rL = origblur->L[y][x] / 327.68f;
+                    const float blurL = origblur->L[y - region.y][x - region.x];
+                    const float blura = origblur->a[y - region.y][x - region.x];
+                    const float blurb = origblur->b[y - region.y][x - region.x];
+                    float rL = blurL / 327.68f;
                     float dE;
                     float abdelta2 = 0.f;
                     float chrodelta2 = 0.f;
                     float huedelta2 = 0.f;
 
                     if (!usemaskreti) {
-                        abdelta2 = SQR(refa - origblur->a[y][x]) + SQR(refb - origblur->b[y][x]);
-                        chrodelta2 = SQR(std::sqrt(SQR(origblur->a[y][x]) + SQR(origblur->b[y][x])) - (chromaref * 327.68f));
+                        abdelta2 = SQR(refa - blura) + SQR(refb - blurb);
+                        chrodelta2 = SQR(std::sqrt(SQR(blura) + SQR(blurb)) - (chromaref * 327.68f));
                         huedelta2 = abdelta2 - chrodelta2;
-                        dE = std::sqrt(kab * (kch * chrodelta2 + kH * huedelta2) + kL * SQR(refL - origblur->L[y][x]));
+                        dE = std::sqrt(kab * (kch * chrodelta2 + kH * huedelta2) + kL * SQR(refL - blurL));
                     } else {
                         if (call == 2) {
                             abdelta2 = SQR(refa - buforigmas->a[y - ystart][x - xstart]) + SQR(refb - buforigmas->b[y - ystart][x - xstart]);
@@ -5764,9 +5761,9 @@ void ImProcFunctions::transit_shapedetect(int senstype, const LabImage * bufexpo
         #pragma omp parallel if (multiThread)
 #endif
         {
-            gaussianBlur(originalmask->L, origblurmask->L, bfw, bfh, radius);
-            gaussianBlur(originalmask->a, origblurmask->a, bfw, bfh, radius);
-            gaussianBlur(originalmask->b, origblurmask->b, bfw, bfh, radius);
+            float** const srcPlanes[3] = {originalmask->L, originalmask->a, originalmask->b};
+            float** const dstPlanes[3] = {origblurmask->L, origblurmask->a, origblurmask->b};
+            gaussianBlur(srcPlanes, dstPlanes, 3, bfw, bfh, radius);
         }
     }
     if (lp.equtm  && senstype == 8) //normalize luminance for Tone mapping , at this place we can use for others senstype!
@@ -5812,9 +5809,8 @@ void ImProcFunctions::transit_shapedetect(int senstype, const LabImage * bufexpo
             }
         }
 
-        gaussianBlur(origblur->L, origblur->L, bfw, bfh, radius);
-        gaussianBlur(origblur->a, origblur->a, bfw, bfh, radius);
-        gaussianBlur(origblur->b, origblur->b, bfw, bfh, radius);
+        float** const planes[3] = {origblur->L, origblur->a, origblur->b};
+        gaussianBlur(planes, planes, 3, bfw, bfh, radius);
 
     }
 
@@ -6127,9 +6123,9 @@ void ImProcFunctions::InverseColorLight_Local(bool tonequ, bool tonecurv, int sp
         #pragma omp parallel if (multiThread)
 #endif
         {
-            gaussianBlur(originalmask->L, origblurmask->L, GW, GH, radius);
-            gaussianBlur(originalmask->a, origblurmask->a, GW, GH, radius);
-            gaussianBlur(originalmask->b, origblurmask->b, GW, GH, radius);
+            float** const srcPlanes[3] = {originalmask->L, originalmask->a, originalmask->b};
+            float** const dstPlanes[3] = {origblurmask->L, origblurmask->a, origblurmask->b};
+            gaussianBlur(srcPlanes, dstPlanes, 3, GW, GH, radius);
         }
     }
 
@@ -6145,9 +6141,9 @@ void ImProcFunctions::InverseColorLight_Local(bool tonequ, bool tonecurv, int sp
     #pragma omp parallel if (multiThread)
 #endif
     {
-        gaussianBlur(original->L, origblur->L, GW, GH, radius);
-        gaussianBlur(original->a, origblur->a, GW, GH, radius);
-        gaussianBlur(original->b, origblur->b, GW, GH, radius);
+        float** const srcPlanes[3] = {original->L, original->a, original->b};
+        float** const dstPlanes[3] = {origblur->L, origblur->a, origblur->b};
+        gaussianBlur(srcPlanes, dstPlanes, 3, GW, GH, radius);
     }
 
 #ifdef _OPENMP
@@ -6312,16 +6308,13 @@ void ImProcFunctions::calc_ref(int sp, LabImage * original, LabImage * transform
         float avg2 = 0.f;
         int nc2 = 0;
 
-        for (int y = 0; y < transformed->H ; y++) //{
-            for (int x = 0; x < transformed->W; x++) {
-                int lox = cx + x;
-                int loy = cy + y;
-
-                if (lox >= begx && lox < xEn && loy >= begy && loy < yEn) {
-                    avg2 += original->L[y][x];
-                    nc2++;
-                }
+        // only the spot contributes, don't scan the whole image
+        for (int y = rtengine::max(begy - cy, 0); y < rtengine::min(yEn - cy, transformed->H); y++) {
+            for (int x = rtengine::max(begx - cx, 0); x < rtengine::min(xEn - cx, transformed->W); x++) {
+                avg2 += original->L[y][x];
+                nc2++;
             }
+        }
 
         avg2 /= 32768.f;
         avg = avg2 / nc2;
@@ -6394,9 +6387,9 @@ void ImProcFunctions::calc_ref(int sp, LabImage * original, LabImage * transform
             float radius = 3.f / sk;
             {
                 //No omp
-                gaussianBlur(origblur->L, blurorig->L, spotSi, spotSi, radius);
-                gaussianBlur(origblur->a, blurorig->a, spotSi, spotSi, radius);
-                gaussianBlur(origblur->b, blurorig->b, spotSi, spotSi, radius);
+                float** const srcPlanes[3] = {origblur->L, origblur->a, origblur->b};
+                float** const dstPlanes[3] = {blurorig->L, blurorig->a, blurorig->b};
+                gaussianBlur(srcPlanes, dstPlanes, 3, spotSi, spotSi, radius);
 
             }
 
@@ -6645,37 +6638,15 @@ void ImProcFunctions::BlurNoise_Local(LabImage *tmp1, LabImage * originalmask, c
     const bool usemaskbl = lp.showmaskblmet == 2 || lp.enablMask || lp.showmaskblmet == 4;
     const bool usemaskall = usemaskbl;
     const float radius = 3.f / sk;
-    std::unique_ptr<LabImage> origblurmask;
-
-    const std::unique_ptr<LabImage> origblur(new LabImage(GW, GH));
-
-    if (usemaskall) {
-        origblurmask.reset(new LabImage(GW, GH));
-
-#ifdef _OPENMP
-        #pragma omp parallel if (multiThread)
-#endif
-        {
-            gaussianBlur(originalmask->L, origblurmask->L, GW, GH, radius);
-            gaussianBlur(originalmask->a, origblurmask->a, GW, GH, radius);
-            gaussianBlur(originalmask->b, origblurmask->b, GW, GH, radius);
-        }
-    }
-
-#ifdef _OPENMP
-    #pragma omp parallel if (multiThread)
-#endif
-    {
-        gaussianBlur(original->L, origblur->L, GW, GH, radius);
-        gaussianBlur(original->a, origblur->a, GW, GH, radius);
-        gaussianBlur(original->b, origblur->b, GW, GH, radius);
-    }
+    const SpotRegion region = calcSpotRegion(lp, cx, cy, GW, GH, radius);
+    // only one of the blurred images is used for deltaE
+    const std::unique_ptr<LabImage> origblur = blurSpotRegion(usemaskall ? originalmask : original, region, radius, multiThread);
 
 #ifdef _OPENMP
     #pragma omp parallel if (multiThread)
 #endif
     {
-        const LabImage *maskptr = usemaskall ? origblurmask.get() : origblur.get();
+        const LabImage *maskptr = origblur.get();
         const float mindE = 4.f + MINSCOPE * lp.sensbn * lp.thr;//best usage ?? with blurnoise
         const float maxdE = 5.f + MAXSCOPE * lp.sensbn * (1 + 0.1f * lp.thr);
         const float mindElim = 2.f + MINSCOPE * limscope * lp.thr;
@@ -6701,10 +6672,13 @@ void ImProcFunctions::BlurNoise_Local(LabImage *tmp1, LabImage * originalmask, c
                     continue;
                 }
 
-                const float abdelta2 = SQR(refa - maskptr->a[y][x]) + SQR(refb - maskptr->b[y][x]);
-                const float chrodelta2 = SQR(std::sqrt(SQR(maskptr->a[y][x]) + SQR(maskptr->b[y][x])) - chromaref * 327.68f);
+                const float blurL = maskptr->L[y - region.y][x - region.x];
+                const float blura = maskptr->a[y - region.y][x - region.x];
+                const float blurb = maskptr->b[y - region.y][x - region.x];
+                const float abdelta2 = SQR(refa - blura) + SQR(refb - blurb);
+                const float chrodelta2 = SQR(std::sqrt(SQR(blura) + SQR(blurb)) - chromaref * 327.68f);
                 const float huedelta2 = abdelta2 - chrodelta2;
-                const float dE = std::sqrt(kab * (kch * chrodelta2 + kH * huedelta2) + kL * SQR(refL - maskptr->L[y][x]));
+                const float dE = std::sqrt(kab * (kch * chrodelta2 + kH * huedelta2) + kL * SQR(refL - blurL));
                 const float reducdE = calcreducdE(dE, maxdE, mindE, maxdElim, mindElim, lp.iterat, limscope, lp.sensbn);
 
                 float difL = (tmp1->L[y - ystart][x - xstart] - original->L[y][x]) * localFactor * reducdE;
@@ -6880,9 +6854,9 @@ void ImProcFunctions::transit_shapedetect2(int call, int senstype, const LabImag
         #pragma omp parallel if (multiThread)
 #endif
         {
-            gaussianBlur(originalmask->L, origblurmask->L, bfw, bfh, radius);
-            gaussianBlur(originalmask->a, origblurmask->a, bfw, bfh, radius);
-            gaussianBlur(originalmask->b, origblurmask->b, bfw, bfh, radius);
+            float** const srcPlanes[3] = {originalmask->L, originalmask->a, originalmask->b};
+            float** const dstPlanes[3] = {origblurmask->L, origblurmask->a, origblurmask->b};
+            gaussianBlur(srcPlanes, dstPlanes, 3, bfw, bfh, radius);
         }
     }
 
@@ -6927,9 +6901,8 @@ void ImProcFunctions::transit_shapedetect2(int call, int senstype, const LabImag
             }
         }
 
-        gaussianBlur(origblur->L, origblur->L, bfw, bfh, radius);
-        gaussianBlur(origblur->a, origblur->a, bfw, bfh, radius);
-        gaussianBlur(origblur->b, origblur->b, bfw, bfh, radius);
+        float** const planes[3] = {origblur->L, origblur->a, origblur->b};
+        gaussianBlur(planes, planes, 3, bfw, bfh, radius);
 
     }
     
@@ -11396,6 +11369,10 @@ void ImProcFunctions::Lab_Local(
 //Prepare mask for Blur and noise and Denoise
     bool denoiz = false;
 
+    if (isCancelled()) {
+        return;
+    }
+
     if ((lp.noiself > 0.f || lp.noiself0 > 0.f || lp.noiself2 > 0.f || lp.noiselc > 0.f || lp.wavcurvedenoi || lp.noisecf > 0.f || lp.noisecc > 0.f  || lp.bilat > 0.f) && lp.denoiena) {
         denoiz = true;
     }
@@ -11597,12 +11574,11 @@ void ImProcFunctions::Lab_Local(
                             if (lp.chromet == 0) {
                                 gaussianBlur(tmp1->L, tmp1->L, bfw, bfh, radius);
                             } else if (lp.chromet == 1) {
-                                gaussianBlur(tmp1->a, tmp1->a, bfw, bfh, radius);
-                                gaussianBlur(tmp1->b, tmp1->b, bfw, bfh, radius);
+                                float** const planes[2] = {tmp1->a, tmp1->b};
+                                gaussianBlur(planes, planes, 2, bfw, bfh, radius);
                             } else if (lp.chromet == 2) {
-                                gaussianBlur(tmp1->L, tmp1->L, bfw, bfh, radius);
-                                gaussianBlur(tmp1->a, tmp1->a, bfw, bfh, radius);
-                                gaussianBlur(tmp1->b, tmp1->b, bfw, bfh, radius);
+                                float** const planes[3] = {tmp1->L, tmp1->a, tmp1->b};
+                                gaussianBlur(planes, planes, 3, bfw, bfh, radius);
                             }
                         }
                     }
@@ -11627,12 +11603,13 @@ void ImProcFunctions::Lab_Local(
                             if (lp.chromet == 0) {
                                 gaussianBlur(original->L, tmp1->L, TW, TH, radius);
                             } else if (lp.chromet == 1) {
-                                gaussianBlur(original->a, tmp1->a, TW, TH, radius);
-                                gaussianBlur(original->b, tmp1->b, TW, TH, radius);
+                                float** const srcPlanes[2] = {original->a, original->b};
+                                float** const dstPlanes[2] = {tmp1->a, tmp1->b};
+                                gaussianBlur(srcPlanes, dstPlanes, 2, TW, TH, radius);
                             } else if (lp.chromet == 2) {
-                                gaussianBlur(original->L, tmp1->L, TW, TH, radius);
-                                gaussianBlur(original->a, tmp1->a, TW, TH, radius);
-                                gaussianBlur(original->b, tmp1->b, TW, TH, radius);
+                                float** const srcPlanes[3] = {original->L, original->a, original->b};
+                                float** const dstPlanes[3] = {tmp1->L, tmp1->a, tmp1->b};
+                                gaussianBlur(srcPlanes, dstPlanes, 3, TW, TH, radius);
                             }
                         }
                     }
@@ -11805,8 +11782,9 @@ void ImProcFunctions::Lab_Local(
                         if (lp.chromet == 0) {
                             rtengine::guidedFilterLog(guide, 10.f, LL, r, epsil, multiThread);
                         } else if (lp.chromet == 1) {
-                            rtengine::guidedFilterLog(guide, 10.f, rr, r, epsil, multiThread);
-                            rtengine::guidedFilterLog(guide, 10.f, bb, r, epsil, multiThread);
+                            rtengine::GuidedFilterGuide chromaGuide(guide, multiThread);
+                            rtengine::guidedFilterLog(chromaGuide, 10.f, rr, r, epsil, multiThread);
+                            rtengine::guidedFilterLog(chromaGuide, 10.f, bb, r, epsil, multiThread);
                         } else if (lp.chromet == 2) {
                             rtengine::guidedFilterLog(10.f, gg, r, epsil, multiThread);
                             rtengine::guidedFilterLog(10.f, rr, r, epsil, multiThread);
@@ -11960,8 +11938,9 @@ void ImProcFunctions::Lab_Local(
                         if (lp.chromet == 0) {
                             rtengine::guidedFilterLog(guide, 10.f, LL, r, epsil, multiThread);
                         } else if (lp.chromet == 1) {
-                            rtengine::guidedFilterLog(guide, 10.f, rr, r, epsil, multiThread);
-                            rtengine::guidedFilterLog(guide, 10.f, bb, r, epsil, multiThread);
+                            rtengine::GuidedFilterGuide chromaGuide(guide, multiThread);
+                            rtengine::guidedFilterLog(chromaGuide, 10.f, rr, r, epsil, multiThread);
+                            rtengine::guidedFilterLog(chromaGuide, 10.f, bb, r, epsil, multiThread);
                         } else if (lp.chromet == 2) {
                             rtengine::guidedFilterLog(10.f, gg, r, epsil, multiThread);
                             rtengine::guidedFilterLog(10.f, rr, r, epsil, multiThread);
@@ -12157,6 +12136,10 @@ void ImProcFunctions::Lab_Local(
 
 
 //begin cbdl
+    if (isCancelled()) {
+        return;
+    }
+
     if ((lp.mulloc[0] != 1.f || lp.mulloc[1] != 1.f || lp.mulloc[2] != 1.f || lp.mulloc[3] != 1.f || lp.mulloc[4] != 1.f || lp.mulloc[5] != 1.f || lp.clarityml != 0.f || lp.contresid != 0.f  || lp.enacbMask || lp.showmaskcbmet == 2 || lp.showmaskcbmet == 3 || lp.showmaskcbmet == 4 || lp.prevdE) && lp.cbdlena) {
         if (call <= 3) { //call from simpleprocess dcrop improcc
             const int ystart = rtengine::max(static_cast<int>(lp.yc - lp.lyT) - cy, 0);
@@ -12378,6 +12361,10 @@ void ImProcFunctions::Lab_Local(
 
 //vibrance
 
+    if (isCancelled()) {
+        return;
+    }
+
     if (lp.expvib && (lp.past != 0.f  || lp.satur != 0.f || lp.strvib != 0.f  || lp.war != 0 || lp.strvibab != 0.f  || lp.strvibh != 0.f || lp.showmaskvibmet == 2 || lp.enavibMask || lp.showmaskvibmet == 3 || lp.showmaskvibmet == 4 || lp.prevdE) && lp.vibena) { //interior ellipse renforced lightness and chroma  //locallutili
         if (call <= 3) { //simpleprocess, dcrop, improccoordinator
             const int ystart = rtengine::max(static_cast<int>(lp.yc - lp.lyT) - cy, 0);
@@ -12601,6 +12588,10 @@ void ImProcFunctions::Lab_Local(
 
 //Tone mapping
 
+    if (isCancelled()) {
+        return;
+    }
+
     if ((lp.strengt != 0.f || lp.showmasktmmet == 2 || lp.enatmMask || lp.showmasktmmet == 3 || lp.showmasktmmet == 4 || lp.prevdE) && lp.tonemapena && !params->epd.enabled) {
         if (call <= 3) { //simpleprocess dcrop improcc
             const int ystart = rtengine::max(static_cast<int>(lp.yc - lp.lyT) - cy, 0);
@@ -12842,6 +12833,10 @@ void ImProcFunctions::Lab_Local(
         tonecurv = true;
     }
 
+    if (isCancelled()) {
+        return;
+    }
+
     if (! lp.invsh && (lp.highlihs > 0.f || lp.shadowhs > 0.f || tonequ || tonecurv || lp.strSH != 0.f || lp.showmaskSHmet == 2 || lp.enaSHMask || lp.showmaskSHmet == 3 || lp.showmaskSHmet == 4 || lp.prevdE) && call <= 3 && lp.hsena) {
         const int ystart = rtengine::max(static_cast<int>(lp.yc - lp.lyT) - cy, 0);
         const int yend = rtengine::min(static_cast<int>(lp.yc + lp.ly) - cy, original->H);
@@ -13238,6 +13233,10 @@ void ImProcFunctions::Lab_Local(
         }
     }
 
+    if (isCancelled()) {
+        return;
+    }
+
     if ((lp.lcamount > 0.f || wavcurve || lp.showmasklcmet == 2 || lp.enalcMask || lp.showmasklcmet == 3 || lp.showmasklcmet == 4 || lp.prevdE || lp.strwav != 0.f || wavcurvelev || wavcurvecon || wavcurvecomp || wavcurvecompre || lp.edgwena || params->locallab.spots.at(sp).residblur > 0.0 || params->locallab.spots.at(sp).levelblur > 0.0 || params->locallab.spots.at(sp).residcont != 0.0 || params->locallab.spots.at(sp).clarilres != 0.0 || params->locallab.spots.at(sp).claricres != 0.0) && call <= 3 && lp.lcena) {
 
         int ystart = rtengine::max(static_cast<int>(lp.yc - lp.lyT) - cy, 0);
@@ -13718,6 +13717,10 @@ void ImProcFunctions::Lab_Local(
         }
     }
 
+    if (isCancelled()) {
+        return;
+    }
+
     if ((lp.dehaze != 0 || lp.prevdE) && lp.retiena ) {
         int ystart = rtengine::max(static_cast<int>(lp.yc - lp.lyT) - cy, 0);
         int yend = rtengine::min(static_cast<int>(lp.yc + lp.ly) - cy, original->H);
@@ -13767,6 +13770,10 @@ void ImProcFunctions::Lab_Local(
 
     lp.invret = false;//always disabled inverse RETI   too complex todo !!
 
+    if (isCancelled()) {
+        return;
+    }
+
     if (lp.str >= 0.2f && lp.retiena && call != 2) {
         LabImage *bufreti = nullptr;
         LabImage *bufmask = nullptr;
@@ -14422,6 +14429,10 @@ void ImProcFunctions::Lab_Local(
 
     bool enablefat = false;
 
+    if (isCancelled()) {
+        return;
+    }
+
     if (params->locallab.spots.at(sp).fatamount > 1.0) {
         enablefat = true;;
     }
@@ -14886,6 +14897,10 @@ void ImProcFunctions::Lab_Local(
     const float b_basemerg = lp.lowBmerg / scaling;
     const bool ctoningmerg = (a_scalemerg != 0.f || b_scalemerg != 0.f || a_basemerg != 0.f || b_basemerg != 0.f);
 
+    if (isCancelled()) {
+        return;
+    }
+
     if (!lp.inv && (lp.chro != 0 || lp.ligh != 0.f || lp.cont != 0 || ctoning || lp.mergemet > 0 ||  lp.strcol != 0.f ||  lp.strcolab != 0.f || lp.qualcurvemet != 0 || lp.showmaskcolmet == 2 || lp.enaColorMask || lp.showmaskcolmet == 3  || lp.showmaskcolmet == 4 || lp.showmaskcolmet == 5 || lp.prevdE) && lp.colorena) { // || lllocalcurve)) { //interior ellipse renforced lightness and chroma  //locallutili
         int ystart = rtengine::max(static_cast<int>(lp.yc - lp.lyT) - cy, 0);
         int yend = rtengine::min(static_cast<int>(lp.yc + lp.ly) - cy, original->H);
@@ -16034,6 +16049,10 @@ void ImProcFunctions::Lab_Local(
     }
     
 //begin common mask
+    if (isCancelled()) {
+        return;
+    }
+
     if(lp.maskena) {
         int ystart = rtengine::max(static_cast<int>(lp.yc - lp.lyT) - cy, 0);
         int yend = rtengine::min(static_cast<int>(lp.yc + lp.ly) - cy, original->H);
@@ -17,6 +17,9 @@
  *  along with RawTherapee.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <cstring>
+#include <vector>
+
 #include "improcfun.h"
 
 #include "alignedbuffer.h"
@@ -49,288 +52,244 @@ static inline float Lanc (float x, float a)
     }
 }
 
-void ImProcFunctions::Lanczos (const Imagefloat* src, Imagefloat* dst, float scale)
+namespace
 {
 
-    const float delta = 1.0f / scale;
-    const float a = 3.0f;
-    const float sc = min (scale, 1.0f);
-    const int support = static_cast<int> (2.0f * a / sc) + 1;
-
-#ifdef _OPENMP
-    #pragma omp parallel
-#endif
+// Lanczos weights of all output positions of one dimension, computed once per resize
+struct LanczosWeights {
+    LanczosWeights(int srcSize, int dstSize, float scale) :
+        start(dstSize),
+        count(dstSize)
     {
-        // storage for precomputed parameters for horisontal interpolation
-        float * wwh = new float[support * dst->getWidth()];
-        int * jj0 = new int[dst->getWidth()];
-        int * jj1 = new int[dst->getWidth()];
-
-        // temporal storage for vertically-interpolated row of pixels
-        float * lr = new float[src->getWidth()];
-        float * lg = new float[src->getWidth()];
-        float * lb = new float[src->getWidth()];
-
-        // Phase 1: precompute coefficients for horisontal interpolation
-
-        for (int j = 0; j < dst->getWidth(); j++) {
-
-            // x coord of the center of pixel on src image
-            float x0 = (static_cast<float> (j) + 0.5f) * delta - 0.5f;
-
-            // weights for interpolation in horisontal direction
-            float * w = wwh + j * support;
+        const float delta = 1.0f / scale;
+        constexpr float a = 3.0f;
+        const float sc = min(scale, 1.0f);
+        const int support = static_cast<int> (2.0f * a / sc) + 1;
+
+        // the taps are padded to a multiple of 4 with zero weights, so that the horizontal pass can use full vectors
+        stride = (support + 3) & ~3;
+        weights.assign(static_cast<size_t>(dstSize) * stride, 0.f);
+
+        for (int j = 0; j < dstSize; j++) {
+            // coord of the center of pixel on src image
+            const float x0 = (static_cast<float> (j) + 0.5f) * delta - 0.5f;
+            const int j0 = max(0, static_cast<int> (floorf (x0 - a / sc)) + 1);
+            const int j1 = min(srcSize, static_cast<int> (floorf (x0 + a / sc)) + 1);
+            float* const w = &weights[static_cast<size_t>(j) * stride];
 
             // sum of weights used for normalization
             float ws = 0.0f;
 
-            jj0[j] = max (0, static_cast<int> (floorf (x0 - a / sc)) + 1);
-            jj1[j] = min (src->getWidth(), static_cast<int> (floorf (x0 + a / sc)) + 1);
-
-            // calculate weights
-            for (int jj = jj0[j]; jj < jj1[j]; jj++) {
-                int k = jj - jj0[j];
-                float z = sc * (x0 - static_cast<float> (jj));
-                w[k] = Lanc (z, a);
-                ws += w[k];
+            for (int jj = j0; jj < j1; jj++) {
+                const float z = sc * (x0 - static_cast<float> (jj));
+                w[jj - j0] = Lanc (z, a);
+                ws += w[jj - j0];
             }
 
-            // normalize weights
-            for (int k = 0; k < support; k++) {
+            for (int k = 0; k < j1 - j0; k++) {
                 w[k] /= ws;
             }
-        }
 
-        // Phase 2: do actual interpolation
-#ifdef _OPENMP
-        #pragma omp for
-#endif
-
-        for (int i = 0; i < dst->getHeight(); i++) {
-
-            // y coord of the center of pixel on src image
-            float y0 = (static_cast<float> (i) + 0.5f) * delta - 0.5f;
+            start[j] = j0;
+            count[j] = j1 - j0;
+        }
+    }
 
-            // weights for interpolation in y direction
-            float w[support];
-            for (auto& f : w) {
-                f = 0.f;
-            }
+    const float* get(int j) const
+    {
+        return &weights[static_cast<size_t>(j) * stride];
+    }
 
-            // sum of weights used for normalization
-            float ws = 0.0f;
+    std::vector<int> start;
+    std::vector<int> count;
+    std::vector<float> weights;
+    int stride;
+};
 
-            int ii0 = max (0, static_cast<int> (floorf (y0 - a / sc)) + 1);
-            int ii1 = min (src->getHeight(), static_cast<int> (floorf (y0 + a / sc)) + 1);
+// Horizontal pass of one row of three planes, which share the weights
+void lanczosRow(const LanczosWeights& wh, const float* const row[3], int rowLength, float* const out[3], int outLength)
+{
+    for (int x = 0; x < outLength; x++) {
+        const float* const wx = wh.get(x);
+        const int jj0 = wh.start[x];
+#ifdef __SSE2__
 
-            // calculate weights for vertical interpolation
-            for (int ii = ii0; ii < ii1; ii++) {
-                int k = ii - ii0;
-                float z = sc * (y0 - static_cast<float> (ii));
-                w[k] = Lanc (z, a);
-                ws += w[k];
+        // the padding taps must not read past the end of the row
+        if (jj0 + wh.stride <= rowLength) {
+            vfloat sum0 = ZEROV;
+            vfloat sum1 = ZEROV;
+            vfloat sum2 = ZEROV;
+
+            for (int k = 0; k < wh.stride; k += 4) {
+                const vfloat wkv = LVFU(wx[k]);
+                sum0 = vmlaf(wkv, LVFU(row[0][jj0 + k]), sum0);
+                sum1 = vmlaf(wkv, LVFU(row[1][jj0 + k]), sum1);
+                sum2 = vmlaf(wkv, LVFU(row[2][jj0 + k]), sum2);
             }
 
-            // normalize weights
-            for (int k = 0; k < support; k++) {
-                w[k] /= ws;
-            }
+            out[0][x] = vhadd(sum0);
+            out[1][x] = vhadd(sum1);
+            out[2][x] = vhadd(sum2);
+            continue;
+        }
 
-            // Do vertical interpolation. Store results.
-            for (int j = 0; j < src->getWidth(); j++) {
+#endif
+        float sum0 = 0.f, sum1 = 0.f, sum2 = 0.f;
 
-                float r = 0.0f, g = 0.0f, b = 0.0f;
+        for (int k = 0; k < wh.count[x]; k++) {
+            sum0 += wx[k] * row[0][jj0 + k];
+            sum1 += wx[k] * row[1][jj0 + k];
+            sum2 += wx[k] * row[2][jj0 + k];
+        }
 
-                for (int ii = ii0; ii < ii1; ii++) {
-                    int k = ii - ii0;
+        out[0][x] = sum0;
+        out[1][x] = sum1;
+        out[2][x] = sum2;
+    }
+}
 
-                    r += w[k] * src->r (ii, j);
-                    g += w[k] * src->g (ii, j);
-                    b += w[k] * src->b (ii, j);
-                }
+// Vertical pass: out = sum over taps of w[k] * rows[k], for the columns j0 .. j1 - 1
+void lanczosColumns(const float* w, int taps, const float* const* rows, float* out, int j0, int j1)
+{
+    for (int k = 0; k < taps; k++) {
+        const float* const s = rows[k];
+        const float wk = w[k];
+        int j = j0;
+#ifdef __SSE2__
+        const vfloat wkv = F2V(wk);
 
-                lr[j] = r;
-                lg[j] = g;
-                lb[j] = b;
+        if (k == 0) {
+            for (; j < j1 - 3; j += 4) {
+                STVFU(out[j], wkv * LVFU(s[j]));
             }
+        } else {
+            for (; j < j1 - 3; j += 4) {
+                STVFU(out[j], vmlaf(wkv, LVFU(s[j]), LVFU(out[j])));
+            }
+        }
 
-            // Do horizontal interpolation
-            for (int j = 0; j < dst->getWidth(); j++) {
-
-                float * wh = wwh + support * j;
-
-                float r = 0.0f, g = 0.0f, b = 0.0f;
-
-                for (int jj = jj0[j]; jj < jj1[j]; jj++) {
-                    int k = jj - jj0[j];
-
-                    r += wh[k] * lr[jj];
-                    g += wh[k] * lg[jj];
-                    b += wh[k] * lb[jj];
-                }
+#endif
 
-                dst->r (i, j) = /*CLIP*/ (r);//static_cast<int> (r));
-                dst->g (i, j) = /*CLIP*/ (g);//static_cast<int> (g));
-                dst->b (i, j) = /*CLIP*/ (b);//static_cast<int> (b));
+        if (k == 0) {
+            for (; j < j1; j++) {
+                out[j] = wk * s[j];
+            }
+        } else {
+            for (; j < j1; j++) {
+                out[j] += wk * s[j];
             }
         }
-
-        delete[] wwh;
-        delete[] jj0;
-        delete[] jj1;
-        delete[] lr;
-        delete[] lg;
-        delete[] lb;
     }
 }
 
-
-void ImProcFunctions::Lanczos (const LabImage* src, LabImage* dst, float scale)
+// Separable Lanczos of three planes, which share the weights.
+// When downscaling by more than 2, the horizontal pass comes first, so that the vertical pass works on the narrower rows.
+// The horizontally filtered rows are kept for bands of output rows, which bounds the memory needed.
+// Otherwise the vertical pass comes first, on blocks of columns to keep the accumulated row in L1.
+void lanczos3Planes(const float* const* const src[3], float** const dst[3], int srcW, int srcH, int dstW, int dstH, float scale, bool multiThread)
 {
-    const float delta = 1.0f / scale;
-    constexpr float a = 3.0f;
-    const float sc = min(scale, 1.0f);
-    const int support = static_cast<int> (2.0f * a / sc) + 1;
-
-    // storage for precomputed parameters for horizontal interpolation
-    float* const wwh = new float[support * dst->W];
-    int* const jj0 = new int[dst->W];
-    int* const jj1 = new int[dst->W];
-
-    // Phase 1: precompute coefficients for horizontal interpolation
-    for (int j = 0; j < dst->W; j++) {
-
-        // x coord of the center of pixel on src image
-        float x0 = (static_cast<float> (j) + 0.5f) * delta - 0.5f;
+    const LanczosWeights wh(srcW, dstW, scale);
+    const LanczosWeights wv(srcH, dstH, scale);
 
-        // weights for interpolation in horizontal direction
-        float * w = wwh + j * support;
+    if (scale < 0.5f) {
+        constexpr int bandHeight = 64;
+        const int bandStride = (dstW + 3) & ~3;
 
-        // sum of weights used for normalization
-        float ws = 0.0f;
+        // source rows needed by the largest band
+        int bandRows = 0;
 
-        jj0[j] = max (0, static_cast<int> (floorf (x0 - a / sc)) + 1);
-        jj1[j] = min (src->W, static_cast<int> (floorf (x0 + a / sc)) + 1);
-
-        // calculate weights
-        for (int jj = jj0[j]; jj < jj1[j]; jj++) {
-            int k = jj - jj0[j];
-            float z = sc * (x0 - static_cast<float> (jj));
-            w[k] = Lanc (z, a);
-            ws += w[k];
-        }
-
-        // normalize weights
-        for (int k = 0; k < support; k++) {
-            w[k] /= ws;
+        for (int b0 = 0; b0 < dstH; b0 += bandHeight) {
+            const int b1 = min(b0 + bandHeight, dstH) - 1;
+            bandRows = max(bandRows, wv.start[b1] + wv.count[b1] - wv.start[b0]);
         }
-    }
 
 #ifdef _OPENMP
-    #pragma omp parallel
+        #pragma omp parallel if (multiThread)
 #endif
-    {
-        // temporal storage for vertically-interpolated row of pixels
-        AlignedBuffer<float> aligned_buffer_ll(src->W);
-        AlignedBuffer<float> aligned_buffer_la(src->W);
-        AlignedBuffer<float> aligned_buffer_lb(src->W);
-        float* const lL = aligned_buffer_ll.data;
-        float* const la = aligned_buffer_la.data;
-        float* const lb = aligned_buffer_lb.data;
-        // weights for interpolation in y direction
-        float w[support] ALIGNED64;
-        memset(w, 0, sizeof(w));
-
-        // Phase 2: do actual interpolation
-#ifdef _OPENMP
-        #pragma omp for
-#endif
-
-        for (int i = 0; i < dst->H; i++) {
-            // y coord of the center of pixel on src image
-            float y0 = (static_cast<float> (i) + 0.5f) * delta - 0.5f;
-
-            // sum of weights used for normalization
-            float ws = 0.0f;
-
-            int ii0 = max (0, static_cast<int> (floorf (y0 - a / sc)) + 1);
-            int ii1 = min (src->H, static_cast<int> (floorf (y0 + a / sc)) + 1);
+        {
+            AlignedBuffer<float> bandBuffer(3 * static_cast<size_t>(bandRows) * bandStride);
+            std::vector<float*> bandRowPtrs(3 * bandRows);
 
-            // calculate weights for vertical interpolation
-            for (int ii = ii0; ii < ii1; ii++) {
-                int k = ii - ii0;
-                float z = sc * (y0 - static_cast<float> (ii));
-                w[k] = Lanc (z, a);
-                ws += w[k];
+            for (int c = 0; c < 3; c++) {
+                for (int r = 0; r < bandRows; r++) {
+                    bandRowPtrs[c * bandRows + r] = bandBuffer.data + (static_cast<size_t>(c) * bandRows + r) * bandStride;
+                }
             }
 
-            // normalize weights
-            for (int k = 0; k < support; k++) {
-                w[k] /= ws;
-            }
+#ifdef _OPENMP
+            #pragma omp for schedule(dynamic)
+#endif
 
-            // Do vertical interpolation. Store results.
-            int j = 0;
-#ifdef __SSE2__
-            __m128 Lv, av, bv, wkv;
-
-            for (j = 0; j < src->W - 3; j += 4) {
-                Lv = ZEROV;
-                av = ZEROV;
-                bv = ZEROV;
-
-                for (int ii = ii0; ii < ii1; ii++) {
-                    int k = ii - ii0;
-                    wkv = F2V(w[k]);
-                    Lv += wkv * LVFU(src->L[ii][j]);
-                    av += wkv * LVFU(src->a[ii][j]);
-                    bv += wkv * LVFU(src->b[ii][j]);
+            for (int b0 = 0; b0 < dstH; b0 += bandHeight) {
+                const int b1 = min(b0 + bandHeight, dstH);
+                const int r0 = wv.start[b0];
+                const int r1 = wv.start[b1 - 1] + wv.count[b1 - 1];
+
+                // Do horizontal interpolation of the source rows of this band
+                for (int r = r0; r < r1; r++) {
+                    const float* const row[3] = {src[0][r], src[1][r], src[2][r]};
+                    float* const out[3] = {bandRowPtrs[r - r0], bandRowPtrs[bandRows + r - r0], bandRowPtrs[2 * bandRows + r - r0]};
+                    lanczosRow(wh, row, srcW, out, dstW);
                 }
 
-                STVF(lL[j], Lv);
-                STVF(la[j], av);
-                STVF(lb[j], bv);
+                // Do vertical interpolation. Store results.
+                for (int i = b0; i < b1; i++) {
+                    for (int c = 0; c < 3; c++) {
+                        lanczosColumns(wv.get(i), wv.count[i], &bandRowPtrs[c * bandRows + wv.start[i] - r0], dst[c][i], 0, dstW);
+                    }
+                }
             }
+        }
+    } else {
+        constexpr int blockWidth = 256;
+
+#ifdef _OPENMP
+        #pragma omp parallel if (multiThread)
 #endif
+        {
+            // vertically interpolated row of pixels, the tail covers the padding taps of the horizontal weights
+            const int lineLength = (srcW + wh.stride + 3) & ~3;
+            AlignedBuffer<float> lineBuffer(3 * lineLength);
+            memset(lineBuffer.data, 0, 3 * lineLength * sizeof(float));
+            float* const line[3] = {lineBuffer.data, lineBuffer.data + lineLength, lineBuffer.data + 2 * lineLength};
 
-            for (; j < src->W; ++j) {
-                float Ll = 0.0f, La = 0.0f, Lb = 0.0f;
+#ifdef _OPENMP
+            #pragma omp for schedule(dynamic, 16)
+#endif
 
-                for (int ii = ii0; ii < ii1; ++ii) {
-                    int k = ii - ii0;
+            for (int i = 0; i < dstH; i++) {
+                // Do vertical interpolation. Store results.
+                for (int j0 = 0; j0 < srcW; j0 += blockWidth) {
+                    const int j1 = min(j0 + blockWidth, srcW);
 
-                    Ll += w[k] * src->L[ii][j];
-                    La += w[k] * src->a[ii][j];
-                    Lb += w[k] * src->b[ii][j];
+                    for (int c = 0; c < 3; c++) {
+                        lanczosColumns(wv.get(i), wv.count[i], src[c] + wv.start[i], line[c], j0, j1);
+                    }
                 }
 
-                lL[j] = Ll;
-                la[j] = La;
-                lb[j] = Lb;
+                // Do horizontal interpolation
+                float* const out[3] = {dst[0][i], dst[1][i], dst[2][i]};
+                lanczosRow(wh, line, lineLength, out, dstW);
             }
+        }
+    }
+}
 
-            // Do horizontal interpolation
-            for (int x = 0; x < dst->W; ++x) {
-                float * wh = wwh + support * x;
-                float Ll = 0.0f, La = 0.0f, Lb = 0.0f;
+}
 
-                for (int jj = jj0[x]; jj < jj1[x]; ++jj) {
-                    int k = jj - jj0[x];
+void ImProcFunctions::Lanczos (const Imagefloat* src, Imagefloat* dst, float scale)
+{
+    const float* const* const srcPlanes[3] = {src->r.ptrs, src->g.ptrs, src->b.ptrs};
+    float** const dstPlanes[3] = {dst->r.ptrs, dst->g.ptrs, dst->b.ptrs};
+    lanczos3Planes(srcPlanes, dstPlanes, src->getWidth(), src->getHeight(), dst->getWidth(), dst->getHeight(), scale, multiThread);
+}
 
-                    Ll += wh[k] * lL[jj];
-                    La += wh[k] * la[jj];
-                    Lb += wh[k] * lb[jj];
-                }
 
-                dst->L[i][x] = Ll;
-                dst->a[i][x] = La;
-                dst->b[i][x] = Lb;
-            }
-        }
-    }
-    delete[] jj0;
-    delete[] jj1;
-    delete[] wwh;
+void ImProcFunctions::Lanczos (const LabImage* src, LabImage* dst, float scale)
+{
+    const float* const* const srcPlanes[3] = {src->L, src->a, src->b};
+    float** const dstPlanes[3] = {dst->L, dst->a, dst->b};
+    lanczos3Planes(srcPlanes, dstPlanes, src->W, src->H, dst->W, dst->H, scale, multiThread);
 }
 
 float ImProcFunctions::resizeScale (const ProcParams* params, int fw, int fh, int &imw, int &imh)
@@ -1063,9 +1063,10 @@ void ImProcFunctions::maskforretinex(int sp, int before, float ** luminance, flo
     #pragma omp parallel
 #endif
     {
-        gaussianBlur(bufmaskblurreti->L, bufmaskorigreti->L, W_L, H_L, radiusb);
-        gaussianBlur(bufmaskblurreti->a, bufmaskorigreti->a, W_L, H_L, 1.f + (0.5f * rad) / skip);
-        gaussianBlur(bufmaskblurreti->b, bufmaskorigreti->b, W_L, H_L, 1.f + (0.5f * rad) / skip);
+        float** const srcPlanes[3] = {bufmaskblurreti->L, bufmaskblurreti->a, bufmaskblurreti->b};
+        float** const dstPlanes[3] = {bufmaskorigreti->L, bufmaskorigreti->a, bufmaskorigreti->b};
+        const double sigmas[3] = {radiusb, 1.f + (0.5f * rad) / skip, 1.f + (0.5f * rad) / skip};
+        gaussianBlur(srcPlanes, dstPlanes, 3, W_L, H_L, sigmas);
     }
 
     float modr = 0.01f * (float) blend;
@@ -1124,9 +1125,9 @@ void ImProcFunctions::maskforretinex(int sp, int before, float ** luminance, flo
         #pragma omp parallel if (multiThread)
 #endif
         {
-            gaussianBlur(buforig->L, buforigmas->L, W_L, H_L, radius);
-            gaussianBlur(buforig->a, buforigmas->a, W_L, H_L, radius);
-            gaussianBlur(buforig->b, buforigmas->b, W_L, H_L, radius);
+            float** const srcPlanes[3] = {buforig->L, buforig->a, buforig->b};
+            float** const dstPlanes[3] = {buforigmas->L, buforigmas->a, buforigmas->b};
+            gaussianBlur(srcPlanes, dstPlanes, 3, W_L, H_L, radius);
         }
 
     }
@@ -1266,6 +1267,10 @@ void ImProcFunctions::MSRLocal(int call, int sp, bool fftw, int lum, float** red
     float kg = 1.f;//on Gaussianblur
 
     for (int scale = scal - 1; scale >= 0; --scale) {
+        if (isCancelled()) {
+            return;
+        }
+
         //    printf("retscale=%f scale=%i \n", mulradiusfftw * RetinexScales[scale], scale);
         //emprical adjustment between FFTW radius and Gaussainblur
         //under 50 ==> 10.f
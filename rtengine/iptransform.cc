@@ -17,6 +17,9 @@
  *  along with RawTherapee.  If not, see <https://www.gnu.org/licenses/>.
  */
 #include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
 
 #include "imagefloat.h"
 #include "improcfun.h"
@@ -327,6 +330,85 @@ inline void interpolateTransformChannelsCubicLog(const float* const* src, int xs
 }
 #endif
 
+/*
+ * Source positions of the output pixels, sampled every step pixels and bilinearly interpolated in between.
+ * The geometric chain of transformGeneral (perspective, LCP / lensfun distortion, rotation) is smooth,
+ * evaluating it once per node instead of once per pixel removes most of its cost.
+ */
+class DisplacementGrid
+{
+public:
+    DisplacementGrid() :
+        step(0),
+        invStep(0.0),
+        nodesX(0)
+    {
+    }
+
+    /** @brief Sample map(x, y, sourceX, sourceY) every step pixels of a width x height output
+     *  @return false if the interpolation error, measured at the cell centres, exceeds maxError (in source pixels)
+     */
+    template<typename MapFunc>
+    bool build(int width, int height, int step, double maxError, const MapFunc& map, bool multiThread)
+    {
+        this->step = step;
+        invStep = 1.0 / step;
+        // one node beyond the last pixel, so that every pixel has four nodes around it
+        nodesX = (width - 1) / step + 2;
+        const int nodesY = (height - 1) / step + 2;
+        nodes.resize(2 * nodesX * nodesY);
+
+#ifdef _OPENMP
+        #pragma omp parallel for if (multiThread)
+#endif
+
+        for (int i = 0; i < nodesY; ++i) {
+            for (int j = 0; j < nodesX; ++j) {
+                map(j * step, i * step, nodes[2 * (i * nodesX + j)], nodes[2 * (i * nodesX + j) + 1]);
+            }
+        }
+
+        double error = 0.0;
+
+#ifdef _OPENMP
+        #pragma omp parallel for reduction(max:error) if (multiThread)
+#endif
+
+        for (int i = 0; i < nodesY - 1; ++i) {
+            for (int j = 0; j < nodesX - 1; ++j) {
+                const int x = j * step + step / 2;
+                const int y = i * step + step / 2;
+                double sx, sy, gx, gy;
+                map(x, y, sx, sy);
+                get(x, y, gx, gy);
+                const double cellError = std::max(std::fabs(sx - gx), std::fabs(sy - gy));
+                // non finite positions (e.g. behind the camera for perspective) are not interpolated
+                error = std::max(error, std::isfinite(cellError) ? cellError : std::numeric_limits<double>::infinity());
+            }
+        }
+
+        return error <= maxError;
+    }
+
+    void get(int x, int y, double& sx, double& sy) const
+    {
+        const int j = x / step;
+        const int i = y / step;
+        const double fx = (x - j * step) * invStep;
+        const double fy = (y - i * step) * invStep;
+        const double* const n0 = &nodes[2 * (i * nodesX + j)];
+        const double* const n1 = n0 + 2 * nodesX;
+        sx = (1.0 - fy) * ((1.0 - fx) * n0[0] + fx * n0[2]) + fy * ((1.0 - fx) * n1[0] + fx * n1[2]);
+        sy = (1.0 - fy) * ((1.0 - fx) * n0[1] + fx * n0[3]) + fy * ((1.0 - fx) * n1[1] + fx * n1[3]);
+    }
+
+private:
+    int step;
+    double invStep;
+    int nodesX;
+    std::vector<double> nodes; // x and y interleaved
+};
+
 }
 
 namespace rtengine
@@ -1206,13 +1288,10 @@ void ImProcFunctions::transformGeneral(bool highQuality, Imagefloat *original, I
         original->b.ptrs
     };
 
-    // main cycle
-#ifdef _OPENMP
-    #pragma omp parallel for schedule(dynamic, 16) if(multiThread)
-#endif
-
-    for (int y = 0; y < transformed->getHeight(); ++y) {
-        for (int x = 0; x < transformed->getWidth(); ++x) {
+    // maps an output pixel to the centered and rotated source position, before distortion correction
+    const auto mapToSource =
+        [&](int x, int y, double &Dxc, double &Dyc)
+        {
             double x_d = x;
             double y_d = y;
 
@@ -1245,8 +1324,34 @@ void ImProcFunctions::transformGeneral(bool highQuality, Imagefloat *original, I
             }
 
             // rotate
-            const double Dxc = x_d * cost - y_d * sint;
-            const double Dyc = x_d * sint + y_d * cost;
+            Dxc = x_d * cost - y_d * sint;
+            Dyc = x_d * sint + y_d * cost;
+        };
+
+    // the chain is cheap without perspective and lens distortion, the grid would not pay off
+    DisplacementGrid grid;
+    bool useGrid = false;
+
+    if (perspectiveType != PerspType::NONE || enableLCPDist) {
+        for (int step = 16; step >= 4 && !useGrid; step /= 2) {
+            useGrid = grid.build(transformed->getWidth(), transformed->getHeight(), step, 0.01, mapToSource, multiThread);
+        }
+    }
+
+    // main cycle
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 16) if(multiThread)
+#endif
+
+    for (int y = 0; y < transformed->getHeight(); ++y) {
+        for (int x = 0; x < transformed->getWidth(); ++x) {
+            double Dxc, Dyc;
+
+            if (useGrid) {
+                grid.get(x, y, Dxc, Dyc);
+            } else {
+                mapToSource(x, y, Dxc, Dyc);
+            }
 
             // distortion correction
             double s = 1.0;
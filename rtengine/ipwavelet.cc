@@ -869,6 +869,10 @@ void ImProcFunctions::ip_wavelet(LabImage * lab, LabImage * dst, int kall, const
 
         for (int tiletop = 0; tiletop < imheight; tiletop += tileHskip) {
             for (int tileleft = 0; tileleft < imwidth ; tileleft += tileWskip) {
+                if (isCancelled()) {
+                    continue;
+                }
+
                 int tileright = rtengine::min(imwidth, tileleft + tilewidth);
                 int tilebottom = rtengine::min(imheight, tiletop + tileheight);
                 int width  = tileright - tileleft;
@@ -1082,8 +1086,8 @@ void ImProcFunctions::ip_wavelet(LabImage * lab, LabImage * dst, int kall, const
                 }
 
                 if (levwavL > 0) {
+                    const bool denoiseL = (cp.lev0n > 0.1f || cp.lev1n > 0.1f || cp.lev2n > 0.1f || cp.lev3n > 0.1f || cp.lev4n > 0.1f) && cp.noiseena;
                     const std::unique_ptr<wavelet_decomposition> Ldecomp(new wavelet_decomposition(labco->data, labco->W, labco->H, levwavL, 1, skip, rtengine::max(1, wavNestedLevels), DaubLen));
-                 //   const std::unique_ptr<wavelet_decomposition> Ldecomp2(new wavelet_decomposition(labco->data, labco->W, labco->H, levwavL, 1, skip, rtengine::max(1, wavNestedLevels), DaubLen));
 
                     if (!Ldecomp->memory_allocation_failed()) {
                         float madL[10][3];
@@ -1160,7 +1164,7 @@ void ImProcFunctions::ip_wavelet(LabImage * lab, LabImage * dst, int kall, const
                         } else {
                             kr4 = 1.f;
                         }
-                        if ((cp.lev0n > 0.1f || cp.lev1n > 0.1f || cp.lev2n > 0.1f || cp.lev3n > 0.1f || cp.lev4n > 0.1f) && cp.noiseena) {
+                        if (denoiseL) {
                             int edge = 6;
                             vari[0] = rtengine::max(0.000001f, vari[0]);
                             vari[1] = rtengine::max(0.000001f, vari[1]);
@@ -1169,7 +1173,8 @@ void ImProcFunctions::ip_wavelet(LabImage * lab, LabImage * dst, int kall, const
                             vari[4] = rtengine::max(0.000001f, kr4 * vari[4]);
                             vari[5] = rtengine::max(0.000001f, kr4 * vari[5]);
                             
-                            const std::unique_ptr<wavelet_decomposition> Ldecomp2(new wavelet_decomposition(labco->data, labco->W, labco->H, levwavL, 1, skip, rtengine::max(1, wavNestedLevels), DaubLen));
+                            // Ldecomp is still unmodified here, copying it is much cheaper than decomposing labco->data again
+                            const std::unique_ptr<const wavelet_decomposition> Ldecomp2(Ldecomp->clone());
                             if(!Ldecomp2->memory_allocation_failed()){
                                 if (settings->verbose) {
                                     printf("LUM var0=%f var1=%f var2=%f var3=%f var4=%f\n", vari[0], vari[1], vari[2], vari[3], vari[4]);
@@ -1332,7 +1337,7 @@ void ImProcFunctions::ip_wavelet(LabImage * lab, LabImage * dst, int kall, const
                                             int Wlvl_L = Ldecomp->level_W(level);
                                             int Hlvl_L = Ldecomp->level_H(level);
                                             float* const* WavCoeffs_L = Ldecomp->level_coeffs(level);//first decomp denoised
-                                            float* const* WavCoeffs_L2 = Ldecomp2->level_coeffs(level);//second decomp before denoise
+                                            const float* const* WavCoeffs_L2 = Ldecomp2->level_coeffs(level);//second decomp before denoise
                                             int k4 = 3;
                                             int k5 = 3;
                                             if(cp.complex == 1){
@@ -1763,7 +1768,9 @@ void ImProcFunctions::ip_wavelet(LabImage * lab, LabImage * dst, int kall, const
 
                         bool exblurab = cp.chrwav > 0.f && exblurL;
 
-                        if (!hhutili) { //always a or b
+                        if (isCancelled()) {
+                            // superseded preview, skip the chroma levels
+                        } else if (!hhutili) { //always a or b
                             int levwava = levwav;
 
                             if (!exblurab && cp.chrores == 0.f  && cp.blurcres == 0.f && !cp.noiseena && !cp.tonemap && !cp.resena && !cp.chromena && !cp.finena && !cp.edgeena&& params->wavelet.CLmethod == "all" && !cp.cbena) { // no processing of residual ab => we probably can reduce the number of levels
@@ -2127,6 +2134,10 @@ void ImProcFunctions::ip_wavelet(LabImage * lab, LabImage * dst, int kall, const
         delete dsttmp;
     }
 
+    if (isCancelled()) {
+        return;
+    }
+
     if (waparams.softradend > 0.f  && cp.finena) {
         float guid = waparams.softradend;
         float strend = waparams.strend;
@@ -2597,7 +2608,7 @@ void ImProcFunctions::EPDToneMapResid(float * WavCoeffs_L0, unsigned int Iterate
     const float gamm = params->wavelet.gamma;
     constexpr int rew = 0; //params->epd.reweightingIterates;
 
-    EdgePreservingDecomposition epd2(W_L, H_L);
+    EdgePreservingDecomposition epd2(W_L, H_L, params->wavelet.tmLegacySolver);
 
 #ifdef _OPENMP
     #pragma omp parallel for
@@ -0,0 +1,153 @@
+/*
+ *  This file is part of RawTherapee.
+ *
+ *  RawTherapee is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RawTherapee is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RawTherapee.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "locallabmaskcache.h"
+#include "labimage.h"
+#include "LUT.h"
+#include "settings.h"
+
+namespace
+{
+
+std::uint64_t mix(std::uint64_t x)
+{
+    // finalizer of splitmix64
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+std::uint64_t hashRow(const float* row, int width)
+{
+    // FNV-1a on 32 bit words
+    std::uint64_t hash = 0xcbf29ce484222325ULL;
+
+    for (int i = 0; i < width; ++i) {
+        std::uint32_t bits;
+        std::memcpy(&bits, row + i, sizeof(bits));
+        hash = (hash ^ bits) * 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+std::size_t maskSize(const rtengine::LabImage& mask)
+{
+    return 3 * sizeof(float) * mask.W * mask.H;
+}
+
+std::size_t maxCacheSize()
+{
+    // the default of 64 MiB holds about 5 masks of a 1200 x 800 preview
+    return static_cast<std::size_t>(rtengine::settings->locallabMaskCacheSize) * 1024 * 1024;
+}
+
+}
+
+namespace rtengine
+{
+
+void LocallabMaskCache::Key::add(const std::string& value)
+{
+    add(value.size());
+    settings.insert(settings.end(), value.begin(), value.end());
+}
+
+void LocallabMaskCache::Key::addCurve(const LUTf& curve, bool used)
+{
+    used = used && curve;
+    add(used);
+
+    if (used) {
+        const float* const data = &curve[0];
+        addData(&data, 0, 0, curve.getSize(), 1, false);
+    }
+}
+
+void LocallabMaskCache::Key::addData(const float* const* plane, int x, int y, int width, int height, bool multiThread)
+{
+    std::vector<std::uint64_t> rowHashes(height);
+
+#ifdef _OPENMP
+    #pragma omp parallel for if (multiThread)
+#endif
+    for (int i = 0; i < height; ++i) {
+        rowHashes[i] = hashRow(plane[y + i] + x, width);
+    }
+
+    add(width, height);
+
+    for (int i = 0; i < height; ++i) {
+        dataHash = mix(dataHash ^ mix(rowHashes[i] + i));
+    }
+}
+
+LocallabMaskCache::LocallabMaskCache() :
+    size(0)
+{
+}
+
+LocallabMaskCache::~LocallabMaskCache() = default;
+
+bool LocallabMaskCache::restore(const Key& key, LabImage& mask)
+{
+    MyMutex::MyLock lock(mutex);
+
+    for (auto entry = entries.begin(); entry != entries.end(); ++entry) {
+        if (entry->key == key) {
+            if (entry->mask->W != mask.W || entry->mask->H != mask.H) {
+                return false;
+            }
+
+            mask.CopyFrom(entry->mask.get());
+            entries.splice(entries.begin(), entries, entry);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void LocallabMaskCache::store(const Key& key, const LabImage& mask)
+{
+    const std::size_t budget = maxCacheSize();
+
+    if (maskSize(mask) > budget) {
+        return;
+    }
+
+    MyMutex::MyLock lock(mutex);
+
+    entries.push_front({key, std::unique_ptr<LabImage>(new LabImage(mask, true))});
+    size += maskSize(mask);
+
+    while (size > budget) {
+        size -= maskSize(*entries.back().mask);
+        entries.pop_back();
+    }
+}
+
+void LocallabMaskCache::clear()
+{
+    MyMutex::MyLock lock(mutex);
+
+    entries.clear();
+    size = 0;
+}
+
+}
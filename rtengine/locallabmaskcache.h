@@ -0,0 +1,129 @@
+/*
+ *  This file is part of RawTherapee.
+ *
+ *  RawTherapee is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RawTherapee is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RawTherapee.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "noncopyable.h"
+
+#include "../rtgui/threadutils.h"
+
+template<typename T>
+class LUT;
+
+using LUTf = LUT<float>;
+
+namespace rtengine
+{
+
+class LabImage;
+
+/*
+ * Keeps the masks of the Local Adjustments tools (maskcalccol) of the last preview updates.
+ *
+ * A mask only depends on the image at the input of the tool, on the mask settings and curves of the
+ * tool and on the spot geometry. Changing a slider of the tool itself (e.g. the exposure) changes
+ * none of these, so the mask of the last update can be reused. Masks are looked up by a key made of
+ * the exact settings and of a hash of the input image data. The least recently used masks are
+ * dropped once the cache exceeds its budget (Settings::locallabMaskCacheSize).
+ */
+class LocallabMaskCache final :
+    public NonCopyable
+{
+public:
+    class Key
+    {
+    public:
+        template<typename T>
+        void add(T value)
+        {
+            static_assert(std::is_arithmetic<T>::value, "only arithmetic values can be added to the key");
+            const std::size_t size = settings.size();
+            settings.resize(size + sizeof(T));
+            std::memcpy(settings.data() + size, &value, sizeof(T));
+        }
+
+        template<typename T, typename... Tail>
+        void add(T value, Tail... tail)
+        {
+            add(value);
+            add(tail...);
+        }
+
+        void add(const std::string& value);
+
+        // curve is one of the Loc*Curve classes, which are sampled at 501 points
+        template<typename Curve>
+        void addCurve(const Curve& curve, bool used)
+        {
+            used = used && curve;
+            add(used);
+
+            if (used) {
+                for (int i = 0; i <= 500; ++i) {
+                    add(curve[i]);
+                }
+            }
+        }
+
+        void addCurve(const LUTf& curve, bool used);
+
+        // hash of the width x height region at (x, y) of plane
+        void addData(const float* const* plane, int x, int y, int width, int height, bool multiThread);
+
+        bool operator ==(const Key& other) const
+        {
+            return dataHash == other.dataHash && settings == other.settings;
+        }
+
+    private:
+        std::vector<char> settings;
+        std::uint64_t dataHash = 0;
+    };
+
+    LocallabMaskCache();
+    ~LocallabMaskCache();
+
+    /** @brief Look up the mask stored for key
+     *  @param mask receives the mask, must have the size of the stored one
+     *  @return true if the mask was found
+     */
+    bool restore(const Key& key, LabImage& mask);
+
+    void store(const Key& key, const LabImage& mask);
+
+    void clear();
+
+private:
+    struct Entry {
+        Key key;
+        std::unique_ptr<LabImage> mask;
+    };
+
+    // the crops of the detail windows use the same ImProcFunctions as the preview, from their own threads
+    MyMutex mutex;
+    std::list<Entry> entries; // most recently used first
+    std::size_t size;
+};
+
+}
@@ -0,0 +1,91 @@
+/*
+ *  This file is part of RawTherapee.
+ *
+ *  RawTherapee is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RawTherapee is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RawTherapee.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+
+#include "locallabspotcache.h"
+#include "labimage.h"
+
+namespace rtengine
+{
+
+LocallabSpotCache::LocallabSpotCache() :
+    width(0),
+    height(0),
+    scale(0)
+{
+}
+
+LocallabSpotCache::~LocallabSpotCache() = default;
+
+int LocallabSpotCache::restore(const procparams::ProcParams& params, int width, int height, int scale, LabImage& dst,
+                               std::vector<LocallabListener::locallabRef>& refs, std::vector<LocallabListener::locallabRetiMinMax>& retiMinMax) const
+{
+    if (!snapshot || width != this->width || height != this->height || scale != this->scale) {
+        return 0;
+    }
+
+    const std::vector<procparams::LocallabParams::LocallabSpot>& current = params.locallab.spots;
+
+    // the spot at the snapshot has to exist, otherwise there is nothing left to process
+    if (current.size() <= spots.size() || !std::equal(spots.begin(), spots.end(), current.begin())) {
+        return 0;
+    }
+
+    if (!(upstreamParams(params) == upstream)) {
+        return 0;
+    }
+
+    dst.CopyFrom(snapshot.get());
+    refs.insert(refs.end(), spotRefs.begin(), spotRefs.end());
+    retiMinMax.insert(retiMinMax.end(), spotRetiMinMax.begin(), spotRetiMinMax.end());
+    return static_cast<int>(spots.size());
+}
+
+void LocallabSpotCache::store(const procparams::ProcParams& params, int sp, int width, int height, int scale, const LabImage& src,
+                              const std::vector<LocallabListener::locallabRef>& refs, const std::vector<LocallabListener::locallabRetiMinMax>& retiMinMax)
+{
+    if (!snapshot || snapshot->W != width || snapshot->H != height) {
+        snapshot.reset(new LabImage(width, height));
+    }
+
+    snapshot->CopyFrom(&src);
+    upstream = upstreamParams(params);
+    spots.assign(params.locallab.spots.begin(), params.locallab.spots.begin() + sp);
+    spotRefs.assign(refs.begin(), refs.begin() + sp);
+    spotRetiMinMax.assign(retiMinMax.begin(), retiMinMax.begin() + sp);
+    this->width = width;
+    this->height = height;
+    this->scale = scale;
+}
+
+void LocallabSpotCache::clear()
+{
+    snapshot.reset();
+    spots.clear();
+    spotRefs.clear();
+    spotRetiMinMax.clear();
+}
+
+procparams::ProcParams LocallabSpotCache::upstreamParams(const procparams::ProcParams& params)
+{
+    procparams::ProcParams result = params;
+    result.locallab.spots.clear();
+    result.locallab.selspot = 0;
+    return result;
+}
+
+}
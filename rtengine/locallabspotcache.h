@@ -0,0 +1,78 @@
+/*
+ *  This file is part of RawTherapee.
+ *
+ *  RawTherapee is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RawTherapee is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RawTherapee.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "noncopyable.h"
+#include "procparams.h"
+#include "rtengine.h"
+
+namespace rtengine
+{
+
+class LabImage;
+
+/*
+ * Keeps the image at the input of one Local Adjustments spot of the last preview update.
+ *
+ * Spots are applied one after the other on the same image, so the input of spot n only depends on
+ * the pipeline before Local Adjustments and on spots 0 .. n - 1. While the user edits spot n, these
+ * do not change and the spots before n (including their masks and reference values) don't need to
+ * be processed again. The snapshot is taken at the input of the selected spot.
+ */
+class LocallabSpotCache final :
+    public NonCopyable
+{
+public:
+    LocallabSpotCache();
+    ~LocallabSpotCache();
+
+    /** @brief Restore the input of the first spot which has to be processed
+     *  @param dst receives the input of that spot
+     *  @param refs receives the reference values of the skipped spots
+     *  @param retiMinMax receives the Retinex min/max of the skipped spots
+     *  @return number of leading spots which did not change since the snapshot was taken, 0 if all spots have to be processed
+     */
+    int restore(const procparams::ProcParams& params, int width, int height, int scale, LabImage& dst,
+                std::vector<LocallabListener::locallabRef>& refs, std::vector<LocallabListener::locallabRetiMinMax>& retiMinMax) const;
+
+    /** @brief Take a snapshot of the input of spot sp
+     *  @param refs reference values of spots 0 .. sp - 1
+     *  @param retiMinMax Retinex min/max of spots 0 .. sp - 1
+     */
+    void store(const procparams::ProcParams& params, int sp, int width, int height, int scale, const LabImage& src,
+               const std::vector<LocallabListener::locallabRef>& refs, const std::vector<LocallabListener::locallabRetiMinMax>& retiMinMax);
+
+    void clear();
+
+private:
+    // everything before Local Adjustments influences the snapshot, params are stored without the spots
+    static procparams::ProcParams upstreamParams(const procparams::ProcParams& params);
+
+    procparams::ProcParams upstream;
+    std::vector<procparams::LocallabParams::LocallabSpot> spots; // the spots before the snapshot
+    std::vector<LocallabListener::locallabRef> spotRefs;
+    std::vector<LocallabListener::locallabRetiMinMax> spotRetiMinMax;
+    int width;
+    int height;
+    int scale;
+    std::unique_ptr<LabImage> snapshot;
+};
+
+}
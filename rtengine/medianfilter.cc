@@ -0,0 +1,3100 @@
+/*
+ *  This file is part of RawTherapee.
+ *
+ *  RawTherapee is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RawTherapee is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RawTherapee.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+
+#include "medianfilter.h"
+#include "opthelper.h"
+#include "separablefilter.h"
+
+namespace rtengine
+{
+
+namespace
+{
+
+inline float sortMin(float a, float b)
+{
+    return std::min(a, b);
+}
+
+inline float sortMax(float a, float b)
+{
+    return std::max(a, b);
+}
+
+#ifdef __SSE2__
+inline vfloat sortMin(vfloat a, vfloat b)
+{
+    return vminf(a, b);
+}
+
+inline vfloat sortMax(vfloat a, vfloat b)
+{
+    return vmaxf(a, b);
+}
+#endif
+
+constexpr int WINDOWS = 4; // adjacent windows evaluated by one selection network
+
+/*
+ * MedianNetwork<K>::sortColumn sorts the K values of a column.
+ * MedianNetwork<K>::slidingMedians returns the medians of the windows of the columns 0 .. K - 1, 1 .. K, 2 .. K + 1
+ * and 3 .. K + 2 of K + 3 sorted columns, value r of column c is c[c * K + r].
+ *
+ * The networks are generated by tools/generateMedianNetworks: odd-even merges of the sorted columns, where the merge
+ * of the columns common to several windows is done once for them. Comparisons known from the order of the columns or
+ * of earlier comparisons are left out, and so are all comparisons which don't contribute to a median.
+ * tools/checkMedianFilter.cc compares the filter with std::nth_element.
+ */
+template<int K>
+struct MedianNetwork;
+
+// BEGIN GENERATED by tools/generateMedianNetworks, do not edit
+template<>
+struct MedianNetwork<3> {
+    template<typename T>
+    static void sortColumn(T* v)
+    {
+        const T t0 = sortMin(v[0], v[1]);
+        const T t1 = sortMax(v[0], v[1]);
+        const T t2 = sortMin(v[2], t0);
+        const T t3 = sortMax(v[2], t0);
+        const T t4 = sortMin(t1, t3);
+        const T t5 = sortMax(t1, t3);
+        v[0] = t2;
+        v[1] = t4;
+        v[2] = t5;
+    }
+
+    template<typename T>
+    static void slidingMedians(const T* c, T* out)
+    {
+        const T t0 = sortMin(c[3], c[6]);
+        const T t1 = sortMax(c[3], c[6]);
+        const T t2 = sortMin(c[5], c[8]);
+        const T t3 = sortMax(c[5], c[8]);
+        const T t4 = sortMin(t2, t1);
+        const T t5 = sortMax(t2, t1);
+        const T t6 = sortMin(c[4], c[7]);
+        const T t7 = sortMax(c[4], c[7]);
+        const T t8 = sortMin(t6, t4);
+        const T t9 = sortMax(t6, t4);
+        const T t10 = sortMin(t7, t5);
+        const T t11 = sortMax(t7, t5);
+        const T t12 = sortMax(c[0], t0);
+        const T t13 = sortMin(t11, t12);
+        const T t14 = sortMin(c[2], t9);
+        const T t15 = sortMax(t14, t13);
+        const T t16 = sortMax(c[1], t8);
+        const T t17 = sortMin(t3, t16);
+        const T t18 = sortMin(t10, t17);
+        const T t19 = sortMax(t18, t15);
+        const T t20 = sortMax(c[9], t0);
+        const T t21 = sortMin(t11, t20);
+        const T t22 = sortMin(c[11], t9);
+        const T t23 = sortMax(t22, t21);
+        const T t24 = sortMax(c[10], t8);
+        const T t25 = sortMin(t3, t24);
+        const T t26 = sortMin(t10, t25);
+        const T t27 = sortMax(t26, t23);
+        const T t28 = sortMin(c[9], c[12]);
+        const T t29 = sortMax(c[9], c[12]);
+        const T t30 = sortMin(c[11], c[14]);
+        const T t31 = sortMax(c[11], c[14]);
+        const T t32 = sortMin(t30, t29);
+        const T t33 = sortMax(t30, t29);
+        const T t34 = sortMin(c[10], c[13]);
+        const T t35 = sortMax(c[10], c[13]);
+        const T t36 = sortMin(t34, t32);
+        const T t37 = sortMax(t34, t32);
+        const T t38 = sortMin(t35, t33);
+        const T t39 = sortMax(t35, t33);
+        const T t40 = sortMax(c[6], t28);
+        const T t41 = sortMin(t39, t40);
+        const T t42 = sortMin(c[8], t37);
+        const T t43 = sortMax(t42, t41);
+        const T t44 = sortMax(c[7], t36);
+        const T t45 = sortMin(t31, t44);
+        const T t46 = sortMin(t38, t45);
+        const T t47 = sortMax(t46, t43);
+        const T t48 = sortMax(c[15], t28);
+        const T t49 = sortMin(t39, t48);
+        const T t50 = sortMin(c[17], t37);
+        const T t51 = sortMax(t50, t49);
+        const T t52 = sortMax(c[16], t36);
+        const T t53 = sortMin(t31, t52);
+        const T t54 = sortMin(t38, t53);
+        const T t55 = sortMax(t54, t51);
+        out[0] = t19;
+        out[1] = t27;
+        out[2] = t47;
+        out[3] = t55;
+    }
+};
+
+template<>
+struct MedianNetwork<5> {
+    template<typename T>
+    static void sortColumn(T* v)
+    {
+        const T t0 = sortMin(v[0], v[1]);
+        const T t1 = sortMax(v[0], v[1]);
+        const T t2 = sortMin(v[2], v[3]);
+        const T t3 = sortMax(v[2], v[3]);
+        const T t4 = sortMin(v[4], t0);
+        const T t5 = sortMax(v[4], t0);
+        const T t6 = sortMin(t1, t5);
+        const T t7 = sortMax(t1, t5);
+        const T t8 = sortMin(t2, t4);
+        const T t9 = sortMax(t2, t4);
+        const T t10 = sortMin(t7, t9);
+        const T t11 = sortMax(t7, t9);
+        const T t12 = sortMin(t3, t6);
+        const T t13 = sortMax(t3, t6);
+        const T t14 = sortMin(t12, t10);
+        const T t15 = sortMax(t12, t10);
+        const T t16 = sortMin(t13, t11);
+        const T t17 = sortMax(t13, t11);
+        v[0] = t8;
+        v[1] = t14;
+        v[2] = t15;
+        v[3] = t16;
+        v[4] = t17;
+    }
+
+    template<typename T>
+    static void slidingMedians(const T* c, T* out)
+    {
+        const T t0 = sortMin(c[15], c[20]);
+        const T t1 = sortMax(c[15], c[20]);
+        const T t2 = sortMin(c[19], c[24]);
+        const T t3 = sortMax(c[19], c[24]);
+        const T t4 = sortMin(t2, t1);
+        const T t5 = sortMax(t2, t1);
+        const T t6 = sortMin(c[17], c[22]);
+        const T t7 = sortMax(c[17], c[22]);
+        const T t8 = sortMin(t6, t4);
+        const T t9 = sortMax(t6, t4);
+        const T t10 = sortMin(t7, t5);
+        const T t11 = sortMax(t7, t5);
+        const T t12 = sortMin(c[16], c[21]);
+        const T t13 = sortMax(c[16], c[21]);
+        const T t14 = sortMin(c[18], c[23]);
+        const T t15 = sortMax(c[18], c[23]);
+        const T t16 = sortMin(t14, t13);
+        const T t17 = sortMax(t14, t13);
+        const T t18 = sortMin(t12, t8);
+        const T t19 = sortMax(t12, t8);
+        const T t20 = sortMin(t16, t9);
+        const T t21 = sortMax(t16, t9);
+        const T t22 = sortMin(t17, t10);
+        const T t23 = sortMax(t17, t10);
+        const T t24 = sortMin(t15, t11);
+        const T t25 = sortMax(t15, t11);
+        const T t26 = sortMin(c[5], c[10]);
+        const T t27 = sortMax(c[5], c[10]);
+        const T t28 = sortMin(c[9], c[14]);
+        const T t29 = sortMax(c[9], c[14]);
+        const T t30 = sortMin(t28, t27);
+        const T t31 = sortMax(t28, t27);
+        const T t32 = sortMin(c[7], c[12]);
+        const T t33 = sortMax(c[7], c[12]);
+        const T t34 = sortMin(t32, t30);
+        const T t35 = sortMax(t32, t30);
+        const T t36 = sortMin(t33, t31);
+        const T t37 = sortMax(t33, t31);
+        const T t38 = sortMin(c[6], c[11]);
+        const T t39 = sortMax(c[6], c[11]);
+        const T t40 = sortMin(c[8], c[13]);
+        const T t41 = sortMax(c[8], c[13]);
+        const T t42 = sortMin(t40, t39);
+        const T t43 = sortMax(t40, t39);
+        const T t44 = sortMin(t38, t34);
+        const T t45 = sortMax(t38, t34);
+        const T t46 = sortMin(t42, t35);
+        const T t47 = sortMax(t42, t35);
+        const T t48 = sortMin(t43, t36);
+        const T t49 = sortMax(t43, t36);
+        const T t50 = sortMin(t41, t37);
+        const T t51 = sortMax(t41, t37);
+        const T t52 = sortMin(t0, t26);
+        const T t53 = sortMax(t0, t26);
+        const T t54 = sortMin(t25, t51);
+        const T t55 = sortMax(t25, t51);
+        const T t56 = sortMin(t54, t53);
+        const T t57 = sortMax(t54, t53);
+        const T t58 = sortMin(t21, t47);
+        const T t59 = sortMax(t21, t47);
+        const T t60 = sortMin(t58, t56);
+        const T t61 = sortMax(t58, t56);
+        const T t62 = sortMin(t59, t57);
+        const T t63 = sortMax(t59, t57);
+        const T t64 = sortMin(t19, t45);
+        const T t65 = sortMax(t19, t45);
+        const T t66 = sortMin(t23, t49);
+        const T t67 = sortMax(t23, t49);
+        const T t68 = sortMin(t66, t65);
+        const T t69 = sortMax(t66, t65);
+        const T t70 = sortMin(t64, t60);
+        const T t71 = sortMax(t64, t60);
+        const T t72 = sortMin(t68, t61);
+        const T t73 = sortMax(t68, t61);
+        const T t74 = sortMin(t69, t62);
+        const T t75 = sortMax(t69, t62);
+        const T t76 = sortMin(t67, t63);
+        const T t77 = sortMax(t67, t63);
+        const T t78 = sortMin(t18, t44);
+        const T t79 = sortMax(t18, t44);
+        const T t80 = sortMin(t3, t29);
+        const T t81 = sortMax(t3, t29);
+        const T t82 = sortMin(t80, t79);
+        const T t83 = sortMax(t80, t79);
+        const T t84 = sortMin(t22, t48);
+        const T t85 = sortMax(t22, t48);
+        const T t86 = sortMin(t84, t82);
+        const T t87 = sortMax(t84, t82);
+        const T t88 = sortMin(t85, t83);
+        const T t89 = sortMax(t85, t83);
+        const T t90 = sortMin(t20, t46);
+        const T t91 = sortMax(t20, t46);
+        const T t92 = sortMin(t24, t50);
+        const T t93 = sortMax(t24, t50);
+        const T t94 = sortMin(t92, t91);
+        const T t95 = sortMax(t92, t91);
+        const T t96 = sortMin(t90, t86);
+        const T t97 = sortMax(t90, t86);
+        const T t98 = sortMin(t94, t87);
+        const T t99 = sortMax(t94, t87);
+        const T t100 = sortMin(t95, t88);
+        const T t101 = sortMax(t95, t88);
+        const T t102 = sortMin(t93, t89);
+        const T t103 = sortMax(t93, t89);
+        const T t104 = sortMin(t78, t70);
+        const T t105 = sortMax(t78, t70);
+        const T t106 = sortMin(t96, t71);
+        const T t107 = sortMax(t96, t71);
+        const T t108 = sortMax(t97, t72);
+        const T t109 = sortMin(t98, t73);
+        const T t110 = sortMax(t98, t73);
+        const T t111 = sortMin(t99, t74);
+        const T t112 = sortMax(t99, t74);
+        const T t113 = sortMin(t100, t75);
+        const T t114 = sortMax(t100, t75);
+        const T t115 = sortMin(t101, t76);
+        const T t116 = sortMax(t102, t77);
+        const T t117 = sortMin(t103, t55);
+        const T t118 = sortMax(t103, t55);
+        const T t119 = sortMax(c[0], t52);
+        const T t120 = sortMin(t116, t119);
+        const T t121 = sortMax(t110, t120);
+        const T t122 = sortMax(c[4], t107);
+        const T t123 = sortMin(t114, t122);
+        const T t124 = sortMin(t123, t121);
+        const T t125 = sortMax(c[2], t105);
+        const T t126 = sortMin(t118, t125);
+        const T t127 = sortMin(t112, t126);
+        const T t128 = sortMax(t108, t127);
+        const T t129 = sortMax(t128, t124);
+        const T t130 = sortMax(c[1], t104);
+        const T t131 = sortMin(t117, t130);
+        const T t132 = sortMax(t111, t131);
+        const T t133 = sortMin(t115, t132);
+        const T t134 = sortMax(c[3], t106);
+        const T t135 = sortMin(t81, t134);
+        const T t136 = sortMin(t113, t135);
+        const T t137 = sortMax(t109, t136);
+        const T t138 = sortMin(t137, t133);
+        const T t139 = sortMax(t138, t129);
+        const T t140 = sortMax(c[25], t52);
+        const T t141 = sortMin(t116, t140);
+        const T t142 = sortMax(t110, t141);
+        const T t143 = sortMax(c[29], t107);
+        const T t144 = sortMin(t114, t143);
+        const T t145 = sortMin(t144, t142);
+        const T t146 = sortMax(c[27], t105);
+        const T t147 = sortMin(t118, t146);
+        const T t148 = sortMin(t112, t147);
+        const T t149 = sortMax(t108, t148);
+        const T t150 = sortMax(t149, t145);
+        const T t151 = sortMax(c[26], t104);
+        const T t152 = sortMin(t117, t151);
+        const T t153 = sortMax(t111, t152);
+        const T t154 = sortMin(t115, t153);
+        const T t155 = sortMax(c[28], t106);
+        const T t156 = sortMin(t81, t155);
+        const T t157 = sortMin(t113, t156);
+        const T t158 = sortMax(t109, t157);
+        const T t159 = sortMin(t158, t154);
+        const T t160 = sortMax(t159, t150);
+        const T t161 = sortMin(c[25], c[30]);
+        const T t162 = sortMax(c[25], c[30]);
+        const T t163 = sortMin(c[29], c[34]);
+        const T t164 = sortMax(c[29], c[34]);
+        const T t165 = sortMin(t163, t162);
+        const T t166 = sortMax(t163, t162);
+        const T t167 = sortMin(c[27], c[32]);
+        const T t168 = sortMax(c[27], c[32]);
+        const T t169 = sortMin(t167, t165);
+        const T t170 = sortMax(t167, t165);
+        const T t171 = sortMin(t168, t166);
+        const T t172 = sortMax(t168, t166);
+        const T t173 = sortMin(c[26], c[31]);
+        const T t174 = sortMax(c[26], c[31]);
+        const T t175 = sortMin(c[28], c[33]);
+        const T t176 = sortMax(c[28], c[33]);
+        const T t177 = sortMin(t175, t174);
+        const T t178 = sortMax(t175, t174);
+        const T t179 = sortMin(t173, t169);
+        const T t180 = sortMax(t173, t169);
+        const T t181 = sortMin(t177, t170);
+        const T t182 = sortMax(t177, t170);
+        const T t183 = sortMin(t178, t171);
+        const T t184 = sortMax(t178, t171);
+        const T t185 = sortMin(t176, t172);
+        const T t186 = sortMax(t176, t172);
+        const T t187 = sortMin(t0, t161);
+        const T t188 = sortMax(t0, t161);
+        const T t189 = sortMin(t25, t186);
+        const T t190 = sortMax(t25, t186);
+        const T t191 = sortMin(t189, t188);
+        const T t192 = sortMax(t189, t188);
+        const T t193 = sortMin(t21, t182);
+        const T t194 = sortMax(t21, t182);
+        const T t195 = sortMin(t193, t191);
+        const T t196 = sortMax(t193, t191);
+        const T t197 = sortMin(t194, t192);
+        const T t198 = sortMax(t194, t192);
+        const T t199 = sortMin(t19, t180);
+        const T t200 = sortMax(t19, t180);
+        const T t201 = sortMin(t23, t184);
+        const T t202 = sortMax(t23, t184);
+        const T t203 = sortMin(t201, t200);
+        const T t204 = sortMax(t201, t200);
+        const T t205 = sortMin(t199, t195);
+        const T t206 = sortMax(t199, t195);
+        const T t207 = sortMin(t203, t196);
+        const T t208 = sortMax(t203, t196);
+        const T t209 = sortMin(t204, t197);
+        const T t210 = sortMax(t204, t197);
+        const T t211 = sortMin(t202, t198);
+        const T t212 = sortMax(t202, t198);
+        const T t213 = sortMin(t18, t179);
+        const T t214 = sortMax(t18, t179);
+        const T t215 = sortMin(t3, t164);
+        const T t216 = sortMax(t3, t164);
+        const T t217 = sortMin(t215, t214);
+        const T t218 = sortMax(t215, t214);
+        const T t219 = sortMin(t22, t183);
+        const T t220 = sortMax(t22, t183);
+        const T t221 = sortMin(t219, t217);
+        const T t222 = sortMax(t219, t217);
+        const T t223 = sortMin(t220, t218);
+        const T t224 = sortMax(t220, t218);
+        const T t225 = sortMin(t20, t181);
+        const T t226 = sortMax(t20, t181);
+        const T t227 = sortMin(t24, t185);
+        const T t228 = sortMax(t24, t185);
+        const T t229 = sortMin(t227, t226);
+        const T t230 = sortMax(t227, t226);
+        const T t231 = sortMin(t225, t221);
+        const T t232 = sortMax(t225, t221);
+        const T t233 = sortMin(t229, t222);
+        const T t234 = sortMax(t229, t222);
+        const T t235 = sortMin(t230, t223);
+        const T t236 = sortMax(t230, t223);
+        const T t237 = sortMin(t228, t224);
+        const T t238 = sortMax(t228, t224);
+        const T t239 = sortMin(t213, t205);
+        const T t240 = sortMax(t213, t205);
+        const T t241 = sortMin(t231, t206);
+        const T t242 = sortMax(t231, t206);
+        const T t243 = sortMax(t232, t207);
+        const T t244 = sortMin(t233, t208);
+        const T t245 = sortMax(t233, t208);
+        const T t246 = sortMin(t234, t209);
+        const T t247 = sortMax(t234, t209);
+        const T t248 = sortMin(t235, t210);
+        const T t249 = sortMax(t235, t210);
+        const T t250 = sortMin(t236, t211);
+        const T t251 = sortMax(t237, t212);
+        const T t252 = sortMin(t238, t190);
+        const T t253 = sortMax(t238, t190);
+        const T t254 = sortMax(c[10], t187);
+        const T t255 = sortMin(t251, t254);
+        const T t256 = sortMax(t245, t255);
+        const T t257 = sortMax(c[14], t242);
+        const T t258 = sortMin(t249, t257);
+        const T t259 = sortMin(t258, t256);
+        const T t260 = sortMax(c[12], t240);
+        const T t261 = sortMin(t253, t260);
+        const T t262 = sortMin(t247, t261);
+        const T t263 = sortMax(t243, t262);
+        const T t264 = sortMax(t263, t259);
+        const T t265 = sortMax(c[11], t239);
+        const T t266 = sortMin(t252, t265);
+        const T t267 = sortMax(t246, t266);
+        const T t268 = sortMin(t250, t267);
+        const T t269 = sortMax(c[13], t241);
+        const T t270 = sortMin(t216, t269);
+        const T t271 = sortMin(t248, t270);
+        const T t272 = sortMax(t244, t271);
+        const T t273 = sortMin(t272, t268);
+        const T t274 = sortMax(t273, t264);
+        const T t275 = sortMax(c[35], t187);
+        const T t276 = sortMin(t251, t275);
+        const T t277 = sortMax(t245, t276);
+        const T t278 = sortMax(c[39], t242);
+        const T t279 = sortMin(t249, t278);
+        const T t280 = sortMin(t279, t277);
+        const T t281 = sortMax(c[37], t240);
+        const T t282 = sortMin(t253, t281);
+        const T t283 = sortMin(t247, t282);
+        const T t284 = sortMax(t243, t283);
+        const T t285 = sortMax(t284, t280);
+        const T t286 = sortMax(c[36], t239);
+        const T t287 = sortMin(t252, t286);
+        const T t288 = sortMax(t246, t287);
+        const T t289 = sortMin(t250, t288);
+        const T t290 = sortMax(c[38], t241);
+        const T t291 = sortMin(t216, t290);
+        const T t292 = sortMin(t248, t291);
+        const T t293 = sortMax(t244, t292);
+        const T t294 = sortMin(t293, t289);
+        const T t295 = sortMax(t294, t285);
+        out[0] = t139;
+        out[1] = t160;
+        out[2] = t274;
+        out[3] = t295;
+    }
+};
+
+template<>
+struct MedianNetwork<7> {
+    template<typename T>
+    static void sortColumn(T* v)
+    {
+        const T t0 = sortMin(v[0], v[1]);
+        const T t1 = sortMax(v[0], v[1]);
+        const T t2 = sortMin(v[2], v[3]);
+        const T t3 = sortMax(v[2], v[3]);
+        const T t4 = sortMin(v[4], v[5]);
+        const T t5 = sortMax(v[4], v[5]);
+        const T t6 = sortMin(v[6], t0);
+        const T t7 = sortMax(v[6], t0);
+        const T t8 = sortMin(t1, t7);
+        const T t9 = sortMax(t1, t7);
+        const T t10 = sortMin(t2, t4);
+        const T t11 = sortMax(t2, t4);
+        const T t12 = sortMin(t3, t5);
+        const T t13 = sortMax(t3, t5);
+        const T t14 = sortMin(t12, t11);
+        const T t15 = sortMax(t12, t11);
+        const T t16 = sortMin(t6, t10);
+        const T t17 = sortMax(t6, t10);
+        const T t18 = sortMin(t9, t15);
+        const T t19 = sortMax(t9, t15);
+        const T t20 = sortMin(t18, t17);
+        const T t21 = sortMax(t18, t17);
+        const T t22 = sortMin(t8, t14);
+        const T t23 = sortMax(t8, t14);
+        const T t24 = sortMin(t13, t23);
+        const T t25 = sortMax(t13, t23);
+        const T t26 = sortMin(t22, t20);
+        const T t27 = sortMax(t22, t20);
+        const T t28 = sortMin(t24, t21);
+        const T t29 = sortMax(t24, t21);
+        const T t30 = sortMin(t25, t19);
+        const T t31 = sortMax(t25, t19);
+        v[0] = t16;
+        v[1] = t26;
+        v[2] = t27;
+        v[3] = t28;
+        v[4] = t29;
+        v[5] = t30;
+        v[6] = t31;
+    }
+
+    template<typename T>
+    static void slidingMedians(const T* c, T* out)
+    {
+        const T t0 = sortMin(c[21], c[28]);
+        const T t1 = sortMax(c[21], c[28]);
+        const T t2 = sortMin(c[25], c[32]);
+        const T t3 = sortMax(c[25], c[32]);
+        const T t4 = sortMin(t2, t1);
+        const T t5 = sortMax(t2, t1);
+        const T t6 = sortMin(c[23], c[30]);
+        const T t7 = sortMax(c[23], c[30]);
+        const T t8 = sortMin(c[27], c[34]);
+        const T t9 = sortMax(c[27], c[34]);
+        const T t10 = sortMin(t8, t7);
+        const T t11 = sortMax(t8, t7);
+        const T t12 = sortMin(t6, t4);
+        const T t13 = sortMax(t6, t4);
+        const T t14 = sortMin(t10, t5);
+        const T t15 = sortMax(t10, t5);
+        const T t16 = sortMin(t11, t3);
+        const T t17 = sortMax(t11, t3);
+        const T t18 = sortMin(c[22], c[29]);
+        const T t19 = sortMax(c[22], c[29]);
+        const T t20 = sortMin(c[26], c[33]);
+        const T t21 = sortMax(c[26], c[33]);
+        const T t22 = sortMin(t20, t19);
+        const T t23 = sortMax(t20, t19);
+        const T t24 = sortMin(c[24], c[31]);
+        const T t25 = sortMax(c[24], c[31]);
+        const T t26 = sortMin(t24, t22);
+        const T t27 = sortMax(t24, t22);
+        const T t28 = sortMin(t25, t23);
+        const T t29 = sortMax(t25, t23);
+        const T t30 = sortMin(t18, t12);
+        const T t31 = sortMax(t18, t12);
+        const T t32 = sortMin(t26, t13);
+        const T t33 = sortMax(t26, t13);
+        const T t34 = sortMin(t27, t14);
+        const T t35 = sortMax(t27, t14);
+        const T t36 = sortMin(t28, t15);
+        const T t37 = sortMax(t28, t15);
+        const T t38 = sortMin(t29, t16);
+        const T t39 = sortMax(t29, t16);
+        const T t40 = sortMin(t21, t17);
+        const T t41 = sortMax(t21, t17);
+        const T t42 = sortMin(c[35], c[42]);
+        const T t43 = sortMax(c[35], c[42]);
+        const T t44 = sortMin(c[39], c[46]);
+        const T t45 = sortMax(c[39], c[46]);
+        const T t46 = sortMin(t44, t43);
+        const T t47 = sortMax(t44, t43);
+        const T t48 = sortMin(c[37], c[44]);
+        const T t49 = sortMax(c[37], c[44]);
+        const T t50 = sortMin(c[41], c[48]);
+        const T t51 = sortMax(c[41], c[48]);
+        const T t52 = sortMin(t50, t49);
+        const T t53 = sortMax(t50, t49);
+        const T t54 = sortMin(t48, t46);
+        const T t55 = sortMax(t48, t46);
+        const T t56 = sortMin(t52, t47);
+        const T t57 = sortMax(t52, t47);
+        const T t58 = sortMin(t53, t45);
+        const T t59 = sortMax(t53, t45);
+        const T t60 = sortMin(c[36], c[43]);
+        const T t61 = sortMax(c[36], c[43]);
+        const T t62 = sortMin(c[40], c[47]);
+        const T t63 = sortMax(c[40], c[47]);
+        const T t64 = sortMin(t62, t61);
+        const T t65 = sortMax(t62, t61);
+        const T t66 = sortMin(c[38], c[45]);
+        const T t67 = sortMax(c[38], c[45]);
+        const T t68 = sortMin(t66, t64);
+        const T t69 = sortMax(t66, t64);
+        const T t70 = sortMin(t67, t65);
+        const T t71 = sortMax(t67, t65);
+        const T t72 = sortMin(t60, t54);
+        const T t73 = sortMax(t60, t54);
+        const T t74 = sortMin(t68, t55);
+        const T t75 = sortMax(t68, t55);
+        const T t76 = sortMin(t69, t56);
+        const T t77 = sortMax(t69, t56);
+        const T t78 = sortMin(t70, t57);
+        const T t79 = sortMax(t70, t57);
+        const T t80 = sortMin(t71, t58);
+        const T t81 = sortMax(t71, t58);
+        const T t82 = sortMin(t63, t59);
+        const T t83 = sortMax(t63, t59);
+        const T t84 = sortMin(t0, t42);
+        const T t85 = sortMax(t0, t42);
+        const T t86 = sortMin(t37, t79);
+        const T t87 = sortMax(t37, t79);
+        const T t88 = sortMin(t86, t85);
+        const T t89 = sortMax(t86, t85);
+        const T t90 = sortMin(t33, t75);
+        const T t91 = sortMax(t33, t75);
+        const T t92 = sortMin(t41, t83);
+        const T t93 = sortMax(t41, t83);
+        const T t94 = sortMin(t92, t91);
+        const T t95 = sortMax(t92, t91);
+        const T t96 = sortMin(t90, t88);
+        const T t97 = sortMax(t90, t88);
+        const T t98 = sortMin(t94, t89);
+        const T t99 = sortMax(t94, t89);
+        const T t100 = sortMin(t95, t87);
+        const T t101 = sortMax(t95, t87);
+        const T t102 = sortMin(t31, t73);
+        const T t103 = sortMax(t31, t73);
+        const T t104 = sortMin(t39, t81);
+        const T t105 = sortMax(t39, t81);
+        const T t106 = sortMin(t104, t103);
+        const T t107 = sortMax(t104, t103);
+        const T t108 = sortMin(t35, t77);
+        const T t109 = sortMax(t35, t77);
+        const T t110 = sortMin(t108, t106);
+        const T t111 = sortMax(t108, t106);
+        const T t112 = sortMin(t109, t107);
+        const T t113 = sortMax(t109, t107);
+        const T t114 = sortMin(t102, t96);
+        const T t115 = sortMax(t102, t96);
+        const T t116 = sortMin(t110, t97);
+        const T t117 = sortMax(t110, t97);
+        const T t118 = sortMin(t111, t98);
+        const T t119 = sortMax(t111, t98);
+        const T t120 = sortMin(t112, t99);
+        const T t121 = sortMax(t112, t99);
+        const T t122 = sortMin(t113, t100);
+        const T t123 = sortMax(t113, t100);
+        const T t124 = sortMin(t105, t101);
+        const T t125 = sortMax(t105, t101);
+        const T t126 = sortMin(t30, t72);
+        const T t127 = sortMax(t30, t72);
+        const T t128 = sortMin(t38, t80);
+        const T t129 = sortMax(t38, t80);
+        const T t130 = sortMin(t128, t127);
+        const T t131 = sortMax(t128, t127);
+        const T t132 = sortMin(t34, t76);
+        const T t133 = sortMax(t34, t76);
+        const T t134 = sortMin(t9, t51);
+        const T t135 = sortMax(t9, t51);
+        const T t136 = sortMin(t134, t133);
+        const T t137 = sortMax(t134, t133);
+        const T t138 = sortMin(t132, t130);
+        const T t139 = sortMax(t132, t130);
+        const T t140 = sortMin(t136, t131);
+        const T t141 = sortMax(t136, t131);
+        const T t142 = sortMin(t137, t129);
+        const T t143 = sortMax(t137, t129);
+        const T t144 = sortMin(t32, t74);
+        const T t145 = sortMax(t32, t74);
+        const T t146 = sortMin(t40, t82);
+        const T t147 = sortMax(t40, t82);
+        const T t148 = sortMin(t146, t145);
+        const T t149 = sortMax(t146, t145);
+        const T t150 = sortMin(t36, t78);
+        const T t151 = sortMax(t36, t78);
+        const T t152 = sortMin(t150, t148);
+        const T t153 = sortMax(t150, t148);
+        const T t154 = sortMin(t151, t149);
+        const T t155 = sortMax(t151, t149);
+        const T t156 = sortMin(t144, t138);
+        const T t157 = sortMax(t144, t138);
+        const T t158 = sortMin(t152, t139);
+        const T t159 = sortMax(t152, t139);
+        const T t160 = sortMin(t153, t140);
+        const T t161 = sortMax(t153, t140);
+        const T t162 = sortMin(t154, t141);
+        const T t163 = sortMax(t154, t141);
+        const T t164 = sortMin(t155, t142);
+        const T t165 = sortMax(t155, t142);
+        const T t166 = sortMin(t147, t143);
+        const T t167 = sortMax(t147, t143);
+        const T t168 = sortMin(t126, t114);
+        const T t169 = sortMax(t126, t114);
+        const T t170 = sortMin(t156, t115);
+        const T t171 = sortMax(t156, t115);
+        const T t172 = sortMin(t157, t116);
+        const T t173 = sortMax(t157, t116);
+        const T t174 = sortMin(t158, t117);
+        const T t175 = sortMax(t158, t117);
+        const T t176 = sortMin(t159, t118);
+        const T t177 = sortMax(t159, t118);
+        const T t178 = sortMin(t160, t119);
+        const T t179 = sortMax(t160, t119);
+        const T t180 = sortMin(t161, t120);
+        const T t181 = sortMax(t161, t120);
+        const T t182 = sortMin(t162, t121);
+        const T t183 = sortMax(t162, t121);
+        const T t184 = sortMin(t163, t122);
+        const T t185 = sortMax(t163, t122);
+        const T t186 = sortMin(t164, t123);
+        const T t187 = sortMax(t164, t123);
+        const T t188 = sortMin(t165, t124);
+        const T t189 = sortMax(t165, t124);
+        const T t190 = sortMin(t166, t125);
+        const T t191 = sortMax(t166, t125);
+        const T t192 = sortMin(t167, t93);
+        const T t193 = sortMax(t167, t93);
+        const T t194 = sortMin(c[7], c[14]);
+        const T t195 = sortMax(c[7], c[14]);
+        const T t196 = sortMin(c[11], c[18]);
+        const T t197 = sortMax(c[11], c[18]);
+        const T t198 = sortMin(t196, t195);
+        const T t199 = sortMax(t196, t195);
+        const T t200 = sortMin(c[9], c[16]);
+        const T t201 = sortMax(c[9], c[16]);
+        const T t202 = sortMin(c[13], c[20]);
+        const T t203 = sortMax(c[13], c[20]);
+        const T t204 = sortMin(t202, t201);
+        const T t205 = sortMax(t202, t201);
+        const T t206 = sortMin(t200, t198);
+        const T t207 = sortMax(t200, t198);
+        const T t208 = sortMin(t204, t199);
+        const T t209 = sortMax(t204, t199);
+        const T t210 = sortMin(t205, t197);
+        const T t211 = sortMax(t205, t197);
+        const T t212 = sortMin(c[8], c[15]);
+        const T t213 = sortMax(c[8], c[15]);
+        const T t214 = sortMin(c[12], c[19]);
+        const T t215 = sortMax(c[12], c[19]);
+        const T t216 = sortMin(t214, t213);
+        const T t217 = sortMax(t214, t213);
+        const T t218 = sortMin(c[10], c[17]);
+        const T t219 = sortMax(c[10], c[17]);
+        const T t220 = sortMin(t218, t216);
+        const T t221 = sortMax(t218, t216);
+        const T t222 = sortMin(t219, t217);
+        const T t223 = sortMax(t219, t217);
+        const T t224 = sortMin(t212, t206);
+        const T t225 = sortMax(t212, t206);
+        const T t226 = sortMin(t220, t207);
+        const T t227 = sortMax(t220, t207);
+        const T t228 = sortMin(t221, t208);
+        const T t229 = sortMax(t221, t208);
+        const T t230 = sortMin(t222, t209);
+        const T t231 = sortMax(t222, t209);
+        const T t232 = sortMin(t223, t210);
+        const T t233 = sortMax(t223, t210);
+        const T t234 = sortMin(t215, t211);
+        const T t235 = sortMax(t215, t211);
+        const T t236 = sortMin(t194, t84);
+        const T t237 = sortMax(t194, t84);
+        const T t238 = sortMin(t183, t237);
+        const T t239 = sortMax(t183, t237);
+        const T t240 = sortMin(t231, t175);
+        const T t241 = sortMax(t231, t175);
+        const T t242 = sortMin(t191, t241);
+        const T t243 = sortMax(t191, t241);
+        const T t244 = sortMin(t240, t238);
+        const T t245 = sortMax(t240, t238);
+        const T t246 = sortMin(t242, t239);
+        const T t247 = sortMax(t242, t239);
+        const T t248 = sortMin(t227, t171);
+        const T t249 = sortMax(t227, t171);
+        const T t250 = sortMin(t187, t249);
+        const T t251 = sortMax(t187, t249);
+        const T t252 = sortMin(t235, t179);
+        const T t253 = sortMax(t235, t179);
+        const T t254 = sortMin(t252, t250);
+        const T t255 = sortMax(t252, t250);
+        const T t256 = sortMin(t253, t251);
+        const T t257 = sortMax(t253, t251);
+        const T t258 = sortMin(t248, t244);
+        const T t259 = sortMax(t248, t244);
+        const T t260 = sortMin(t254, t245);
+        const T t261 = sortMax(t254, t245);
+        const T t262 = sortMin(t255, t246);
+        const T t263 = sortMax(t255, t246);
+        const T t264 = sortMin(t256, t247);
+        const T t265 = sortMax(t256, t247);
+        const T t266 = sortMin(t257, t243);
+        const T t267 = sortMax(t257, t243);
+        const T t268 = sortMin(t225, t169);
+        const T t269 = sortMax(t225, t169);
+        const T t270 = sortMin(t185, t269);
+        const T t271 = sortMax(t185, t269);
+        const T t272 = sortMin(t233, t177);
+        const T t273 = sortMax(t233, t177);
+        const T t274 = sortMin(t193, t273);
+        const T t275 = sortMax(t193, t273);
+        const T t276 = sortMin(t272, t270);
+        const T t277 = sortMax(t272, t270);
+        const T t278 = sortMin(t274, t271);
+        const T t279 = sortMax(t274, t271);
+        const T t280 = sortMin(t229, t173);
+        const T t281 = sortMax(t229, t173);
+        const T t282 = sortMin(t189, t281);
+        const T t283 = sortMax(t189, t281);
+        const T t284 = sortMin(t181, t282);
+        const T t285 = sortMax(t181, t282);
+        const T t286 = sortMin(t280, t276);
+        const T t287 = sortMax(t280, t276);
+        const T t288 = sortMin(t284, t277);
+        const T t289 = sortMax(t284, t277);
+        const T t290 = sortMin(t285, t278);
+        const T t291 = sortMax(t285, t278);
+        const T t292 = sortMin(t283, t279);
+        const T t293 = sortMax(t283, t279);
+        const T t294 = sortMin(t268, t258);
+        const T t295 = sortMax(t268, t258);
+        const T t296 = sortMin(t286, t259);
+        const T t297 = sortMax(t287, t260);
+        const T t298 = sortMin(t288, t261);
+        const T t299 = sortMax(t288, t261);
+        const T t300 = sortMin(t289, t262);
+        const T t301 = sortMax(t289, t262);
+        const T t302 = sortMin(t290, t263);
+        const T t303 = sortMax(t290, t263);
+        const T t304 = sortMin(t291, t264);
+        const T t305 = sortMax(t291, t264);
+        const T t306 = sortMax(t292, t265);
+        const T t307 = sortMin(t293, t266);
+        const T t308 = sortMax(t293, t266);
+        const T t309 = sortMin(t275, t267);
+        const T t310 = sortMin(t224, t168);
+        const T t311 = sortMax(t224, t168);
+        const T t312 = sortMin(t184, t311);
+        const T t313 = sortMax(t184, t311);
+        const T t314 = sortMin(t232, t176);
+        const T t315 = sortMax(t232, t176);
+        const T t316 = sortMin(t192, t315);
+        const T t317 = sortMax(t192, t315);
+        const T t318 = sortMin(t314, t312);
+        const T t319 = sortMax(t314, t312);
+        const T t320 = sortMin(t316, t313);
+        const T t321 = sortMax(t316, t313);
+        const T t322 = sortMin(t228, t172);
+        const T t323 = sortMax(t228, t172);
+        const T t324 = sortMin(t188, t323);
+        const T t325 = sortMax(t188, t323);
+        const T t326 = sortMin(t203, t180);
+        const T t327 = sortMax(t203, t180);
+        const T t328 = sortMin(t326, t324);
+        const T t329 = sortMax(t326, t324);
+        const T t330 = sortMin(t327, t325);
+        const T t331 = sortMax(t327, t325);
+        const T t332 = sortMin(t322, t318);
+        const T t333 = sortMin(t328, t319);
+        const T t334 = sortMax(t328, t319);
+        const T t335 = sortMin(t329, t320);
+        const T t336 = sortMax(t329, t320);
+        const T t337 = sortMin(t330, t321);
+        const T t338 = sortMax(t330, t321);
+        const T t339 = sortMin(t331, t317);
+        const T t340 = sortMin(t226, t170);
+        const T t341 = sortMax(t226, t170);
+        const T t342 = sortMin(t186, t341);
+        const T t343 = sortMax(t186, t341);
+        const T t344 = sortMin(t234, t178);
+        const T t345 = sortMax(t234, t178);
+        const T t346 = sortMin(t135, t345);
+        const T t347 = sortMin(t344, t342);
+        const T t348 = sortMax(t344, t342);
+        const T t349 = sortMin(t346, t343);
+        const T t350 = sortMax(t346, t343);
+        const T t351 = sortMin(t230, t174);
+        const T t352 = sortMax(t230, t174);
+        const T t353 = sortMin(t190, t352);
+        const T t354 = sortMax(t190, t352);
+        const T t355 = sortMin(t182, t353);
+        const T t356 = sortMax(t182, t353);
+        const T t357 = sortMax(t351, t347);
+        const T t358 = sortMin(t355, t348);
+        const T t359 = sortMax(t355, t348);
+        const T t360 = sortMin(t356, t349);
+        const T t361 = sortMax(t356, t349);
+        const T t362 = sortMin(t354, t350);
+        const T t363 = sortMax(t354, t350);
+        const T t364 = sortMin(t340, t332);
+        const T t365 = sortMax(t340, t332);
+        const T t366 = sortMin(t357, t333);
+        const T t367 = sortMax(t357, t333);
+        const T t368 = sortMin(t358, t334);
+        const T t369 = sortMax(t358, t334);
+        const T t370 = sortMin(t359, t335);
+        const T t371 = sortMax(t359, t335);
+        const T t372 = sortMin(t360, t336);
+        const T t373 = sortMax(t360, t336);
+        const T t374 = sortMin(t361, t337);
+        const T t375 = sortMin(t362, t338);
+        const T t376 = sortMax(t362, t338);
+        const T t377 = sortMin(t363, t339);
+        const T t378 = sortMax(t363, t339);
+        const T t379 = sortMin(t310, t294);
+        const T t380 = sortMax(t310, t294);
+        const T t381 = sortMin(t364, t295);
+        const T t382 = sortMax(t364, t295);
+        const T t383 = sortMin(t365, t296);
+        const T t384 = sortMax(t365, t296);
+        const T t385 = sortMax(t366, t297);
+        const T t386 = sortMin(t367, t298);
+        const T t387 = sortMax(t367, t298);
+        const T t388 = sortMax(t368, t299);
+        const T t389 = sortMin(t369, t300);
+        const T t390 = sortMax(t369, t300);
+        const T t391 = sortMin(t370, t301);
+        const T t392 = sortMax(t370, t301);
+        const T t393 = sortMin(t371, t302);
+        const T t394 = sortMax(t371, t302);
+        const T t395 = sortMin(t372, t303);
+        const T t396 = sortMax(t372, t303);
+        const T t397 = sortMin(t373, t304);
+        const T t398 = sortMax(t373, t304);
+        const T t399 = sortMin(t374, t305);
+        const T t400 = sortMax(t375, t306);
+        const T t401 = sortMin(t376, t307);
+        const T t402 = sortMax(t376, t307);
+        const T t403 = sortMin(t377, t308);
+        const T t404 = sortMax(t377, t308);
+        const T t405 = sortMin(t378, t309);
+        const T t406 = sortMax(t378, t309);
+        const T t407 = sortMax(c[0], t236);
+        const T t408 = sortMin(t400, t407);
+        const T t409 = sortMax(t388, t408);
+        const T t410 = sortMin(t396, t409);
+        const T t411 = sortMax(c[4], t382);
+        const T t412 = sortMin(t404, t411);
+        const T t413 = sortMin(t392, t412);
+        const T t414 = sortMax(t385, t413);
+        const T t415 = sortMax(t414, t410);
+        const T t416 = sortMax(c[2], t380);
+        const T t417 = sortMin(t402, t416);
+        const T t418 = sortMax(t390, t417);
+        const T t419 = sortMin(t398, t418);
+        const T t420 = sortMax(c[6], t384);
+        const T t421 = sortMin(t406, t420);
+        const T t422 = sortMin(t394, t421);
+        const T t423 = sortMax(t387, t422);
+        const T t424 = sortMin(t423, t419);
+        const T t425 = sortMax(t424, t415);
+        const T t426 = sortMax(c[1], t379);
+        const T t427 = sortMin(t401, t426);
+        const T t428 = sortMax(t389, t427);
+        const T t429 = sortMin(t397, t428);
+        const T t430 = sortMax(c[5], t383);
+        const T t431 = sortMin(t405, t430);
+        const T t432 = sortMin(t393, t431);
+        const T t433 = sortMax(t386, t432);
+        const T t434 = sortMax(t433, t429);
+        const T t435 = sortMax(c[3], t381);
+        const T t436 = sortMin(t403, t435);
+        const T t437 = sortMax(t391, t436);
+        const T t438 = sortMin(t399, t437);
+        const T t439 = sortMin(t395, t438);
+        const T t440 = sortMin(t439, t434);
+        const T t441 = sortMax(t440, t425);
+        const T t442 = sortMax(c[49], t236);
+        const T t443 = sortMin(t400, t442);
+        const T t444 = sortMax(t388, t443);
+        const T t445 = sortMin(t396, t444);
+        const T t446 = sortMax(c[53], t382);
+        const T t447 = sortMin(t404, t446);
+        const T t448 = sortMin(t392, t447);
+        const T t449 = sortMax(t385, t448);
+        const T t450 = sortMax(t449, t445);
+        const T t451 = sortMax(c[51], t380);
+        const T t452 = sortMin(t402, t451);
+        const T t453 = sortMax(t390, t452);
+        const T t454 = sortMin(t398, t453);
+        const T t455 = sortMax(c[55], t384);
+        const T t456 = sortMin(t406, t455);
+        const T t457 = sortMin(t394, t456);
+        const T t458 = sortMax(t387, t457);
+        const T t459 = sortMin(t458, t454);
+        const T t460 = sortMax(t459, t450);
+        const T t461 = sortMax(c[50], t379);
+        const T t462 = sortMin(t401, t461);
+        const T t463 = sortMax(t389, t462);
+        const T t464 = sortMin(t397, t463);
+        const T t465 = sortMax(c[54], t383);
+        const T t466 = sortMin(t405, t465);
+        const T t467 = sortMin(t393, t466);
+        const T t468 = sortMax(t386, t467);
+        const T t469 = sortMax(t468, t464);
+        const T t470 = sortMax(c[52], t381);
+        const T t471 = sortMin(t403, t470);
+        const T t472 = sortMax(t391, t471);
+        const T t473 = sortMin(t399, t472);
+        const T t474 = sortMin(t395, t473);
+        const T t475 = sortMin(t474, t469);
+        const T t476 = sortMax(t475, t460);
+        const T t477 = sortMin(c[49], c[56]);
+        const T t478 = sortMax(c[49], c[56]);
+        const T t479 = sortMin(c[53], c[60]);
+        const T t480 = sortMax(c[53], c[60]);
+        const T t481 = sortMin(t479, t478);
+        const T t482 = sortMax(t479, t478);
+        const T t483 = sortMin(c[51], c[58]);
+        const T t484 = sortMax(c[51], c[58]);
+        const T t485 = sortMin(c[55], c[62]);
+        const T t486 = sortMax(c[55], c[62]);
+        const T t487 = sortMin(t485, t484);
+        const T t488 = sortMax(t485, t484);
+        const T t489 = sortMin(t483, t481);
+        const T t490 = sortMax(t483, t481);
+        const T t491 = sortMin(t487, t482);
+        const T t492 = sortMax(t487, t482);
+        const T t493 = sortMin(t488, t480);
+        const T t494 = sortMax(t488, t480);
+        const T t495 = sortMin(c[50], c[57]);
+        const T t496 = sortMax(c[50], c[57]);
+        const T t497 = sortMin(c[54], c[61]);
+        const T t498 = sortMax(c[54], c[61]);
+        const T t499 = sortMin(t497, t496);
+        const T t500 = sortMax(t497, t496);
+        const T t501 = sortMin(c[52], c[59]);
+        const T t502 = sortMax(c[52], c[59]);
+        const T t503 = sortMin(t501, t499);
+        const T t504 = sortMax(t501, t499);
+        const T t505 = sortMin(t502, t500);
+        const T t506 = sortMax(t502, t500);
+        const T t507 = sortMin(t495, t489);
+        const T t508 = sortMax(t495, t489);
+        const T t509 = sortMin(t503, t490);
+        const T t510 = sortMax(t503, t490);
+        const T t511 = sortMin(t504, t491);
+        const T t512 = sortMax(t504, t491);
+        const T t513 = sortMin(t505, t492);
+        const T t514 = sortMax(t505, t492);
+        const T t515 = sortMin(t506, t493);
+        const T t516 = sortMax(t506, t493);
+        const T t517 = sortMin(t498, t494);
+        const T t518 = sortMax(t498, t494);
+        const T t519 = sortMin(t477, t84);
+        const T t520 = sortMax(t477, t84);
+        const T t521 = sortMin(t183, t520);
+        const T t522 = sortMax(t183, t520);
+        const T t523 = sortMin(t514, t175);
+        const T t524 = sortMax(t514, t175);
+        const T t525 = sortMin(t191, t524);
+        const T t526 = sortMax(t191, t524);
+        const T t527 = sortMin(t523, t521);
+        const T t528 = sortMax(t523, t521);
+        const T t529 = sortMin(t525, t522);
+        const T t530 = sortMax(t525, t522);
+        const T t531 = sortMin(t510, t171);
+        const T t532 = sortMax(t510, t171);
+        const T t533 = sortMin(t187, t532);
+        const T t534 = sortMax(t187, t532);
+        const T t535 = sortMin(t518, t179);
+        const T t536 = sortMax(t518, t179);
+        const T t537 = sortMin(t535, t533);
+        const T t538 = sortMax(t535, t533);
+        const T t539 = sortMin(t536, t534);
+        const T t540 = sortMax(t536, t534);
+        const T t541 = sortMin(t531, t527);
+        const T t542 = sortMax(t531, t527);
+        const T t543 = sortMin(t537, t528);
+        const T t544 = sortMax(t537, t528);
+        const T t545 = sortMin(t538, t529);
+        const T t546 = sortMax(t538, t529);
+        const T t547 = sortMin(t539, t530);
+        const T t548 = sortMax(t539, t530);
+        const T t549 = sortMin(t540, t526);
+        const T t550 = sortMax(t540, t526);
+        const T t551 = sortMin(t508, t169);
+        const T t552 = sortMax(t508, t169);
+        const T t553 = sortMin(t185, t552);
+        const T t554 = sortMax(t185, t552);
+        const T t555 = sortMin(t516, t177);
+        const T t556 = sortMax(t516, t177);
+        const T t557 = sortMin(t193, t556);
+        const T t558 = sortMax(t193, t556);
+        const T t559 = sortMin(t555, t553);
+        const T t560 = sortMax(t555, t553);
+        const T t561 = sortMin(t557, t554);
+        const T t562 = sortMax(t557, t554);
+        const T t563 = sortMin(t512, t173);
+        const T t564 = sortMax(t512, t173);
+        const T t565 = sortMin(t189, t564);
+        const T t566 = sortMax(t189, t564);
+        const T t567 = sortMin(t181, t565);
+        const T t568 = sortMax(t181, t565);
+        const T t569 = sortMin(t563, t559);
+        const T t570 = sortMax(t563, t559);
+        const T t571 = sortMin(t567, t560);
+        const T t572 = sortMax(t567, t560);
+        const T t573 = sortMin(t568, t561);
+        const T t574 = sortMax(t568, t561);
+        const T t575 = sortMin(t566, t562);
+        const T t576 = sortMax(t566, t562);
+        const T t577 = sortMin(t551, t541);
+        const T t578 = sortMax(t551, t541);
+        const T t579 = sortMin(t569, t542);
+        const T t580 = sortMax(t570, t543);
+        const T t581 = sortMin(t571, t544);
+        const T t582 = sortMax(t571, t544);
+        const T t583 = sortMin(t572, t545);
+        const T t584 = sortMax(t572, t545);
+        const T t585 = sortMin(t573, t546);
+        const T t586 = sortMax(t573, t546);
+        const T t587 = sortMin(t574, t547);
+        const T t588 = sortMax(t574, t547);
+        const T t589 = sortMax(t575, t548);
+        const T t590 = sortMin(t576, t549);
+        const T t591 = sortMax(t576, t549);
+        const T t592 = sortMin(t558, t550);
+        const T t593 = sortMin(t507, t168);
+        const T t594 = sortMax(t507, t168);
+        const T t595 = sortMin(t184, t594);
+        const T t596 = sortMax(t184, t594);
+        const T t597 = sortMin(t515, t176);
+        const T t598 = sortMax(t515, t176);
+        const T t599 = sortMin(t192, t598);
+        const T t600 = sortMax(t192, t598);
+        const T t601 = sortMin(t597, t595);
+        const T t602 = sortMax(t597, t595);
+        const T t603 = sortMin(t599, t596);
+        const T t604 = sortMax(t599, t596);
+        const T t605 = sortMin(t511, t172);
+        const T t606 = sortMax(t511, t172);
+        const T t607 = sortMin(t188, t606);
+        const T t608 = sortMax(t188, t606);
+        const T t609 = sortMin(t486, t180);
+        const T t610 = sortMax(t486, t180);
+        const T t611 = sortMin(t609, t607);
+        const T t612 = sortMax(t609, t607);
+        const T t613 = sortMin(t610, t608);
+        const T t614 = sortMax(t610, t608);
+        const T t615 = sortMin(t605, t601);
+        const T t616 = sortMin(t611, t602);
+        const T t617 = sortMax(t611, t602);
+        const T t618 = sortMin(t612, t603);
+        const T t619 = sortMax(t612, t603);
+        const T t620 = sortMin(t613, t604);
+        const T t621 = sortMax(t613, t604);
+        const T t622 = sortMin(t614, t600);
+        const T t623 = sortMin(t509, t170);
+        const T t624 = sortMax(t509, t170);
+        const T t625 = sortMin(t186, t624);
+        const T t626 = sortMax(t186, t624);
+        const T t627 = sortMin(t517, t178);
+        const T t628 = sortMax(t517, t178);
+        const T t629 = sortMin(t135, t628);
+        const T t630 = sortMin(t627, t625);
+        const T t631 = sortMax(t627, t625);
+        const T t632 = sortMin(t629, t626);
+        const T t633 = sortMax(t629, t626);
+        const T t634 = sortMin(t513, t174);
+        const T t635 = sortMax(t513, t174);
+        const T t636 = sortMin(t190, t635);
+        const T t637 = sortMax(t190, t635);
+        const T t638 = sortMin(t182, t636);
+        const T t639 = sortMax(t182, t636);
+        const T t640 = sortMax(t634, t630);
+        const T t641 = sortMin(t638, t631);
+        const T t642 = sortMax(t638, t631);
+        const T t643 = sortMin(t639, t632);
+        const T t644 = sortMax(t639, t632);
+        const T t645 = sortMin(t637, t633);
+        const T t646 = sortMax(t637, t633);
+        const T t647 = sortMin(t623, t615);
+        const T t648 = sortMax(t623, t615);
+        const T t649 = sortMin(t640, t616);
+        const T t650 = sortMax(t640, t616);
+        const T t651 = sortMin(t641, t617);
+        const T t652 = sortMax(t641, t617);
+        const T t653 = sortMin(t642, t618);
+        const T t654 = sortMax(t642, t618);
+        const T t655 = sortMin(t643, t619);
+        const T t656 = sortMax(t643, t619);
+        const T t657 = sortMin(t644, t620);
+        const T t658 = sortMin(t645, t621);
+        const T t659 = sortMax(t645, t621);
+        const T t660 = sortMin(t646, t622);
+        const T t661 = sortMax(t646, t622);
+        const T t662 = sortMin(t593, t577);
+        const T t663 = sortMax(t593, t577);
+        const T t664 = sortMin(t647, t578);
+        const T t665 = sortMax(t647, t578);
+        const T t666 = sortMin(t648, t579);
+        const T t667 = sortMax(t648, t579);
+        const T t668 = sortMax(t649, t580);
+        const T t669 = sortMin(t650, t581);
+        const T t670 = sortMax(t650, t581);
+        const T t671 = sortMax(t651, t582);
+        const T t672 = sortMin(t652, t583);
+        const T t673 = sortMax(t652, t583);
+        const T t674 = sortMin(t653, t584);
+        const T t675 = sortMax(t653, t584);
+        const T t676 = sortMin(t654, t585);
+        const T t677 = sortMax(t654, t585);
+        const T t678 = sortMin(t655, t586);
+        const T t679 = sortMax(t655, t586);
+        const T t680 = sortMin(t656, t587);
+        const T t681 = sortMax(t656, t587);
+        const T t682 = sortMin(t657, t588);
+        const T t683 = sortMax(t658, t589);
+        const T t684 = sortMin(t659, t590);
+        const T t685 = sortMax(t659, t590);
+        const T t686 = sortMin(t660, t591);
+        const T t687 = sortMax(t660, t591);
+        const T t688 = sortMin(t661, t592);
+        const T t689 = sortMax(t661, t592);
+        const T t690 = sortMax(c[14], t519);
+        const T t691 = sortMin(t683, t690);
+        const T t692 = sortMax(t671, t691);
+        const T t693 = sortMin(t679, t692);
+        const T t694 = sortMax(c[18], t665);
+        const T t695 = sortMin(t687, t694);
+        const T t696 = sortMin(t675, t695);
+        const T t697 = sortMax(t668, t696);
+        const T t698 = sortMax(t697, t693);
+        const T t699 = sortMax(c[16], t663);
+        const T t700 = sortMin(t685, t699);
+        const T t701 = sortMax(t673, t700);
+        const T t702 = sortMin(t681, t701);
+        const T t703 = sortMax(c[20], t667);
+        const T t704 = sortMin(t689, t703);
+        const T t705 = sortMin(t677, t704);
+        const T t706 = sortMax(t670, t705);
+        const T t707 = sortMin(t706, t702);
+        const T t708 = sortMax(t707, t698);
+        const T t709 = sortMax(c[15], t662);
+        const T t710 = sortMin(t684, t709);
+        const T t711 = sortMax(t672, t710);
+        const T t712 = sortMin(t680, t711);
+        const T t713 = sortMax(c[19], t666);
+        const T t714 = sortMin(t688, t713);
+        const T t715 = sortMin(t676, t714);
+        const T t716 = sortMax(t669, t715);
+        const T t717 = sortMax(t716, t712);
+        const T t718 = sortMax(c[17], t664);
+        const T t719 = sortMin(t686, t718);
+        const T t720 = sortMax(t674, t719);
+        const T t721 = sortMin(t682, t720);
+        const T t722 = sortMin(t678, t721);
+        const T t723 = sortMin(t722, t717);
+        const T t724 = sortMax(t723, t708);
+        const T t725 = sortMax(c[63], t519);
+        const T t726 = sortMin(t683, t725);
+        const T t727 = sortMax(t671, t726);
+        const T t728 = sortMin(t679, t727);
+        const T t729 = sortMax(c[67], t665);
+        const T t730 = sortMin(t687, t729);
+        const T t731 = sortMin(t675, t730);
+        const T t732 = sortMax(t668, t731);
+        const T t733 = sortMax(t732, t728);
+        const T t734 = sortMax(c[65], t663);
+        const T t735 = sortMin(t685, t734);
+        const T t736 = sortMax(t673, t735);
+        const T t737 = sortMin(t681, t736);
+        const T t738 = sortMax(c[69], t667);
+        const T t739 = sortMin(t689, t738);
+        const T t740 = sortMin(t677, t739);
+        const T t741 = sortMax(t670, t740);
+        const T t742 = sortMin(t741, t737);
+        const T t743 = sortMax(t742, t733);
+        const T t744 = sortMax(c[64], t662);
+        const T t745 = sortMin(t684, t744);
+        const T t746 = sortMax(t672, t745);
+        const T t747 = sortMin(t680, t746);
+        const T t748 = sortMax(c[68], t666);
+        const T t749 = sortMin(t688, t748);
+        const T t750 = sortMin(t676, t749);
+        const T t751 = sortMax(t669, t750);
+        const T t752 = sortMax(t751, t747);
+        const T t753 = sortMax(c[66], t664);
+        const T t754 = sortMin(t686, t753);
+        const T t755 = sortMax(t674, t754);
+        const T t756 = sortMin(t682, t755);
+        const T t757 = sortMin(t678, t756);
+        const T t758 = sortMin(t757, t752);
+        const T t759 = sortMax(t758, t743);
+        out[0] = t441;
+        out[1] = t476;
+        out[2] = t724;
+        out[3] = t759;
+    }
+};
+
+template<>
+struct MedianNetwork<9> {
+    template<typename T>
+    static void sortColumn(T* v)
+    {
+        const T t0 = sortMin(v[0], v[1]);
+        const T t1 = sortMax(v[0], v[1]);
+        const T t2 = sortMin(v[2], v[3]);
+        const T t3 = sortMax(v[2], v[3]);
+        const T t4 = sortMin(v[4], v[5]);
+        const T t5 = sortMax(v[4], v[5]);
+        const T t6 = sortMin(v[6], v[7]);
+        const T t7 = sortMax(v[6], v[7]);
+        const T t8 = sortMin(v[8], t0);
+        const T t9 = sortMax(v[8], t0);
+        const T t10 = sortMin(t1, t9);
+        const T t11 = sortMax(t1, t9);
+        const T t12 = sortMin(t2, t4);
+        const T t13 = sortMax(t2, t4);
+        const T t14 = sortMin(t3, t5);
+        const T t15 = sortMax(t3, t5);
+        const T t16 = sortMin(t14, t13);
+        const T t17 = sortMax(t14, t13);
+        const T t18 = sortMin(t6, t8);
+        const T t19 = sortMax(t6, t8);
+        const T t20 = sortMin(t11, t19);
+        const T t21 = sortMax(t11, t19);
+        const T t22 = sortMin(t7, t10);
+        const T t23 = sortMax(t7, t10);
+        const T t24 = sortMin(t22, t20);
+        const T t25 = sortMax(t22, t20);
+        const T t26 = sortMin(t23, t21);
+        const T t27 = sortMax(t23, t21);
+        const T t28 = sortMin(t12, t18);
+        const T t29 = sortMax(t12, t18);
+        const T t30 = sortMin(t27, t29);
+        const T t31 = sortMax(t27, t29);
+        const T t32 = sortMin(t17, t25);
+        const T t33 = sortMax(t17, t25);
+        const T t34 = sortMin(t32, t30);
+        const T t35 = sortMax(t32, t30);
+        const T t36 = sortMin(t33, t31);
+        const T t37 = sortMax(t33, t31);
+        const T t38 = sortMin(t16, t24);
+        const T t39 = sortMax(t16, t24);
+        const T t40 = sortMin(t15, t26);
+        const T t41 = sortMax(t15, t26);
+        const T t42 = sortMin(t40, t39);
+        const T t43 = sortMax(t40, t39);
+        const T t44 = sortMin(t38, t34);
+        const T t45 = sortMax(t38, t34);
+        const T t46 = sortMin(t42, t35);
+        const T t47 = sortMax(t42, t35);
+        const T t48 = sortMin(t43, t36);
+        const T t49 = sortMax(t43, t36);
+        const T t50 = sortMin(t41, t37);
+        const T t51 = sortMax(t41, t37);
+        v[0] = t28;
+        v[1] = t44;
+        v[2] = t45;
+        v[3] = t46;
+        v[4] = t47;
+        v[5] = t48;
+        v[6] = t49;
+        v[7] = t50;
+        v[8] = t51;
+    }
+
+    template<typename T>
+    static void slidingMedians(const T* c, T* out)
+    {
+        const T t0 = sortMin(c[27], c[36]);
+        const T t1 = sortMax(c[27], c[36]);
+        const T t2 = sortMin(c[35], c[44]);
+        const T t3 = sortMax(c[35], c[44]);
+        const T t4 = sortMin(t2, t1);
+        const T t5 = sortMax(t2, t1);
+        const T t6 = sortMin(c[31], c[40]);
+        const T t7 = sortMax(c[31], c[40]);
+        const T t8 = sortMin(t6, t4);
+        const T t9 = sortMax(t6, t4);
+        const T t10 = sortMin(t7, t5);
+        const T t11 = sortMax(t7, t5);
+        const T t12 = sortMin(c[29], c[38]);
+        const T t13 = sortMax(c[29], c[38]);
+        const T t14 = sortMin(c[33], c[42]);
+        const T t15 = sortMax(c[33], c[42]);
+        const T t16 = sortMin(t14, t13);
+        const T t17 = sortMax(t14, t13);
+        const T t18 = sortMin(t12, t8);
+        const T t19 = sortMax(t12, t8);
+        const T t20 = sortMin(t16, t9);
+        const T t21 = sortMax(t16, t9);
+        const T t22 = sortMin(t17, t10);
+        const T t23 = sortMax(t17, t10);
+        const T t24 = sortMin(t15, t11);
+        const T t25 = sortMax(t15, t11);
+        const T t26 = sortMin(c[28], c[37]);
+        const T t27 = sortMax(c[28], c[37]);
+        const T t28 = sortMin(c[32], c[41]);
+        const T t29 = sortMax(c[32], c[41]);
+        const T t30 = sortMin(t28, t27);
+        const T t31 = sortMax(t28, t27);
+        const T t32 = sortMin(c[30], c[39]);
+        const T t33 = sortMax(c[30], c[39]);
+        const T t34 = sortMin(c[34], c[43]);
+        const T t35 = sortMax(c[34], c[43]);
+        const T t36 = sortMin(t34, t33);
+        const T t37 = sortMax(t34, t33);
+        const T t38 = sortMin(t32, t30);
+        const T t39 = sortMax(t32, t30);
+        const T t40 = sortMin(t36, t31);
+        const T t41 = sortMax(t36, t31);
+        const T t42 = sortMin(t37, t29);
+        const T t43 = sortMax(t37, t29);
+        const T t44 = sortMin(t26, t18);
+        const T t45 = sortMax(t26, t18);
+        const T t46 = sortMin(t38, t19);
+        const T t47 = sortMax(t38, t19);
+        const T t48 = sortMin(t39, t20);
+        const T t49 = sortMax(t39, t20);
+        const T t50 = sortMin(t40, t21);
+        const T t51 = sortMax(t40, t21);
+        const T t52 = sortMin(t41, t22);
+        const T t53 = sortMax(t41, t22);
+        const T t54 = sortMin(t42, t23);
+        const T t55 = sortMax(t42, t23);
+        const T t56 = sortMin(t43, t24);
+        const T t57 = sortMax(t43, t24);
+        const T t58 = sortMin(t35, t25);
+        const T t59 = sortMax(t35, t25);
+        const T t60 = sortMin(c[45], c[54]);
+        const T t61 = sortMax(c[45], c[54]);
+        const T t62 = sortMin(c[53], c[62]);
+        const T t63 = sortMax(c[53], c[62]);
+        const T t64 = sortMin(t62, t61);
+        const T t65 = sortMax(t62, t61);
+        const T t66 = sortMin(c[49], c[58]);
+        const T t67 = sortMax(c[49], c[58]);
+        const T t68 = sortMin(t66, t64);
+        const T t69 = sortMax(t66, t64);
+        const T t70 = sortMin(t67, t65);
+        const T t71 = sortMax(t67, t65);
+        const T t72 = sortMin(c[47], c[56]);
+        const T t73 = sortMax(c[47], c[56]);
+        const T t74 = sortMin(c[51], c[60]);
+        const T t75 = sortMax(c[51], c[60]);
+        const T t76 = sortMin(t74, t73);
+        const T t77 = sortMax(t74, t73);
+        const T t78 = sortMin(t72, t68);
+        const T t79 = sortMax(t72, t68);
+        const T t80 = sortMin(t76, t69);
+        const T t81 = sortMax(t76, t69);
+        const T t82 = sortMin(t77, t70);
+        const T t83 = sortMax(t77, t70);
+        const T t84 = sortMin(t75, t71);
+        const T t85 = sortMax(t75, t71);
+        const T t86 = sortMin(c[46], c[55]);
+        const T t87 = sortMax(c[46], c[55]);
+        const T t88 = sortMin(c[50], c[59]);
+        const T t89 = sortMax(c[50], c[59]);
+        const T t90 = sortMin(t88, t87);
+        const T t91 = sortMax(t88, t87);
+        const T t92 = sortMin(c[48], c[57]);
+        const T t93 = sortMax(c[48], c[57]);
+        const T t94 = sortMin(c[52], c[61]);
+        const T t95 = sortMax(c[52], c[61]);
+        const T t96 = sortMin(t94, t93);
+        const T t97 = sortMax(t94, t93);
+        const T t98 = sortMin(t92, t90);
+        const T t99 = sortMax(t92, t90);
+        const T t100 = sortMin(t96, t91);
+        const T t101 = sortMax(t96, t91);
+        const T t102 = sortMin(t97, t89);
+        const T t103 = sortMax(t97, t89);
+        const T t104 = sortMin(t86, t78);
+        const T t105 = sortMax(t86, t78);
+        const T t106 = sortMin(t98, t79);
+        const T t107 = sortMax(t98, t79);
+        const T t108 = sortMin(t99, t80);
+        const T t109 = sortMax(t99, t80);
+        const T t110 = sortMin(t100, t81);
+        const T t111 = sortMax(t100, t81);
+        const T t112 = sortMin(t101, t82);
+        const T t113 = sortMax(t101, t82);
+        const T t114 = sortMin(t102, t83);
+        const T t115 = sortMax(t102, t83);
+        const T t116 = sortMin(t103, t84);
+        const T t117 = sortMax(t103, t84);
+        const T t118 = sortMin(t95, t85);
+        const T t119 = sortMax(t95, t85);
+        const T t120 = sortMin(c[63], c[72]);
+        const T t121 = sortMax(c[63], c[72]);
+        const T t122 = sortMin(c[71], c[80]);
+        const T t123 = sortMax(c[71], c[80]);
+        const T t124 = sortMin(t122, t121);
+        const T t125 = sortMax(t122, t121);
+        const T t126 = sortMin(c[67], c[76]);
+        const T t127 = sortMax(c[67], c[76]);
+        const T t128 = sortMin(t126, t124);
+        const T t129 = sortMax(t126, t124);
+        const T t130 = sortMin(t127, t125);
+        const T t131 = sortMax(t127, t125);
+        const T t132 = sortMin(c[65], c[74]);
+        const T t133 = sortMax(c[65], c[74]);
+        const T t134 = sortMin(c[69], c[78]);
+        const T t135 = sortMax(c[69], c[78]);
+        const T t136 = sortMin(t134, t133);
+        const T t137 = sortMax(t134, t133);
+        const T t138 = sortMin(t132, t128);
+        const T t139 = sortMax(t132, t128);
+        const T t140 = sortMin(t136, t129);
+        const T t141 = sortMax(t136, t129);
+        const T t142 = sortMin(t137, t130);
+        const T t143 = sortMax(t137, t130);
+        const T t144 = sortMin(t135, t131);
+        const T t145 = sortMax(t135, t131);
+        const T t146 = sortMin(c[64], c[73]);
+        const T t147 = sortMax(c[64], c[73]);
+        const T t148 = sortMin(c[68], c[77]);
+        const T t149 = sortMax(c[68], c[77]);
+        const T t150 = sortMin(t148, t147);
+        const T t151 = sortMax(t148, t147);
+        const T t152 = sortMin(c[66], c[75]);
+        const T t153 = sortMax(c[66], c[75]);
+        const T t154 = sortMin(c[70], c[79]);
+        const T t155 = sortMax(c[70], c[79]);
+        const T t156 = sortMin(t154, t153);
+        const T t157 = sortMax(t154, t153);
+        const T t158 = sortMin(t152, t150);
+        const T t159 = sortMax(t152, t150);
+        const T t160 = sortMin(t156, t151);
+        const T t161 = sortMax(t156, t151);
+        const T t162 = sortMin(t157, t149);
+        const T t163 = sortMax(t157, t149);
+        const T t164 = sortMin(t146, t138);
+        const T t165 = sortMax(t146, t138);
+        const T t166 = sortMin(t158, t139);
+        const T t167 = sortMax(t158, t139);
+        const T t168 = sortMin(t159, t140);
+        const T t169 = sortMax(t159, t140);
+        const T t170 = sortMin(t160, t141);
+        const T t171 = sortMax(t160, t141);
+        const T t172 = sortMin(t161, t142);
+        const T t173 = sortMax(t161, t142);
+        const T t174 = sortMin(t162, t143);
+        const T t175 = sortMax(t162, t143);
+        const T t176 = sortMin(t163, t144);
+        const T t177 = sortMax(t163, t144);
+        const T t178 = sortMin(t155, t145);
+        const T t179 = sortMax(t155, t145);
+        const T t180 = sortMin(t0, t60);
+        const T t181 = sortMax(t0, t60);
+        const T t182 = sortMin(t59, t119);
+        const T t183 = sortMax(t59, t119);
+        const T t184 = sortMin(t182, t181);
+        const T t185 = sortMax(t182, t181);
+        const T t186 = sortMin(t51, t111);
+        const T t187 = sortMax(t51, t111);
+        const T t188 = sortMin(t186, t184);
+        const T t189 = sortMax(t186, t184);
+        const T t190 = sortMin(t187, t185);
+        const T t191 = sortMax(t187, t185);
+        const T t192 = sortMin(t47, t107);
+        const T t193 = sortMax(t47, t107);
+        const T t194 = sortMin(t55, t115);
+        const T t195 = sortMax(t55, t115);
+        const T t196 = sortMin(t194, t193);
+        const T t197 = sortMax(t194, t193);
+        const T t198 = sortMin(t192, t188);
+        const T t199 = sortMax(t192, t188);
+        const T t200 = sortMin(t196, t189);
+        const T t201 = sortMax(t196, t189);
+        const T t202 = sortMin(t197, t190);
+        const T t203 = sortMax(t197, t190);
+        const T t204 = sortMin(t195, t191);
+        const T t205 = sortMax(t195, t191);
+        const T t206 = sortMin(t45, t105);
+        const T t207 = sortMax(t45, t105);
+        const T t208 = sortMin(t53, t113);
+        const T t209 = sortMax(t53, t113);
+        const T t210 = sortMin(t208, t207);
+        const T t211 = sortMax(t208, t207);
+        const T t212 = sortMin(t49, t109);
+        const T t213 = sortMax(t49, t109);
+        const T t214 = sortMin(t57, t117);
+        const T t215 = sortMax(t57, t117);
+        const T t216 = sortMin(t214, t213);
+        const T t217 = sortMax(t214, t213);
+        const T t218 = sortMin(t212, t210);
+        const T t219 = sortMax(t212, t210);
+        const T t220 = sortMin(t216, t211);
+        const T t221 = sortMax(t216, t211);
+        const T t222 = sortMin(t217, t209);
+        const T t223 = sortMax(t217, t209);
+        const T t224 = sortMin(t206, t198);
+        const T t225 = sortMax(t206, t198);
+        const T t226 = sortMin(t218, t199);
+        const T t227 = sortMax(t218, t199);
+        const T t228 = sortMin(t219, t200);
+        const T t229 = sortMax(t219, t200);
+        const T t230 = sortMin(t220, t201);
+        const T t231 = sortMax(t220, t201);
+        const T t232 = sortMin(t221, t202);
+        const T t233 = sortMax(t221, t202);
+        const T t234 = sortMin(t222, t203);
+        const T t235 = sortMax(t222, t203);
+        const T t236 = sortMin(t223, t204);
+        const T t237 = sortMax(t223, t204);
+        const T t238 = sortMin(t215, t205);
+        const T t239 = sortMax(t215, t205);
+        const T t240 = sortMin(t44, t104);
+        const T t241 = sortMax(t44, t104);
+        const T t242 = sortMin(t3, t63);
+        const T t243 = sortMax(t3, t63);
+        const T t244 = sortMin(t242, t241);
+        const T t245 = sortMax(t242, t241);
+        const T t246 = sortMin(t52, t112);
+        const T t247 = sortMax(t52, t112);
+        const T t248 = sortMin(t246, t244);
+        const T t249 = sortMax(t246, t244);
+        const T t250 = sortMin(t247, t245);
+        const T t251 = sortMax(t247, t245);
+        const T t252 = sortMin(t48, t108);
+        const T t253 = sortMax(t48, t108);
+        const T t254 = sortMin(t56, t116);
+        const T t255 = sortMax(t56, t116);
+        const T t256 = sortMin(t254, t253);
+        const T t257 = sortMax(t254, t253);
+        const T t258 = sortMin(t252, t248);
+        const T t259 = sortMax(t252, t248);
+        const T t260 = sortMin(t256, t249);
+        const T t261 = sortMax(t256, t249);
+        const T t262 = sortMin(t257, t250);
+        const T t263 = sortMax(t257, t250);
+        const T t264 = sortMin(t255, t251);
+        const T t265 = sortMax(t255, t251);
+        const T t266 = sortMin(t46, t106);
+        const T t267 = sortMax(t46, t106);
+        const T t268 = sortMin(t54, t114);
+        const T t269 = sortMax(t54, t114);
+        const T t270 = sortMin(t268, t267);
+        const T t271 = sortMax(t268, t267);
+        const T t272 = sortMin(t50, t110);
+        const T t273 = sortMax(t50, t110);
+        const T t274 = sortMin(t58, t118);
+        const T t275 = sortMax(t58, t118);
+        const T t276 = sortMin(t274, t273);
+        const T t277 = sortMax(t274, t273);
+        const T t278 = sortMin(t272, t270);
+        const T t279 = sortMax(t272, t270);
+        const T t280 = sortMin(t276, t271);
+        const T t281 = sortMax(t276, t271);
+        const T t282 = sortMin(t277, t269);
+        const T t283 = sortMax(t277, t269);
+        const T t284 = sortMin(t266, t258);
+        const T t285 = sortMax(t266, t258);
+        const T t286 = sortMin(t278, t259);
+        const T t287 = sortMax(t278, t259);
+        const T t288 = sortMin(t279, t260);
+        const T t289 = sortMax(t279, t260);
+        const T t290 = sortMin(t280, t261);
+        const T t291 = sortMax(t280, t261);
+        const T t292 = sortMin(t281, t262);
+        const T t293 = sortMax(t281, t262);
+        const T t294 = sortMin(t282, t263);
+        const T t295 = sortMax(t282, t263);
+        const T t296 = sortMin(t283, t264);
+        const T t297 = sortMax(t283, t264);
+        const T t298 = sortMin(t275, t265);
+        const T t299 = sortMax(t275, t265);
+        const T t300 = sortMin(t240, t224);
+        const T t301 = sortMax(t240, t224);
+        const T t302 = sortMin(t284, t225);
+        const T t303 = sortMax(t284, t225);
+        const T t304 = sortMin(t285, t226);
+        const T t305 = sortMax(t285, t226);
+        const T t306 = sortMin(t286, t227);
+        const T t307 = sortMax(t286, t227);
+        const T t308 = sortMin(t287, t228);
+        const T t309 = sortMax(t287, t228);
+        const T t310 = sortMin(t288, t229);
+        const T t311 = sortMax(t288, t229);
+        const T t312 = sortMin(t289, t230);
+        const T t313 = sortMax(t289, t230);
+        const T t314 = sortMin(t290, t231);
+        const T t315 = sortMax(t290, t231);
+        const T t316 = sortMin(t291, t232);
+        const T t317 = sortMax(t291, t232);
+        const T t318 = sortMin(t292, t233);
+        const T t319 = sortMax(t292, t233);
+        const T t320 = sortMin(t293, t234);
+        const T t321 = sortMax(t293, t234);
+        const T t322 = sortMin(t294, t235);
+        const T t323 = sortMax(t294, t235);
+        const T t324 = sortMin(t295, t236);
+        const T t325 = sortMax(t295, t236);
+        const T t326 = sortMin(t296, t237);
+        const T t327 = sortMax(t296, t237);
+        const T t328 = sortMin(t297, t238);
+        const T t329 = sortMax(t297, t238);
+        const T t330 = sortMin(t298, t239);
+        const T t331 = sortMax(t298, t239);
+        const T t332 = sortMin(t299, t183);
+        const T t333 = sortMax(t299, t183);
+        const T t334 = sortMin(t120, t180);
+        const T t335 = sortMax(t120, t180);
+        const T t336 = sortMin(t331, t335);
+        const T t337 = sortMax(t331, t335);
+        const T t338 = sortMin(t179, t315);
+        const T t339 = sortMax(t179, t315);
+        const T t340 = sortMin(t338, t336);
+        const T t341 = sortMax(t338, t336);
+        const T t342 = sortMin(t339, t337);
+        const T t343 = sortMax(t339, t337);
+        const T t344 = sortMin(t171, t307);
+        const T t345 = sortMax(t171, t307);
+        const T t346 = sortMin(t323, t345);
+        const T t347 = sortMax(t323, t345);
+        const T t348 = sortMin(t344, t340);
+        const T t349 = sortMax(t344, t340);
+        const T t350 = sortMin(t346, t341);
+        const T t351 = sortMax(t346, t341);
+        const T t352 = sortMin(t347, t342);
+        const T t353 = sortMax(t347, t342);
+        const T t354 = sortMin(t167, t303);
+        const T t355 = sortMax(t167, t303);
+        const T t356 = sortMin(t319, t355);
+        const T t357 = sortMax(t319, t355);
+        const T t358 = sortMin(t175, t311);
+        const T t359 = sortMax(t175, t311);
+        const T t360 = sortMin(t327, t359);
+        const T t361 = sortMax(t327, t359);
+        const T t362 = sortMin(t358, t356);
+        const T t363 = sortMax(t358, t356);
+        const T t364 = sortMin(t360, t357);
+        const T t365 = sortMax(t360, t357);
+        const T t366 = sortMin(t354, t348);
+        const T t367 = sortMax(t354, t348);
+        const T t368 = sortMin(t362, t349);
+        const T t369 = sortMax(t362, t349);
+        const T t370 = sortMin(t363, t350);
+        const T t371 = sortMax(t363, t350);
+        const T t372 = sortMin(t364, t351);
+        const T t373 = sortMax(t364, t351);
+        const T t374 = sortMin(t365, t352);
+        const T t375 = sortMax(t365, t352);
+        const T t376 = sortMin(t361, t353);
+        const T t377 = sortMax(t361, t353);
+        const T t378 = sortMin(t165, t301);
+        const T t379 = sortMax(t165, t301);
+        const T t380 = sortMin(t333, t379);
+        const T t381 = sortMax(t333, t379);
+        const T t382 = sortMin(t317, t380);
+        const T t383 = sortMax(t317, t380);
+        const T t384 = sortMin(t173, t309);
+        const T t385 = sortMax(t173, t309);
+        const T t386 = sortMin(t325, t385);
+        const T t387 = sortMax(t325, t385);
+        const T t388 = sortMin(t384, t382);
+        const T t389 = sortMax(t384, t382);
+        const T t390 = sortMin(t386, t383);
+        const T t391 = sortMax(t386, t383);
+        const T t392 = sortMin(t387, t381);
+        const T t393 = sortMax(t387, t381);
+        const T t394 = sortMin(t169, t305);
+        const T t395 = sortMax(t169, t305);
+        const T t396 = sortMin(t321, t395);
+        const T t397 = sortMax(t321, t395);
+        const T t398 = sortMin(t177, t313);
+        const T t399 = sortMax(t177, t313);
+        const T t400 = sortMin(t329, t399);
+        const T t401 = sortMax(t329, t399);
+        const T t402 = sortMin(t398, t396);
+        const T t403 = sortMax(t398, t396);
+        const T t404 = sortMin(t400, t397);
+        const T t405 = sortMax(t400, t397);
+        const T t406 = sortMin(t394, t388);
+        const T t407 = sortMax(t394, t388);
+        const T t408 = sortMin(t402, t389);
+        const T t409 = sortMax(t402, t389);
+        const T t410 = sortMin(t403, t390);
+        const T t411 = sortMax(t403, t390);
+        const T t412 = sortMin(t404, t391);
+        const T t413 = sortMax(t404, t391);
+        const T t414 = sortMin(t405, t392);
+        const T t415 = sortMax(t405, t392);
+        const T t416 = sortMin(t401, t393);
+        const T t417 = sortMax(t401, t393);
+        const T t418 = sortMin(t378, t366);
+        const T t419 = sortMax(t378, t366);
+        const T t420 = sortMin(t406, t367);
+        const T t421 = sortMax(t406, t367);
+        const T t422 = sortMin(t407, t368);
+        const T t423 = sortMax(t407, t368);
+        const T t424 = sortMin(t408, t369);
+        const T t425 = sortMax(t408, t369);
+        const T t426 = sortMin(t409, t370);
+        const T t427 = sortMax(t409, t370);
+        const T t428 = sortMin(t410, t371);
+        const T t429 = sortMax(t410, t371);
+        const T t430 = sortMin(t411, t372);
+        const T t431 = sortMax(t411, t372);
+        const T t432 = sortMin(t412, t373);
+        const T t433 = sortMax(t412, t373);
+        const T t434 = sortMin(t413, t374);
+        const T t435 = sortMax(t413, t374);
+        const T t436 = sortMin(t414, t375);
+        const T t437 = sortMax(t414, t375);
+        const T t438 = sortMin(t415, t376);
+        const T t439 = sortMax(t415, t376);
+        const T t440 = sortMin(t416, t377);
+        const T t441 = sortMax(t416, t377);
+        const T t442 = sortMin(t417, t343);
+        const T t443 = sortMax(t417, t343);
+        const T t444 = sortMin(t164, t300);
+        const T t445 = sortMax(t164, t300);
+        const T t446 = sortMin(t332, t445);
+        const T t447 = sortMax(t332, t445);
+        const T t448 = sortMin(t123, t316);
+        const T t449 = sortMax(t123, t316);
+        const T t450 = sortMin(t448, t446);
+        const T t451 = sortMax(t448, t446);
+        const T t452 = sortMin(t449, t447);
+        const T t453 = sortMax(t449, t447);
+        const T t454 = sortMin(t172, t308);
+        const T t455 = sortMax(t172, t308);
+        const T t456 = sortMin(t324, t455);
+        const T t457 = sortMax(t324, t455);
+        const T t458 = sortMin(t454, t450);
+        const T t459 = sortMax(t454, t450);
+        const T t460 = sortMin(t456, t451);
+        const T t461 = sortMax(t456, t451);
+        const T t462 = sortMin(t457, t452);
+        const T t463 = sortMax(t457, t452);
+        const T t464 = sortMin(t168, t304);
+        const T t465 = sortMax(t168, t304);
+        const T t466 = sortMin(t320, t465);
+        const T t467 = sortMax(t320, t465);
+        const T t468 = sortMin(t176, t312);
+        const T t469 = sortMax(t176, t312);
+        const T t470 = sortMin(t328, t469);
+        const T t471 = sortMax(t328, t469);
+        const T t472 = sortMin(t468, t466);
+        const T t473 = sortMax(t468, t466);
+        const T t474 = sortMin(t470, t467);
+        const T t475 = sortMax(t470, t467);
+        const T t476 = sortMin(t464, t458);
+        const T t477 = sortMax(t464, t458);
+        const T t478 = sortMin(t472, t459);
+        const T t479 = sortMax(t472, t459);
+        const T t480 = sortMin(t473, t460);
+        const T t481 = sortMax(t473, t460);
+        const T t482 = sortMin(t474, t461);
+        const T t483 = sortMax(t474, t461);
+        const T t484 = sortMin(t475, t462);
+        const T t485 = sortMax(t475, t462);
+        const T t486 = sortMin(t471, t463);
+        const T t487 = sortMax(t471, t463);
+        const T t488 = sortMin(t166, t302);
+        const T t489 = sortMax(t166, t302);
+        const T t490 = sortMin(t243, t489);
+        const T t491 = sortMax(t243, t489);
+        const T t492 = sortMin(t318, t490);
+        const T t493 = sortMax(t318, t490);
+        const T t494 = sortMin(t174, t310);
+        const T t495 = sortMax(t174, t310);
+        const T t496 = sortMin(t326, t495);
+        const T t497 = sortMax(t326, t495);
+        const T t498 = sortMin(t494, t492);
+        const T t499 = sortMax(t494, t492);
+        const T t500 = sortMin(t496, t493);
+        const T t501 = sortMax(t496, t493);
+        const T t502 = sortMin(t497, t491);
+        const T t503 = sortMax(t497, t491);
+        const T t504 = sortMin(t170, t306);
+        const T t505 = sortMax(t170, t306);
+        const T t506 = sortMin(t322, t505);
+        const T t507 = sortMax(t322, t505);
+        const T t508 = sortMin(t178, t314);
+        const T t509 = sortMax(t178, t314);
+        const T t510 = sortMin(t330, t509);
+        const T t511 = sortMax(t330, t509);
+        const T t512 = sortMin(t508, t506);
+        const T t513 = sortMax(t508, t506);
+        const T t514 = sortMin(t510, t507);
+        const T t515 = sortMax(t510, t507);
+        const T t516 = sortMin(t504, t498);
+        const T t517 = sortMax(t504, t498);
+        const T t518 = sortMin(t512, t499);
+        const T t519 = sortMax(t512, t499);
+        const T t520 = sortMin(t513, t500);
+        const T t521 = sortMax(t513, t500);
+        const T t522 = sortMin(t514, t501);
+        const T t523 = sortMax(t514, t501);
+        const T t524 = sortMin(t515, t502);
+        const T t525 = sortMax(t515, t502);
+        const T t526 = sortMin(t511, t503);
+        const T t527 = sortMax(t511, t503);
+        const T t528 = sortMin(t488, t476);
+        const T t529 = sortMax(t488, t476);
+        const T t530 = sortMin(t516, t477);
+        const T t531 = sortMax(t516, t477);
+        const T t532 = sortMin(t517, t478);
+        const T t533 = sortMax(t517, t478);
+        const T t534 = sortMin(t518, t479);
+        const T t535 = sortMax(t518, t479);
+        const T t536 = sortMin(t519, t480);
+        const T t537 = sortMax(t519, t480);
+        const T t538 = sortMin(t520, t481);
+        const T t539 = sortMax(t520, t481);
+        const T t540 = sortMin(t521, t482);
+        const T t541 = sortMax(t521, t482);
+        const T t542 = sortMin(t522, t483);
+        const T t543 = sortMax(t522, t483);
+        const T t544 = sortMin(t523, t484);
+        const T t545 = sortMax(t523, t484);
+        const T t546 = sortMin(t524, t485);
+        const T t547 = sortMax(t524, t485);
+        const T t548 = sortMin(t525, t486);
+        const T t549 = sortMax(t525, t486);
+        const T t550 = sortMin(t526, t487);
+        const T t551 = sortMax(t526, t487);
+        const T t552 = sortMin(t527, t453);
+        const T t553 = sortMax(t527, t453);
+        const T t554 = sortMin(t444, t418);
+        const T t555 = sortMax(t444, t418);
+        const T t556 = sortMin(t528, t419);
+        const T t557 = sortMax(t528, t419);
+        const T t558 = sortMin(t529, t420);
+        const T t559 = sortMax(t529, t420);
+        const T t560 = sortMin(t530, t421);
+        const T t561 = sortMax(t530, t421);
+        const T t562 = sortMin(t531, t422);
+        const T t563 = sortMax(t531, t422);
+        const T t564 = sortMin(t532, t423);
+        const T t565 = sortMax(t532, t423);
+        const T t566 = sortMin(t533, t424);
+        const T t567 = sortMax(t533, t424);
+        const T t568 = sortMin(t534, t425);
+        const T t569 = sortMax(t534, t425);
+        const T t570 = sortMin(t535, t426);
+        const T t571 = sortMax(t535, t426);
+        const T t572 = sortMin(t536, t427);
+        const T t573 = sortMax(t536, t427);
+        const T t574 = sortMin(t537, t428);
+        const T t575 = sortMax(t537, t428);
+        const T t576 = sortMin(t538, t429);
+        const T t577 = sortMax(t538, t429);
+        const T t578 = sortMin(t539, t430);
+        const T t579 = sortMax(t539, t430);
+        const T t580 = sortMin(t540, t431);
+        const T t581 = sortMax(t540, t431);
+        const T t582 = sortMin(t541, t432);
+        const T t583 = sortMax(t541, t432);
+        const T t584 = sortMin(t542, t433);
+        const T t585 = sortMax(t542, t433);
+        const T t586 = sortMin(t543, t434);
+        const T t587 = sortMax(t543, t434);
+        const T t588 = sortMin(t544, t435);
+        const T t589 = sortMax(t544, t435);
+        const T t590 = sortMin(t545, t436);
+        const T t591 = sortMax(t545, t436);
+        const T t592 = sortMin(t546, t437);
+        const T t593 = sortMax(t546, t437);
+        const T t594 = sortMin(t547, t438);
+        const T t595 = sortMax(t547, t438);
+        const T t596 = sortMin(t548, t439);
+        const T t597 = sortMax(t548, t439);
+        const T t598 = sortMin(t549, t440);
+        const T t599 = sortMax(t549, t440);
+        const T t600 = sortMin(t550, t441);
+        const T t601 = sortMax(t550, t441);
+        const T t602 = sortMin(t551, t442);
+        const T t603 = sortMax(t551, t442);
+        const T t604 = sortMin(t552, t443);
+        const T t605 = sortMax(t552, t443);
+        const T t606 = sortMin(c[9], c[18]);
+        const T t607 = sortMax(c[9], c[18]);
+        const T t608 = sortMin(c[17], c[26]);
+        const T t609 = sortMax(c[17], c[26]);
+        const T t610 = sortMin(t608, t607);
+        const T t611 = sortMax(t608, t607);
+        const T t612 = sortMin(c[13], c[22]);
+        const T t613 = sortMax(c[13], c[22]);
+        const T t614 = sortMin(t612, t610);
+        const T t615 = sortMax(t612, t610);
+        const T t616 = sortMin(t613, t611);
+        const T t617 = sortMax(t613, t611);
+        const T t618 = sortMin(c[11], c[20]);
+        const T t619 = sortMax(c[11], c[20]);
+        const T t620 = sortMin(c[15], c[24]);
+        const T t621 = sortMax(c[15], c[24]);
+        const T t622 = sortMin(t620, t619);
+        const T t623 = sortMax(t620, t619);
+        const T t624 = sortMin(t618, t614);
+        const T t625 = sortMax(t618, t614);
+        const T t626 = sortMin(t622, t615);
+        const T t627 = sortMax(t622, t615);
+        const T t628 = sortMin(t623, t616);
+        const T t629 = sortMax(t623, t616);
+        const T t630 = sortMin(t621, t617);
+        const T t631 = sortMax(t621, t617);
+        const T t632 = sortMin(c[10], c[19]);
+        const T t633 = sortMax(c[10], c[19]);
+        const T t634 = sortMin(c[14], c[23]);
+        const T t635 = sortMax(c[14], c[23]);
+        const T t636 = sortMin(t634, t633);
+        const T t637 = sortMax(t634, t633);
+        const T t638 = sortMin(c[12], c[21]);
+        const T t639 = sortMax(c[12], c[21]);
+        const T t640 = sortMin(c[16], c[25]);
+        const T t641 = sortMax(c[16], c[25]);
+        const T t642 = sortMin(t640, t639);
+        const T t643 = sortMax(t640, t639);
+        const T t644 = sortMin(t638, t636);
+        const T t645 = sortMax(t638, t636);
+        const T t646 = sortMin(t642, t637);
+        const T t647 = sortMax(t642, t637);
+        const T t648 = sortMin(t643, t635);
+        const T t649 = sortMax(t643, t635);
+        const T t650 = sortMin(t632, t624);
+        const T t651 = sortMax(t632, t624);
+        const T t652 = sortMin(t644, t625);
+        const T t653 = sortMax(t644, t625);
+        const T t654 = sortMin(t645, t626);
+        const T t655 = sortMax(t645, t626);
+        const T t656 = sortMin(t646, t627);
+        const T t657 = sortMax(t646, t627);
+        const T t658 = sortMin(t647, t628);
+        const T t659 = sortMax(t647, t628);
+        const T t660 = sortMin(t648, t629);
+        const T t661 = sortMax(t648, t629);
+        const T t662 = sortMin(t649, t630);
+        const T t663 = sortMax(t649, t630);
+        const T t664 = sortMin(t641, t631);
+        const T t665 = sortMax(t641, t631);
+        const T t666 = sortMin(t606, t334);
+        const T t667 = sortMax(t606, t334);
+        const T t668 = sortMin(t585, t667);
+        const T t669 = sortMax(t585, t667);
+        const T t670 = sortMin(t665, t569);
+        const T t671 = sortMax(t665, t569);
+        const T t672 = sortMin(t601, t671);
+        const T t673 = sortMax(t601, t671);
+        const T t674 = sortMin(t670, t668);
+        const T t675 = sortMax(t670, t668);
+        const T t676 = sortMin(t672, t669);
+        const T t677 = sortMax(t672, t669);
+        const T t678 = sortMin(t657, t561);
+        const T t679 = sortMax(t657, t561);
+        const T t680 = sortMin(t593, t679);
+        const T t681 = sortMax(t593, t679);
+        const T t682 = sortMin(t577, t680);
+        const T t683 = sortMax(t577, t680);
+        const T t684 = sortMin(t678, t674);
+        const T t685 = sortMin(t682, t675);
+        const T t686 = sortMax(t682, t675);
+        const T t687 = sortMin(t683, t676);
+        const T t688 = sortMax(t683, t676);
+        const T t689 = sortMin(t681, t677);
+        const T t690 = sortMax(t681, t677);
+        const T t691 = sortMin(t653, t557);
+        const T t692 = sortMax(t653, t557);
+        const T t693 = sortMin(t589, t692);
+        const T t694 = sortMax(t589, t692);
+        const T t695 = sortMin(t573, t693);
+        const T t696 = sortMax(t573, t693);
+        const T t697 = sortMin(t605, t694);
+        const T t698 = sortMax(t605, t694);
+        const T t699 = sortMin(t661, t565);
+        const T t700 = sortMax(t661, t565);
+        const T t701 = sortMin(t597, t700);
+        const T t702 = sortMax(t597, t700);
+        const T t703 = sortMin(t581, t701);
+        const T t704 = sortMax(t581, t701);
+        const T t705 = sortMax(t699, t695);
+        const T t706 = sortMin(t703, t696);
+        const T t707 = sortMax(t703, t696);
+        const T t708 = sortMin(t704, t697);
+        const T t709 = sortMax(t704, t697);
+        const T t710 = sortMin(t702, t698);
+        const T t711 = sortMax(t702, t698);
+        const T t712 = sortMin(t691, t684);
+        const T t713 = sortMax(t691, t684);
+        const T t714 = sortMin(t705, t685);
+        const T t715 = sortMax(t705, t685);
+        const T t716 = sortMin(t706, t686);
+        const T t717 = sortMax(t706, t686);
+        const T t718 = sortMin(t707, t687);
+        const T t719 = sortMax(t707, t687);
+        const T t720 = sortMin(t708, t688);
+        const T t721 = sortMax(t708, t688);
+        const T t722 = sortMin(t709, t689);
+        const T t723 = sortMax(t710, t690);
+        const T t724 = sortMin(t711, t673);
+        const T t725 = sortMax(t711, t673);
+        const T t726 = sortMin(t651, t555);
+        const T t727 = sortMax(t651, t555);
+        const T t728 = sortMin(t587, t727);
+        const T t729 = sortMax(t587, t727);
+        const T t730 = sortMin(t571, t728);
+        const T t731 = sortMax(t571, t728);
+        const T t732 = sortMin(t603, t729);
+        const T t733 = sortMax(t603, t729);
+        const T t734 = sortMin(t659, t563);
+        const T t735 = sortMax(t659, t563);
+        const T t736 = sortMin(t595, t735);
+        const T t737 = sortMax(t595, t735);
+        const T t738 = sortMin(t579, t736);
+        const T t739 = sortMax(t579, t736);
+        const T t740 = sortMin(t734, t730);
+        const T t741 = sortMax(t734, t730);
+        const T t742 = sortMin(t738, t731);
+        const T t743 = sortMax(t738, t731);
+        const T t744 = sortMin(t739, t732);
+        const T t745 = sortMax(t739, t732);
+        const T t746 = sortMax(t737, t733);
+        const T t747 = sortMin(t655, t559);
+        const T t748 = sortMax(t655, t559);
+        const T t749 = sortMin(t591, t748);
+        const T t750 = sortMax(t591, t748);
+        const T t751 = sortMin(t575, t749);
+        const T t752 = sortMax(t575, t749);
+        const T t753 = sortMin(t663, t567);
+        const T t754 = sortMax(t663, t567);
+        const T t755 = sortMin(t599, t754);
+        const T t756 = sortMax(t599, t754);
+        const T t757 = sortMin(t583, t755);
+        const T t758 = sortMax(t583, t755);
+        const T t759 = sortMin(t753, t751);
+        const T t760 = sortMax(t753, t751);
+        const T t761 = sortMin(t757, t752);
+        const T t762 = sortMax(t757, t752);
+        const T t763 = sortMin(t758, t750);
+        const T t764 = sortMin(t747, t740);
+        const T t765 = sortMax(t759, t741);
+        const T t766 = sortMin(t760, t742);
+        const T t767 = sortMax(t760, t742);
+        const T t768 = sortMin(t761, t743);
+        const T t769 = sortMax(t761, t743);
+        const T t770 = sortMin(t762, t744);
+        const T t771 = sortMax(t762, t744);
+        const T t772 = sortMin(t763, t745);
+        const T t773 = sortMax(t763, t745);
+        const T t774 = sortMin(t756, t746);
+        const T t775 = sortMax(t756, t746);
+        const T t776 = sortMin(t726, t712);
+        const T t777 = sortMax(t726, t712);
+        const T t778 = sortMin(t764, t713);
+        const T t779 = sortMax(t764, t713);
+        const T t780 = sortMax(t765, t714);
+        const T t781 = sortMin(t766, t715);
+        const T t782 = sortMax(t766, t715);
+        const T t783 = sortMax(t767, t716);
+        const T t784 = sortMin(t768, t717);
+        const T t785 = sortMax(t768, t717);
+        const T t786 = sortMin(t769, t718);
+        const T t787 = sortMax(t769, t718);
+        const T t788 = sortMin(t770, t719);
+        const T t789 = sortMax(t770, t719);
+        const T t790 = sortMin(t771, t720);
+        const T t791 = sortMax(t771, t720);
+        const T t792 = sortMax(t772, t721);
+        const T t793 = sortMin(t773, t722);
+        const T t794 = sortMax(t773, t722);
+        const T t795 = sortMax(t774, t723);
+        const T t796 = sortMin(t775, t724);
+        const T t797 = sortMax(t775, t724);
+        const T t798 = sortMin(t650, t554);
+        const T t799 = sortMax(t650, t554);
+        const T t800 = sortMin(t586, t799);
+        const T t801 = sortMax(t586, t799);
+        const T t802 = sortMin(t609, t570);
+        const T t803 = sortMax(t609, t570);
+        const T t804 = sortMin(t602, t803);
+        const T t805 = sortMax(t602, t803);
+        const T t806 = sortMin(t802, t800);
+        const T t807 = sortMax(t802, t800);
+        const T t808 = sortMin(t804, t801);
+        const T t809 = sortMax(t804, t801);
+        const T t810 = sortMin(t658, t562);
+        const T t811 = sortMax(t658, t562);
+        const T t812 = sortMin(t594, t811);
+        const T t813 = sortMax(t594, t811);
+        const T t814 = sortMin(t578, t812);
+        const T t815 = sortMax(t578, t812);
+        const T t816 = sortMin(t810, t806);
+        const T t817 = sortMin(t814, t807);
+        const T t818 = sortMax(t814, t807);
+        const T t819 = sortMin(t815, t808);
+        const T t820 = sortMax(t815, t808);
+        const T t821 = sortMin(t813, t809);
+        const T t822 = sortMax(t813, t809);
+        const T t823 = sortMin(t654, t558);
+        const T t824 = sortMax(t654, t558);
+        const T t825 = sortMin(t590, t824);
+        const T t826 = sortMax(t590, t824);
+        const T t827 = sortMin(t574, t825);
+        const T t828 = sortMax(t574, t825);
+        const T t829 = sortMin(t553, t826);
+        const T t830 = sortMax(t553, t826);
+        const T t831 = sortMin(t662, t566);
+        const T t832 = sortMax(t662, t566);
+        const T t833 = sortMin(t598, t832);
+        const T t834 = sortMax(t598, t832);
+        const T t835 = sortMin(t582, t833);
+        const T t836 = sortMax(t582, t833);
+        const T t837 = sortMax(t831, t827);
+        const T t838 = sortMin(t835, t828);
+        const T t839 = sortMax(t835, t828);
+        const T t840 = sortMin(t836, t829);
+        const T t841 = sortMax(t836, t829);
+        const T t842 = sortMin(t834, t830);
+        const T t843 = sortMax(t834, t830);
+        const T t844 = sortMin(t823, t816);
+        const T t845 = sortMax(t823, t816);
+        const T t846 = sortMin(t837, t817);
+        const T t847 = sortMax(t837, t817);
+        const T t848 = sortMin(t838, t818);
+        const T t849 = sortMax(t838, t818);
+        const T t850 = sortMin(t839, t819);
+        const T t851 = sortMax(t839, t819);
+        const T t852 = sortMin(t840, t820);
+        const T t853 = sortMax(t840, t820);
+        const T t854 = sortMin(t841, t821);
+        const T t855 = sortMax(t842, t822);
+        const T t856 = sortMin(t843, t805);
+        const T t857 = sortMax(t843, t805);
+        const T t858 = sortMin(t652, t556);
+        const T t859 = sortMax(t652, t556);
+        const T t860 = sortMin(t588, t859);
+        const T t861 = sortMax(t588, t859);
+        const T t862 = sortMin(t572, t860);
+        const T t863 = sortMax(t572, t860);
+        const T t864 = sortMin(t604, t861);
+        const T t865 = sortMax(t604, t861);
+        const T t866 = sortMin(t660, t564);
+        const T t867 = sortMax(t660, t564);
+        const T t868 = sortMin(t596, t867);
+        const T t869 = sortMax(t596, t867);
+        const T t870 = sortMin(t580, t868);
+        const T t871 = sortMax(t580, t868);
+        const T t872 = sortMin(t866, t862);
+        const T t873 = sortMax(t866, t862);
+        const T t874 = sortMin(t870, t863);
+        const T t875 = sortMax(t870, t863);
+        const T t876 = sortMin(t871, t864);
+        const T t877 = sortMax(t871, t864);
+        const T t878 = sortMax(t869, t865);
+        const T t879 = sortMin(t656, t560);
+        const T t880 = sortMax(t656, t560);
+        const T t881 = sortMin(t592, t880);
+        const T t882 = sortMax(t592, t880);
+        const T t883 = sortMin(t576, t881);
+        const T t884 = sortMax(t576, t881);
+        const T t885 = sortMin(t664, t568);
+        const T t886 = sortMax(t664, t568);
+        const T t887 = sortMin(t600, t886);
+        const T t888 = sortMax(t600, t886);
+        const T t889 = sortMin(t584, t887);
+        const T t890 = sortMax(t584, t887);
+        const T t891 = sortMin(t885, t883);
+        const T t892 = sortMax(t885, t883);
+        const T t893 = sortMin(t889, t884);
+        const T t894 = sortMax(t889, t884);
+        const T t895 = sortMin(t890, t882);
+        const T t896 = sortMin(t879, t872);
+        const T t897 = sortMax(t891, t873);
+        const T t898 = sortMin(t892, t874);
+        const T t899 = sortMax(t892, t874);
+        const T t900 = sortMin(t893, t875);
+        const T t901 = sortMax(t893, t875);
+        const T t902 = sortMin(t894, t876);
+        const T t903 = sortMax(t894, t876);
+        const T t904 = sortMin(t895, t877);
+        const T t905 = sortMax(t895, t877);
+        const T t906 = sortMin(t888, t878);
+        const T t907 = sortMax(t888, t878);
+        const T t908 = sortMin(t858, t844);
+        const T t909 = sortMax(t858, t844);
+        const T t910 = sortMin(t896, t845);
+        const T t911 = sortMin(t897, t846);
+        const T t912 = sortMax(t897, t846);
+        const T t913 = sortMin(t898, t847);
+        const T t914 = sortMin(t899, t848);
+        const T t915 = sortMax(t899, t848);
+        const T t916 = sortMin(t900, t849);
+        const T t917 = sortMax(t900, t849);
+        const T t918 = sortMin(t901, t850);
+        const T t919 = sortMax(t901, t850);
+        const T t920 = sortMin(t902, t851);
+        const T t921 = sortMax(t902, t851);
+        const T t922 = sortMin(t903, t852);
+        const T t923 = sortMin(t904, t853);
+        const T t924 = sortMax(t904, t853);
+        const T t925 = sortMin(t905, t854);
+        const T t926 = sortMin(t906, t855);
+        const T t927 = sortMax(t906, t855);
+        const T t928 = sortMin(t907, t856);
+        const T t929 = sortMax(t907, t856);
+        const T t930 = sortMin(t798, t776);
+        const T t931 = sortMax(t798, t776);
+        const T t932 = sortMin(t908, t777);
+        const T t933 = sortMax(t908, t777);
+        const T t934 = sortMin(t909, t778);
+        const T t935 = sortMax(t909, t778);
+        const T t936 = sortMin(t910, t779);
+        const T t937 = sortMax(t910, t779);
+        const T t938 = sortMax(t911, t780);
+        const T t939 = sortMin(t912, t781);
+        const T t940 = sortMax(t912, t781);
+        const T t941 = sortMin(t913, t782);
+        const T t942 = sortMax(t913, t782);
+        const T t943 = sortMax(t914, t783);
+        const T t944 = sortMin(t915, t784);
+        const T t945 = sortMax(t915, t784);
+        const T t946 = sortMin(t916, t785);
+        const T t947 = sortMax(t916, t785);
+        const T t948 = sortMin(t917, t786);
+        const T t949 = sortMax(t917, t786);
+        const T t950 = sortMin(t918, t787);
+        const T t951 = sortMax(t918, t787);
+        const T t952 = sortMin(t919, t788);
+        const T t953 = sortMax(t919, t788);
+        const T t954 = sortMin(t920, t789);
+        const T t955 = sortMax(t920, t789);
+        const T t956 = sortMin(t921, t790);
+        const T t957 = sortMax(t921, t790);
+        const T t958 = sortMin(t922, t791);
+        const T t959 = sortMax(t923, t792);
+        const T t960 = sortMin(t924, t793);
+        const T t961 = sortMax(t924, t793);
+        const T t962 = sortMin(t925, t794);
+        const T t963 = sortMax(t926, t795);
+        const T t964 = sortMin(t927, t796);
+        const T t965 = sortMax(t927, t796);
+        const T t966 = sortMin(t928, t797);
+        const T t967 = sortMax(t928, t797);
+        const T t968 = sortMin(t929, t725);
+        const T t969 = sortMax(t929, t725);
+        const T t970 = sortMax(c[0], t666);
+        const T t971 = sortMin(t963, t970);
+        const T t972 = sortMax(t947, t971);
+        const T t973 = sortMin(t959, t972);
+        const T t974 = sortMax(c[8], t937);
+        const T t975 = sortMin(t955, t974);
+        const T t976 = sortMax(t942, t975);
+        const T t977 = sortMin(t976, t973);
+        const T t978 = sortMax(c[4], t933);
+        const T t979 = sortMin(t967, t978);
+        const T t980 = sortMin(t951, t979);
+        const T t981 = sortMax(t938, t980);
+        const T t982 = sortMax(t943, t981);
+        const T t983 = sortMax(t982, t977);
+        const T t984 = sortMax(c[2], t931);
+        const T t985 = sortMin(t965, t984);
+        const T t986 = sortMax(t949, t985);
+        const T t987 = sortMin(t961, t986);
+        const T t988 = sortMin(t957, t987);
+        const T t989 = sortMax(c[6], t935);
+        const T t990 = sortMin(t969, t989);
+        const T t991 = sortMin(t953, t990);
+        const T t992 = sortMax(t940, t991);
+        const T t993 = sortMax(t945, t992);
+        const T t994 = sortMin(t993, t988);
+        const T t995 = sortMax(t994, t983);
+        const T t996 = sortMax(c[1], t930);
+        const T t997 = sortMin(t964, t996);
+        const T t998 = sortMax(t948, t997);
+        const T t999 = sortMin(t960, t998);
+        const T t1000 = sortMin(t956, t999);
+        const T t1001 = sortMax(c[5], t934);
+        const T t1002 = sortMin(t968, t1001);
+        const T t1003 = sortMin(t952, t1002);
+        const T t1004 = sortMax(t939, t1003);
+        const T t1005 = sortMax(t944, t1004);
+        const T t1006 = sortMax(t1005, t1000);
+        const T t1007 = sortMax(c[3], t932);
+        const T t1008 = sortMin(t966, t1007);
+        const T t1009 = sortMax(t950, t1008);
+        const T t1010 = sortMin(t962, t1009);
+        const T t1011 = sortMin(t958, t1010);
+        const T t1012 = sortMax(c[7], t936);
+        const T t1013 = sortMin(t857, t1012);
+        const T t1014 = sortMin(t954, t1013);
+        const T t1015 = sortMax(t941, t1014);
+        const T t1016 = sortMax(t946, t1015);
+        const T t1017 = sortMin(t1016, t1011);
+        const T t1018 = sortMin(t1017, t1006);
+        const T t1019 = sortMax(t1018, t995);
+        const T t1020 = sortMax(c[81], t666);
+        const T t1021 = sortMin(t963, t1020);
+        const T t1022 = sortMax(t947, t1021);
+        const T t1023 = sortMin(t959, t1022);
+        const T t1024 = sortMax(c[89], t937);
+        const T t1025 = sortMin(t955, t1024);
+        const T t1026 = sortMax(t942, t1025);
+        const T t1027 = sortMin(t1026, t1023);
+        const T t1028 = sortMax(c[85], t933);
+        const T t1029 = sortMin(t967, t1028);
+        const T t1030 = sortMin(t951, t1029);
+        const T t1031 = sortMax(t938, t1030);
+        const T t1032 = sortMax(t943, t1031);
+        const T t1033 = sortMax(t1032, t1027);
+        const T t1034 = sortMax(c[83], t931);
+        const T t1035 = sortMin(t965, t1034);
+        const T t1036 = sortMax(t949, t1035);
+        const T t1037 = sortMin(t961, t1036);
+        const T t1038 = sortMin(t957, t1037);
+        const T t1039 = sortMax(c[87], t935);
+        const T t1040 = sortMin(t969, t1039);
+        const T t1041 = sortMin(t953, t1040);
+        const T t1042 = sortMax(t940, t1041);
+        const T t1043 = sortMax(t945, t1042);
+        const T t1044 = sortMin(t1043, t1038);
+        const T t1045 = sortMax(t1044, t1033);
+        const T t1046 = sortMax(c[82], t930);
+        const T t1047 = sortMin(t964, t1046);
+        const T t1048 = sortMax(t948, t1047);
+        const T t1049 = sortMin(t960, t1048);
+        const T t1050 = sortMin(t956, t1049);
+        const T t1051 = sortMax(c[86], t934);
+        const T t1052 = sortMin(t968, t1051);
+        const T t1053 = sortMin(t952, t1052);
+        const T t1054 = sortMax(t939, t1053);
+        const T t1055 = sortMax(t944, t1054);
+        const T t1056 = sortMax(t1055, t1050);
+        const T t1057 = sortMax(c[84], t932);
+        const T t1058 = sortMin(t966, t1057);
+        const T t1059 = sortMax(t950, t1058);
+        const T t1060 = sortMin(t962, t1059);
+        const T t1061 = sortMin(t958, t1060);
+        const T t1062 = sortMax(c[88], t936);
+        const T t1063 = sortMin(t857, t1062);
+        const T t1064 = sortMin(t954, t1063);
+        const T t1065 = sortMax(t941, t1064);
+        const T t1066 = sortMax(t946, t1065);
+        const T t1067 = sortMin(t1066, t1061);
+        const T t1068 = sortMin(t1067, t1056);
+        const T t1069 = sortMax(t1068, t1045);
+        const T t1070 = sortMin(c[81], c[90]);
+        const T t1071 = sortMax(c[81], c[90]);
+        const T t1072 = sortMin(c[89], c[98]);
+        const T t1073 = sortMax(c[89], c[98]);
+        const T t1074 = sortMin(t1072, t1071);
+        const T t1075 = sortMax(t1072, t1071);
+        const T t1076 = sortMin(c[85], c[94]);
+        const T t1077 = sortMax(c[85], c[94]);
+        const T t1078 = sortMin(t1076, t1074);
+        const T t1079 = sortMax(t1076, t1074);
+        const T t1080 = sortMin(t1077, t1075);
+        const T t1081 = sortMax(t1077, t1075);
+        const T t1082 = sortMin(c[83], c[92]);
+        const T t1083 = sortMax(c[83], c[92]);
+        const T t1084 = sortMin(c[87], c[96]);
+        const T t1085 = sortMax(c[87], c[96]);
+        const T t1086 = sortMin(t1084, t1083);
+        const T t1087 = sortMax(t1084, t1083);
+        const T t1088 = sortMin(t1082, t1078);
+        const T t1089 = sortMax(t1082, t1078);
+        const T t1090 = sortMin(t1086, t1079);
+        const T t1091 = sortMax(t1086, t1079);
+        const T t1092 = sortMin(t1087, t1080);
+        const T t1093 = sortMax(t1087, t1080);
+        const T t1094 = sortMin(t1085, t1081);
+        const T t1095 = sortMax(t1085, t1081);
+        const T t1096 = sortMin(c[82], c[91]);
+        const T t1097 = sortMax(c[82], c[91]);
+        const T t1098 = sortMin(c[86], c[95]);
+        const T t1099 = sortMax(c[86], c[95]);
+        const T t1100 = sortMin(t1098, t1097);
+        const T t1101 = sortMax(t1098, t1097);
+        const T t1102 = sortMin(c[84], c[93]);
+        const T t1103 = sortMax(c[84], c[93]);
+        const T t1104 = sortMin(c[88], c[97]);
+        const T t1105 = sortMax(c[88], c[97]);
+        const T t1106 = sortMin(t1104, t1103);
+        const T t1107 = sortMax(t1104, t1103);
+        const T t1108 = sortMin(t1102, t1100);
+        const T t1109 = sortMax(t1102, t1100);
+        const T t1110 = sortMin(t1106, t1101);
+        const T t1111 = sortMax(t1106, t1101);
+        const T t1112 = sortMin(t1107, t1099);
+        const T t1113 = sortMax(t1107, t1099);
+        const T t1114 = sortMin(t1096, t1088);
+        const T t1115 = sortMax(t1096, t1088);
+        const T t1116 = sortMin(t1108, t1089);
+        const T t1117 = sortMax(t1108, t1089);
+        const T t1118 = sortMin(t1109, t1090);
+        const T t1119 = sortMax(t1109, t1090);
+        const T t1120 = sortMin(t1110, t1091);
+        const T t1121 = sortMax(t1110, t1091);
+        const T t1122 = sortMin(t1111, t1092);
+        const T t1123 = sortMax(t1111, t1092);
+        const T t1124 = sortMin(t1112, t1093);
+        const T t1125 = sortMax(t1112, t1093);
+        const T t1126 = sortMin(t1113, t1094);
+        const T t1127 = sortMax(t1113, t1094);
+        const T t1128 = sortMin(t1105, t1095);
+        const T t1129 = sortMax(t1105, t1095);
+        const T t1130 = sortMin(t1070, t334);
+        const T t1131 = sortMax(t1070, t334);
+        const T t1132 = sortMin(t585, t1131);
+        const T t1133 = sortMax(t585, t1131);
+        const T t1134 = sortMin(t1129, t569);
+        const T t1135 = sortMax(t1129, t569);
+        const T t1136 = sortMin(t601, t1135);
+        const T t1137 = sortMax(t601, t1135);
+        const T t1138 = sortMin(t1134, t1132);
+        const T t1139 = sortMax(t1134, t1132);
+        const T t1140 = sortMin(t1136, t1133);
+        const T t1141 = sortMax(t1136, t1133);
+        const T t1142 = sortMin(t1121, t561);
+        const T t1143 = sortMax(t1121, t561);
+        const T t1144 = sortMin(t593, t1143);
+        const T t1145 = sortMax(t593, t1143);
+        const T t1146 = sortMin(t577, t1144);
+        const T t1147 = sortMax(t577, t1144);
+        const T t1148 = sortMin(t1142, t1138);
+        const T t1149 = sortMin(t1146, t1139);
+        const T t1150 = sortMax(t1146, t1139);
+        const T t1151 = sortMin(t1147, t1140);
+        const T t1152 = sortMax(t1147, t1140);
+        const T t1153 = sortMin(t1145, t1141);
+        const T t1154 = sortMax(t1145, t1141);
+        const T t1155 = sortMin(t1117, t557);
+        const T t1156 = sortMax(t1117, t557);
+        const T t1157 = sortMin(t589, t1156);
+        const T t1158 = sortMax(t589, t1156);
+        const T t1159 = sortMin(t573, t1157);
+        const T t1160 = sortMax(t573, t1157);
+        const T t1161 = sortMin(t605, t1158);
+        const T t1162 = sortMax(t605, t1158);
+        const T t1163 = sortMin(t1125, t565);
+        const T t1164 = sortMax(t1125, t565);
+        const T t1165 = sortMin(t597, t1164);
+        const T t1166 = sortMax(t597, t1164);
+        const T t1167 = sortMin(t581, t1165);
+        const T t1168 = sortMax(t581, t1165);
+        const T t1169 = sortMax(t1163, t1159);
+        const T t1170 = sortMin(t1167, t1160);
+        const T t1171 = sortMax(t1167, t1160);
+        const T t1172 = sortMin(t1168, t1161);
+        const T t1173 = sortMax(t1168, t1161);
+        const T t1174 = sortMin(t1166, t1162);
+        const T t1175 = sortMax(t1166, t1162);
+        const T t1176 = sortMin(t1155, t1148);
+        const T t1177 = sortMax(t1155, t1148);
+        const T t1178 = sortMin(t1169, t1149);
+        const T t1179 = sortMax(t1169, t1149);
+        const T t1180 = sortMin(t1170, t1150);
+        const T t1181 = sortMax(t1170, t1150);
+        const T t1182 = sortMin(t1171, t1151);
+        const T t1183 = sortMax(t1171, t1151);
+        const T t1184 = sortMin(t1172, t1152);
+        const T t1185 = sortMax(t1172, t1152);
+        const T t1186 = sortMin(t1173, t1153);
+        const T t1187 = sortMax(t1174, t1154);
+        const T t1188 = sortMin(t1175, t1137);
+        const T t1189 = sortMax(t1175, t1137);
+        const T t1190 = sortMin(t1115, t555);
+        const T t1191 = sortMax(t1115, t555);
+        const T t1192 = sortMin(t587, t1191);
+        const T t1193 = sortMax(t587, t1191);
+        const T t1194 = sortMin(t571, t1192);
+        const T t1195 = sortMax(t571, t1192);
+        const T t1196 = sortMin(t603, t1193);
+        const T t1197 = sortMax(t603, t1193);
+        const T t1198 = sortMin(t1123, t563);
+        const T t1199 = sortMax(t1123, t563);
+        const T t1200 = sortMin(t595, t1199);
+        const T t1201 = sortMax(t595, t1199);
+        const T t1202 = sortMin(t579, t1200);
+        const T t1203 = sortMax(t579, t1200);
+        const T t1204 = sortMin(t1198, t1194);
+        const T t1205 = sortMax(t1198, t1194);
+        const T t1206 = sortMin(t1202, t1195);
+        const T t1207 = sortMax(t1202, t1195);
+        const T t1208 = sortMin(t1203, t1196);
+        const T t1209 = sortMax(t1203, t1196);
+        const T t1210 = sortMax(t1201, t1197);
+        const T t1211 = sortMin(t1119, t559);
+        const T t1212 = sortMax(t1119, t559);
+        const T t1213 = sortMin(t591, t1212);
+        const T t1214 = sortMax(t591, t1212);
+        const T t1215 = sortMin(t575, t1213);
+        const T t1216 = sortMax(t575, t1213);
+        const T t1217 = sortMin(t1127, t567);
+        const T t1218 = sortMax(t1127, t567);
+        const T t1219 = sortMin(t599, t1218);
+        const T t1220 = sortMax(t599, t1218);
+        const T t1221 = sortMin(t583, t1219);
+        const T t1222 = sortMax(t583, t1219);
+        const T t1223 = sortMin(t1217, t1215);
+        const T t1224 = sortMax(t1217, t1215);
+        const T t1225 = sortMin(t1221, t1216);
+        const T t1226 = sortMax(t1221, t1216);
+        const T t1227 = sortMin(t1222, t1214);
+        const T t1228 = sortMin(t1211, t1204);
+        const T t1229 = sortMax(t1223, t1205);
+        const T t1230 = sortMin(t1224, t1206);
+        const T t1231 = sortMax(t1224, t1206);
+        const T t1232 = sortMin(t1225, t1207);
+        const T t1233 = sortMax(t1225, t1207);
+        const T t1234 = sortMin(t1226, t1208);
+        const T t1235 = sortMax(t1226, t1208);
+        const T t1236 = sortMin(t1227, t1209);
+        const T t1237 = sortMax(t1227, t1209);
+        const T t1238 = sortMin(t1220, t1210);
+        const T t1239 = sortMax(t1220, t1210);
+        const T t1240 = sortMin(t1190, t1176);
+        const T t1241 = sortMax(t1190, t1176);
+        const T t1242 = sortMin(t1228, t1177);
+        const T t1243 = sortMax(t1228, t1177);
+        const T t1244 = sortMax(t1229, t1178);
+        const T t1245 = sortMin(t1230, t1179);
+        const T t1246 = sortMax(t1230, t1179);
+        const T t1247 = sortMax(t1231, t1180);
+        const T t1248 = sortMin(t1232, t1181);
+        const T t1249 = sortMax(t1232, t1181);
+        const T t1250 = sortMin(t1233, t1182);
+        const T t1251 = sortMax(t1233, t1182);
+        const T t1252 = sortMin(t1234, t1183);
+        const T t1253 = sortMax(t1234, t1183);
+        const T t1254 = sortMin(t1235, t1184);
+        const T t1255 = sortMax(t1235, t1184);
+        const T t1256 = sortMax(t1236, t1185);
+        const T t1257 = sortMin(t1237, t1186);
+        const T t1258 = sortMax(t1237, t1186);
+        const T t1259 = sortMax(t1238, t1187);
+        const T t1260 = sortMin(t1239, t1188);
+        const T t1261 = sortMax(t1239, t1188);
+        const T t1262 = sortMin(t1114, t554);
+        const T t1263 = sortMax(t1114, t554);
+        const T t1264 = sortMin(t586, t1263);
+        const T t1265 = sortMax(t586, t1263);
+        const T t1266 = sortMin(t1073, t570);
+        const T t1267 = sortMax(t1073, t570);
+        const T t1268 = sortMin(t602, t1267);
+        const T t1269 = sortMax(t602, t1267);
+        const T t1270 = sortMin(t1266, t1264);
+        const T t1271 = sortMax(t1266, t1264);
+        const T t1272 = sortMin(t1268, t1265);
+        const T t1273 = sortMax(t1268, t1265);
+        const T t1274 = sortMin(t1122, t562);
+        const T t1275 = sortMax(t1122, t562);
+        const T t1276 = sortMin(t594, t1275);
+        const T t1277 = sortMax(t594, t1275);
+        const T t1278 = sortMin(t578, t1276);
+        const T t1279 = sortMax(t578, t1276);
+        const T t1280 = sortMin(t1274, t1270);
+        const T t1281 = sortMin(t1278, t1271);
+        const T t1282 = sortMax(t1278, t1271);
+        const T t1283 = sortMin(t1279, t1272);
+        const T t1284 = sortMax(t1279, t1272);
+        const T t1285 = sortMin(t1277, t1273);
+        const T t1286 = sortMax(t1277, t1273);
+        const T t1287 = sortMin(t1118, t558);
+        const T t1288 = sortMax(t1118, t558);
+        const T t1289 = sortMin(t590, t1288);
+        const T t1290 = sortMax(t590, t1288);
+        const T t1291 = sortMin(t574, t1289);
+        const T t1292 = sortMax(t574, t1289);
+        const T t1293 = sortMin(t553, t1290);
+        const T t1294 = sortMax(t553, t1290);
+        const T t1295 = sortMin(t1126, t566);
+        const T t1296 = sortMax(t1126, t566);
+        const T t1297 = sortMin(t598, t1296);
+        const T t1298 = sortMax(t598, t1296);
+        const T t1299 = sortMin(t582, t1297);
+        const T t1300 = sortMax(t582, t1297);
+        const T t1301 = sortMax(t1295, t1291);
+        const T t1302 = sortMin(t1299, t1292);
+        const T t1303 = sortMax(t1299, t1292);
+        const T t1304 = sortMin(t1300, t1293);
+        const T t1305 = sortMax(t1300, t1293);
+        const T t1306 = sortMin(t1298, t1294);
+        const T t1307 = sortMax(t1298, t1294);
+        const T t1308 = sortMin(t1287, t1280);
+        const T t1309 = sortMax(t1287, t1280);
+        const T t1310 = sortMin(t1301, t1281);
+        const T t1311 = sortMax(t1301, t1281);
+        const T t1312 = sortMin(t1302, t1282);
+        const T t1313 = sortMax(t1302, t1282);
+        const T t1314 = sortMin(t1303, t1283);
+        const T t1315 = sortMax(t1303, t1283);
+        const T t1316 = sortMin(t1304, t1284);
+        const T t1317 = sortMax(t1304, t1284);
+        const T t1318 = sortMin(t1305, t1285);
+        const T t1319 = sortMax(t1306, t1286);
+        const T t1320 = sortMin(t1307, t1269);
+        const T t1321 = sortMax(t1307, t1269);
+        const T t1322 = sortMin(t1116, t556);
+        const T t1323 = sortMax(t1116, t556);
+        const T t1324 = sortMin(t588, t1323);
+        const T t1325 = sortMax(t588, t1323);
+        const T t1326 = sortMin(t572, t1324);
+        const T t1327 = sortMax(t572, t1324);
+        const T t1328 = sortMin(t604, t1325);
+        const T t1329 = sortMax(t604, t1325);
+        const T t1330 = sortMin(t1124, t564);
+        const T t1331 = sortMax(t1124, t564);
+        const T t1332 = sortMin(t596, t1331);
+        const T t1333 = sortMax(t596, t1331);
+        const T t1334 = sortMin(t580, t1332);
+        const T t1335 = sortMax(t580, t1332);
+        const T t1336 = sortMin(t1330, t1326);
+        const T t1337 = sortMax(t1330, t1326);
+        const T t1338 = sortMin(t1334, t1327);
+        const T t1339 = sortMax(t1334, t1327);
+        const T t1340 = sortMin(t1335, t1328);
+        const T t1341 = sortMax(t1335, t1328);
+        const T t1342 = sortMax(t1333, t1329);
+        const T t1343 = sortMin(t1120, t560);
+        const T t1344 = sortMax(t1120, t560);
+        const T t1345 = sortMin(t592, t1344);
+        const T t1346 = sortMax(t592, t1344);
+        const T t1347 = sortMin(t576, t1345);
+        const T t1348 = sortMax(t576, t1345);
+        const T t1349 = sortMin(t1128, t568);
+        const T t1350 = sortMax(t1128, t568);
+        const T t1351 = sortMin(t600, t1350);
+        const T t1352 = sortMax(t600, t1350);
+        const T t1353 = sortMin(t584, t1351);
+        const T t1354 = sortMax(t584, t1351);
+        const T t1355 = sortMin(t1349, t1347);
+        const T t1356 = sortMax(t1349, t1347);
+        const T t1357 = sortMin(t1353, t1348);
+        const T t1358 = sortMax(t1353, t1348);
+        const T t1359 = sortMin(t1354, t1346);
+        const T t1360 = sortMin(t1343, t1336);
+        const T t1361 = sortMax(t1355, t1337);
+        const T t1362 = sortMin(t1356, t1338);
+        const T t1363 = sortMax(t1356, t1338);
+        const T t1364 = sortMin(t1357, t1339);
+        const T t1365 = sortMax(t1357, t1339);
+        const T t1366 = sortMin(t1358, t1340);
+        const T t1367 = sortMax(t1358, t1340);
+        const T t1368 = sortMin(t1359, t1341);
+        const T t1369 = sortMax(t1359, t1341);
+        const T t1370 = sortMin(t1352, t1342);
+        const T t1371 = sortMax(t1352, t1342);
+        const T t1372 = sortMin(t1322, t1308);
+        const T t1373 = sortMax(t1322, t1308);
+        const T t1374 = sortMin(t1360, t1309);
+        const T t1375 = sortMin(t1361, t1310);
+        const T t1376 = sortMax(t1361, t1310);
+        const T t1377 = sortMin(t1362, t1311);
+        const T t1378 = sortMin(t1363, t1312);
+        const T t1379 = sortMax(t1363, t1312);
+        const T t1380 = sortMin(t1364, t1313);
+        const T t1381 = sortMax(t1364, t1313);
+        const T t1382 = sortMin(t1365, t1314);
+        const T t1383 = sortMax(t1365, t1314);
+        const T t1384 = sortMin(t1366, t1315);
+        const T t1385 = sortMax(t1366, t1315);
+        const T t1386 = sortMin(t1367, t1316);
+        const T t1387 = sortMin(t1368, t1317);
+        const T t1388 = sortMax(t1368, t1317);
+        const T t1389 = sortMin(t1369, t1318);
+        const T t1390 = sortMin(t1370, t1319);
+        const T t1391 = sortMax(t1370, t1319);
+        const T t1392 = sortMin(t1371, t1320);
+        const T t1393 = sortMax(t1371, t1320);
+        const T t1394 = sortMin(t1262, t1240);
+        const T t1395 = sortMax(t1262, t1240);
+        const T t1396 = sortMin(t1372, t1241);
+        const T t1397 = sortMax(t1372, t1241);
+        const T t1398 = sortMin(t1373, t1242);
+        const T t1399 = sortMax(t1373, t1242);
+        const T t1400 = sortMin(t1374, t1243);
+        const T t1401 = sortMax(t1374, t1243);
+        const T t1402 = sortMax(t1375, t1244);
+        const T t1403 = sortMin(t1376, t1245);
+        const T t1404 = sortMax(t1376, t1245);
+        const T t1405 = sortMin(t1377, t1246);
+        const T t1406 = sortMax(t1377, t1246);
+        const T t1407 = sortMax(t1378, t1247);
+        const T t1408 = sortMin(t1379, t1248);
+        const T t1409 = sortMax(t1379, t1248);
+        const T t1410 = sortMin(t1380, t1249);
+        const T t1411 = sortMax(t1380, t1249);
+        const T t1412 = sortMin(t1381, t1250);
+        const T t1413 = sortMax(t1381, t1250);
+        const T t1414 = sortMin(t1382, t1251);
+        const T t1415 = sortMax(t1382, t1251);
+        const T t1416 = sortMin(t1383, t1252);
+        const T t1417 = sortMax(t1383, t1252);
+        const T t1418 = sortMin(t1384, t1253);
+        const T t1419 = sortMax(t1384, t1253);
+        const T t1420 = sortMin(t1385, t1254);
+        const T t1421 = sortMax(t1385, t1254);
+        const T t1422 = sortMin(t1386, t1255);
+        const T t1423 = sortMax(t1387, t1256);
+        const T t1424 = sortMin(t1388, t1257);
+        const T t1425 = sortMax(t1388, t1257);
+        const T t1426 = sortMin(t1389, t1258);
+        const T t1427 = sortMax(t1390, t1259);
+        const T t1428 = sortMin(t1391, t1260);
+        const T t1429 = sortMax(t1391, t1260);
+        const T t1430 = sortMin(t1392, t1261);
+        const T t1431 = sortMax(t1392, t1261);
+        const T t1432 = sortMin(t1393, t1189);
+        const T t1433 = sortMax(t1393, t1189);
+        const T t1434 = sortMax(c[18], t1130);
+        const T t1435 = sortMin(t1427, t1434);
+        const T t1436 = sortMax(t1411, t1435);
+        const T t1437 = sortMin(t1423, t1436);
+        const T t1438 = sortMax(c[26], t1401);
+        const T t1439 = sortMin(t1419, t1438);
+        const T t1440 = sortMax(t1406, t1439);
+        const T t1441 = sortMin(t1440, t1437);
+        const T t1442 = sortMax(c[22], t1397);
+        const T t1443 = sortMin(t1431, t1442);
+        const T t1444 = sortMin(t1415, t1443);
+        const T t1445 = sortMax(t1402, t1444);
+        const T t1446 = sortMax(t1407, t1445);
+        const T t1447 = sortMax(t1446, t1441);
+        const T t1448 = sortMax(c[20], t1395);
+        const T t1449 = sortMin(t1429, t1448);
+        const T t1450 = sortMax(t1413, t1449);
+        const T t1451 = sortMin(t1425, t1450);
+        const T t1452 = sortMin(t1421, t1451);
+        const T t1453 = sortMax(c[24], t1399);
+        const T t1454 = sortMin(t1433, t1453);
+        const T t1455 = sortMin(t1417, t1454);
+        const T t1456 = sortMax(t1404, t1455);
+        const T t1457 = sortMax(t1409, t1456);
+        const T t1458 = sortMin(t1457, t1452);
+        const T t1459 = sortMax(t1458, t1447);
+        const T t1460 = sortMax(c[19], t1394);
+        const T t1461 = sortMin(t1428, t1460);
+        const T t1462 = sortMax(t1412, t1461);
+        const T t1463 = sortMin(t1424, t1462);
+        const T t1464 = sortMin(t1420, t1463);
+        const T t1465 = sortMax(c[23], t1398);
+        const T t1466 = sortMin(t1432, t1465);
+        const T t1467 = sortMin(t1416, t1466);
+        const T t1468 = sortMax(t1403, t1467);
+        const T t1469 = sortMax(t1408, t1468);
+        const T t1470 = sortMax(t1469, t1464);
+        const T t1471 = sortMax(c[21], t1396);
+        const T t1472 = sortMin(t1430, t1471);
+        const T t1473 = sortMax(t1414, t1472);
+        const T t1474 = sortMin(t1426, t1473);
+        const T t1475 = sortMin(t1422, t1474);
+        const T t1476 = sortMax(c[25], t1400);
+        const T t1477 = sortMin(t1321, t1476);
+        const T t1478 = sortMin(t1418, t1477);
+        const T t1479 = sortMax(t1405, t1478);
+        const T t1480 = sortMax(t1410, t1479);
+        const T t1481 = sortMin(t1480, t1475);
+        const T t1482 = sortMin(t1481, t1470);
+        const T t1483 = sortMax(t1482, t1459);
+        const T t1484 = sortMax(c[99], t1130);
+        const T t1485 = sortMin(t1427, t1484);
+        const T t1486 = sortMax(t1411, t1485);
+        const T t1487 = sortMin(t1423, t1486);
+        const T t1488 = sortMax(c[107], t1401);
+        const T t1489 = sortMin(t1419, t1488);
+        const T t1490 = sortMax(t1406, t1489);
+        const T t1491 = sortMin(t1490, t1487);
+        const T t1492 = sortMax(c[103], t1397);
+        const T t1493 = sortMin(t1431, t1492);
+        const T t1494 = sortMin(t1415, t1493);
+        const T t1495 = sortMax(t1402, t1494);
+        const T t1496 = sortMax(t1407, t1495);
+        const T t1497 = sortMax(t1496, t1491);
+        const T t1498 = sortMax(c[101], t1395);
+        const T t1499 = sortMin(t1429, t1498);
+        const T t1500 = sortMax(t1413, t1499);
+        const T t1501 = sortMin(t1425, t1500);
+        const T t1502 = sortMin(t1421, t1501);
+        const T t1503 = sortMax(c[105], t1399);
+        const T t1504 = sortMin(t1433, t1503);
+        const T t1505 = sortMin(t1417, t1504);
+        const T t1506 = sortMax(t1404, t1505);
+        const T t1507 = sortMax(t1409, t1506);
+        const T t1508 = sortMin(t1507, t1502);
+        const T t1509 = sortMax(t1508, t1497);
+        const T t1510 = sortMax(c[100], t1394);
+        const T t1511 = sortMin(t1428, t1510);
+        const T t1512 = sortMax(t1412, t1511);
+        const T t1513 = sortMin(t1424, t1512);
+        const T t1514 = sortMin(t1420, t1513);
+        const T t1515 = sortMax(c[104], t1398);
+        const T t1516 = sortMin(t1432, t1515);
+        const T t1517 = sortMin(t1416, t1516);
+        const T t1518 = sortMax(t1403, t1517);
+        const T t1519 = sortMax(t1408, t1518);
+        const T t1520 = sortMax(t1519, t1514);
+        const T t1521 = sortMax(c[102], t1396);
+        const T t1522 = sortMin(t1430, t1521);
+        const T t1523 = sortMax(t1414, t1522);
+        const T t1524 = sortMin(t1426, t1523);
+        const T t1525 = sortMin(t1422, t1524);
+        const T t1526 = sortMax(c[106], t1400);
+        const T t1527 = sortMin(t1321, t1526);
+        const T t1528 = sortMin(t1418, t1527);
+        const T t1529 = sortMax(t1405, t1528);
+        const T t1530 = sortMax(t1410, t1529);
+        const T t1531 = sortMin(t1530, t1525);
+        const T t1532 = sortMin(t1531, t1520);
+        const T t1533 = sortMax(t1532, t1509);
+        out[0] = t1019;
+        out[1] = t1069;
+        out[2] = t1483;
+        out[3] = t1533;
+    }
+};
+
+// END GENERATED
+
+// filters the rows row .. row + LINE_VECTOR_SIZE - 1 (as far as they have a full window), columns has to hold (W + WINDOWS - 1) * K LineVectors
+template<int Radius, bool useUpperBound>
+void medianRowGroup(float** src, float** dst, int W, int H, int row, float upperBound, LineVector* columns)
+{
+    constexpr int K = 2 * Radius + 1;
+    constexpr int N = LINE_VECTOR_SIZE;
+    const int rows = std::min(N, H - Radius - row);
+    // missing rows of the last group repeat the last row
+    int outRow[N];
+
+    for (int l = 0; l < N; ++l) {
+        outRow[l] = row + std::min(l, rows - 1);
+    }
+
+    int x = 0;
+
+#ifdef __SSE2__
+
+    for (; x < W - 3; x += 4) {
+        LineVector* const column = columns + x * K;
+
+        for (int r = 0; r < K; ++r) {
+            vfloat v0 = LVFU(src[outRow[0] + r - Radius][x]);
+            vfloat v1 = LVFU(src[outRow[1] + r - Radius][x]);
+            vfloat v2 = LVFU(src[outRow[2] + r - Radius][x]);
+            vfloat v3 = LVFU(src[outRow[3] + r - Radius][x]);
+            _MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+            column[r] = v0;
+            column[K + r] = v1;
+            column[2 * K + r] = v2;
+            column[3 * K + r] = v3;
+        }
+
+        for (int q = 0; q < 4; ++q) {
+            MedianNetwork<K>::sortColumn(column + q * K);
+        }
+    }
+
+    for (; x < W; ++x) {
+        LineVector* const column = columns + x * K;
+
+        for (int r = 0; r < K; ++r) {
+            column[r] = _mm_setr_ps(src[outRow[0] + r - Radius][x], src[outRow[1] + r - Radius][x], src[outRow[2] + r - Radius][x], src[outRow[3] + r - Radius][x]);
+        }
+
+        MedianNetwork<K>::sortColumn(column);
+    }
+
+#else
+
+    for (; x < W; ++x) {
+        LineVector* const column = columns + x * K;
+
+        for (int r = 0; r < K; ++r) {
+            column[r] = src[row + r - Radius][x];
+        }
+
+        MedianNetwork<K>::sortColumn(column);
+    }
+
+#endif
+
+    // the windows of the last network may reach beyond the image, these columns repeat the last column
+    for (; x < W + WINDOWS - 1; ++x) {
+        std::copy_n(columns + (W - 1) * K, K, columns + x * K);
+    }
+
+    const int end = W - Radius; // first column without a full window
+#ifdef __SSE2__
+    const vfloat upperBoundv = F2V(upperBound);
+#endif
+
+    for (int j = Radius; j < end; j += WINDOWS) {
+        LineVector med[WINDOWS];
+        MedianNetwork<K>::slidingMedians(columns + (j - Radius) * K, med);
+#ifdef __SSE2__
+
+        if (rows == N && j + WINDOWS <= end) {
+            _MM_TRANSPOSE4_PS(med[0], med[1], med[2], med[3]);
+
+            for (int l = 0; l < N; ++l) {
+                if (useUpperBound) {
+                    const vfloat valv = LVFU(src[row + l][j]);
+                    STVFU(dst[row + l][j], vself(vmaskf_le(valv, upperBoundv), med[l], valv));
+                } else {
+                    STVFU(dst[row + l][j], med[l]);
+                }
+            }
+
+            continue;
+        }
+
+        float values[WINDOWS][N] ALIGNED16;
+
+        for (int q = 0; q < WINDOWS; ++q) {
+            STVF(values[q][0], med[q]);
+        }
+
+        for (int l = 0; l < rows; ++l) {
+            for (int q = 0; q < std::min(WINDOWS, end - j); ++q) {
+                dst[row + l][j + q] = !useUpperBound || src[row + l][j + q] <= upperBound ? values[q][l] : src[row + l][j + q];
+            }
+        }
+
+#else
+
+        for (int q = 0; q < std::min(WINDOWS, end - j); ++q) {
+            dst[row][j + q] = !useUpperBound || src[row][j + q] <= upperBound ? med[q] : src[row][j + q];
+        }
+
+#endif
+    }
+
+    for (int l = 0; l < rows; ++l) {
+        for (int j = 0; j < std::min(Radius, W); ++j) {
+            dst[row + l][j] = src[row + l][j];
+        }
+
+        for (int j = std::max(end, Radius); j < W; ++j) {
+            dst[row + l][j] = src[row + l][j];
+        }
+    }
+}
+
+template<int Radius, bool useUpperBound>
+void doMedianFilter(float** src, float** dst, float upperBound, int W, int H, int numThreads)
+{
+    constexpr int K = 2 * Radius + 1;
+
+    // rows without a full window
+    for (int row = 0; row < H; ++row) {
+        if (row < Radius || row >= H - Radius) {
+            std::copy_n(src[row], W, dst[row]);
+        }
+    }
+
+#ifdef _OPENMP
+    #pragma omp parallel num_threads(numThreads) if (numThreads > 1)
+#endif
+    {
+        LineVectorBuffer columns((W + WINDOWS - 1) * K);
+
+#ifdef _OPENMP
+        #pragma omp for schedule(dynamic, 4)
+#endif
+
+        for (int row = Radius; row < H - Radius; row += LINE_VECTOR_SIZE) {
+            medianRowGroup<Radius, useUpperBound>(src, dst, W, H, row, upperBound, columns.data);
+        }
+    }
+}
+
+template<bool useUpperBound>
+void doMedianFilter(float** src, float** dst, float upperBound, int W, int H, int radius, int numThreads)
+{
+    switch (radius) {
+        case 1:
+            doMedianFilter<1, useUpperBound>(src, dst, upperBound, W, H, numThreads);
+            break;
+
+        case 2:
+            doMedianFilter<2, useUpperBound>(src, dst, upperBound, W, H, numThreads);
+            break;
+
+        case 3:
+            doMedianFilter<3, useUpperBound>(src, dst, upperBound, W, H, numThreads);
+            break;
+
+        default:
+            doMedianFilter<4, useUpperBound>(src, dst, upperBound, W, H, numThreads);
+    }
+}
+
+}
+
+void medianFilter(float** src, float** dst, int W, int H, int radius, int numThreads)
+{
+    doMedianFilter<false>(src, dst, 0.f, W, H, radius, numThreads);
+}
+
+void medianFilter(float** src, float** dst, float upperBound, int W, int H, int radius, int numThreads)
+{
+    doMedianFilter<true>(src, dst, upperBound, W, H, radius, numThreads);
+}
+
+}
@@ -0,0 +1,36 @@
+/*
+ *  This file is part of RawTherapee.
+ *
+ *  RawTherapee is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RawTherapee is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RawTherapee.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+namespace rtengine
+{
+
+/*
+ * Median of the square (2 * radius + 1) x (2 * radius + 1) window around each pixel, radius 1 to 4.
+ *
+ * The columns of the windows are sorted once and shared by all windows containing them. Four horizontally
+ * adjacent windows are evaluated by one selection network which merges the columns they have in common only
+ * once. With SSE the lanes of a vector hold four rows, so the network runs on 16 pixels at a time.
+ *
+ * Pixels closer than radius to the border are copied. src and dst must be different images of W x H.
+ */
+void medianFilter(float** src, float** dst, int W, int H, int radius, int numThreads);
+
+// same, but only pixels <= upperBound are replaced by the median
+void medianFilter(float** src, float** dst, float upperBound, int W, int H, int radius, int numThreads);
+
+}
@@ -55,6 +55,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "../rtgui/threadutils.h"
 #include "colortemp.h"
 #include "imagefloat.h"
@@ -1671,7 +1671,8 @@ EPDParams::EPDParams() :
     gamma(1.0),
     edgeStopping(1.4),
     scale(1.0),
-    reweightingIterates(0)
+    reweightingIterates(0),
+    legacySolver(false)
 {
 }
 
@@ -1683,7 +1684,8 @@ bool EPDParams::operator ==(const EPDParams& other) const
         && gamma == other.gamma
         && edgeStopping == other.edgeStopping
         && scale == other.scale
-        && reweightingIterates == other.reweightingIterates;
+        && reweightingIterates == other.reweightingIterates
+        && legacySolver == other.legacySolver;
 }
 
 bool EPDParams::operator !=(const EPDParams& other) const
@@ -2528,6 +2530,7 @@ WaveletParams::WaveletParams() :
     resblur(0),
     resblurc(0),
     tmrs(0),
+    tmLegacySolver(false),
     edgs(1.4),
     scale(1.),
     gamma(1),
@@ -2678,6 +2681,7 @@ bool WaveletParams::operator ==(const WaveletParams& other) const
         && resblur == other.resblur
         && resblurc == other.resblurc
         && tmrs == other.tmrs
+        && tmLegacySolver == other.tmLegacySolver
         && edgs == other.edgs
         && scale == other.scale
         && gamma == other.gamma
@@ -3491,6 +3495,7 @@ LocallabParams::LocallabSpot::LocallabSpot() :
     estop(1.4),
     scaltm(1.0),
     rewei(0),
+    legacysolvertm(false),
     satur(0.),
     sensitm(60),
     softradiustm(0.0),
@@ -4489,6 +4494,7 @@ bool LocallabParams::LocallabSpot::operator ==(const LocallabSpot& other) const
         && estop == other.estop
         && scaltm == other.scaltm
         && rewei == other.rewei
+        && legacysolvertm == other.legacysolvertm
         && satur == other.satur
         && sensitm == other.sensitm
         && softradiustm == other.softradiustm
@@ -5716,6 +5722,7 @@ int ProcParams::save(const Glib::ustring& fname, const Glib::ustring& fname2, bo
         saveToKeyfile(!pedited || pedited->epd.edgeStopping, "EPD", "EdgeStopping", epd.edgeStopping, keyFile);
         saveToKeyfile(!pedited || pedited->epd.scale, "EPD", "Scale", epd.scale, keyFile);
         saveToKeyfile(!pedited || pedited->epd.reweightingIterates, "EPD", "ReweightingIterates", epd.reweightingIterates, keyFile);
+        saveToKeyfile(!pedited || pedited->epd.reweightingIterates, "EPD", "LegacySolver", epd.legacySolver, keyFile);
 
 // Fattal
         saveToKeyfile(!pedited || pedited->fattal.enabled, "FattalToneMapping", "Enabled", fattal.enabled, keyFile);
@@ -6130,6 +6137,7 @@ int ProcParams::save(const Glib::ustring& fname, const Glib::ustring& fname2, bo
                     saveToKeyfile(!pedited || spot_edited->estop, "Locallab", "Estop_" + index_str, spot.estop, keyFile);
                     saveToKeyfile(!pedited || spot_edited->scaltm, "Locallab", "Scaltm_" + index_str, spot.scaltm, keyFile);
                     saveToKeyfile(!pedited || spot_edited->rewei, "Locallab", "Rewei_" + index_str, spot.rewei, keyFile);
+                    saveToKeyfile(!pedited || spot_edited->rewei, "Locallab", "Legacysolvertm_" + index_str, spot.legacysolvertm, keyFile);
                     saveToKeyfile(!pedited || spot_edited->satur, "Locallab", "Satur_" + index_str, spot.satur, keyFile);
                     saveToKeyfile(!pedited || spot_edited->sensitm, "Locallab", "Sensitm_" + index_str, spot.sensitm, keyFile);
                     saveToKeyfile(!pedited || spot_edited->softradiustm, "Locallab", "Softradiustm_" + index_str, spot.softradiustm, keyFile);
@@ -6621,6 +6629,7 @@ int ProcParams::save(const Glib::ustring& fname, const Glib::ustring& fname2, bo
         saveToKeyfile(!pedited || pedited->wavelet.resblur, "Wavelet", "Residualblur", wavelet.resblur, keyFile);
         saveToKeyfile(!pedited || pedited->wavelet.resblurc, "Wavelet", "Residualblurc", wavelet.resblurc, keyFile);
         saveToKeyfile(!pedited || pedited->wavelet.tmrs, "Wavelet", "ResidualTM", wavelet.tmrs, keyFile);
+        saveToKeyfile(!pedited || pedited->wavelet.tmrs, "Wavelet", "ResidualTMLegacySolver", wavelet.tmLegacySolver, keyFile);
         saveToKeyfile(!pedited || pedited->wavelet.edgs, "Wavelet", "ResidualEDGS", wavelet.edgs, keyFile);
         saveToKeyfile(!pedited || pedited->wavelet.scale, "Wavelet", "ResidualSCALE", wavelet.scale, keyFile);
         saveToKeyfile(!pedited || pedited->wavelet.gamma, "Wavelet", "Residualgamma", wavelet.gamma, keyFile);
@@ -7414,6 +7423,13 @@ int ProcParams::load(const Glib::ustring& fname, ParamsEdited* pedited)
             assignFromKeyfile(keyFile, "EPD", "EdgeStopping", pedited, epd.edgeStopping, pedited->epd.edgeStopping);
             assignFromKeyfile(keyFile, "EPD", "Scale", pedited, epd.scale, pedited->epd.scale);
             assignFromKeyfile(keyFile, "EPD", "ReweightingIterates", pedited, epd.reweightingIterates, pedited->epd.reweightingIterates);
+
+            if (ppVersion < 350) {
+                // the multigrid solver of version 350 renders differently, keep the old one
+                epd.legacySolver = true;
+            } else if (keyFile.has_key("EPD", "LegacySolver")) {
+                epd.legacySolver = keyFile.get_boolean("EPD", "LegacySolver");
+            }
         }
 
         if (keyFile.has_group("FattalToneMapping")) {
@@ -7998,6 +8014,14 @@ int ProcParams::load(const Glib::ustring& fname, ParamsEdited* pedited)
                 assignFromKeyfile(keyFile, "Locallab", "Estop_" + index_str, pedited, spot.estop, spotEdited.estop);
                 assignFromKeyfile(keyFile, "Locallab", "Scaltm_" + index_str, pedited, spot.scaltm, spotEdited.scaltm);
                 assignFromKeyfile(keyFile, "Locallab", "Rewei_" + index_str, pedited, spot.rewei, spotEdited.rewei);
+
+                if (ppVersion < 350) {
+                    // the multigrid solver of version 350 renders differently, keep the old one
+                    spot.legacysolvertm = true;
+                } else if (keyFile.has_key("Locallab", "Legacysolvertm_" + index_str)) {
+                    spot.legacysolvertm = keyFile.get_boolean("Locallab", "Legacysolvertm_" + index_str);
+                }
+
                 assignFromKeyfile(keyFile, "Locallab", "Satur_" + index_str, pedited, spot.satur, spotEdited.satur);
                 assignFromKeyfile(keyFile, "Locallab", "Sensitm_" + index_str, pedited, spot.sensitm, spotEdited.sensitm);
                 assignFromKeyfile(keyFile, "Locallab", "Softradiustm_" + index_str, pedited, spot.softradiustm, spotEdited.softradiustm);
@@ -8548,6 +8572,14 @@ int ProcParams::load(const Glib::ustring& fname, ParamsEdited* pedited)
             assignFromKeyfile(keyFile, "Wavelet", "Residualblur", pedited, wavelet.resblur, pedited->wavelet.resblur);
             assignFromKeyfile(keyFile, "Wavelet", "Residualblurc", pedited, wavelet.resblurc, pedited->wavelet.resblurc);
             assignFromKeyfile(keyFile, "Wavelet", "ResidualTM", pedited, wavelet.tmrs, pedited->wavelet.tmrs);
+
+            if (ppVersion < 350) {
+                // the multigrid solver of version 350 renders differently, keep the old one
+                wavelet.tmLegacySolver = true;
+            } else if (keyFile.has_key("Wavelet", "ResidualTMLegacySolver")) {
+                wavelet.tmLegacySolver = keyFile.get_boolean("Wavelet", "ResidualTMLegacySolver");
+            }
+
             assignFromKeyfile(keyFile, "Wavelet", "ResidualEDGS", pedited, wavelet.edgs, pedited->wavelet.edgs);
             assignFromKeyfile(keyFile, "Wavelet", "ResidualSCALE", pedited, wavelet.scale, pedited->wavelet.scale);
             assignFromKeyfile(keyFile, "Wavelet", "Residualgamma", pedited, wavelet.gamma, pedited->wavelet.gamma);
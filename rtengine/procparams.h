@@ -788,6 +788,7 @@ struct EPDParams {
     double edgeStopping;
     double scale;
     int    reweightingIterates;
+    bool   legacySolver; // solver of profiles older than version 350, not managed by the GUI
 
     EPDParams();
 
@@ -1297,6 +1298,7 @@ struct LocallabParams {
         double estop;
         double scaltm;
         int rewei;
+        bool legacysolvertm; // solver of profiles older than version 350, not managed by the GUI
         double satur;
         int sensitm;
         double softradiustm;
@@ -1920,6 +1922,7 @@ struct WaveletParams {
     int resblur;
     int resblurc;
     double tmrs;
+    bool tmLegacySolver; // solver of profiles older than version 350, not managed by the GUI
     double edgs;
     double scale;
     double gamma;
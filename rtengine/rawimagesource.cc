@@ -1740,6 +1740,111 @@ void RawImageSource::demosaic(const RAWParams &raw, bool autoContrast, double &c
     }
 }
 
+int RawImageSource::getBinningFactor(const RAWParams &raw, double scale) const
+{
+    // the superpixels have to hold all colours of the CFA: 2x2 for Bayer, 3x3 for X-Trans
+    int factor;
+
+    if (ri->getSensorType() == ST_BAYER) {
+        if (raw.bayersensor.method == RAWParams::BayerSensor::getMethodString(RAWParams::BayerSensor::Method::MONO)
+                || raw.bayersensor.method == RAWParams::BayerSensor::getMethodString(RAWParams::BayerSensor::Method::NONE)
+                || raw.bayersensor.method == RAWParams::BayerSensor::getMethodString(RAWParams::BayerSensor::Method::PIXELSHIFT)) {
+            return 1;
+        }
+
+        factor = 2;
+    } else if (ri->getSensorType() == ST_FUJI_XTRANS) {
+        if (raw.xtranssensor.method == RAWParams::XTransSensor::getMethodString(RAWParams::XTransSensor::Method::MONO)
+                || raw.xtranssensor.method == RAWParams::XTransSensor::getMethodString(RAWParams::XTransSensor::Method::NONE)) {
+            return 1;
+        }
+
+        factor = 3;
+    } else {
+        return 1;
+    }
+
+    // Fuji Super CCD and Nikon D1x don't have a regular pixel grid
+    if (fuji || d1x || ri->get_colors() != 3 || scale <= 0.0 || scale * factor > 1.0) {
+        return 1;
+    }
+
+    // the binned image must not get smaller than the output
+    if (scale * factor * 2 <= 1.0) {
+        factor *= 2;
+    }
+
+    return (W >= factor && H >= factor) ? factor : 1;
+}
+
+void RawImageSource::binnedDemosaic(int factor)
+{
+    MyTime t1, t2;
+    t1.set();
+
+    red(W, H);
+    green(W, H);
+    blue(W, H);
+
+    const bool xtrans = ri->getSensorType() == ST_FUJI_XTRANS;
+    const int blocksW = (W + factor - 1) / factor;
+    const int blocksH = (H + factor - 1) / factor;
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 16)
+#endif
+
+    for (int by = 0; by < blocksH; ++by) {
+        // the last superpixel of a column is moved inwards to stay complete, so that it holds all colours
+        const int rowStart = by * factor;
+        const int rowEnd = std::min(rowStart + factor, H);
+        const int sumRowStart = std::min(rowStart, H - factor);
+
+        for (int bx = 0; bx < blocksW; ++bx) {
+            const int colStart = bx * factor;
+            const int colEnd = std::min(colStart + factor, W);
+            const int sumColStart = std::min(colStart, W - factor);
+
+            float sum[3] = {0.f, 0.f, 0.f};
+            int count[3] = {0, 0, 0};
+
+            for (int i = sumRowStart; i < sumRowStart + factor; ++i) {
+                for (int j = sumColStart; j < sumColStart + factor; ++j) {
+                    const unsigned int c = xtrans ? ri->XTRANSFC(i, j) : FC(i, j);
+                    sum[c] += rawData[i][j];
+                    ++count[c];
+                }
+            }
+
+            const float r = sum[0] / count[0];
+            const float g = sum[1] / count[1];
+            const float b = sum[2] / count[2];
+
+            for (int i = rowStart; i < rowEnd; ++i) {
+                for (int j = colStart; j < colEnd; ++j) {
+                    red[i][j] = r;
+                    green[i][j] = g;
+                    blue[i][j] = b;
+                }
+            }
+        }
+    }
+
+    rgbSourceModified = false;
+
+    delete redCache;
+    redCache = nullptr;
+    delete greenCache;
+    greenCache = nullptr;
+    delete blueCache;
+    blueCache = nullptr;
+
+    t2.set();
+
+    if (settings->verbose) {
+        printf("Binning %s data %dx%d - %d usec\n", xtrans ? "X-Trans" : "Bayer", factor, factor, t2.etime(t1));
+    }
+}
 
 //void RawImageSource::retinexPrepareBuffers(ColorManagementParams cmp, RetinexParams retinexParams, multi_array2D<float, 3> &conversionBuffer, LUTu &lhist16RETI)
 void RawImageSource::retinexPrepareBuffers(const ColorManagementParams& cmp, const RetinexParams &retinexParams, multi_array2D<float, 4> &conversionBuffer, LUTu &lhist16RETI)
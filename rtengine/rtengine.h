@@ -22,6 +22,7 @@
 #include <ctime>
 #include <string>
 #include <memory>
+#include <vector>
 
 #include <glibmm/ustring.h>
 
@@ -655,6 +656,22 @@ int init (const Settings* s, const Glib::ustring& baseDir, const Glib::ustring&
 /** Cleanup the RT engine (static variables) */
 void cleanup ();
 
+/** Persistent per image storage of the auto-matched tone curves, provided by the application (e.g. in its image cache).
+  * Rendering the embedded thumbnail and the raw file to match them is expensive, a stored curve is reused when the image is opened again
+  * or processed in the queue. The key identifies the parameters the curve depends on. */
+class AutoMatchedToneCurveStore
+{
+public:
+    virtual ~AutoMatchedToneCurveStore() = default;
+
+    /** @return true if a curve for fname and key is stored, the curve is returned in curve */
+    virtual bool loadAutoMatchedToneCurve(const Glib::ustring& fname, const Glib::ustring& key, std::vector<double>& curve) = 0;
+    virtual void storeAutoMatchedToneCurve(const Glib::ustring& fname, const Glib::ustring& key, const std::vector<double>& curve) = 0;
+};
+
+/** Sets the store used for the auto-matched tone curves, nullptr (default) if the curves are not stored */
+void setAutoMatchedToneCurveStore (AutoMatchedToneCurveStore* store);
+
 /** This class  holds all the necessary information to accomplish the full processing of the image */
 class ProcessingJob
 {
@@ -695,6 +712,13 @@ public:
    * @return the resulting image, with the output profile applied, exif and iptc data set. You have to save it or you can access the pixel data directly.  */
 IImagefloat* processImage (ProcessingJob* job, int& errorCode, ProgressListener* pl = nullptr, bool flush = false);
 
+/** Same as above, but produces one image per rendition from a single run of the pipeline. Everything up to the output stage is processed once
+   * with the parameters of the job, then resize, post-resize sharpening and the output profile are taken from each rendition.
+   * The fast pipeline of the job is not used, as it resizes at the start of the pipeline.
+   * @param renditions the parameters of the renditions, only resize, prsharpening and the output profile settings are used. If empty, the job's own parameters are used.
+   * @return the resulting images, in the order of renditions. Empty if an error occurred. */
+std::vector<IImagefloat*> processImage (ProcessingJob* job, const std::vector<procparams::ProcParams>& renditions, int& errorCode, ProgressListener* pl = nullptr, bool flush = false);
+
 /** This class is used to control the batch processing. The class implementing this interface will be called when the full processing of an
    * image is ready and the next job to process is needed. */
 class BatchProcessingListener : public ProgressListener
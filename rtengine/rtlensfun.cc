@@ -24,6 +24,7 @@
 #include "procparams.h"
 #include "rtlensfun.h"
 #include "settings.h"
+#include "startuptimer.h"
 
 namespace rtengine
 {
@@ -316,25 +317,39 @@ bool LFLens::hasCACorrection() const
 LFDatabase LFDatabase::instance_;
 
 
-bool LFDatabase::init(const Glib::ustring &dbdir)
+void LFDatabase::init(const Glib::ustring &dbdir)
 {
-    instance_.data_ = lfDatabase::Create();
+    MyMutex::MyLock lock(instance_.lfDBMutex);
+    instance_.dbDir_ = dbdir;
+    instance_.pending_ = true;
+}
+
+
+bool LFDatabase::load()
+{
+    StartupTimer timer("lensfun database", true);
+
+    if (data_) {
+        data_->Destroy();
+    }
+
+    data_ = lfDatabase::Create();
 
     if (settings->verbose) {
         std::cout << "Loading lensfun database from ";
-        if (dbdir.empty()) {
+        if (dbDir_.empty()) {
             std::cout << "the default directories";
         } else {
-            std::cout << "'" << dbdir << "'";
+            std::cout << "'" << dbDir_ << "'";
         }
         std::cout << "..." << std::flush;
     }
 
     bool ok = false;
-    if (dbdir.empty()) {
-        ok = (instance_.data_->Load() ==  LF_NO_ERROR);
+    if (dbDir_.empty()) {
+        ok = (data_->Load() ==  LF_NO_ERROR);
     } else {
-        ok = instance_.LoadDirectory(dbdir.c_str());
+        ok = LoadDirectory(dbDir_.c_str());
     }
 
     if (settings->verbose) {
@@ -348,7 +363,7 @@ bool LFDatabase::init(const Glib::ustring &dbdir)
 bool LFDatabase::LoadDirectory(const char *dirname)
 {
 #if RT_LENSFUN_HAS_LOAD_DIRECTORY
-    return instance_.data_->LoadDirectory(dirname);
+    return data_->LoadDirectory(dirname);
 #else
     // backported from lensfun 0.3.x
     bool database_found = false;
@@ -383,7 +398,8 @@ bool LFDatabase::LoadDirectory(const char *dirname)
 
 
 LFDatabase::LFDatabase():
-    data_(nullptr)
+    data_(nullptr),
+    pending_(false)
 {
 }
 
@@ -399,6 +415,13 @@ LFDatabase::~LFDatabase()
 
 const LFDatabase *LFDatabase::getInstance()
 {
+    if (instance_.pending_) {
+        MyMutex::MyLock lock(instance_.lfDBMutex);
+        if (instance_.pending_) {
+            instance_.load();
+            instance_.pending_ = false;
+        }
+    }
     return &instance_;
 }
 
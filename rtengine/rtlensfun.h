@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <set>
 #include <vector>
@@ -113,7 +114,8 @@ class LFDatabase final :
     public NonCopyable
 {
 public:
-    static bool init(const Glib::ustring &dbdir);
+    // only records dbdir, the database is loaded on the first call of getInstance()
+    static void init(const Glib::ustring &dbdir);
     static const LFDatabase *getInstance();
 
     ~LFDatabase();
@@ -136,11 +138,14 @@ private:
                                             float focalLen, float aperture, float focusDist,
                                             int width, int height, bool swap_xy) const;
     LFDatabase();
+    bool load();
     bool LoadDirectory(const char *dirname);
 
     mutable MyMutex lfDBMutex;
     static LFDatabase instance_;
     lfDatabase *data_;
+    Glib::ustring dbDir_;
+    std::atomic<bool> pending_;
     mutable std::set<std::string> notFound;
 };
 
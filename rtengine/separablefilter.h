@@ -0,0 +1,356 @@
+/*
+ *  This file is part of RawTherapee.
+ *
+ *  RawTherapee is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RawTherapee is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RawTherapee.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "alignedbuffer.h"
+#include "noncopyable.h"
+#include "opthelper.h"
+
+/*
+ * Building blocks for separable filters on row pointer images (float**).
+ *
+ * A kernel filters N independent lines at once, which hides the latency of recursive filters:
+ *     template<class Lines> void filter(Lines lines, int n, LineVector* buffer) const
+ * reads the n input samples of the Lines::N lines with lines.load(j, k), writes the output samples
+ * with lines.store(j, k, value) and may use buffer (n * Lines::N LineVectors) for intermediate
+ * results. A sample must be loaded before the output sample at the same position is stored, as
+ * input and output may be the same memory. With SSE a LineVector holds the samples of four lines
+ * side by side, so a kernel written with the vfloat operators filters 4 * N lines at once, without
+ * SSE it holds the sample of one line.
+ *
+ * The horizontal pass brings groups of rows into an interleaved buffer by 4x4 transposes, so the
+ * kernel reads contiguous memory instead of gathering single floats from several rows. The vertical
+ * pass works on strips of adjacent columns which are read and written directly in the rows. A strip
+ * is at most a cache line wide and narrow enough that the intermediate results of the kernel for
+ * the whole strip fit into the L2 budget.
+ */
+
+namespace rtengine
+{
+
+#ifdef __SSE2__
+using LineVector = vfloat;
+constexpr int LINE_VECTOR_SIZE = 4;
+
+inline LineVector lineVectorSplat(float value)
+{
+    return F2V(value);
+}
+
+inline LineVector lineVectorAbs(LineVector value)
+{
+    return vabsf(value);
+}
+
+inline LineVector lineVectorLoad(const float* p)
+{
+    return LVFU(p[0]);
+}
+
+inline void lineVectorStore(float* p, LineVector value)
+{
+    STVFU(p[0], value);
+}
+#else
+using LineVector = float;
+constexpr int LINE_VECTOR_SIZE = 1;
+
+inline LineVector lineVectorSplat(float value)
+{
+    return value;
+}
+
+inline LineVector lineVectorAbs(LineVector value)
+{
+    return std::fabs(value);
+}
+
+inline LineVector lineVectorLoad(const float* p)
+{
+    return p[0];
+}
+
+inline void lineVectorStore(float* p, LineVector value)
+{
+    p[0] = value;
+}
+#endif
+
+// Aligned buffer of size LineVectors. It holds floats, as the attributes of vfloat would be ignored in the template
+// argument of AlignedBuffer<vfloat> (GCC -Wignored-attributes).
+class LineVectorBuffer final :
+    public NonCopyable
+{
+private:
+    AlignedBuffer<float> buffer;
+
+public:
+    explicit LineVectorBuffer(std::size_t size) :
+        buffer(size * LINE_VECTOR_SIZE),
+        data(reinterpret_cast<LineVector*>(buffer.data))
+    {
+    }
+
+    LineVector* const data;
+};
+
+constexpr std::size_t SEPARABLE_FILTER_L2_BUDGET = 256 * 1024; // bytes of intermediate results per thread
+constexpr int MAX_LINE_VECTORS = 4; // LineVectors per column strip, with SSE one cache line of floats
+constexpr int ROW_LINE_VECTORS = 2; // LineVectors per group of rows
+constexpr int ROW_GROUP_SIZE = ROW_LINE_VECTORS * LINE_VECTOR_SIZE; // rows per group of rows
+
+// Count lines interleaved in a contiguous buffer, filtered in place
+template<int Count>
+class InterleavedLines
+{
+public:
+    static constexpr int N = Count;
+
+    explicit InterleavedLines(LineVector* data) :
+        data(data)
+    {
+    }
+
+    LineVector load(int j, int k) const
+    {
+        return data[j * N + k];
+    }
+
+    void store(int j, int k, LineVector value) const
+    {
+        data[j * N + k] = value;
+    }
+
+private:
+    LineVector* const data;
+};
+
+// Count * LINE_VECTOR_SIZE adjacent columns of row pointer images, starting at column col
+template<int Count>
+class ColumnLines
+{
+public:
+    static constexpr int N = Count;
+
+    ColumnLines(float** src, float** dst, int col) :
+        src(src),
+        dst(dst),
+        col(col)
+    {
+    }
+
+    LineVector load(int j, int k) const
+    {
+        return lineVectorLoad(src[j] + col + k * LINE_VECTOR_SIZE);
+    }
+
+    void store(int j, int k, LineVector value) const
+    {
+        lineVectorStore(dst[j] + col + k * LINE_VECTOR_SIZE, value);
+    }
+
+private:
+    float** const src;
+    float** const dst;
+    const int col;
+};
+
+// number of columns processed together by the vertical pass of an image of height H
+inline int columnStripWidth(int H)
+{
+    const int lineVectors = SEPARABLE_FILTER_L2_BUDGET / (sizeof(LineVector) * std::max(H, 1));
+    return std::max(1, std::min(lineVectors, MAX_LINE_VECTORS)) * LINE_VECTOR_SIZE;
+}
+
+// size of the per thread buffer (number of LineVectors) for the passes over a W x H image
+inline std::size_t separableFilterBufferSize(int W, int H)
+{
+    return std::max<std::size_t>(static_cast<std::size_t>(W) * 2 * ROW_LINE_VECTORS, static_cast<std::size_t>(H) * (columnStripWidth(H) / LINE_VECTOR_SIZE + 2));
+}
+
+// filters rows row .. row + ROW_GROUP_SIZE - 1 (as far as they exist) of src into dst, src may be dst
+template<class Kernel>
+void filterRowGroup(float** src, float** dst, int W, int H, int row, const Kernel& kernel, LineVector* buffer)
+{
+    constexpr int N = ROW_LINE_VECTORS;
+    const int rows = std::min(ROW_GROUP_SIZE, H - row);
+    // missing rows of the last group repeat the last row
+    const float* in[ROW_GROUP_SIZE];
+
+    for (int k = 0; k < ROW_GROUP_SIZE; ++k) {
+        in[k] = src[row + std::min(k, rows - 1)];
+    }
+
+#ifdef __SSE2__
+    int col = 0;
+
+    for (; col < W - 3; col += 4) {
+        for (int k = 0; k < N; ++k) {
+            vfloat v0 = LVFU(in[4 * k][col]);
+            vfloat v1 = LVFU(in[4 * k + 1][col]);
+            vfloat v2 = LVFU(in[4 * k + 2][col]);
+            vfloat v3 = LVFU(in[4 * k + 3][col]);
+            _MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+            buffer[col * N + k] = v0;
+            buffer[(col + 1) * N + k] = v1;
+            buffer[(col + 2) * N + k] = v2;
+            buffer[(col + 3) * N + k] = v3;
+        }
+    }
+
+    for (; col < W; ++col) {
+        for (int k = 0; k < N; ++k) {
+            buffer[col * N + k] = _mm_setr_ps(in[4 * k][col], in[4 * k + 1][col], in[4 * k + 2][col], in[4 * k + 3][col]);
+        }
+    }
+
+    kernel.filter(InterleavedLines<N>(buffer), W, buffer + W * N);
+
+    col = 0;
+
+    if (rows == ROW_GROUP_SIZE) {
+        for (; col < W - 3; col += 4) {
+            for (int k = 0; k < N; ++k) {
+                vfloat v0 = buffer[col * N + k];
+                vfloat v1 = buffer[(col + 1) * N + k];
+                vfloat v2 = buffer[(col + 2) * N + k];
+                vfloat v3 = buffer[(col + 3) * N + k];
+                _MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+                STVFU(dst[row + 4 * k][col], v0);
+                STVFU(dst[row + 4 * k + 1][col], v1);
+                STVFU(dst[row + 4 * k + 2][col], v2);
+                STVFU(dst[row + 4 * k + 3][col], v3);
+            }
+        }
+    }
+
+    for (; col < W; ++col) {
+        float values[ROW_GROUP_SIZE] ALIGNED16;
+
+        for (int k = 0; k < N; ++k) {
+            STVF(values[4 * k], buffer[col * N + k]);
+        }
+
+        for (int k = 0; k < rows; ++k) {
+            dst[row + k][col] = values[k];
+        }
+    }
+
+#else
+
+    for (int col = 0; col < W; ++col) {
+        for (int k = 0; k < N; ++k) {
+            buffer[col * N + k] = in[k][col];
+        }
+    }
+
+    kernel.filter(InterleavedLines<N>(buffer), W, buffer + W * N);
+
+    for (int col = 0; col < W; ++col) {
+        for (int k = 0; k < rows; ++k) {
+            dst[row + k][col] = buffer[col * N + k];
+        }
+    }
+
+#endif
+}
+
+// filters columns col .. col + width - 1 of src into dst, width must not exceed columnStripWidth(H), src may be dst
+template<class Kernel>
+void filterColumnStrip(float** src, float** dst, int H, int col, int width, const Kernel& kernel, LineVector* buffer)
+{
+    const int fullVectors = width / LINE_VECTOR_SIZE;
+
+    switch (fullVectors) {
+        case 0:
+            break;
+
+        case 1:
+            kernel.filter(ColumnLines<1>(src, dst, col), H, buffer);
+            break;
+
+        case 2:
+            kernel.filter(ColumnLines<2>(src, dst, col), H, buffer);
+            break;
+
+        case 3:
+            kernel.filter(ColumnLines<3>(src, dst, col), H, buffer);
+            break;
+
+        default:
+            kernel.filter(ColumnLines<MAX_LINE_VECTORS>(src, dst, col), H, buffer);
+    }
+
+#ifdef __SSE2__
+    const int remaining = width % 4;
+
+    if (remaining > 0) {
+        // the last columns of the image go through a buffer, missing columns repeat the last column
+        const int first = col + 4 * fullVectors;
+
+        for (int row = 0; row < H; ++row) {
+            const float* const in = src[row] + first;
+            buffer[row] = _mm_setr_ps(in[0], in[std::min(1, remaining - 1)], in[std::min(2, remaining - 1)], in[remaining - 1]);
+        }
+
+        kernel.filter(InterleavedLines<1>(buffer), H, buffer + H);
+
+        for (int row = 0; row < H; ++row) {
+            float values[4] ALIGNED16;
+            STVF(values[0], buffer[row]);
+
+            for (int k = 0; k < remaining; ++k) {
+                dst[row][first + k] = values[k];
+            }
+        }
+    }
+#endif
+}
+
+// Horizontal and vertical pass. Both have to be called by all threads of a parallel region (or outside of one),
+// each thread with its own buffer of separableFilterBufferSize(W, H) LineVectors.
+template<class Kernel>
+void filterRows(float** src, float** dst, int W, int H, const Kernel& kernel, LineVector* buffer)
+{
+#ifdef _OPENMP
+    #pragma omp for
+#endif
+
+    for (int row = 0; row < H; row += ROW_GROUP_SIZE) {
+        filterRowGroup(src, dst, W, H, row, kernel, buffer);
+    }
+}
+
+template<class Kernel>
+void filterColumns(float** src, float** dst, int W, int H, const Kernel& kernel, LineVector* buffer)
+{
+    const int stripWidth = columnStripWidth(H);
+
+#ifdef _OPENMP
+    #pragma omp for
+#endif
+
+    for (int col = 0; col < W; col += stripWidth) {
+        filterColumnStrip(src, dst, H, col, std::min(stripWidth, W - col), kernel, buffer);
+    }
+}
+
+}
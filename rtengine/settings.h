@@ -112,6 +112,14 @@ public:
     };
     ThumbnailInspectorMode thumbnail_inspector_mode;
 
+    bool            compactLUTs;            // use cache-resident compact copies of the per-pixel tone curve LUTs (see compactlut.h)
+    int             denoiseMemoryBudget;    // memory in MiB RGB_denoise plans its tiles for, 0 = whole image first, tiles if that runs out of memory
+    bool            jpegParallelBands;      // encode large JPEG files in parallel bands, with the standard instead of optimized Huffman tables
+    int             locallabMaskCacheSize;  // memory in MiB each editor may keep the masks of the Local Adjustments tools in, 0 = no cache
+    int             maxThreads;             // cap of the threads of the engine (TaskPool workers and OpenMP regions), 0 = number of cores
+    bool            perspectivePyramid;     // automatic perspective correction detects lines on a reduced image and refines them on the full one
+    int             tiffTileSize;           // tile size of the saved TIFF files in pixels (rounded up to a multiple of 16), 0 = strips
+
     /** Creates a new instance of Settings.
       * @return a pointer to the new Settings instance. */
     static Settings* create();
@@ -37,6 +37,8 @@
 #include "mytime.h"
 #include "guidedfilter.h"
 #include "color.h"
+#include "colorspacetrace.h"
+#include "taskpool.h"
 
 #undef THREAD_PRIORITY_NORMAL
 
@@ -72,6 +74,8 @@ public:
         imgsrc(nullptr),
         fw(0),
         fh(0),
+        binning(1),
+        allowBinning(false),
         tr(0),
         pp(0, 0, 0, 0, 0),
         calclum(nullptr),
@@ -97,6 +101,7 @@ public:
         hlcomprthresh(0),
         baseImg(nullptr),
         labView(nullptr),
+        csTrace("output"),
         ctColorCurve(),
         autili(false),
         butili(false)
@@ -112,6 +117,39 @@ public:
         }
     }
 
+    // one image per rendition, the pipeline runs once and branches at the output stage
+    std::vector<IImagefloat*> operator()(const std::vector<procparams::ProcParams>& renditions)
+    {
+        std::vector<IImagefloat*> result;
+
+        // the fast pipeline resizes early, there is only one size then
+        if (!stage_init()) {
+            return result;
+        }
+
+        stage_denoise();
+        stage_transform();
+        stage_finish_lab();
+
+        for (size_t i = 0; i < renditions.size(); ++i) {
+            procparams::ProcParams params = job->pparams;
+            params.resize = renditions[i].resize;
+            params.prsharpening = renditions[i].prsharpening;
+            params.icm.outputProfile = renditions[i].icm.outputProfile;
+            params.icm.outputIntent = renditions[i].icm.outputIntent;
+            params.icm.outputBPC = renditions[i].icm.outputBPC;
+            ImProcFunctions ipf(&params, true);
+
+            // the last rendition takes over labView, the others work on a copy
+            LabImage *lab = i + 1 < renditions.size() ? new LabImage(*labView, true) : labView;
+            result.push_back(stage_output(params, ipf, lab));
+        }
+
+        labView = nullptr;
+        stage_release();
+        return result;
+    }
+
 private:
     Imagefloat *normal_pipeline()
     {
@@ -131,6 +169,7 @@ private:
         }
 
         pl = nullptr;
+        allowBinning = true;
 
         if (!stage_init()) {
             return nullptr;
@@ -226,9 +265,19 @@ private:
         bool autoContrast = imgsrc->getSensorType() == ST_BAYER ? params.raw.bayersensor.dualDemosaicAutoContrast : params.raw.xtranssensor.dualDemosaicAutoContrast;
         double contrastThreshold = imgsrc->getSensorType() == ST_BAYER ? params.raw.bayersensor.dualDemosaicContrast : params.raw.xtranssensor.dualDemosaicContrast;
 
-        imgsrc->demosaic (params.raw, autoContrast, contrastThreshold, params.pdsharpening.enabled && pl);
-        if (params.pdsharpening.enabled) {
-            imgsrc->captureSharpening(params.pdsharpening, false, params.pdsharpening.contrast, params.pdsharpening.deconvradius);
+        if (allowBinning) {
+            // small proxies of large raws: bin the raw data instead of demosaicing the full sensor
+            int imw, imh;
+            binning = imgsrc->getBinningFactor(params.raw, ipf.resizeScale(&params, fw, fh, imw, imh));
+        }
+
+        if (binning > 1) {
+            imgsrc->binnedDemosaic(binning);
+        } else {
+            imgsrc->demosaic (params.raw, autoContrast, contrastThreshold, params.pdsharpening.enabled && pl);
+            if (params.pdsharpening.enabled) {
+                imgsrc->captureSharpening(params.pdsharpening, false, params.pdsharpening.contrast, params.pdsharpening.deconvradius);
+            }
         }
 
 
@@ -751,6 +800,22 @@ private:
             //end evaluate noise
         }
 
+        if (binning > 1) {
+            // from here on the pipeline works on the binned image, like the preview at a scale of 1:binning
+            pp = PreviewProps(0, 0, fw, fh, binning);
+            imgsrc->getSize(pp, fw, fh);
+            ipf.setScale(binning);
+
+            params.crop.x /= binning;
+            params.crop.y /= binning;
+            params.crop.w = LIM(params.crop.w / binning, 1, fw - params.crop.x);
+            params.crop.h = LIM(params.crop.h / binning, 1, fh - params.crop.y);
+
+            if (params.resize.dataspec == 0) {
+                params.resize.scale *= binning;
+            }
+        }
+
         baseImg = new Imagefloat(fw, fh);
         imgsrc->getImage(currWB, tr, baseImg, pp, params.toneCurve, params.raw);
 
@@ -910,18 +975,33 @@ private:
     }
 
     Imagefloat *stage_finish()
+    {
+        stage_finish_lab();
+        Imagefloat *readyImg = stage_output(job->pparams, *ipf_p, labView);
+        labView = nullptr;
+        stage_release();
+        return readyImg;
+    }
+
+    // everything up to the output stage, the result is in labView
+    void stage_finish_lab()
     {
         procparams::ProcParams& params = job->pparams;
         //ImProcFunctions ipf (&params, true);
         ImProcFunctions &ipf = * (ipf_p.get());
 
-        if (params.dirpyrequalizer.cbdlMethod == "bef" && params.dirpyrequalizer.enabled && !params.colorappearance.enabled) {
+        const ColorSpacePlan csPlan(
+            params.dirpyrequalizer.cbdlMethod == "bef" && params.dirpyrequalizer.enabled && !params.colorappearance.enabled,
+            params.locallab.enabled && params.locallab.spots.size() > 0
+        );
+
+        if (csPlan.cbdlStandalone()) {
             const int W = baseImg->getWidth();
             const int H = baseImg->getHeight();
             LabImage labcbdl(W, H);
-            ipf.rgb2lab(*baseImg, labcbdl, params.icm.workingProfile);
+            csTrace.rgb2lab(ipf, *baseImg, labcbdl, params.icm.workingProfile, "cbdl");
             ipf.dirpyrequalizer(&labcbdl, 1);
-            ipf.lab2rgb(labcbdl, *baseImg, params.icm.workingProfile);
+            csTrace.lab2rgb(ipf, labcbdl, *baseImg, params.icm.workingProfile, "cbdl");
         }
 
 /*        //gamma TRC working
@@ -944,7 +1024,14 @@ private:
         labView = new LabImage(fw, fh);
 
         if (params.locallab.enabled && params.locallab.spots.size() > 0) {
-            ipf.rgb2lab(*baseImg, *labView, params.icm.workingProfile);
+            csTrace.rgb2lab(ipf, *baseImg, *labView, params.icm.workingProfile, "locallab");
+
+            if (csPlan.cbdlInLocallab()) {
+                // the image is in Lab already, no need to convert back and forth for CBDL
+                ipf.dirpyrequalizer(labView, 1);
+                csTrace.elided(ColorSpaceTrace::Space::LAB, ColorSpaceTrace::Space::RGB, "cbdl", fw, fh);
+                csTrace.elided(ColorSpaceTrace::Space::RGB, ColorSpaceTrace::Space::LAB, "cbdl", fw, fh);
+            }
             
             MyTime t1, t2;
             t1.set();
@@ -1197,7 +1284,7 @@ private:
             }
 
             t2.set();
-            ipf.lab2rgb(*labView, *baseImg, params.icm.workingProfile);
+            csTrace.lab2rgb(ipf, *labView, *baseImg, params.icm.workingProfile, "locallab");
 
             if (settings->verbose) {
                 printf("Total local:- %d usec\n", t2.etime(t1));
@@ -1278,6 +1365,7 @@ private:
         LUTu histToneCurve;
 
         ipf.rgbProc(baseImg, labView, nullptr, curve1, curve2, curve, params.toneCurve.saturation, rCurve, gCurve, bCurve, satLimit, satLimitOpacity, ctColorCurve, ctOpacityCurve, opautili, clToningcurve, cl2Toningcurve, customToneCurve1, customToneCurve2, customToneCurvebw1, customToneCurvebw2, rrm, ggm, bbm, autor, autog, autob, expcomp, hlcompr, hlcomprthresh, dcpProf, as, histToneCurve, options.chunkSizeRGB, options.measure);
+        csTrace.converted(ColorSpaceTrace::Space::RGB, ColorSpaceTrace::Space::LAB, "rgbProc", fw, fh);
 
         if (settings->verbose) {
             printf ("Output image / Auto B&W coefs:   R=%.2f   G=%.2f   B=%.2f\n", static_cast<double>(autor), static_cast<double>(autog), static_cast<double>(autob));
@@ -1616,14 +1704,18 @@ private:
         if (pl) {
             pl->setProgress(0.60);
         }
+    }
 
+    // resize, post-resize sharpening and conversion to the output profile, takes over lab
+    Imagefloat *stage_output(const procparams::ProcParams& params, ImProcFunctions& ipf, LabImage* lab)
+    {
         int imw, imh;
         double tmpScale = ipf.resizeScale(&params, fw, fh, imw, imh);
         bool labResize = params.resize.enabled && params.resize.method != "Nearest" && (tmpScale != 1.0 || params.prsharpening.enabled);
         LabImage *tmplab;
 
         // crop and convert to rgb16
-        int cx = 0, cy = 0, cw = labView->W, ch = labView->H;
+        int cx = 0, cy = 0, cw = lab->W, ch = lab->H;
 
         if (params.crop.enabled) {
             cx = params.crop.x;
@@ -1636,40 +1728,40 @@ private:
 
                 for (int row = 0; row < ch; row++) {
                     for (int col = 0; col < cw; col++) {
-                        tmplab->L[row][col] = labView->L[row + cy][col + cx];
-                        tmplab->a[row][col] = labView->a[row + cy][col + cx];
-                        tmplab->b[row][col] = labView->b[row + cy][col + cx];
+                        tmplab->L[row][col] = lab->L[row + cy][col + cx];
+                        tmplab->a[row][col] = lab->a[row + cy][col + cx];
+                        tmplab->b[row][col] = lab->b[row + cy][col + cx];
                     }
                 }
 
-                delete labView;
-                labView = tmplab;
+                delete lab;
+                lab = tmplab;
                 cx = 0;
                 cy = 0;
             }
         }
 
         if (labResize) { // resize lab data
-            if ((labView->W != imw || labView->H != imh) &&
-                    (params.resize.allowUpscaling || (labView->W >= imw && labView->H >= imh))) {
+            if ((lab->W != imw || lab->H != imh) &&
+                    (params.resize.allowUpscaling || (lab->W >= imw && lab->H >= imh))) {
                 // resize image
                 tmplab = new LabImage(imw, imh);
-                ipf.Lanczos(labView, tmplab, tmpScale);
-                delete labView;
-                labView = tmplab;
+                ipf.Lanczos(lab, tmplab, tmpScale);
+                delete lab;
+                lab = tmplab;
             }
 
-            cw = labView->W;
-            ch = labView->H;
+            cw = lab->W;
+            ch = lab->H;
 
             if (params.prsharpening.enabled) {
                 for (int i = 0; i < ch; i++) {
                     for (int j = 0; j < cw; j++) {
-                        labView->L[i][j] = labView->L[i][j] < 0.f ? 0.f : labView->L[i][j];
+                        lab->L[i][j] = lab->L[i][j] < 0.f ? 0.f : lab->L[i][j];
                     }
                 }
 
-                ipf.sharpening(labView, params.prsharpening);
+                ipf.sharpening(lab, params.prsharpening);
             }
         }
 
@@ -1681,14 +1773,15 @@ private:
         // if Default gamma mode: we use the profile selected in the "Output profile" combobox;
         // gamma come from the selected profile, otherwise it comes from "Free gamma" tool
 
-        Imagefloat* readyImg = ipf.lab2rgbOut(labView, cx, cy, cw, ch, params.icm);
+        Imagefloat* readyImg = ipf.lab2rgbOut(lab, cx, cy, cw, ch, params.icm);
+        csTrace.converted(ColorSpaceTrace::Space::LAB, ColorSpaceTrace::Space::RGB, "output", cw, ch);
 
         if (settings->verbose) {
             printf("Output profile_: \"%s\"\n", params.icm.outputProfile.c_str());
         }
 
-        delete labView;
-        labView = nullptr;
+        delete lab;
+        lab = nullptr;
 
         if (bwonly) { //force BW r=g=b
             if (settings->verbose) {
@@ -1758,9 +1851,12 @@ private:
             readyImg->setOutputProfile(nullptr, 0);
         }
 
-//    t2.set();
-//    if( settings->verbose )
-//           printf("Total:- %d usec\n", t2.etime(t1));
+        return readyImg;
+    }
+
+    void stage_release()
+    {
+        csTrace.print();
 
         if (!job->initialImage) {
             initialImage->decreaseRef();
@@ -1771,19 +1867,6 @@ private:
         if (pl) {
             pl->setProgress(0.75);
         }
-
-        /*  curve1.reset();curve2.reset();
-            curve.reset();
-            satcurve.reset();
-            lhskcurve.reset();
-
-            rCurve.reset();
-            gCurve.reset();
-            bCurve.reset();
-            hist16.reset();
-            hist16C.reset();
-        */
-        return readyImg;
     }
 
     void stage_early_resize()
@@ -1826,7 +1909,9 @@ private:
             tmplab = std::move(resized);
         }
 
-        adjust_procparams(scale_factor);
+        // the parameters still refer to the full sensor resolution
+        adjust_procparams(scale_factor / binning);
+        ipf.setScale(1.0);
 
         fw = imw;
         fh = imh;
@@ -1931,6 +2016,8 @@ private:
     ImageSource *imgsrc;
     int fw;
     int fh;
+    int binning; // > 1 if the raw data was binned into superpixels of binning x binning instead of demosaiced
+    bool allowBinning;
 
     int tr;
     PreviewProps pp;
@@ -1964,6 +2051,7 @@ private:
     ColorTemp currWB;
     Imagefloat *baseImg;
     LabImage* labView;
+    ColorSpaceTrace csTrace;
 
     LUTu hist16;
 
@@ -2002,8 +2090,20 @@ IImagefloat* processImage(ProcessingJob* pjob, int& errorCode, ProgressListener*
     return proc();
 }
 
+std::vector<IImagefloat*> processImage(ProcessingJob* pjob, const std::vector<procparams::ProcParams>& renditions, int& errorCode, ProgressListener* pl, bool flush)
+{
+    if (renditions.empty()) {
+        IImagefloat* img = processImage(pjob, errorCode, pl, flush);
+        return img ? std::vector<IImagefloat*>{img} : std::vector<IImagefloat*>();
+    }
+
+    ImageProcessor proc(pjob, errorCode, pl, flush);
+    return proc(renditions);
+}
+
 void batchProcessingThread(ProcessingJob* job, BatchProcessingListener* bpl)
 {
+    TaskPool::applyThreadLimit();
 
     ProcessingJob* currentJob = job;
 
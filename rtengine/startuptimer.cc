@@ -0,0 +1,62 @@
+/*
+ *  This file is part of RawTherapee.
+ *
+ *  RawTherapee is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RawTherapee is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RawTherapee.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "startuptimer.h"
+
+#include "../rtgui/threadutils.h"
+
+namespace
+{
+
+MyMutex& entriesMutex()
+{
+    static MyMutex mutex;
+    return mutex;
+}
+
+std::vector<rtengine::StartupTimer::Entry>& entries()
+{
+    static std::vector<rtengine::StartupTimer::Entry> list;
+    return list;
+}
+
+}
+
+namespace rtengine
+{
+
+StartupTimer::StartupTimer(const char* subsystem, bool lazy) :
+    subsystem(subsystem),
+    lazy(lazy),
+    start(std::chrono::steady_clock::now())
+{
+}
+
+StartupTimer::~StartupTimer()
+{
+    const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    MyMutex::MyLock lock(entriesMutex());
+    entries().push_back({subsystem, milliseconds, lazy});
+}
+
+std::vector<StartupTimer::Entry> StartupTimer::getEntries()
+{
+    MyMutex::MyLock lock(entriesMutex());
+    return entries();
+}
+
+}
@@ -0,0 +1,57 @@
+/*
+ *  This file is part of RawTherapee.
+ *
+ *  RawTherapee is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RawTherapee is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RawTherapee.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "noncopyable.h"
+
+namespace rtengine
+{
+
+/*
+ * Measures the time spent initializing an engine subsystem, from construction to destruction.
+ *
+ * Subsystems which are loaded in rtengine::init() are timed as eager, those which are
+ * deferred until their first use (lens database, camera constants, dark frames, ...) as lazy.
+ * The collected entries are printed by the command line interface with --startup-report.
+ */
+class StartupTimer :
+    public NonCopyable
+{
+public:
+    struct Entry {
+        std::string subsystem;
+        double milliseconds;
+        bool lazy;
+    };
+
+    explicit StartupTimer(const char* subsystem, bool lazy = false);
+    ~StartupTimer();
+
+    // entries in order of completion
+    static std::vector<Entry> getEntries();
+
+private:
+    const char* const subsystem;
+    const bool lazy;
+    const std::chrono::steady_clock::time_point start;
+};
+
+}
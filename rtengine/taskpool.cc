@@ -0,0 +1,137 @@
+/*
+ *  This file is part of RawTherapee.
+ *
+ *  RawTherapee is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RawTherapee is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RawTherapee.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "taskpool.h"
+#include "settings.h"
+
+namespace rtengine
+{
+
+extern const Settings* settings;
+
+TaskPool& TaskPool::getInstance()
+{
+    static TaskPool instance;
+    return instance;
+}
+
+int TaskPool::getThreadLimit()
+{
+    if (settings && settings->maxThreads > 0) {
+        return settings->maxThreads;
+    }
+
+#ifdef _OPENMP
+    return omp_get_num_procs();
+#else
+    return std::max(1u, std::thread::hardware_concurrency());
+#endif
+}
+
+void TaskPool::applyThreadLimit()
+{
+#ifdef _OPENMP
+
+    if (settings && settings->maxThreads > 0) {
+        omp_set_num_threads(settings->maxThreads);
+    }
+
+#endif
+}
+
+TaskPool::TaskPool() :
+    busy(0),
+    stopping(false)
+{
+    const int numWorkers = getThreadLimit();
+
+    for (int i = 0; i < numWorkers; ++i) {
+        workers.emplace_back(&TaskPool::workerLoop, this);
+    }
+}
+
+TaskPool::~TaskPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        // the objects the queued tasks refer to may already be gone at static destruction
+        tasks.clear();
+    }
+
+    wakeUp.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+int TaskPool::getNumWorkers() const
+{
+    return workers.size();
+}
+
+void TaskPool::submit(Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (stopping) {
+            return;
+        }
+
+        tasks.push_back(std::move(task));
+    }
+
+    wakeUp.notify_one();
+}
+
+void TaskPool::workerLoop()
+{
+    const int threadLimit = getThreadLimit();
+
+    while (true) {
+        Task task;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeUp.wait(lock, [this]() { return stopping || !tasks.empty(); });
+
+            if (stopping) {
+                return;
+            }
+
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+
+#ifdef _OPENMP
+        omp_set_num_threads(std::max(1, threadLimit / ++busy));
+#else
+        ++busy;
+#endif
+        task();
+        --busy;
+    }
+}
+
+}
@@ -0,0 +1,76 @@
+/*
+ *  This file is part of RawTherapee.
+ *
+ *  RawTherapee is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RawTherapee is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RawTherapee.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "noncopyable.h"
+
+namespace rtengine
+{
+
+/*
+ * Engine wide pool of worker threads for the GUI workers (thumbnails, previews of the file browser).
+ *
+ * The number of workers is Settings::maxThreads (0 = number of cores). The same cap is applied to the
+ * OpenMP regions of the threads which call applyThreadLimit(). Inside a task, the OpenMP regions get
+ * the cap divided by the number of busy workers, so a single job still runs multithreaded while many
+ * concurrent jobs don't start a full team each. Tasks which are still queued when the pool is
+ * destroyed are discarded.
+ *
+ * This is not a scheduler for the processing kernels: they keep their own OpenMP regions, including
+ * the nested ones of RGB_denoise, Local Adjustments and the wavelets, which only see the cap.
+ */
+class TaskPool final :
+    public NonCopyable
+{
+public:
+    using Task = std::function<void()>;
+
+    static TaskPool& getInstance();
+
+    // cap of the number of threads as configured, at least 1
+    static int getThreadLimit();
+    // limit the OpenMP regions started by the calling thread to the cap
+    static void applyThreadLimit();
+
+    int getNumWorkers() const;
+
+    // fire and forget
+    void submit(Task task);
+
+private:
+    TaskPool();
+    ~TaskPool();
+
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::deque<Task> tasks;
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::atomic<int> busy;
+    bool stopping;
+};
+
+}
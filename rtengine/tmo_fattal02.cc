@@ -426,7 +426,8 @@ void tmo_fattal02(size_t width,
                   float beta,
                   float noise,
                   int detail_level,
-                  bool multithread, int algo)
+                  bool multithread, int algo,
+                  const CancellationToken* cancel)
 {
 // #ifdef TIMER_PROFILING
 //     msec_timer stop_watch;
@@ -652,6 +653,13 @@ void tmo_fattal02(size_t width,
 
     //delete Gx; // RT - reused as temp buffer in solve_pde_fft, deleted later
 
+    if (cancel && cancel->isCancelled()) {
+        // the caller discards L
+        delete Gx;
+        delete FI;
+        return;
+    }
+
     // solve pde and exponentiate (ie recover compressed image)
     {
         MyMutex::MyLock lock(*fftwMutex);
@@ -1157,6 +1165,10 @@ void ImProcFunctions::ToneMapFattal02(Imagefloat *rgb, const FattalToneMappingPa
         Median_Denoise(Yr, Yr, luminance_noise_floor, w, h, med, 1, num_threads, L);
     }
 
+    if (isCancelled()) {
+        return;
+    }
+
     float noise = alpha * 0.01f;
 
     if (settings->verbose) {
@@ -1166,7 +1178,11 @@ void ImProcFunctions::ToneMapFattal02(Imagefloat *rgb, const FattalToneMappingPa
 
     rescale_nearest(Yr, L, multiThread);
 
-    tmo_fattal02(w2, h2, L, L, alpha, beta, noise, detail_level, multiThread, 0);
+    tmo_fattal02(w2, h2, L, L, alpha, beta, noise, detail_level, multiThread, 0, cancelToken.load(std::memory_order_acquire));
+
+    if (isCancelled()) {
+        return;
+    }
 
     const float hr = float(h2) / float(h);
     const float wr = float(w2) / float(w);
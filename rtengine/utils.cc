@@ -19,6 +19,13 @@
 #include <cmath>
 #include <cstring>
 #include <cstdio>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
 #include "rt_math.h"
 
 #include "utils.h"
@@ -263,6 +270,56 @@ void swab(const void* from, void* to, ssize_t n)
     }
 }
 
+std::size_t getAvailableMemory()
+{
+#ifdef WIN32
+    MEMORYSTATUSEX status;
+    status.dwLength = sizeof(status);
+
+    if (GlobalMemoryStatusEx(&status)) {
+        return status.ullAvailPhys;
+    }
+
+    return 0;
+#else
+#ifdef __linux__
+    // MemAvailable includes the page cache which the kernel can reclaim, _SC_AVPHYS_PAGES does not
+    FILE* const meminfo = fopen("/proc/meminfo", "r");
+
+    if (meminfo) {
+        char line[256];
+        unsigned long long kiB = 0;
+
+        while (fgets(line, sizeof(line), meminfo)) {
+            if (sscanf(line, "MemAvailable: %llu kB", &kiB) == 1) {
+                break;
+            }
+        }
+
+        fclose(meminfo);
+
+        if (kiB > 0) {
+            return kiB * 1024;
+        }
+    }
+
+#endif
+    const long pageSize = sysconf(_SC_PAGESIZE);
+#ifdef _SC_AVPHYS_PAGES
+    const long pages = sysconf(_SC_AVPHYS_PAGES);
+#else
+    // no way to query the free memory (macOS), assume half of the physical memory is available
+    const long pages = sysconf(_SC_PHYS_PAGES) / 2;
+#endif
+
+    if (pageSize <= 0 || pages <= 0) {
+        return 0;
+    }
+
+    return static_cast<std::size_t>(pageSize) * pages;
+#endif
+}
+
 }
 
 #if __SIZEOF_WCHAR_T__ == 4
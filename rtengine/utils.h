@@ -18,6 +18,7 @@
  */
 #pragma once
 
+#include <cstddef>
 #include <type_traits>
 #include <glibmm/ustring.h>
 
@@ -54,6 +55,9 @@ bool hasPngExtension(const Glib::ustring& filename);
 
 void swab(const void* from, void* to, ssize_t n);
 
+// Return the physical memory currently available in bytes, 0 if it can not be determined
+std::size_t getAvailableMemory();
+
 }
 
 #if __SIZEOF_WCHAR_T__ == 4
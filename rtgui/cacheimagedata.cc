@@ -61,7 +61,7 @@ CacheImageData::CacheImageData() :
 }
 
 /*
- * Load the General, DateTime, ExifInfo, File info and ExtraRawInfo sections of the image data file
+ * Load the General, DateTime, ExifInfo, File info, ExtraRawInfo and HistogramMatching sections of the image data file
  */
 int CacheImageData::load (const Glib::ustring& fname)
 {
@@ -222,6 +222,13 @@ int CacheImageData::load (const Glib::ustring& fname)
                 thumbImgType = 0;
             }
 
+            if (keyFile.has_group ("HistogramMatching")) {
+                if (keyFile.has_key ("HistogramMatching", "Key") && keyFile.has_key ("HistogramMatching", "Curve")) {
+                    histMatchingKey = keyFile.get_string ("HistogramMatching", "Key");
+                    histMatchingCurve = keyFile.get_double_list ("HistogramMatching", "Curve");
+                }
+            }
+
             return 0;
         }
     } catch (Glib::Error &err) {
@@ -238,7 +245,7 @@ int CacheImageData::load (const Glib::ustring& fname)
 }
 
 /*
- * Save the General, DateTime, ExifInfo, File info and ExtraRawInfo sections of the image data file
+ * Save the General, DateTime, ExifInfo, File info, ExtraRawInfo and HistogramMatching sections of the image data file
  */
 int CacheImageData::save (const Glib::ustring& fname)
 {
@@ -304,6 +311,11 @@ int CacheImageData::save (const Glib::ustring& fname)
         keyFile.set_integer ("ExtraRawInfo", "SensorType", sensortype);
     }
 
+    if (!histMatchingCurve.empty()) {
+        keyFile.set_string  ("HistogramMatching", "Key", histMatchingKey);
+        keyFile.set_double_list ("HistogramMatching", "Curve", histMatchingCurve);
+    }
+
     keyData = keyFile.to_data ();
 
     } catch (Glib::Error &err) {
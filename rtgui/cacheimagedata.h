@@ -18,6 +18,8 @@
  */
 #pragma once
 
+#include <vector>
+
 #include <glibmm/ustring.h>
 
 #include "options.h"
@@ -75,6 +77,11 @@ public:
     int   rotate;
     int   thumbImgType;
 
+    // auto-matched tone curve, stored for rtengine::AutoMatchedToneCurveStore
+    // the key identifies the parameters the curve was matched with
+    Glib::ustring histMatchingKey;
+    std::vector<double> histMatchingCurve;
+
     enum {
         FULL_THUMBNAIL = 0,  // was the thumbnail generated from whole file
         QUICK_THUMBNAIL = 1  // was the thumbnail generated from embedded jpeg
@@ -65,6 +65,8 @@ void CacheManager::init ()
     if (error != 0 && rtengine::settings->verbose) {
         std::cerr << "Failed to create all cache directories: " << g_strerror(errno) << std::endl;
     }
+
+    rtengine::setAutoMatchedToneCurveStore (this);
 }
 
 Thumbnail* CacheManager::getEntry (const Glib::ustring& fname)
@@ -147,6 +149,74 @@ Thumbnail* CacheManager::getEntry (const Glib::ustring& fname)
 }
 
 
+Thumbnail* CacheManager::getOpenEntry (const Glib::ustring& fname)
+{
+    MyMutex::MyLock lock (mutex);
+
+    const auto iterator = openEntries.find (fname);
+
+    if (iterator == openEntries.end ()) {
+        return nullptr;
+    }
+
+    iterator->second->increaseRef ();
+    return iterator->second;
+}
+
+bool CacheManager::loadAutoMatchedToneCurve (const Glib::ustring& fname, const Glib::ustring& key, std::vector<double>& curve)
+{
+    // an open entry has the current data in memory
+    Thumbnail* const thumbnail = getOpenEntry (fname);
+
+    if (thumbnail) {
+        const bool found = thumbnail->getAutoMatchedToneCurve (key, curve);
+        thumbnail->decreaseRef ();
+        return found;
+    }
+
+    const auto md5 = getMD5 (fname);
+
+    if (md5.empty ()) {
+        return false;
+    }
+
+    CacheImageData imageData;
+
+    if (imageData.load (getCacheFileName ("data", fname, ".txt", md5)) != 0 || imageData.histMatchingCurve.empty () || imageData.histMatchingKey != key) {
+        return false;
+    }
+
+    curve = imageData.histMatchingCurve;
+    return true;
+}
+
+void CacheManager::storeAutoMatchedToneCurve (const Glib::ustring& fname, const Glib::ustring& key, const std::vector<double>& curve)
+{
+    Thumbnail* const thumbnail = getOpenEntry (fname);
+
+    if (thumbnail) {
+        thumbnail->setAutoMatchedToneCurve (key, curve);
+        thumbnail->decreaseRef ();
+        return;
+    }
+
+    const auto md5 = getMD5 (fname);
+
+    if (md5.empty ()) {
+        return;
+    }
+
+    // only images which are in the cache already get the curve, the data file isn't created for it
+    const auto cacheName = getCacheFileName ("data", fname, ".txt", md5);
+    CacheImageData imageData;
+
+    if (imageData.load (cacheName) == 0) {
+        imageData.histMatchingKey = key;
+        imageData.histMatchingCurve = curve;
+        imageData.save (cacheName);
+    }
+}
+
 void CacheManager::deleteEntry (const Glib::ustring& fname)
 {
     MyMutex::MyLock lock (mutex);
@@ -20,17 +20,20 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include <glibmm/ustring.h>
 
 #include "threadutils.h"
 
 #include "../rtengine/noncopyable.h"
+#include "../rtengine/rtengine.h"
 
 class Thumbnail;
 
 class CacheManager :
-    public rtengine::NonCopyable
+    public rtengine::NonCopyable,
+    public rtengine::AutoMatchedToneCurveStore
 {
 private:
     using Entries = std::map<std::string, Thumbnail*>;
@@ -43,6 +46,9 @@ private:
 
     void applyCacheSizeLimitation () const;
 
+    // returns the open entry of fname with increased reference count, nullptr if it isn't open
+    Thumbnail* getOpenEntry (const Glib::ustring& fname);
+
 public:
     static CacheManager* getInstance ();
 
@@ -61,6 +67,10 @@ public:
     void clearFromCache (const Glib::ustring& fname, bool purge) const;
     static std::string getMD5 (const Glib::ustring& fname);
 
+    // the auto-matched tone curves are kept in the data file of the image
+    bool loadAutoMatchedToneCurve (const Glib::ustring& fname, const Glib::ustring& key, std::vector<double>& curve) override;
+    void storeAutoMatchedToneCurve (const Glib::ustring& fname, const Glib::ustring& key, const std::vector<double>& curve) override;
+
     Glib::ustring    getCacheFileName (const Glib::ustring& subDir,
                                        const Glib::ustring& fname,
                                        const Glib::ustring& fext,
@@ -31,9 +31,11 @@
 #include <cstring>
 #include <cstdlib>
 #include <locale.h>
+#include <iomanip>
 #include "../rtengine/procparams.h"
 #include "../rtengine/profilestore.h"
 #include "../rtengine/rtengine.h"
+#include "../rtengine/startuptimer.h"
 #include "options.h"
 #include "soundman.h"
 #include "rtimage.h"
@@ -102,6 +104,10 @@ int processLineParams ( int argc, char **argv );
 
 bool dontLoadCache ( int argc, char **argv );
 
+bool showStartupReport ( int argc, char **argv );
+
+void printStartupReport ();
+
 int main (int argc, char **argv)
 {
     setlocale (LC_ALL, "");
@@ -157,6 +163,7 @@ int main (int argc, char **argv)
 #endif
 
     bool quickstart = dontLoadCache (argc, argv);
+    bool startupReport = showStartupReport (argc, argv);
 
     try {
         Options::load (quickstart);
@@ -221,6 +228,10 @@ int main (int argc, char **argv)
         std::cout << "Terminating without anything to do." << std::endl;
     }
 
+    if (startupReport) {
+        printStartupReport ();
+    }
+
     return ret;
 }
 
@@ -251,12 +262,41 @@ bool dontLoadCache ( int argc, char **argv )
     return false;
 }
 
+bool showStartupReport ( int argc, char **argv )
+{
+    for (int iArg = 1; iArg < argc; iArg++) {
+        Glib::ustring currParam (argv[iArg]);
+#if ECLIPSE_ARGS
+        currParam = currParam.substr (1, currParam.length() - 2);
+#endif
+        if ( currParam == "--startup-report" ) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void printStartupReport ()
+{
+    // lazily loaded subsystems only appear if the processed files needed them
+    std::cout << std::endl << "Startup report:" << std::endl;
+
+    for (const auto& entry : rtengine::StartupTimer::getEntries()) {
+        std::cout << "  " << std::left << std::setw (24) << entry.subsystem
+                  << std::right << std::fixed << std::setprecision (1) << std::setw (9) << entry.milliseconds << " ms"
+                  << (entry.lazy ? "  (on first use)" : "") << std::endl;
+    }
+}
+
 int processLineParams ( int argc, char **argv )
 {
     rtengine::procparams::PartialProfile *rawParams = nullptr, *imgParams = nullptr;
     std::vector<Glib::ustring> inputFiles;
     Glib::ustring outputPath;
     std::vector<rtengine::procparams::PartialProfile*> processingParams;
+    std::vector<Glib::ustring> renditionSuffixes;
+    std::vector<rtengine::procparams::PartialProfile*> renditionParams;
     bool outputDirectory = false;
     bool leaveUntouched = false;
     bool overwriteFiles = false;
@@ -339,6 +379,45 @@ int processLineParams ( int argc, char **argv )
 
                     break;
 
+                case 'r': // additional rendition: file name suffix and processing parameters for resize, sharpening and output profile
+                    if ( iArg + 2 < argc ) {
+                        Glib::ustring suffix (fname_to_utf8 (argv[iArg + 1]));
+                        Glib::ustring fname (fname_to_utf8 (argv[iArg + 2]));
+                        iArg += 2;
+#if ECLIPSE_ARGS
+                        suffix = suffix.substr (1, suffix.length() - 2);
+                        fname = fname.substr (1, fname.length() - 2);
+#endif
+
+                        if (suffix.empty() || suffix.at (0) == '-' || fname.at (0) == '-') {
+                            std::cerr << "Error: suffix or filename missing next to the -r switch." << std::endl;
+                            deleteProcParams (processingParams);
+                            deleteProcParams (renditionParams);
+                            return -3;
+                        }
+
+                        rtengine::procparams::PartialProfile* currentParams = new rtengine::procparams::PartialProfile (true);
+
+                        if (! (currentParams->load ( fname ))) {
+                            renditionSuffixes.push_back (suffix);
+                            renditionParams.push_back (currentParams);
+                        } else {
+                            std::cerr << "Error: \"" << fname << "\" not found." << std::endl;
+                            currentParams->deleteInstance();
+                            delete currentParams;
+                            deleteProcParams (processingParams);
+                            deleteProcParams (renditionParams);
+                            return -3;
+                        }
+                    } else {
+                        std::cerr << "Error: the -r switch requires a suffix and a filename." << std::endl;
+                        deleteProcParams (processingParams);
+                        deleteProcParams (renditionParams);
+                        return -3;
+                    }
+
+                    break;
+
                 case 'S':
                     skipIfNoSidecar = true;
 
@@ -538,7 +617,7 @@ int processLineParams ( int argc, char **argv )
                     std::cout << "  " << Glib::path_get_basename (argv[0]) << " <other options> -c <dir>|<files>   Convert files in batch with your own settings." << std::endl;
                     std::cout << std::endl;
                     std::cout << "Options:" << std::endl;
-                    std::cout << "  " << Glib::path_get_basename (argv[0]) << "[-o <output>|-O <output>] [-q] [-a] [-s|-S] [-p <one.pp3> [-p <two.pp3> ...] ] [-d] [ -j[1-100] -js<1-3> | -t[z] -b<8|16|16f|32> | -n -b<8|16> ] [-Y] [-f] -c <input>" << std::endl;
+                    std::cout << "  " << Glib::path_get_basename (argv[0]) << "[-o <output>|-O <output>] [-q] [-a] [-s|-S] [-p <one.pp3> [-p <two.pp3> ...] ] [-r <suffix> <file.pp3> ...] [-d] [ -j[1-100] -js<1-3> | -t[z] -b<8|16|16f|32> | -n -b<8|16> ] [-Y] [-f] [--startup-report] -c <input>" << std::endl;
                     std::cout << std::endl;
                     std::cout << "  -c <files>       Specify one or more input files or folders." << std::endl;
                     std::cout << "                   When specifying folders, Rawtherapee will look for image file types which comply" << std::endl;
@@ -558,6 +637,13 @@ int processLineParams ( int argc, char **argv )
                     std::cout << "  -p <file.pp3>    Specify processing profile to be used for all conversions." << std::endl;
                     std::cout << "                   You can specify as many sets of \"-p <file.pp3>\" options as you like," << std::endl;
                     std::cout << "                   each will be built on top of the previous one, as explained below." << std::endl;
+                    std::cout << "  -r <suffix> <file.pp3>" << std::endl;
+                    std::cout << "                   Also save a rendition of each image with <suffix> appended to the output file name," << std::endl;
+                    std::cout << "                   e.g. -r _web web.pp3 saves photo_web.jpg next to photo.jpg." << std::endl;
+                    std::cout << "                   Only the resize, post-resize sharpening and output profile settings of <file.pp3>" << std::endl;
+                    std::cout << "                   are used, on top of the final values. The image is processed only once for all" << std::endl;
+                    std::cout << "                   renditions. You can specify as many sets of \"-r <suffix> <file.pp3>\" as you like." << std::endl;
+                    std::cout << "                   The fast-export pipeline (-f) is not used when renditions are requested." << std::endl;
                     std::cout << "  -d               Use the default raw or non-raw processing profile as set in" << std::endl;
                     std::cout << "                   Preferences > Image Processing > Default Processing Profile" << std::endl;
                     std::cout << "  -j[1-100]        Specify output to be JPEG (default, if -t and -n are not set)." << std::endl;
@@ -580,6 +666,8 @@ int processLineParams ( int argc, char **argv )
                     std::cout << "                   Compression is hard-coded to PNG_FILTER_PAETH, Z_RLE." << std::endl;
                     std::cout << "  -Y               Overwrite output if present." << std::endl;
                     std::cout << "  -f               Use the custom fast-export processing pipeline." << std::endl;
+                    std::cout << "  --startup-report Print the time spent initializing each engine subsystem before exiting." << std::endl;
+                    std::cout << "                   Subsystems which are only loaded when needed are reported on first use." << std::endl;
                     std::cout << std::endl;
                     std::cout << "Your " << pparamsExt << " files can be incomplete, RawTherapee will build the final values as follows:" << std::endl;
                     std::cout << "  1- A new processing profile is created using neutral values," << std::endl;
@@ -800,39 +888,82 @@ int processLineParams ( int argc, char **argv )
             continue;
         }
 
-        // Process image
-        rtengine::IImagefloat* resultImage = rtengine::processImage (job, errorCode, nullptr);
+        // Process image, the main output and the additional renditions come out of one run of the pipeline
+        std::vector<rtengine::IImagefloat*> resultImages;
+        std::vector<Glib::ustring> outputFiles;
+        std::vector<rtengine::procparams::ProcParams> renditions;
+
+        if (renditionParams.empty()) {
+            rtengine::IImagefloat* resultImage = rtengine::processImage (job, errorCode, nullptr);
+
+            if (resultImage) {
+                resultImages.push_back (resultImage);
+            }
+
+            outputFiles.push_back (outputFile);
+        } else {
+            renditions.push_back (currentParams);
+            outputFiles.push_back (outputFile);
+            Glib::ustring::size_type ext = outputFile.find_last_of ('.');
+
+            for (size_t r = 0; r < renditionParams.size(); r++) {
+                // only these are used by the engine, keep the saved sidecar files in line with the output
+                rtengine::procparams::ProcParams renditionValues = currentParams;
+                renditionParams[r]->applyTo (&renditionValues);
+                renditions.push_back (currentParams);
+                renditions.back().resize = renditionValues.resize;
+                renditions.back().prsharpening = renditionValues.prsharpening;
+                renditions.back().icm.outputProfile = renditionValues.icm.outputProfile;
+                renditions.back().icm.outputIntent = renditionValues.icm.outputIntent;
+                renditions.back().icm.outputBPC = renditionValues.icm.outputBPC;
+                outputFiles.push_back (leaveUntouched ? outputFile : outputFile.substr (0, ext) + renditionSuffixes[r] + "." + outputType);
+            }
+
+            resultImages = rtengine::processImage (job, renditions, errorCode, nullptr);
+        }
 
-        if ( !resultImage ) {
+        if ( resultImages.empty() ) {
             errors++;
             std::cerr << "Error processing: " << inputFile << std::endl;
             rtengine::ProcessingJob::destroy ( job );
             continue;
         }
 
-        // save image to disk
-        if ( outputType == "jpg" ) {
-            errorCode = resultImage->saveAsJPEG ( outputFile, compression, subsampling );
-        } else if ( outputType == "tif" ) {
-            errorCode = resultImage->saveAsTIFF ( outputFile, bits, isFloat, compression == 0  );
-        } else if ( outputType == "png" ) {
-            errorCode = resultImage->saveAsPNG ( outputFile, bits );
-        } else {
-            errorCode = resultImage->saveToFile (outputFile);
-        }
+        for (size_t r = 0; r < resultImages.size(); r++) {
+            rtengine::IImagefloat* resultImage = resultImages[r];
+            const Glib::ustring& currentFile = outputFiles[r];
 
-        if (errorCode) {
-            errors++;
-            std::cerr << "Error saving to: " << outputFile << std::endl;
-        } else {
-            if ( copyParamsFile ) {
-                Glib::ustring outputProcessingParams = outputFile + paramFileExtension;
-                currentParams.save ( outputProcessingParams );
+            if ( r > 0 && !leaveUntouched && !overwriteFiles && Glib::file_test ( currentFile, Glib::FILE_TEST_EXISTS ) ) {
+                std::cerr << currentFile  << " already exists: use -Y option to overwrite. This rendition has been skipped." << std::endl;
+                delete resultImage;
+                continue;
             }
+
+            // save image to disk
+            if ( outputType == "jpg" ) {
+                errorCode = resultImage->saveAsJPEG ( currentFile, compression, subsampling );
+            } else if ( outputType == "tif" ) {
+                errorCode = resultImage->saveAsTIFF ( currentFile, bits, isFloat, compression == 0  );
+            } else if ( outputType == "png" ) {
+                errorCode = resultImage->saveAsPNG ( currentFile, bits );
+            } else {
+                errorCode = resultImage->saveToFile (currentFile);
+            }
+
+            if (errorCode) {
+                errors++;
+                std::cerr << "Error saving to: " << currentFile << std::endl;
+            } else {
+                if ( copyParamsFile ) {
+                    Glib::ustring outputProcessingParams = currentFile + paramFileExtension;
+                    (r == 0 ? currentParams : renditions[r]).save ( outputProcessingParams );
+                }
+            }
+
+            delete resultImage;
         }
 
         ii->decreaseRef();
-        delete resultImage;
     }
 
     if (imgParams) {
@@ -846,6 +977,7 @@ int processLineParams ( int argc, char **argv )
     }
 
     deleteProcParams (processingParams);
+    deleteProcParams (renditionParams);
 
     return errors > 0 ? -2 : 0;
 }
@@ -682,6 +682,13 @@ void Options::setDefaults()
     cropAutoFit = false;
 
     rtSettings.thumbnail_inspector_mode = rtengine::Settings::ThumbnailInspectorMode::JPEG;
+    rtSettings.compactLUTs = false;
+    rtSettings.denoiseMemoryBudget = 4096; // whole image up to about 38 MP
+    rtSettings.locallabMaskCacheSize = 64;
+    rtSettings.maxThreads = 0;
+    rtSettings.perspectivePyramid = false;
+    rtSettings.tiffTileSize = 0;
+    rtSettings.jpegParallelBands = false;
 }
 
 Options* Options::copyFrom(Options* other)
@@ -855,6 +862,14 @@ void Options::readFromFile(Glib::ustring fname)
                     saveFormat.tiffUncompressed = keyFile.get_boolean("Output", "TiffUncompressed");
                 }
 
+                if (keyFile.has_key("Output", "TiffTileSize")) {
+                    rtSettings.tiffTileSize = std::max(0, keyFile.get_integer("Output", "TiffTileSize"));
+                }
+
+                if (keyFile.has_key("Output", "JpegParallelBands")) {
+                    rtSettings.jpegParallelBands = keyFile.get_boolean("Output", "JpegParallelBands");
+                }
+
                 if (keyFile.has_key("Output", "SaveProcParams")) {
                     saveFormat.saveParams = keyFile.get_boolean("Output", "SaveProcParams");
                 }
@@ -1185,6 +1200,26 @@ void Options::readFromFile(Glib::ustring fname)
                 if (keyFile.has_key("Performance", "ThumbnailInspectorMode")) {
                     rtSettings.thumbnail_inspector_mode = static_cast<rtengine::Settings::ThumbnailInspectorMode>(keyFile.get_integer("Performance", "ThumbnailInspectorMode"));
                 }
+
+                if (keyFile.has_key("Performance", "CompactLUTs")) {
+                    rtSettings.compactLUTs = keyFile.get_boolean("Performance", "CompactLUTs");
+                }
+
+                if (keyFile.has_key("Performance", "DenoiseMemoryBudget")) {
+                    rtSettings.denoiseMemoryBudget = std::max(0, keyFile.get_integer("Performance", "DenoiseMemoryBudget"));
+                }
+
+                if (keyFile.has_key("Performance", "LocallabMaskCacheSize")) {
+                    rtSettings.locallabMaskCacheSize = std::max(0, keyFile.get_integer("Performance", "LocallabMaskCacheSize"));
+                }
+
+                if (keyFile.has_key("Performance", "MaxThreads")) {
+                    rtSettings.maxThreads = std::max(0, keyFile.get_integer("Performance", "MaxThreads"));
+                }
+
+                if (keyFile.has_key("Performance", "PerspectivePyramid")) {
+                    rtSettings.perspectivePyramid = keyFile.get_boolean("Performance", "PerspectivePyramid");
+                }
             }
 
             if (keyFile.has_group("GUI")) {
@@ -2181,6 +2216,11 @@ void Options::saveToFile(Glib::ustring fname)
         keyFile.set_integer("Performance", "ChunkSizeXT", chunkSizeXT);
         keyFile.set_integer("Performance", "ChunkSizeCA", chunkSizeCA);
         keyFile.set_integer("Performance", "ThumbnailInspectorMode", int(rtSettings.thumbnail_inspector_mode));
+        keyFile.set_boolean("Performance", "CompactLUTs", rtSettings.compactLUTs);
+        keyFile.set_integer("Performance", "DenoiseMemoryBudget", rtSettings.denoiseMemoryBudget);
+        keyFile.set_integer("Performance", "LocallabMaskCacheSize", rtSettings.locallabMaskCacheSize);
+        keyFile.set_integer("Performance", "MaxThreads", rtSettings.maxThreads);
+        keyFile.set_boolean("Performance", "PerspectivePyramid", rtSettings.perspectivePyramid);
 
 
         keyFile.set_string("Output", "Format", saveFormat.format);
@@ -2190,6 +2230,8 @@ void Options::saveToFile(Glib::ustring fname)
         keyFile.set_integer("Output", "TiffBps", saveFormat.tiffBits);
         keyFile.set_boolean("Output", "TiffFloat", saveFormat.tiffFloat);
         keyFile.set_boolean("Output", "TiffUncompressed", saveFormat.tiffUncompressed);
+        keyFile.set_integer("Output", "TiffTileSize", rtSettings.tiffTileSize);
+        keyFile.set_boolean("Output", "JpegParallelBands", rtSettings.jpegParallelBands);
         keyFile.set_boolean("Output", "SaveProcParams", saveFormat.saveParams);
 
         keyFile.set_string("Output", "FormatBatch", saveFormatBatch.format);
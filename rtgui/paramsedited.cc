@@ -2970,6 +2970,8 @@ void ParamsEdited::combine(rtengine::procparams::ProcParams& toEdit, const rteng
 
     if (epd.reweightingIterates) {
         toEdit.epd.reweightingIterates = mods.epd.reweightingIterates;
+        // the solver cannot be managed via the GUI, it's saved and copied with the reweighting iterates
+        toEdit.epd.legacySolver = mods.epd.legacySolver;
     }
 
     if (fattal.enabled) {
@@ -4444,6 +4446,8 @@ void ParamsEdited::combine(rtengine::procparams::ProcParams& toEdit, const rteng
 
         if (locallab.spots.at(i).rewei) {
             toEdit.locallab.spots.at(i).rewei = mods.locallab.spots.at(i).rewei;
+            // the solver cannot be managed via the GUI, it's saved and copied with the reweighting iterates
+            toEdit.locallab.spots.at(i).legacysolvertm = mods.locallab.spots.at(i).legacysolvertm;
         }
 
         if (locallab.spots.at(i).satur) {
@@ -6386,6 +6390,8 @@ void ParamsEdited::combine(rtengine::procparams::ProcParams& toEdit, const rteng
 
     if (wavelet.tmrs) {
         toEdit.wavelet.tmrs = dontforceSet && options.baBehav[ADDSET_WA_TMRS] ? toEdit.wavelet.tmrs + mods.wavelet.tmrs : mods.wavelet.tmrs;
+        // the solver cannot be managed via the GUI, it's saved and copied with the strength
+        toEdit.wavelet.tmLegacySolver = mods.wavelet.tmLegacySolver;
     }
 
     if (wavelet.edgs) {
@@ -1,11 +1,13 @@
 #pragma once
 
 // This number has to be incremented whenever the PP3 file format is modified or the behaviour of a tool changes
-#define PPVERSION 349
+#define PPVERSION 350
 #define PPVERSION_AEXP 301 //value of PPVERSION when auto exposure algorithm was modified
 
 /*
   Log of version changes
+   350  2026-10-18
+        edge preserving decomposition solved by multigrid preconditioned CG, older profiles keep the old solver
    349  2020-10-29
         replaced Haze removal Luminance checkbox with an adjuster to blend between luminance and normal mode
    348  2018-09-25
@@ -24,9 +24,7 @@
 #include "guiutils.h"
 #include "threadutils.h"
 
-#ifdef _OPENMP
-#include <omp.h>
-#endif
+#include "../rtengine/taskpool.h"
 
 #define DEBUG(format,args...)
 //#define DEBUG(format,args...) printf("PreviewLoader::%s: " format "\n", __FUNCTION__, ## args)
@@ -75,16 +73,8 @@ public:
 
     Impl(): nConcurrentThreads(0)
     {
-#ifdef _OPENMP
-        int threadCount = omp_get_num_procs();
-#else
-        int threadCount = 2;
-#endif
-
-        threadPool_ = new Glib::ThreadPool(threadCount, 0);
     }
 
-    Glib::ThreadPool* threadPool_;
     MyMutex mutex_;
     JobSet jobs_;
     gint nConcurrentThreads;
@@ -194,7 +184,8 @@ void PreviewLoader::add(int dir_id, const Glib::ustring& dir_entry, PreviewLoade
 
         // queue a run request
         DEBUG("adding run request %s", dir_entry.c_str());
-        impl_->threadPool_->push(sigc::mem_fun(*impl_, &PreviewLoader::Impl::processNextJob));
+        Impl* const impl = impl_;
+        rtengine::TaskPool::getInstance().submit([impl]() { impl->processNextJob(); });
     }
 }
 
@@ -30,10 +30,7 @@
 #include "thumbnail.h"
 
 #include "../rtengine/procparams.h"
-
-#ifdef _OPENMP
-#include <omp.h>
-#endif
+#include "../rtengine/taskpool.h"
 
 #define DEBUG(format,args...)
 //#define DEBUG(format,args...) printf("ThumbImageUpdate::%s: " format "\n", __FUNCTION__, ## args)
@@ -75,16 +72,8 @@ public:
         active_(0),
         inactive_waiting_(false)
     {
-        int threadCount = 1;
-#ifdef _OPENMP
-        threadCount = omp_get_num_procs();
-#endif
-
-        threadPool_ = new Glib::ThreadPool(threadCount, 0);
     }
 
-    Glib::ThreadPool* threadPool_;
-
     // Need to be a Glib::Threads::Mutex because used in a Glib::Threads::Cond object...
     // This is the only exceptions along with GThreadMutex (guiutils.cc), MyMutex is used everywhere else
     Glib::Threads::Mutex mutex_;
@@ -221,7 +210,8 @@ void ThumbImageUpdater::add(ThumbBrowserEntryBase* tbe, bool* priority, bool upg
     impl_->jobs_.push_back(Impl::Job(tbe, priority, upgrade, l));
 
     DEBUG("adding run request %s", tbe->shortname.c_str());
-    impl_->threadPool_->push(sigc::mem_fun(*impl_, &ThumbImageUpdater::Impl::processNextJob));
+    Impl* const impl = impl_;
+    rtengine::TaskPool::getInstance().submit([impl]() { impl->processNextJob(); });
 }
 
 
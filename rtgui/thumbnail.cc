@@ -968,7 +968,7 @@ void Thumbnail::saveThumbnail ()
  * Update the cached files
  *  - updatePParams==true (default)        : write the procparams file (sidecar or cache, depending on the options)
  *  - updateCacheImageData==true (default) : write the CacheImageData values in the cache folder,
- *                                           i.e. some General, DateTime, ExifInfo, File info and ExtraRawInfo,
+ *                                           i.e. some General, DateTime, ExifInfo, File info, ExtraRawInfo and HistogramMatching,
  */
 void Thumbnail::updateCache (bool updatePParams, bool updateCacheImageData)
 {
@@ -1178,6 +1178,27 @@ void Thumbnail::applyAutoExp (rtengine::procparams::ProcParams& pparams)
     }
 }
 
+bool Thumbnail::getAutoMatchedToneCurve (const Glib::ustring& key, std::vector<double>& curve)
+{
+    MyMutex::MyLock lock(mutex);
+
+    if (cfs.histMatchingCurve.empty() || cfs.histMatchingKey != key) {
+        return false;
+    }
+
+    curve = cfs.histMatchingCurve;
+    return true;
+}
+
+void Thumbnail::setAutoMatchedToneCurve (const Glib::ustring& key, const std::vector<double>& curve)
+{
+    MyMutex::MyLock lock(mutex);
+
+    cfs.histMatchingKey = key;
+    cfs.histMatchingCurve = curve;
+    cfs.save (getCacheFileName ("data", ".txt"));
+}
+
 const CacheImageData* Thumbnail::getCacheImageData()
 {
     return &cfs;
@@ -130,6 +130,9 @@ public:
     void                  getSpotWB (int x, int y, int rect, double& temp, double& green);
     void                  applyAutoExp (rtengine::procparams::ProcParams& pparams);
 
+    bool                  getAutoMatchedToneCurve (const Glib::ustring& key, std::vector<double>& curve);
+    void                  setAutoMatchedToneCurve (const Glib::ustring& key, const std::vector<double>& curve);
+
     ThFileType      getType ();
     Glib::ustring   getFileName () const
     {
@@ -0,0 +1,137 @@
+/*
+ *  This file is part of RawTherapee.
+ *
+ *  RawTherapee is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  RawTherapee is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with RawTherapee.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Compares rtengine::medianFilter (rtengine/medianfilter.cc) with std::nth_element, for all radii (1 to 4), with and
+ * without upper bound, on images of several sizes with random values and many ties. Run it after changing the filter
+ * or regenerating its networks with tools/generateMedianNetworks.
+ *
+ * Build and run from the root of the repository:
+ *   g++ -std=c++11 -O2 -fopenmp -I rtengine tools/checkMedianFilter.cc rtengine/medianfilter.cc -o checkMedianFilter
+ *   ./checkMedianFilter
+ * The exit status is 1 if any pixel differs.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "medianfilter.h"
+
+namespace
+{
+
+class Image
+{
+public:
+    Image(int width, int height) :
+        width(width),
+        height(height),
+        data(width * height),
+        rows(height)
+    {
+        for (int i = 0; i < height; ++i) {
+            rows[i] = data.data() + i * width;
+        }
+    }
+
+    const int width;
+    const int height;
+    std::vector<float> data;
+    std::vector<float*> rows;
+};
+
+float reference(const Image& src, int row, int col, int radius, bool useUpperBound, float upperBound)
+{
+    if (row < radius || row >= src.height - radius || col < radius || col >= src.width - radius) {
+        return src.rows[row][col];
+    }
+
+    if (useUpperBound && src.rows[row][col] > upperBound) {
+        return src.rows[row][col];
+    }
+
+    std::vector<float> window;
+
+    for (int i = -radius; i <= radius; ++i) {
+        for (int j = -radius; j <= radius; ++j) {
+            window.push_back(src.rows[row + i][col + j]);
+        }
+    }
+
+    std::nth_element(window.begin(), window.begin() + window.size() / 2, window.end());
+    return window[window.size() / 2];
+}
+
+}
+
+int main()
+{
+    // sizes smaller than the window, not a multiple of the vector size or of the 4 windows of a network and larger ones
+    const int sizes[][2] = {{1, 1}, {3, 3}, {8, 9}, {9, 9}, {10, 11}, {37, 29}, {64, 64}, {101, 7}, {8, 200}, {517, 333}};
+    constexpr float upperBound = 0.2f;
+
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+    int failures = 0;
+
+    for (const auto& size : sizes) {
+        const int width = size[0];
+        const int height = size[1];
+        Image src(width, height);
+        Image dst(width, height);
+
+        for (auto& value : src.data) {
+            // every fourth value is one of 9 integers, so that windows contain ties
+            value = generator() % 4 == 0 ? std::round(4.f * distribution(generator)) : distribution(generator);
+        }
+
+        for (int radius = 1; radius <= 4; ++radius) {
+            for (int useUpperBound = 0; useUpperBound < 2; ++useUpperBound) {
+                for (int numThreads = 1; numThreads <= 4; numThreads += 3) {
+                    std::fill(dst.data.begin(), dst.data.end(), NAN);
+
+                    if (useUpperBound) {
+                        rtengine::medianFilter(src.rows.data(), dst.rows.data(), upperBound, width, height, radius, numThreads);
+                    } else {
+                        rtengine::medianFilter(src.rows.data(), dst.rows.data(), width, height, radius, numThreads);
+                    }
+
+                    int mismatches = 0;
+
+                    for (int i = 0; i < height; ++i) {
+                        for (int j = 0; j < width; ++j) {
+                            const float expected = reference(src, i, j, radius, useUpperBound, upperBound);
+
+                            if (!(dst.rows[i][j] == expected) && mismatches++ < 5) {
+                                std::printf("%dx%d radius %d%s, %d threads: pixel (%d, %d) is %g instead of %g\n", width, height, radius,
+                                            useUpperBound ? " with upper bound" : "", numThreads, i, j, dst.rows[i][j], expected);
+                            }
+                        }
+                    }
+
+                    failures += mismatches > 0;
+                }
+            }
+        }
+    }
+
+    std::printf(failures ? "medianFilter: %d of the checks failed\n" : "medianFilter: all checks passed\n", failures);
+    return failures ? 1 : 0;
+}